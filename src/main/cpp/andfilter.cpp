@@ -43,6 +43,7 @@ void AndFilter::addFilter(const FilterPtr& filter)
 	else
 	{
 		tailFilter->setNext(filter);
+		tailFilter = filter;
 	}
 }
 
@@ -0,0 +1,402 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/helpers/appendermetrics.h>
+#include <log4cxxNG/helpers/transcoder.h>
+#include <chrono>
+#include <stdio.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+
+namespace
+{
+const char* const COUNTER_NAMES[AppenderMetrics::COUNTER_COUNT] =
+{
+	"log4cxx_appender_events_in_total",
+	"log4cxx_appender_events_out_total",
+	"log4cxx_appender_discarded_total",
+	"log4cxx_appender_bytes_written_total",
+	"log4cxx_appender_flushes_total",
+	"log4cxx_appender_rollovers_total",
+	"log4cxx_appender_rollover_seconds_total",
+	"log4cxx_appender_write_seconds_total"
+};
+
+const char* const COUNTER_HELP[AppenderMetrics::COUNTER_COUNT] =
+{
+	"Events passed to the appender.",
+	"Events appended after threshold and filters.",
+	"Events dropped because a queue was full.",
+	"Formatted characters written.",
+	"Flushes of the output.",
+	"Rollovers performed.",
+	"Time spent rolling over.",
+	"Time spent appending."
+};
+
+void appendAscii(LogString& text, const char* value)
+{
+	Transcoder::decode(std::string(value), text);
+}
+
+void appendUnsigned(LogString& text, unsigned long long value)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%llu", value);
+	appendAscii(text, buf);
+}
+
+/**
+ *  Appends nanoseconds as seconds with nine decimals.  Only integers
+ *  are formatted so that the decimal point of the C locale never
+ *  replaces the '.' that Prometheus expects.
+ */
+void appendSeconds(LogString& text, unsigned long long nanos)
+{
+	char buf[48];
+	snprintf(buf, sizeof(buf), "%llu.%09llu",
+		nanos / 1000000000ULL, nanos % 1000000000ULL);
+	appendAscii(text, buf);
+}
+
+void appendLabel(LogString& text, const LogString& appender)
+{
+	text.append(LOG4CXXNG_STR("{appender=\""));
+
+	for (LogString::const_iterator iter = appender.begin();
+		iter != appender.end();
+		iter++)
+	{
+		switch (*iter)
+		{
+			case 0x22: /* " */
+			case 0x5C: /* \ */
+				text.append(1, (logchar) 0x5C);
+				text.append(1, *iter);
+				break;
+
+			case 0x0A:
+				text.append(LOG4CXXNG_STR("\\n"));
+				break;
+
+			default:
+				text.append(1, *iter);
+		}
+	}
+
+	text.append(LOG4CXXNG_STR("\"}"));
+}
+
+void appendFamily(LogString& text, const char* name, const char* help, const char* type)
+{
+	appendAscii(text, "# HELP ");
+	appendAscii(text, name);
+	text.append(1, (logchar) 0x20);
+	appendAscii(text, help);
+	appendAscii(text, "\n# TYPE ");
+	appendAscii(text, name);
+	text.append(1, (logchar) 0x20);
+	appendAscii(text, type);
+	text.append(1, (logchar) 0x0A);
+}
+}
+
+AppenderMetrics::Snapshot::Snapshot()
+	: queueHighWater(0), writeLatency(BUCKETS, 0)
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		counters[i] = 0;
+	}
+}
+
+unsigned long long AppenderMetrics::Snapshot::getWriteCount() const
+{
+	unsigned long long count = 0;
+
+	for (std::vector<unsigned long long>::const_iterator iter = writeLatency.begin();
+		iter != writeLatency.end();
+		iter++)
+	{
+		count += *iter;
+	}
+
+	return count;
+}
+
+unsigned long long AppenderMetrics::Snapshot::getWriteLatency(double fraction) const
+{
+	unsigned long long count = getWriteCount();
+
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	unsigned long long rank = (unsigned long long) (fraction * count);
+
+	if (rank >= count)
+	{
+		rank = count - 1;
+	}
+
+	unsigned long long seen = 0;
+
+	for (int i = 0; i < BUCKETS; i++)
+	{
+		seen += writeLatency[i];
+
+		if (seen > rank)
+		{
+			return getBucketLimit(i);
+		}
+	}
+
+	return getBucketLimit(BUCKETS - 1);
+}
+
+AppenderMetrics::AppenderMetrics() : queueHighWater(0)
+{
+	for (int s = 0; s < STRIPES; s++)
+	{
+		for (int i = 0; i < COUNTER_COUNT; i++)
+		{
+			stripes[s].counters[i].store(0, std::memory_order_relaxed);
+		}
+
+		for (int i = 0; i < BUCKETS; i++)
+		{
+			stripes[s].writeLatency[i].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+unsigned int AppenderMetrics::stripeIndex()
+{
+	static std::atomic<unsigned int> nextStripe(0);
+	thread_local static unsigned int stripe =
+		nextStripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+	return stripe;
+}
+
+void AppenderMetrics::recordQueueDepth(size_t depth)
+{
+	size_t highWater = queueHighWater.load(std::memory_order_relaxed);
+
+	while (depth > highWater
+		&& !queueHighWater.compare_exchange_weak(highWater, depth,
+			std::memory_order_relaxed))
+	{
+	}
+}
+
+void AppenderMetrics::recordWrite(unsigned long long nanos)
+{
+	Stripe& stripe = stripes[stripeIndex()];
+	stripe.counters[EVENTS_OUT].fetch_add(1, std::memory_order_relaxed);
+	stripe.counters[WRITE_NANOS].fetch_add(nanos, std::memory_order_relaxed);
+	stripe.writeLatency[getBucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AppenderMetrics::recordRollover(unsigned long long nanos)
+{
+	Stripe& stripe = stripes[stripeIndex()];
+	stripe.counters[ROLLOVERS].fetch_add(1, std::memory_order_relaxed);
+	stripe.counters[ROLLOVER_NANOS].fetch_add(nanos, std::memory_order_relaxed);
+}
+
+unsigned long long AppenderMetrics::get(Counter counter) const
+{
+	unsigned long long total = 0;
+
+	for (int s = 0; s < STRIPES; s++)
+	{
+		total += stripes[s].counters[counter].load(std::memory_order_relaxed);
+	}
+
+	return total;
+}
+
+void AppenderMetrics::snapshot(Snapshot& result) const
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		result.counters[i] = get((Counter) i);
+	}
+
+	result.queueHighWater = getQueueHighWater();
+	result.writeLatency.assign(BUCKETS, 0);
+
+	for (int s = 0; s < STRIPES; s++)
+	{
+		for (int i = 0; i < BUCKETS; i++)
+		{
+			result.writeLatency[i] +=
+				stripes[s].writeLatency[i].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+unsigned long long AppenderMetrics::now()
+{
+	return (unsigned long long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int AppenderMetrics::getBucket(unsigned long long nanos)
+{
+	if (nanos < SUB_BUCKETS)
+	{
+		return (int) nanos;
+	}
+
+	//
+	//   the highest set bit selects the power of two,
+	//      the two bits below it the sub-bucket
+	//
+	int exponent = 63;
+
+	while ((nanos >> exponent) == 0)
+	{
+		exponent--;
+	}
+
+	int bucket = (exponent - 1) * SUB_BUCKETS + (int) ((nanos >> (exponent - 2)) & 3);
+	return bucket < BUCKETS ? bucket : BUCKETS - 1;
+}
+
+unsigned long long AppenderMetrics::getBucketLimit(int bucket)
+{
+	if (bucket < SUB_BUCKETS)
+	{
+		return bucket + 1;
+	}
+
+	int exponent = bucket / SUB_BUCKETS + 1;
+	unsigned long long subBucket = bucket % SUB_BUCKETS;
+	return (SUB_BUCKETS + subBucket + 1) << (exponent - 2);
+}
+
+void AppenderMetrics::writePrometheus(const std::map<LogString, Snapshot>& metrics,
+	LogString& text)
+{
+	typedef std::map<LogString, Snapshot>::const_iterator iterator;
+
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		bool seconds = (i == ROLLOVER_NANOS || i == WRITE_NANOS);
+
+		//
+		//   the total write time is reported as the histogram sum
+		//
+		if (i == WRITE_NANOS)
+		{
+			continue;
+		}
+
+		appendFamily(text, COUNTER_NAMES[i], COUNTER_HELP[i], "counter");
+
+		for (iterator iter = metrics.begin(); iter != metrics.end(); iter++)
+		{
+			appendAscii(text, COUNTER_NAMES[i]);
+			appendLabel(text, iter->first);
+			text.append(1, (logchar) 0x20);
+
+			if (seconds)
+			{
+				appendSeconds(text, iter->second.counters[i]);
+			}
+			else
+			{
+				appendUnsigned(text, iter->second.counters[i]);
+			}
+
+			text.append(1, (logchar) 0x0A);
+		}
+	}
+
+	appendFamily(text, "log4cxx_appender_queue_high_water",
+		"Largest queue depth seen.", "gauge");
+
+	for (iterator iter = metrics.begin(); iter != metrics.end(); iter++)
+	{
+		appendAscii(text, "log4cxx_appender_queue_high_water");
+		appendLabel(text, iter->first);
+		text.append(1, (logchar) 0x20);
+		appendUnsigned(text, iter->second.queueHighWater);
+		text.append(1, (logchar) 0x0A);
+	}
+
+	//
+	//   the histogram is exposed with a bucket per power of two,
+	//      from 256ns to about 17s
+	//
+	const char* histogram = "log4cxx_appender_write_latency_seconds";
+	appendFamily(text, histogram, "Time taken by one append.", "histogram");
+
+	for (iterator iter = metrics.begin(); iter != metrics.end(); iter++)
+	{
+		const std::vector<unsigned long long>& buckets = iter->second.writeLatency;
+		unsigned long long cumulative = 0;
+		int bucket = 0;
+
+		for (int exponent = 8; exponent <= 34; exponent++)
+		{
+			unsigned long long limit = 1ULL << exponent;
+
+			while (bucket < BUCKETS && getBucketLimit(bucket) <= limit)
+			{
+				cumulative += buckets[bucket++];
+			}
+
+			appendAscii(text, histogram);
+			appendAscii(text, "_bucket");
+			appendLabel(text, iter->first);
+			text.erase(text.size() - 2);
+			appendAscii(text, "\",le=\"");
+			appendSeconds(text, limit);
+			appendAscii(text, "\"} ");
+			appendUnsigned(text, cumulative);
+			text.append(1, (logchar) 0x0A);
+		}
+
+		unsigned long long count = iter->second.getWriteCount();
+		appendAscii(text, histogram);
+		appendAscii(text, "_bucket");
+		appendLabel(text, iter->first);
+		text.erase(text.size() - 2);
+		appendAscii(text, "\",le=\"+Inf\"} ");
+		appendUnsigned(text, count);
+		text.append(1, (logchar) 0x0A);
+
+		appendAscii(text, histogram);
+		appendAscii(text, "_sum");
+		appendLabel(text, iter->first);
+		text.append(1, (logchar) 0x20);
+		appendSeconds(text, iter->second.counters[WRITE_NANOS]);
+		text.append(1, (logchar) 0x0A);
+
+		appendAscii(text, histogram);
+		appendAscii(text, "_count");
+		appendLabel(text, iter->first);
+		text.append(1, (logchar) 0x20);
+		appendUnsigned(text, count);
+		text.append(1, (logchar) 0x0A);
+	}
+}
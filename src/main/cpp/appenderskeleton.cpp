@@ -95,12 +95,15 @@ void AppenderSkeleton::addFilter(const spi::FilterPtr& newFilter)
 		tailFilter->setNext(newFilter);
 		tailFilter = newFilter;
 	}
+
+	filterTable.compile(headFilter);
 }
 
 void AppenderSkeleton::clearFilters()
 {
 	LOCK_W sync(mutex);
 	headFilter = tailFilter = 0;
+	filterTable.compile(headFilter);
 }
 
 bool AppenderSkeleton::isAsSevereAsThreshold(const LevelPtr& level) const
@@ -112,6 +115,11 @@ void AppenderSkeleton::doAppend(const spi::LoggingEventPtr& event, Pool& pool1)
 {
 	LOCK_W sync(mutex);
 
+	if (!filterTable.isCurrent())
+	{
+		filterTable.compile(headFilter);
+	}
+
 	doAppendImpl(event, pool1);
 }
 
@@ -124,11 +132,26 @@ void AppenderSkeleton::doAppendImpl(const spi::LoggingEventPtr& event, Pool& poo
 		return;
 	}
 
+	metrics.add(AppenderMetrics::EVENTS_IN);
+
 	if (!isAsSevereAsThreshold(event->getLevel()))
 	{
 		return;
 	}
 
+	switch (filterTable.decide(event))
+	{
+		case FilterTable::DROP:
+			return;
+
+		case FilterTable::APPEND:
+			measuredAppend(event, pool1);
+			return;
+
+		case FilterTable::CONSULT_CHAIN:
+			break;
+	}
+
 	FilterPtr f = headFilter;
 
 
@@ -148,7 +171,14 @@ void AppenderSkeleton::doAppendImpl(const spi::LoggingEventPtr& event, Pool& poo
 		}
 	}
 
+	measuredAppend(event, pool1);
+}
+
+void AppenderSkeleton::measuredAppend(const spi::LoggingEventPtr& event, Pool& pool1)
+{
+	unsigned long long start = AppenderMetrics::now();
 	append(event, pool1);
+	metrics.recordWrite(AppenderMetrics::now() - start);
 }
 
 void AppenderSkeleton::setErrorHandler(const spi::ErrorHandlerPtr& errorHandler1)
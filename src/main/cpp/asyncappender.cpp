@@ -32,6 +32,7 @@
 #include <log4cxxNG/helpers/stringhelper.h>
 #include <apr_atomic.h>
 #include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/stringtokenizer.h>
 
 
 using namespace log4cxxng;
@@ -44,7 +45,9 @@ IMPLEMENT_LOG4CXXNG_OBJECT(AsyncAppender)
 
 AsyncAppender::AsyncAppender()
 	: AppenderSkeleton(),
-	  buffer(),
+	  lanes(1, Lane(Level::getAll(), DEFAULT_BUFFER_SIZE)),
+	  queued(0),
+	  capacity(DEFAULT_BUFFER_SIZE),
 	  bufferMutex(pool),
 	  bufferNotFull(pool),
 	  bufferNotEmpty(pool),
@@ -53,7 +56,11 @@ AsyncAppender::AsyncAppender()
 	  appenders(new AppenderAttachableImpl(pool)),
 	  dispatcher(),
 	  locationInfo(false),
-	  blocking(true)
+	  blocking(true),
+	  dispatchPerAppender(false),
+	  dispatcherAffinity(),
+	  affinityPending(false),
+	  workers()
 {
 #if APR_HAS_THREADS
 	dispatcher.run(dispatch, this);
@@ -100,6 +107,18 @@ void AsyncAppender::setOption(const LogString& option,
 	{
 		setBlocking(OptionConverter::toBoolean(value, true));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("DISPATCHPERAPPENDER"), LOG4CXXNG_STR("dispatchperappender")))
+	{
+		setDispatchPerAppender(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("DISPATCHERAFFINITY"), LOG4CXXNG_STR("dispatcheraffinity")))
+	{
+		setDispatcherAffinity(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("LANES"), LOG4CXXNG_STR("lanes")))
+	{
+		setLanes(value);
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -141,15 +160,26 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 	{
 		synchronized sync(bufferMutex);
 
+		size_t laneIndex = 0;
+		int level = event->getLevel()->toInt();
+
+		while (lanes[laneIndex].threshold->toInt() > level)
+		{
+			laneIndex++;
+		}
+
 		while (true)
 		{
-			size_t previousSize = buffer.size();
+			Lane& lane = lanes[laneIndex];
 
-			if (previousSize < (size_t)bufferSize)
+			if ((lane.events.size() < lane.capacity && queued < capacity)
+				|| evictBelow(laneIndex))
 			{
-				buffer.push_back(event);
+				lane.events.push_back(event);
+				queued++;
+				metrics.recordQueueDepth(queued);
 
-				if (previousSize == 0)
+				if (queued == 1)
 				{
 					bufferNotEmpty.signalAll();
 				}
@@ -158,13 +188,14 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 			}
 
 			//
-			//   Following code is only reachable if buffer is full
+			//   Following code is only reachable if the lane is full
+			//   and no lower severity event could be discarded
 			//
 			//
 			//   if blocking and thread is not already interrupted
 			//      and not the dispatcher then
 			//      wait for a buffer notification
-			bool discard = true;
+			bool discarded = true;
 
 			if (blocking
 				&& !Thread::interrupted()
@@ -173,7 +204,7 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 				try
 				{
 					bufferNotFull.await(bufferMutex);
-					discard = false;
+					discarded = false;
 				}
 				catch (InterruptedException&)
 				{
@@ -189,21 +220,9 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 			//   if blocking is false or thread has been interrupted
 			//   add event to discard map.
 			//
-			if (discard)
+			if (discarded)
 			{
-				LogString loggerName = event->getLoggerName();
-				DiscardMap::iterator iter = discardMap->find(loggerName);
-
-				if (iter == discardMap->end())
-				{
-					DiscardSummary summary(event);
-					discardMap->insert(DiscardMap::value_type(loggerName, summary));
-				}
-				else
-				{
-					(*iter).second.add(event);
-				}
-
+				discard(event);
 				break;
 			}
 		}
@@ -239,6 +258,7 @@ void AsyncAppender::close()
 	{
 	}
 
+	stopWorkers();
 #endif
 
 	{
@@ -254,6 +274,41 @@ void AsyncAppender::close()
 	}
 }
 
+bool AsyncAppender::evictBelow(size_t laneIndex)
+{
+	for (size_t i = lanes.size() - 1; i > laneIndex; i--)
+	{
+		std::deque<LoggingEventPtr>& events = lanes[i].events;
+
+		if (!events.empty())
+		{
+			discard(events.front());
+			events.pop_front();
+			queued--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void AsyncAppender::discard(const LoggingEventPtr& event)
+{
+	metrics.add(AppenderMetrics::DISCARDED);
+	LogString loggerName = event->getLoggerName();
+	DiscardMap::iterator iter = discardMap->find(loggerName);
+
+	if (iter == discardMap->end())
+	{
+		DiscardSummary summary(event);
+		discardMap->insert(DiscardMap::value_type(loggerName, summary));
+	}
+	else
+	{
+		(*iter).second.add(event);
+	}
+}
+
 AppenderList AsyncAppender::getAllAppenders() const
 {
 	synchronized sync(appenders->getMutex());
@@ -315,6 +370,8 @@ void AsyncAppender::setBufferSize(int size)
 
 	synchronized sync(bufferMutex);
 	bufferSize = (size < 1) ? 1 : size;
+	capacity = capacity - lanes.back().capacity + bufferSize;
+	lanes.back().capacity = bufferSize;
 	bufferNotFull.signalAll();
 }
 
@@ -323,6 +380,82 @@ int AsyncAppender::getBufferSize() const
 	return bufferSize;
 }
 
+void AsyncAppender::addLane(const LevelPtr& threshold, int laneCapacity)
+{
+	if (threshold == 0 || laneCapacity < 1)
+	{
+		throw IllegalArgumentException(LOG4CXXNG_STR("lane requires a level and a positive capacity"));
+	}
+
+	if (threshold->toInt() <= Level::ALL_INT)
+	{
+		LogLog::warn(LOG4CXXNG_STR("Use BufferSize to set the capacity of the default lane."));
+		return;
+	}
+
+	synchronized sync(bufferMutex);
+	LaneList::iterator iter = lanes.begin();
+
+	while (iter->threshold->toInt() > threshold->toInt())
+	{
+		iter++;
+	}
+
+	if (iter->threshold->toInt() == threshold->toInt())
+	{
+		capacity = capacity - iter->capacity + laneCapacity;
+		iter->capacity = laneCapacity;
+	}
+	else
+	{
+		//
+		//   events already queued in the lane that now
+		//      follows stay there until dispatched
+		//
+		lanes.insert(iter, Lane(threshold, laneCapacity));
+		capacity += laneCapacity;
+	}
+
+	bufferNotFull.signalAll();
+}
+
+void AsyncAppender::setLanes(const LogString& spec)
+{
+	StringTokenizer tokens(spec, LOG4CXXNG_STR(","));
+
+	while (tokens.hasMoreTokens())
+	{
+		LogString lane(tokens.nextToken());
+		size_t equals = lane.find(0x3D /* '=' */);
+
+		if (equals == LogString::npos)
+		{
+			LogLog::warn(LOG4CXXNG_STR("Ignoring lane [") + lane
+				+ LOG4CXXNG_STR("], expected LEVEL=capacity."));
+			continue;
+		}
+
+		LevelPtr threshold(OptionConverter::toLevel(
+				StringHelper::trim(lane.substr(0, equals)), LevelPtr()));
+		int laneCapacity = OptionConverter::toInt(
+				StringHelper::trim(lane.substr(equals + 1)), 0);
+
+		if (threshold == 0 || laneCapacity < 1)
+		{
+			LogLog::warn(LOG4CXXNG_STR("Ignoring lane [") + lane
+				+ LOG4CXXNG_STR("], expected LEVEL=capacity."));
+			continue;
+		}
+
+		addLane(threshold, laneCapacity);
+	}
+}
+
+int AsyncAppender::getLaneCount() const
+{
+	return (int) lanes.size();
+}
+
 void AsyncAppender::setBlocking(bool value)
 {
 	synchronized sync(bufferMutex);
@@ -335,6 +468,35 @@ bool AsyncAppender::getBlocking() const
 	return blocking;
 }
 
+void AsyncAppender::setDispatchPerAppender(bool value)
+{
+	synchronized sync(bufferMutex);
+	dispatchPerAppender = value;
+}
+
+bool AsyncAppender::getDispatchPerAppender() const
+{
+	return dispatchPerAppender;
+}
+
+void AsyncAppender::setDispatcherAffinity(const LogString& cpus)
+{
+	synchronized sync(bufferMutex);
+	dispatcherAffinity = cpus;
+	affinityPending = true;
+}
+
+LogString AsyncAppender::getDispatcherAffinity() const
+{
+	synchronized sync(bufferMutex);
+	return dispatcherAffinity;
+}
+
+AsyncAppender::Lane::Lane(const LevelPtr& threshold1, size_t capacity1) :
+	threshold(threshold1), capacity(capacity1), events()
+{
+}
+
 AsyncAppender::DiscardSummary::DiscardSummary(const LoggingEventPtr& event) :
 	maxEvent(event), count(1)
 {
@@ -406,20 +568,27 @@ void* LOG4CXXNG_THREAD_FUNC AsyncAppender::dispatch(apr_thread_t* /*thread*/, vo
 				//
 				Pool p;
 				LoggingEventList events;
+				bool perAppender;
+				bool rebind = false;
+				LogString affinity;
 				{
 					synchronized sync(pThis->bufferMutex);
-					size_t bufferSize = pThis->buffer.size();
 					isActive = !pThis->closed;
 
-					while ((bufferSize == 0) && isActive) {
+					while ((pThis->queued == 0) && isActive) {
 						pThis->bufferNotEmpty.await(pThis->bufferMutex);
-						bufferSize = pThis->buffer.size();
 						isActive = !pThis->closed;
 					}
 
-					for (LoggingEventList::iterator eventIter = pThis->buffer.begin(); eventIter != pThis->buffer.end();
-							eventIter++) {
-						events.push_back(*eventIter);
+					//
+					//   drain higher severity lanes first
+					//
+					events.reserve(pThis->queued);
+
+					for (LaneList::iterator laneIter = pThis->lanes.begin(); laneIter != pThis->lanes.end();
+							laneIter++) {
+						events.insert(events.end(), laneIter->events.begin(), laneIter->events.end());
+						laneIter->events.clear();
 					}
 
 					for (DiscardMap::iterator discardIter = pThis->discardMap->begin();
@@ -427,9 +596,37 @@ void* LOG4CXXNG_THREAD_FUNC AsyncAppender::dispatch(apr_thread_t* /*thread*/, vo
 						events.push_back(discardIter->second.createEvent(p));
 					}
 
-					pThis->buffer.clear();
+					pThis->queued = 0;
 					pThis->discardMap->clear();
 					pThis->bufferNotFull.signalAll();
+					perAppender = pThis->dispatchPerAppender;
+
+					if (pThis->affinityPending) {
+						affinity = pThis->dispatcherAffinity;
+						pThis->affinityPending = false;
+						rebind = true;
+					}
+				}
+
+				if (rebind) {
+					if (!Thread::setCurrentThreadAffinity(affinity)) {
+						LogLog::warn(LOG4CXXNG_STR("Unable to bind AsyncAppender dispatcher to [")
+							+ affinity + LOG4CXXNG_STR("]."));
+					}
+
+					//
+					//   restart workers so they inherit the binding
+					//
+					pThis->stopWorkers();
+				}
+
+				if (perAppender) {
+					pThis->dispatchToWorkers(events);
+					continue;
+				}
+
+				if (!pThis->workers.empty()) {
+					pThis->stopWorkers();
 				}
 
 				for (LoggingEventList::iterator iter = events.begin(); iter != events.end(); iter++) {
@@ -450,4 +647,282 @@ void* LOG4CXXNG_THREAD_FUNC AsyncAppender::dispatch(apr_thread_t* /*thread*/, vo
 
 	return 0;
 }
+
+class AsyncAppender::Worker
+{
+	public:
+		Worker(AsyncAppender* owner, const AppenderPtr& appender);
+		~Worker();
+
+		const AppenderPtr& getAppender() const
+		{
+			return appender;
+		}
+
+		/**
+		 * Queues an event, waiting for room if the owner is blocking.
+		 * @param event event to append.
+		 */
+		void offer(const LoggingEventPtr& event);
+
+		/**
+		 * Appends the queued events and ends the thread.
+		 */
+		void stop();
+
+	private:
+		Worker(const Worker&);
+		Worker& operator=(const Worker&);
+
+		static void* LOG4CXXNG_THREAD_FUNC run(apr_thread_t* thread, void* data);
+
+		/**
+		 * Discards the queued events and releases any
+		 * thread waiting in offer once the thread ended.
+		 */
+		void markDead();
+
+		AsyncAppender* owner;
+		AppenderPtr appender;
+		Pool pool;
+		Mutex mutex;
+		Condition notEmpty;
+		Condition notFull;
+		std::deque<LoggingEventPtr> events;
+		size_t discarded;
+		bool stopping;
+		/**
+		 * Set when the thread ended on an unexpected error,
+		 * later events are discarded instead of queued.
+		 */
+		bool dead;
+		Thread thread;
+};
+
+AsyncAppender::Worker::Worker(AsyncAppender* owner1, const AppenderPtr& appender1)
+	: owner(owner1),
+	  appender(appender1),
+	  pool(),
+	  mutex(pool),
+	  notEmpty(pool),
+	  notFull(pool),
+	  events(),
+	  discarded(0),
+	  stopping(false),
+	  dead(false),
+	  thread()
+{
+	thread.run(run, this);
+}
+
+AsyncAppender::Worker::~Worker()
+{
+	stop();
+}
+
+void AsyncAppender::Worker::offer(const LoggingEventPtr& event)
+{
+	synchronized sync(mutex);
+
+	while (dead || events.size() >= (size_t) owner->bufferSize)
+	{
+		if (dead || !owner->blocking || Thread::interrupted())
+		{
+			owner->metrics.add(AppenderMetrics::DISCARDED);
+			discarded++;
+			return;
+		}
+
+		try
+		{
+			notFull.await(mutex);
+		}
+		catch (InterruptedException&)
+		{
+			Thread::currentThreadInterrupt();
+		}
+	}
+
+	events.push_back(event);
+
+	if (events.size() == 1)
+	{
+		notEmpty.signalAll();
+	}
+}
+
+void AsyncAppender::Worker::stop()
+{
+	{
+		synchronized sync(mutex);
+		stopping = true;
+		notEmpty.signalAll();
+	}
+
+	try
+	{
+		thread.join();
+	}
+	catch (InterruptedException&)
+	{
+		Thread::currentThreadInterrupt();
+	}
+	catch (Exception&)
+	{
+	}
+}
+
+void* LOG4CXXNG_THREAD_FUNC AsyncAppender::Worker::run(apr_thread_t* /*thread*/, void* data)
+{
+	Worker* pThis = (Worker*) data;
+
+	try
+	{
+		while (true)
+		{
+			Pool p;
+			LoggingEventList batch;
+			size_t discardedCount;
+			{
+				synchronized sync(pThis->mutex);
+
+				while (pThis->events.empty() && !pThis->stopping)
+				{
+					pThis->notEmpty.await(pThis->mutex);
+				}
+
+				if (pThis->events.empty())
+				{
+					break;
+				}
+
+				batch.assign(pThis->events.begin(), pThis->events.end());
+				pThis->events.clear();
+				discardedCount = pThis->discarded;
+				pThis->discarded = 0;
+				pThis->notFull.signalAll();
+			}
+
+			if (discardedCount > 0)
+			{
+				batch.push_back(DiscardSummary::createEvent(p, discardedCount));
+			}
+
+			for (LoggingEventList::iterator iter = batch.begin(); iter != batch.end(); iter++)
+			{
+				try
+				{
+					pThis->appender->doAppend(*iter, p);
+				}
+				catch (IOException&)
+				{
+				}
+				catch (std::exception& e)
+				{
+					LogLog::error(LOG4CXXNG_STR("AsyncAppender worker of [")
+						+ pThis->appender->getName() + LOG4CXXNG_STR("] failed to append."), e);
+				}
+				catch (...)
+				{
+					LogLog::error(LOG4CXXNG_STR("AsyncAppender worker of [")
+						+ pThis->appender->getName() + LOG4CXXNG_STR("] failed to append."));
+				}
+			}
+		}
+	}
+	catch (InterruptedException&)
+	{
+		Thread::currentThreadInterrupt();
+	}
+	catch (std::exception& e)
+	{
+		LogLog::error(LOG4CXXNG_STR("AsyncAppender worker of [")
+			+ pThis->appender->getName() + LOG4CXXNG_STR("] stopped."), e);
+		pThis->markDead();
+	}
+	catch (...)
+	{
+		LogLog::error(LOG4CXXNG_STR("AsyncAppender worker of [")
+			+ pThis->appender->getName() + LOG4CXXNG_STR("] stopped."));
+		pThis->markDead();
+	}
+
+	return 0;
+}
+
+void AsyncAppender::Worker::markDead()
+{
+	synchronized sync(mutex);
+	dead = true;
+	owner->metrics.add(AppenderMetrics::DISCARDED, events.size());
+	events.clear();
+	notFull.signalAll();
+}
+
+void AsyncAppender::dispatchToWorkers(const LoggingEventList& events)
+{
+	AppenderList appenderList;
+	{
+		synchronized sync(appenders->getMutex());
+		appenderList = appenders->getAllAppenders();
+	}
+
+	WorkerList current;
+
+	for (AppenderList::iterator appenderIter = appenderList.begin();
+		appenderIter != appenderList.end(); appenderIter++)
+	{
+		Worker* worker = 0;
+
+		for (WorkerList::iterator workerIter = workers.begin();
+			workerIter != workers.end(); workerIter++)
+		{
+			if (*workerIter != 0 && (*workerIter)->getAppender() == *appenderIter)
+			{
+				worker = *workerIter;
+				*workerIter = 0;
+				break;
+			}
+		}
+
+		if (worker == 0)
+		{
+			worker = new Worker(this, *appenderIter);
+		}
+
+		current.push_back(worker);
+	}
+
+	//
+	//   remaining workers serve appenders that have been removed
+	//
+	for (WorkerList::iterator workerIter = workers.begin();
+		workerIter != workers.end(); workerIter++)
+	{
+		delete *workerIter;
+	}
+
+	workers.swap(current);
+
+	for (LoggingEventList::const_iterator eventIter = events.begin();
+		eventIter != events.end(); eventIter++)
+	{
+		for (WorkerList::iterator workerIter = workers.begin();
+			workerIter != workers.end(); workerIter++)
+		{
+			(*workerIter)->offer(*eventIter);
+		}
+	}
+}
+
+void AsyncAppender::stopWorkers()
+{
+	for (WorkerList::iterator iter = workers.begin();
+		iter != workers.end(); iter++)
+	{
+		delete *iter;
+	}
+
+	workers.clear();
+}
 #endif
@@ -53,7 +53,10 @@ AsyncAppender::AsyncAppender()
 	  appenders(new AppenderAttachableImpl(pool)),
 	  dispatcher(),
 	  locationInfo(false),
-	  blocking(true)
+	  blocking(true),
+	  dispatchPerAppender(false),
+	  dispatcherAffinity(),
+	  affinityPending(false)
 {
 #if APR_HAS_THREADS
 	dispatcher.run(dispatch, this);
@@ -191,6 +194,7 @@ void AsyncAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 			if (discard)
 			{
 				discardedCount++;
+				metrics.add(AppenderMetrics::DISCARDED);
 				break;
 			}
 		}
@@ -315,6 +319,48 @@ int AsyncAppender::getBufferSize() const
 	return bufferSize;
 }
 
+void AsyncAppender::addLane(const LevelPtr&, int)
+{
+	LogLog::warn(LOG4CXXNG_STR("Priority lanes are not supported by the non-blocking AsyncAppender."));
+}
+
+void AsyncAppender::setLanes(const LogString& lanes)
+{
+	if (!lanes.empty())
+	{
+		addLane(LevelPtr(), 0);
+	}
+}
+
+int AsyncAppender::getLaneCount() const
+{
+	return 1;
+}
+
+void AsyncAppender::setDispatchPerAppender(bool value)
+{
+	if (value)
+	{
+		LogLog::warn(LOG4CXXNG_STR("Per appender dispatch is not supported by the non-blocking AsyncAppender."));
+	}
+}
+
+bool AsyncAppender::getDispatchPerAppender() const
+{
+	return false;
+}
+
+void AsyncAppender::setDispatcherAffinity(const LogString& cpus)
+{
+	LogLog::warn(LOG4CXXNG_STR("Dispatcher affinity is not supported by the non-blocking AsyncAppender."));
+	dispatcherAffinity = cpus;
+}
+
+LogString AsyncAppender::getDispatcherAffinity() const
+{
+	return dispatcherAffinity;
+}
+
 void AsyncAppender::setBlocking(bool value)
 {
 	{
@@ -55,5 +55,20 @@ std::vector<unsigned char> ByteArrayOutputStream::toByteArray() const
 	return array;
 }
 
+void ByteArrayOutputStream::reset()
+{
+	array.resize(0);
+}
+
+size_t ByteArrayOutputStream::size() const
+{
+	return array.size();
+}
+
+const unsigned char* ByteArrayOutputStream::data() const
+{
+	return array.empty() ? 0 : &array[0];
+}
+
 
 
@@ -30,6 +30,8 @@
 #include <apr_portable.h>
 #include <log4cxxNG/helpers/stringhelper.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <atomic>
+#include <vector>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
@@ -47,6 +49,10 @@ namespace helpers
  *  Converts from an arbitrary encoding to LogString
  *    using apr_xlate.  Requires real iconv implementation,
 *    apr-iconv will crash in use.
+*
+*    apr_xlate handles are not thread-safe, so each call takes a handle
+*    of its own from a small lock-free cache and opens another one when
+*    all cached handles are in use.
  */
 class APRCharsetDecoder : public CharsetDecoder
 {
@@ -55,27 +61,22 @@ class APRCharsetDecoder : public CharsetDecoder
 		 *  Creates a new instance.
 		 *  @param frompage name of source encoding.
 		 */
-		APRCharsetDecoder(const LogString& frompage) : pool(), mutex(pool)
+		APRCharsetDecoder(const LogString& frompage) :
+			fpage(Transcoder::encodeCharsetName(frompage))
 		{
-#if LOG4CXXNG_LOGCHAR_IS_WCHAR
-			const char* topage = "WCHAR_T";
-#endif
-#if LOG4CXXNG_LOGCHAR_IS_UTF8
-			const char* topage = "UTF-8";
-#endif
-#if LOG4CXXNG_LOGCHAR_IS_UNICHAR
-			const char* topage = "UTF-16";
-#endif
-			std::string fpage(Transcoder::encodeCharsetName(frompage));
-			apr_status_t stat = apr_xlate_open(&convset,
-					topage,
-					fpage.c_str(),
-					pool.getAPRPool());
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				converters[i].store(0);
+			}
 
-			if (stat != APR_SUCCESS)
+			Converter* converter = open();
+
+			if (converter == 0)
 			{
 				throw IllegalArgumentException(frompage);
 			}
+
+			release(converter);
 		}
 
 		/**
@@ -83,6 +84,10 @@ class APRCharsetDecoder : public CharsetDecoder
 		 */
 		virtual ~APRCharsetDecoder()
 		{
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				delete converters[i].load();
+			}
 		}
 
 		virtual log4cxxng_status_t decode(ByteBuffer& in,
@@ -92,15 +97,18 @@ class APRCharsetDecoder : public CharsetDecoder
 			logchar buf[BUFSIZE];
 			const apr_size_t initial_outbytes_left = BUFSIZE * sizeof(logchar);
 			apr_status_t stat = APR_SUCCESS;
+			Converter* converter = acquire();
+
+			if (converter == 0)
+			{
+				return APR_ENOMEM;
+			}
 
 			if (in.remaining() == 0)
 			{
 				size_t outbytes_left = initial_outbytes_left;
-				{
-					synchronized sync(mutex);
-					stat = apr_xlate_conv_buffer((apr_xlate_t*) convset,
-							NULL, NULL, (char*) buf, &outbytes_left);
-				}
+				stat = apr_xlate_conv_buffer(converter->convset,
+						NULL, NULL, (char*) buf, &outbytes_left);
 				out.append(buf, (initial_outbytes_left - outbytes_left) / sizeof(logchar));
 			}
 			else
@@ -111,28 +119,90 @@ class APRCharsetDecoder : public CharsetDecoder
 					size_t initial_inbytes_left = inbytes_left;
 					size_t pos = in.position();
 					apr_size_t outbytes_left = initial_outbytes_left;
-					{
-						synchronized sync(mutex);
-						stat = apr_xlate_conv_buffer((apr_xlate_t*) convset,
-								in.data() + pos,
-								&inbytes_left,
-								(char*) buf,
-								&outbytes_left);
-					}
+					stat = apr_xlate_conv_buffer(converter->convset,
+							in.data() + pos,
+							&inbytes_left,
+							(char*) buf,
+							&outbytes_left);
 					out.append(buf, (initial_outbytes_left - outbytes_left) / sizeof(logchar));
 					in.position(pos + (initial_inbytes_left - inbytes_left));
 				}
 			}
 
+			release(converter);
 			return stat;
 		}
 
 	private:
 		APRCharsetDecoder(const APRCharsetDecoder&);
 		APRCharsetDecoder& operator=(const APRCharsetDecoder&);
-		log4cxxng::helpers::Pool pool;
-		Mutex mutex;
-		apr_xlate_t* convset;
+
+		struct Converter
+		{
+			log4cxxng::helpers::Pool pool;
+			apr_xlate_t* convset;
+		};
+
+		enum { MAX_CONVERTERS = 8 };
+
+		Converter* open()
+		{
+#if LOG4CXXNG_LOGCHAR_IS_WCHAR
+			const char* topage = "WCHAR_T";
+#endif
+#if LOG4CXXNG_LOGCHAR_IS_UTF8
+			const char* topage = "UTF-8";
+#endif
+#if LOG4CXXNG_LOGCHAR_IS_UNICHAR
+			const char* topage = "UTF-16";
+#endif
+			Converter* converter = new Converter();
+			apr_status_t stat = apr_xlate_open(&converter->convset,
+					topage,
+					fpage.c_str(),
+					converter->pool.getAPRPool());
+
+			if (stat != APR_SUCCESS)
+			{
+				delete converter;
+				return 0;
+			}
+
+			return converter;
+		}
+
+		Converter* acquire()
+		{
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				Converter* converter = converters[i].exchange(0);
+
+				if (converter != 0)
+				{
+					return converter;
+				}
+			}
+
+			return open();
+		}
+
+		void release(Converter* converter)
+		{
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				Converter* empty = 0;
+
+				if (converters[i].compare_exchange_strong(empty, converter))
+				{
+					return;
+				}
+			}
+
+			delete converter;
+		}
+
+		const std::string fpage;
+		std::atomic<Converter*> converters[MAX_CONVERTERS];
 };
 
 #endif
@@ -283,6 +353,14 @@ class UTF8CharsetDecoder : public CharsetDecoder
 		virtual log4cxxng_status_t decode(ByteBuffer& in,
 			LogString& out)
 		{
+			if (in.remaining() > 0)
+			{
+				const char* current = in.current();
+				size_t ascii = Transcoder::asciiLength(current, in.remaining());
+				out.append(current, current + ascii);
+				in.position(in.position() + ascii);
+			}
+
 			if (in.remaining() > 0)
 			{
 				std::string tmp(in.current(), in.remaining());
@@ -290,6 +368,16 @@ class UTF8CharsetDecoder : public CharsetDecoder
 
 				while (iter != tmp.end())
 				{
+					size_t ascii = Transcoder::asciiLength(tmp.data() + (iter - tmp.begin()),
+							tmp.end() - iter);
+
+					if (ascii > 0)
+					{
+						out.append(iter, iter + ascii);
+						iter += ascii;
+						continue;
+					}
+
 					unsigned int sv = Transcoder::decode(tmp, iter);
 
 					if (sv == 0xFFFF)
@@ -421,15 +509,28 @@ class USASCIICharsetDecoder : public CharsetDecoder
 /**
  *    Charset decoder that uses an embedded CharsetDecoder consistent
  *     with current locale settings.
+ *
+ *    The embedded decoder is published through an atomic pointer and
+ *    the lock is only taken when the locale encoding changes.
+ *    Replaced selections are kept until destruction since other
+ *    threads may still be using them.
  */
 class LocaleCharsetDecoder : public CharsetDecoder
 {
 	public:
-		LocaleCharsetDecoder() : pool(), mutex(pool), decoder(), encoding()
+		LocaleCharsetDecoder() : pool(), mutex(pool), selected(0), retired()
 		{
 		}
 		virtual ~LocaleCharsetDecoder()
 		{
+			delete selected.load();
+
+			for (std::vector<Selection*>::iterator iter = retired.begin();
+				iter != retired.end();
+				iter++)
+			{
+				delete *iter;
+			}
 		}
 		virtual log4cxxng_status_t decode(ByteBuffer& in,
 			LogString& out)
@@ -450,43 +551,71 @@ class LocaleCharsetDecoder : public CharsetDecoder
 			{
 				Pool subpool;
 				const char* enc = apr_os_locale_encoding(subpool.getAPRPool());
-				{
-					synchronized sync(mutex);
+				Selection* selection = selected.load(std::memory_order_acquire);
 
-					if (enc == 0)
-					{
-						if (decoder == 0)
-						{
-							encoding = "C";
-							decoder = new USASCIICharsetDecoder();
-						}
-					}
-					else if (encoding != enc)
-					{
-						encoding = enc;
-
-						try
-						{
-							LogString e;
-							Transcoder::decode(encoding, e);
-							decoder = getDecoder(e);
-						}
-						catch (IllegalArgumentException&)
-						{
-							decoder = new USASCIICharsetDecoder();
-						}
-					}
+				if (selection == 0 || (enc != 0 && selection->encoding != enc))
+				{
+					selection = select(enc);
 				}
-				return decoder->decode(in, out);
+
+				return selection->decoder->decode(in, out);
 			}
 
 			return APR_SUCCESS;
 		}
 	private:
+		struct Selection
+		{
+			std::string encoding;
+			CharsetDecoderPtr decoder;
+		};
+
+		Selection* select(const char* enc)
+		{
+			synchronized sync(mutex);
+			Selection* selection = selected.load(std::memory_order_relaxed);
+
+			if (selection != 0 && (enc == 0 || selection->encoding == enc))
+			{
+				return selection;
+			}
+
+			Selection* replacement = new Selection();
+
+			if (enc == 0)
+			{
+				replacement->encoding = "C";
+				replacement->decoder = new USASCIICharsetDecoder();
+			}
+			else
+			{
+				replacement->encoding = enc;
+
+				try
+				{
+					LogString e;
+					Transcoder::decode(replacement->encoding, e);
+					replacement->decoder = getDecoder(e);
+				}
+				catch (IllegalArgumentException&)
+				{
+					replacement->decoder = new USASCIICharsetDecoder();
+				}
+			}
+
+			if (selection != 0)
+			{
+				retired.push_back(selection);
+			}
+
+			selected.store(replacement, std::memory_order_release);
+			return replacement;
+		}
+
 		Pool pool;
 		Mutex mutex;
-		CharsetDecoderPtr decoder;
-		std::string encoding;
+		std::atomic<Selection*> selected;
+		std::vector<Selection*> retired;
 };
 
 
@@ -30,6 +30,9 @@
 #include <apr_portable.h>
 #include <log4cxxNG/helpers/mutex.h>
 #include <log4cxxNG/helpers/synchronized.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <atomic>
+#include <vector>
 
 #ifdef LOG4CXXNG_HAS_WCSTOMBS
 	#include <stdlib.h>
@@ -49,41 +52,51 @@ namespace helpers
 #if APR_HAS_XLATE
 /**
 * A character encoder implemented using apr_xlate.
+*
+* apr_xlate handles are not thread-safe, so each call takes a handle
+* of its own from a small lock-free cache and opens another one when
+* all cached handles are in use.
 */
 class APRCharsetEncoder : public CharsetEncoder
 {
 	public:
-		APRCharsetEncoder(const LogString& topage) : pool(), mutex(pool)
+		APRCharsetEncoder(const LogString& topage) :
+			tpage(Transcoder::encodeCharsetName(topage))
 		{
-#if LOG4CXXNG_LOGCHAR_IS_WCHAR
-			const char* frompage = "WCHAR_T";
-#endif
-#if LOG4CXXNG_LOGCHAR_IS_UTF8
-			const char* frompage = "UTF-8";
-#endif
-#if LOG4CXXNG_LOGCHAR_IS_UNICHAR
-			const char* frompage = "UTF-16";
-#endif
-			std::string tpage(Transcoder::encodeCharsetName(topage));
-			apr_status_t stat = apr_xlate_open(&convset,
-					tpage.c_str(),
-					frompage,
-					pool.getAPRPool());
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				converters[i].store(0);
+			}
 
-			if (stat != APR_SUCCESS)
+			Converter* converter = open();
+
+			if (converter == 0)
 			{
 				throw IllegalArgumentException(topage);
 			}
+
+			release(converter);
 		}
 
 		virtual ~APRCharsetEncoder()
 		{
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				delete converters[i].load();
+			}
 		}
 
 		virtual log4cxxng_status_t encode(const LogString& in,
 			LogString::const_iterator& iter,
 			ByteBuffer& out)
 		{
+			Converter* converter = acquire();
+
+			if (converter == 0)
+			{
+				return APR_ENOMEM;
+			}
+
 			apr_status_t stat;
 			size_t outbytes_left = out.remaining();
 			size_t initial_outbytes_left = outbytes_left;
@@ -91,8 +104,7 @@ class APRCharsetEncoder : public CharsetEncoder
 
 			if (iter == in.end())
 			{
-				synchronized sync(mutex);
-				stat = apr_xlate_conv_buffer(convset, NULL, NULL,
+				stat = apr_xlate_conv_buffer(converter->convset, NULL, NULL,
 						out.data() + position, &outbytes_left);
 			}
 			else
@@ -101,17 +113,15 @@ class APRCharsetEncoder : public CharsetEncoder
 				apr_size_t inbytes_left =
 					(in.size() - inOffset) * sizeof(LogString::value_type);
 				apr_size_t initial_inbytes_left = inbytes_left;
-				{
-					synchronized sync(mutex);
-					stat = apr_xlate_conv_buffer(convset,
-							(const char*) (in.data() + inOffset),
-							&inbytes_left,
-							out.data() + position,
-							&outbytes_left);
-				}
+				stat = apr_xlate_conv_buffer(converter->convset,
+						(const char*) (in.data() + inOffset),
+						&inbytes_left,
+						out.data() + position,
+						&outbytes_left);
 				iter += ((initial_inbytes_left - inbytes_left) / sizeof(LogString::value_type));
 			}
 
+			release(converter);
 			out.position(out.position() + (initial_outbytes_left - outbytes_left));
 			return stat;
 		}
@@ -119,9 +129,73 @@ class APRCharsetEncoder : public CharsetEncoder
 	private:
 		APRCharsetEncoder(const APRCharsetEncoder&);
 		APRCharsetEncoder& operator=(const APRCharsetEncoder&);
-		Pool pool;
-		Mutex mutex;
-		apr_xlate_t* convset;
+
+		struct Converter
+		{
+			Pool pool;
+			apr_xlate_t* convset;
+		};
+
+		enum { MAX_CONVERTERS = 8 };
+
+		Converter* open()
+		{
+#if LOG4CXXNG_LOGCHAR_IS_WCHAR
+			const char* frompage = "WCHAR_T";
+#endif
+#if LOG4CXXNG_LOGCHAR_IS_UTF8
+			const char* frompage = "UTF-8";
+#endif
+#if LOG4CXXNG_LOGCHAR_IS_UNICHAR
+			const char* frompage = "UTF-16";
+#endif
+			Converter* converter = new Converter();
+			apr_status_t stat = apr_xlate_open(&converter->convset,
+					tpage.c_str(),
+					frompage,
+					converter->pool.getAPRPool());
+
+			if (stat != APR_SUCCESS)
+			{
+				delete converter;
+				return 0;
+			}
+
+			return converter;
+		}
+
+		Converter* acquire()
+		{
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				Converter* converter = converters[i].exchange(0);
+
+				if (converter != 0)
+				{
+					return converter;
+				}
+			}
+
+			return open();
+		}
+
+		void release(Converter* converter)
+		{
+			for (int i = 0; i < MAX_CONVERTERS; i++)
+			{
+				Converter* empty = 0;
+
+				if (converters[i].compare_exchange_strong(empty, converter))
+				{
+					return;
+				}
+			}
+
+			delete converter;
+		}
+
+		const std::string tpage;
+		std::atomic<Converter*> converters[MAX_CONVERTERS];
 };
 #endif
 
@@ -358,6 +432,26 @@ class UTF8CharsetEncoder : public CharsetEncoder
 		{
 			while (iter != in.end() && out.remaining() >= 8)
 			{
+				//
+				//   copy a run of US-ASCII without decoding it
+				//
+				char* current = out.current();
+				char* limit = current + out.remaining();
+
+				for (;
+					iter != in.end() && current < limit && ((unsigned int) *iter) < 0x80;
+					iter++, current++)
+				{
+					*current = (char) *iter;
+				}
+
+				out.position(current - out.data());
+
+				if (iter == in.end() || out.remaining() < 8)
+				{
+					break;
+				}
+
 				unsigned int sv = Transcoder::decode(in, iter);
 
 				if (sv == 0xFFFF)
@@ -448,15 +542,28 @@ class UTF16LECharsetEncoder : public CharsetEncoder
 /**
  *    Charset encoder that uses an embedded CharsetEncoder consistent
  *     with current locale settings.
+ *
+ *    The embedded encoder is published through an atomic pointer and
+ *    the lock is only taken when the locale encoding changes.
+ *    Replaced selections are kept until destruction since other
+ *    threads may still be using them.
  */
 class LocaleCharsetEncoder : public CharsetEncoder
 {
 	public:
-		LocaleCharsetEncoder() : pool(), mutex(pool), encoder(), encoding()
+		LocaleCharsetEncoder() : pool(), mutex(pool), selected(0), retired()
 		{
 		}
 		virtual ~LocaleCharsetEncoder()
 		{
+			delete selected.load();
+
+			for (std::vector<Selection*>::iterator iter = retired.begin();
+				iter != retired.end();
+				iter++)
+			{
+				delete *iter;
+			}
 		}
 		virtual log4cxxng_status_t encode(const LogString& in,
 			LogString::const_iterator& iter,
@@ -480,34 +587,14 @@ class LocaleCharsetEncoder : public CharsetEncoder
 			{
 				Pool subpool;
 				const char* enc = apr_os_locale_encoding(subpool.getAPRPool());
-				{
-					synchronized sync(mutex);
-
-					if (enc == 0)
-					{
-						if (encoder == 0)
-						{
-							encoding = "C";
-							encoder = new USASCIICharsetEncoder();
-						}
-					}
-					else if (encoding != enc)
-					{
-						encoding = enc;
-						LogString ename;
-						Transcoder::decode(encoding, ename);
+				Selection* selection = selected.load(std::memory_order_acquire);
 
-						try
-						{
-							encoder = CharsetEncoder::getEncoder(ename);
-						}
-						catch (IllegalArgumentException&)
-						{
-							encoder = new USASCIICharsetEncoder();
-						}
-					}
+				if (selection == 0 || (enc != 0 && selection->encoding != enc))
+				{
+					selection = select(enc);
 				}
-				return encoder->encode(in, iter, out);
+
+				return selection->encoder->encode(in, iter, out);
 			}
 
 			return APR_SUCCESS;
@@ -516,10 +603,59 @@ class LocaleCharsetEncoder : public CharsetEncoder
 	private:
 		LocaleCharsetEncoder(const LocaleCharsetEncoder&);
 		LocaleCharsetEncoder& operator=(const LocaleCharsetEncoder&);
+
+		struct Selection
+		{
+			std::string encoding;
+			CharsetEncoderPtr encoder;
+		};
+
+		Selection* select(const char* enc)
+		{
+			synchronized sync(mutex);
+			Selection* selection = selected.load(std::memory_order_relaxed);
+
+			if (selection != 0 && (enc == 0 || selection->encoding == enc))
+			{
+				return selection;
+			}
+
+			Selection* replacement = new Selection();
+
+			if (enc == 0)
+			{
+				replacement->encoding = "C";
+				replacement->encoder = new USASCIICharsetEncoder();
+			}
+			else
+			{
+				replacement->encoding = enc;
+				LogString ename;
+				Transcoder::decode(replacement->encoding, ename);
+
+				try
+				{
+					replacement->encoder = CharsetEncoder::getEncoder(ename);
+				}
+				catch (IllegalArgumentException&)
+				{
+					replacement->encoder = new USASCIICharsetEncoder();
+				}
+			}
+
+			if (selection != 0)
+			{
+				retired.push_back(selection);
+			}
+
+			selected.store(replacement, std::memory_order_release);
+			return replacement;
+		}
+
 		Pool pool;
 		Mutex mutex;
-		CharsetEncoderPtr encoder;
-		std::string encoding;
+		std::atomic<Selection*> selected;
+		std::vector<Selection*> retired;
 };
 
 
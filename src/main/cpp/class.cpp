@@ -37,6 +37,7 @@
 #include <log4cxxNG/asyncappender.h>
 #include <log4cxxNG/consoleappender.h>
 #include <log4cxxNG/fileappender.h>
+#include <log4cxxNG/flightrecorderappender.h>
 #include <log4cxxNG/db/odbcappender.h>
 #if defined(WIN32) || defined(_WIN32)
 	#if !defined(_WIN32_WCE)
@@ -59,9 +60,14 @@
 #include <log4cxxNG/xml/xmllayout.h>
 #include <log4cxxNG/ttcclayout.h>
 
+#include <log4cxxNG/filter/expressionfilter.h>
 #include <log4cxxNG/filter/levelmatchfilter.h>
 #include <log4cxxNG/filter/levelrangefilter.h>
+#include <log4cxxNG/filter/locationinfofilter.h>
+#include <log4cxxNG/filter/propertyfilter.h>
 #include <log4cxxNG/filter/stringmatchfilter.h>
+#include <log4cxxNG/filter/multistringmatchfilter.h>
+#include <log4cxxNG/filter/ratelimitfilter.h>
 #include <log4cxxNG/rolling/filterbasedtriggeringpolicy.h>
 #include <log4cxxNG/rolling/fixedwindowrollingpolicy.h>
 #include <log4cxxNG/rolling/manualtriggeringpolicy.h>
@@ -71,6 +77,7 @@
 
 #include <log4cxxNG/xml/domconfigurator.h>
 #include <log4cxxNG/propertyconfigurator.h>
+#include <log4cxxNG/snapshotconfigurator.h>
 #include <apr.h>
 
 
@@ -153,6 +160,25 @@ const Class& Class::forName(const LogString& className)
 	return *clazz;
 }
 
+const Class* Class::findRegistered(const LogString& registeredName)
+{
+	ClassMap& registry = getRegistry();
+	ClassMap::const_iterator iter = registry.find(registeredName);
+
+	if (iter == registry.end() || iter->second == 0)
+	{
+		registerClasses();
+		iter = registry.find(registeredName);
+
+		if (iter == registry.end())
+		{
+			return 0;
+		}
+	}
+
+	return iter->second;
+}
+
 bool Class::registerClass(const Class& newClass)
 {
 	getRegistry()[StringHelper::toLowerCase(newClass.getName())] = &newClass;
@@ -166,6 +192,7 @@ void Class::registerClasses()
 #endif
 	ConsoleAppender::registerClass();
 	FileAppender::registerClass();
+	FlightRecorderAppender::registerClass();
 	log4cxxng::db::ODBCAppender::registerClass();
 #if (defined(WIN32) || defined(_WIN32))
 #if !defined(_WIN32_WCE)
@@ -193,6 +220,11 @@ void Class::registerClasses()
 	LevelMatchFilter::registerClass();
 	LevelRangeFilter::registerClass();
 	StringMatchFilter::registerClass();
+	MultiStringMatchFilter::registerClass();
+	RateLimitFilter::registerClass();
+	ExpressionFilter::registerClass();
+	LocationInfoFilter::registerClass();
+	PropertyFilter::registerClass();
 	log4cxxng::RollingFileAppender::registerClass();
 	log4cxxng::rolling::RollingFileAppender::registerClass();
 	DailyRollingFileAppender::registerClass();
@@ -203,5 +235,6 @@ void Class::registerClasses()
 	log4cxxng::rolling::FilterBasedTriggeringPolicy::registerClass();
 	log4cxxng::xml::DOMConfigurator::registerClass();
 	log4cxxng::PropertyConfigurator::registerClass();
+	log4cxxng::SnapshotConfigurator::registerClass();
 }
 
@@ -56,6 +56,6 @@ void ClassNamePatternConverter::format(
 	Pool& /* p */) const
 {
 	int initialLength = (int)toAppendTo.length();
-	append(toAppendTo, event->getLocationInformation().getClassName());
+	event->getLocationInformation().getClassName(toAppendTo);
 	abbreviate(initialLength, toAppendTo);
 }
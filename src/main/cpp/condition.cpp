@@ -77,3 +77,30 @@ void Condition::await(Mutex& mutex)
 #endif
 }
 
+bool Condition::await(Mutex& mutex, log4cxxng_time_t timeout)
+{
+#if APR_HAS_THREADS
+
+	if (Thread::interrupted())
+	{
+		throw InterruptedException();
+	}
+
+	apr_status_t stat = apr_thread_cond_timedwait(
+			condition,
+			mutex.getAPRMutex(),
+			timeout);
+
+	if (APR_STATUS_IS_TIMEUP(stat))
+	{
+		return false;
+	}
+
+	if (stat != APR_SUCCESS)
+	{
+		throw InterruptedException(stat);
+	}
+
+#endif
+	return true;
+}
@@ -32,7 +32,7 @@ The <code>maxSize</code> argument must a positive integer.
 @param maxSize The maximum number of elements in the buffer.
 */
 CyclicBuffer::CyclicBuffer(int maxSize1)
-	: ea(maxSize1), first(0), last(0), numElems(0), maxSize(maxSize1)
+	: slots(0), maxSize(0), head(0), tail(0)
 {
 	if (maxSize1 < 1)
 	{
@@ -42,10 +42,31 @@ CyclicBuffer::CyclicBuffer(int maxSize1)
 		msg.append(LOG4CXXNG_STR(") is not a positive integer."));
 		throw IllegalArgumentException(msg);
 	}
+
+	init(maxSize1);
 }
 
 CyclicBuffer::~CyclicBuffer()
 {
+	delete [] slots;
+}
+
+void CyclicBuffer::init(int size)
+{
+	delete [] slots;
+	slots = size > 0 ? new Slot[size] : 0;
+	maxSize = size;
+
+	// A slot is free for the writer at position p when its sequence is p
+	// and holds an event for the reader at position p when it is p + 1.
+	for (int i = 0; i < size; i++)
+	{
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+		slots[i].readers.store(0, std::memory_order_relaxed);
+	}
+
+	head.store(0, std::memory_order_relaxed);
+	tail.store(0, std::memory_order_release);
 }
 
 /**
@@ -53,20 +74,37 @@ Add an <code>event</code> as the last event in the buffer.
 */
 void CyclicBuffer::add(const spi::LoggingEventPtr& event)
 {
-	ea[last] = event;
-
-	if (++last == maxSize)
+	if (maxSize == 0)
 	{
-		last = 0;
+		return;
 	}
 
-	if (numElems < maxSize)
-	{
-		numElems++;
-	}
-	else if (++first == maxSize)
+	size_t pos = tail.load(std::memory_order_relaxed);
+
+	while (true)
 	{
-		first = 0;
+		Slot& slot = slots[pos % maxSize];
+		size_t seq = slot.sequence.load(std::memory_order_acquire);
+
+		if (seq == pos)
+		{
+			if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				slot.event = event;
+				slot.sequence.store(pos + 1, std::memory_order_release);
+				return;
+			}
+		}
+		else if ((ptrdiff_t) (seq - pos) < 0)
+		{
+			// Full: make room by dropping the oldest event.
+			get();
+			pos = tail.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			pos = tail.load(std::memory_order_relaxed);
+		}
 	}
 }
 
@@ -78,12 +116,28 @@ currently in the buffer, then <code>null</code> is returned.
 */
 spi::LoggingEventPtr CyclicBuffer::get(int i)
 {
-	if (i < 0 || i >= numElems)
+	if (i < 0 || i >= maxSize)
 	{
 		return 0;
 	}
 
-	return ea[(first + i) % maxSize];
+	size_t pos = head.load() + i;
+	Slot& slot = slots[pos % maxSize];
+	LoggingEventPtr r;
+
+	// Announce the read before checking that the event is still in
+	// place: get() removes it only after it has moved the head past
+	// pos and then seen no reader, so one of the two sides backs off.
+	slot.readers.fetch_add(1);
+
+	if ((ptrdiff_t) (pos - head.load()) >= 0
+		&& slot.sequence.load() == pos + 1)
+	{
+		r = slot.event;
+	}
+
+	slot.readers.fetch_sub(1);
+	return r;
 }
 
 /**
@@ -92,21 +146,56 @@ is removed from the buffer.
 */
 spi::LoggingEventPtr CyclicBuffer::get()
 {
-	LoggingEventPtr r;
+	if (maxSize == 0)
+	{
+		return 0;
+	}
 
-	if (numElems > 0)
+	size_t pos = head.load(std::memory_order_relaxed);
+
+	while (true)
 	{
-		numElems--;
-		r = ea[first];
-		ea[first] = 0;
+		Slot& slot = slots[pos % maxSize];
+		size_t seq = slot.sequence.load(std::memory_order_acquire);
 
-		if (++first == maxSize)
+		if (seq == pos + 1)
+		{
+			if (head.compare_exchange_weak(pos, pos + 1))
+			{
+				// wait for get(int) calls that saw the event in place
+				while (slot.readers.load() != 0)
+				{
+				}
+
+				LoggingEventPtr r(slot.event);
+				slot.event = 0;
+				slot.sequence.store(pos + maxSize, std::memory_order_release);
+				return r;
+			}
+		}
+		else if ((ptrdiff_t) (seq - (pos + 1)) < 0)
 		{
-			first = 0;
+			return 0;
+		}
+		else
+		{
+			pos = head.load(std::memory_order_relaxed);
 		}
 	}
+}
 
-	return r;
+int CyclicBuffer::length() const
+{
+	size_t first = head.load(std::memory_order_acquire);
+	size_t last = tail.load(std::memory_order_acquire);
+	ptrdiff_t len = (ptrdiff_t) (last - first);
+
+	if (len < 0)
+	{
+		return 0;
+	}
+
+	return len > maxSize ? maxSize : (int) len;
 }
 
 /**
@@ -124,38 +213,27 @@ void CyclicBuffer::resize(int newSize)
 		throw IllegalArgumentException(msg);
 	}
 
-	if (newSize == numElems)
+	if (newSize == maxSize)
 	{
 		return;    // nothing to do
 	}
 
-	LoggingEventList temp(newSize);
-
-	int loopLen = newSize < numElems ? newSize : numElems;
-	int i;
+	// Keep the oldest events that fit.
+	LoggingEventList temp;
+	LoggingEventPtr event;
 
-	for (i = 0; i < loopLen; i++)
+	while ((event = get()) != 0)
 	{
-		temp[i] = ea[first];
-		ea[first] = 0;
-
-		if (++first == numElems)
+		if ((int) temp.size() < newSize)
 		{
-			first = 0;
+			temp.push_back(event);
 		}
 	}
 
-	ea = temp;
-	first = 0;
-	numElems = loopLen;
-	maxSize = newSize;
+	init(newSize);
 
-	if (loopLen == newSize)
-	{
-		last = 0;
-	}
-	else
+	for (LoggingEventList::const_iterator it = temp.begin(); it != temp.end(); ++it)
 	{
-		last = loopLen;
+		add(*it);
 	}
 }
@@ -50,6 +50,28 @@ void DefaultConfigurator::configure(LoggerRepository* repository)
 				break;
 			}
 		}
+
+		// A snapshot is the cheapest to load, but only stands in for
+		// the configuration file when it was written after the last edit.
+		File snapshot("log4cxx.snapshot");
+
+		if (snapshot.exists(pool))
+		{
+			if (!configuration.exists(pool)
+				|| snapshot.lastModified(pool) > configuration.lastModified(pool))
+			{
+				configuration = snapshot;
+			}
+			else
+			{
+				LogString msg(LOG4CXXNG_STR("Ignoring configuration snapshot ["));
+				msg += snapshot.getPath();
+				msg += LOG4CXXNG_STR("], it is older than [");
+				msg += configuration.getPath();
+				msg += LOG4CXXNG_STR("].");
+				LogLog::debug(msg);
+			}
+		}
 	}
 	else
 	{
@@ -34,6 +34,7 @@
 #include <log4cxxNG/helpers/filewatchdog.h>
 #include <log4cxxNG/helpers/synchronized.h>
 #include <log4cxxNG/spi/loggerrepository.h>
+#include <log4cxxNG/spi/reconfiguration.h>
 #include <log4cxxNG/spi/loggingevent.h>
 #include <log4cxxNG/helpers/pool.h>
 #include <sstream>
@@ -44,6 +45,7 @@
 #include <log4cxxNG/helpers/bytebuffer.h>
 #include <log4cxxNG/helpers/charsetdecoder.h>
 #include <log4cxxNG/net/smtpappender.h>
+#include <log4cxxNG/filter/multistringmatchfilter.h>
 #include <log4cxxNG/helpers/messagebuffer.h>
 
 #define LOG4CXXNG 1
@@ -116,7 +118,7 @@ IMPLEMENT_LOG4CXXNG_OBJECT(DOMConfigurator)
 #define INTERNAL_DEBUG_ATTR "debug"
 
 DOMConfigurator::DOMConfigurator()
-	: props(), repository()
+	: props(), repository(), reconfiguration(0)
 {
 }
 
@@ -214,13 +216,29 @@ AppenderPtr DOMConfigurator::parseAppender(Pool& p,
 	LogString className(subst(getAttribute(utf8Decoder, appenderElement, CLASS_ATTR)));
 	LogLog::debug(LOG4CXXNG_STR("Class name: [") + className + LOG4CXXNG_STR("]"));
 
+	LogString appenderName(subst(getAttribute(utf8Decoder, appenderElement, NAME_ATTR)));
+	LogString signature;
+
+	if (!appendSignature(utf8Decoder, appenderElement, signature))
+	{
+		signature.clear();
+	}
+
+	AppenderPtr previous(reconfiguration->reuseAppender(appenderName, signature));
+
+	if (previous != 0)
+	{
+		return previous;
+	}
+
 	try
 	{
 		ObjectPtr instance = Loader::loadClass(className).newInstance();
 		AppenderPtr appender = instance;
 		PropertySetter propSetter(appender);
 
-		appender->setName(subst(getAttribute(utf8Decoder, appenderElement, NAME_ATTR)));
+		appender->setName(appenderName);
+		std::vector<log4cxxng::spi::FilterPtr> filters;
 
 		for (apr_xml_elem* currentElement = appenderElement->first_child;
 			currentElement;
@@ -242,15 +260,7 @@ AppenderPtr DOMConfigurator::parseAppender(Pool& p,
 			// Add filters
 			else if (tagName == FILTER_TAG)
 			{
-				std::vector<log4cxxng::spi::FilterPtr> filters;
 				parseFilters(p, utf8Decoder, currentElement, filters);
-
-				for (std::vector<log4cxxng::spi::FilterPtr>::iterator iter = filters.begin();
-					iter != filters.end();
-					iter++)
-				{
-					appender->addFilter(*iter);
-				}
 			}
 			else if (tagName == ERROR_HANDLER_TAG)
 			{
@@ -307,7 +317,20 @@ AppenderPtr DOMConfigurator::parseAppender(Pool& p,
 			}
 		}
 
+		//
+		//   consecutive string match filters are scanned in one pass
+		//
+		log4cxxng::filter::MultiStringMatchFilter::compile(filters);
+
+		for (std::vector<log4cxxng::spi::FilterPtr>::iterator iter = filters.begin();
+			iter != filters.end();
+			iter++)
+		{
+			appender->addFilter(*iter);
+		}
+
 		propSetter.activate(p);
+		reconfiguration->addAppender(appender, signature);
 		return appender;
 	}
 	/* Yes, it's ugly.  But all of these exceptions point to the same
@@ -428,17 +451,16 @@ void DOMConfigurator::parseLogger(
 	LogLog::debug(LOG4CXXNG_STR("Retreiving an instance of Logger."));
 	LoggerPtr logger = repository->getLogger(loggerName, loggerFactory);
 
-	// Setting up a logger needs to be an atomic operation, in order
-	// to protect potential log operations while logger
-	// configuration is in progress.
-	LOCK_W sync(logger->getMutex());
+	// Changes to the logger are staged and published together once the
+	// whole document has been parsed, so logging is not held up while
+	// the configuration is in progress.
 	bool additivity = OptionConverter::toBoolean(
 			subst(getAttribute(utf8Decoder, loggerElement, ADDITIVITY_ATTR)),
 			true);
 
 	LogLog::debug(LOG4CXXNG_STR("Setting [") + logger->getName() + LOG4CXXNG_STR("] additivity to [") +
 		(additivity ? LogString(LOG4CXXNG_STR("true")) : LogString(LOG4CXXNG_STR("false"))) + LOG4CXXNG_STR("]."));
-	logger->setAdditivity(additivity);
+	reconfiguration->setAdditivity(logger, additivity);
 	parseChildrenOfLoggerElement(p, utf8Decoder, loggerElement, logger, false, doc, appenders);
 }
 
@@ -491,8 +513,6 @@ void DOMConfigurator::parseRoot(
 	AppenderMap& appenders)
 {
 	LoggerPtr root = repository->getRootLogger();
-	// logger configuration needs to be atomic
-	LOCK_W sync(root->getMutex());
 	parseChildrenOfLoggerElement(p, utf8Decoder, rootElement, root, true, doc, appenders);
 }
 
@@ -511,7 +531,7 @@ void DOMConfigurator::parseChildrenOfLoggerElement(
 
 	// Remove all existing appenders from logger. They will be
 	// reconstructed if need be.
-	logger->removeAllAppenders();
+	reconfiguration->removeAllAppenders(logger);
 
 
 	for (apr_xml_elem* currentElement = loggerElement->first_child;
@@ -529,6 +549,7 @@ void DOMConfigurator::parseChildrenOfLoggerElement(
 			{
 				LogLog::debug(LOG4CXXNG_STR("Adding appender named [") + refName +
 					LOG4CXXNG_STR("] to logger [") + logger->getName() + LOG4CXXNG_STR("]."));
+				reconfiguration->addLoggerAppender(logger, appender);
 			}
 			else
 			{
@@ -536,8 +557,6 @@ void DOMConfigurator::parseChildrenOfLoggerElement(
 					LOG4CXXNG_STR("] not found."));
 			}
 
-			logger->addAppender(appender);
-
 		}
 		else if (tagName == LEVEL_TAG)
 		{
@@ -720,7 +739,7 @@ void DOMConfigurator::parseLevel(
 		}
 		else
 		{
-			logger->setLevel(0);
+			reconfiguration->setLevel(logger, 0);
 		}
 	}
 	else
@@ -729,7 +748,7 @@ void DOMConfigurator::parseLevel(
 
 		if (className.empty())
 		{
-			logger->setLevel(OptionConverter::toLevel(levelStr, Level::getDebug()));
+			reconfiguration->setLevel(logger, OptionConverter::toLevel(levelStr, Level::getDebug()));
 		}
 		else
 		{
@@ -740,7 +759,7 @@ void DOMConfigurator::parseLevel(
 				Level::LevelClass& levelClass =
 					(Level::LevelClass&)Loader::loadClass(className);
 				LevelPtr level = levelClass.toLevel(levelStr);
-				logger->setLevel(level);
+				reconfiguration->setLevel(logger, level);
 			}
 			catch (Exception& oops)
 			{
@@ -761,8 +780,7 @@ void DOMConfigurator::parseLevel(
 		}
 	}
 
-	LogLog::debug(loggerName + LOG4CXXNG_STR(" level set to ") +
-		logger->getEffectiveLevel()->toString());
+	LogLog::debug(loggerName + LOG4CXXNG_STR(" level set to ") + levelStr);
 }
 
 void DOMConfigurator::setParameter(log4cxxng::helpers::Pool& p,
@@ -829,7 +847,24 @@ void DOMConfigurator::doConfigure(const File& filename, spi::LoggerRepositoryPtr
 		{
 			AppenderMap appenders;
 			CharsetDecoderPtr utf8Decoder(CharsetDecoder::getUTF8Decoder());
-			parse(p, utf8Decoder, doc->root, doc, appenders);
+
+			// Loggers and appenders are staged off to the side and
+			// published in one step once the document has been parsed.
+			Reconfiguration staged(repository);
+			reconfiguration = &staged;
+
+			try
+			{
+				parse(p, utf8Decoder, doc->root, doc, appenders);
+			}
+			catch (...)
+			{
+				reconfiguration = 0;
+				throw;
+			}
+
+			reconfiguration = 0;
+			staged.commit();
 		}
 	}
 }
@@ -1089,6 +1124,52 @@ LogString DOMConfigurator::subst(const LogString& value)
 }
 
 
+bool DOMConfigurator::appendSignature(
+	log4cxxng::helpers::CharsetDecoderPtr& utf8Decoder,
+	apr_xml_elem* element,
+	LogString& signature)
+{
+	std::string tagName(element->name);
+
+	if (tagName == APPENDER_REF_TAG)
+	{
+		return false;
+	}
+
+	LOG4CXXNG_DECODE_CHAR(ltagName, tagName);
+	signature.append(1, (logchar) 0x3C /* '<' */);
+	signature.append(ltagName);
+
+	for (apr_xml_attr* attr = element->attr;
+		attr;
+		attr = attr->next)
+	{
+		LOG4CXXNG_DECODE_CHAR(lattrName, std::string(attr->name));
+		LogString attrValue;
+		ByteBuffer buf((char*) attr->value, strlen(attr->value));
+		utf8Decoder->decode(buf, attrValue);
+		signature.append(1, (logchar) 0x20 /* ' ' */);
+		signature.append(lattrName);
+		signature.append(1, (logchar) 0x3D /* '=' */);
+		signature.append(subst(attrValue));
+	}
+
+	signature.append(1, (logchar) 0x3E /* '>' */);
+
+	for (apr_xml_elem* child = element->first_child;
+		child;
+		child = child->next)
+	{
+		if (!appendSignature(utf8Decoder, child, signature))
+		{
+			return false;
+		}
+	}
+
+	signature.append(1, (logchar) 0x2F /* '/' */);
+	return true;
+}
+
 LogString DOMConfigurator::getAttribute(
 	log4cxxng::helpers::CharsetDecoderPtr& utf8Decoder,
 	apr_xml_elem* element,
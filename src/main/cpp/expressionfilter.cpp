@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/filter/expressionfilter.h>
+#include <log4cxxNG/rule/expressionrule.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/exception.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::rule;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(ExpressionFilter)
+
+
+ExpressionFilter::ExpressionFilter()
+	: acceptOnMatch(true), convertInFixToPostFix(true), expression(), expressionRule()
+{
+}
+
+void ExpressionFilter::activateOptions(Pool&)
+{
+	try
+	{
+		expressionRule = ExpressionRule::getRule(expression, !convertInFixToPostFix);
+	}
+	catch (IllegalArgumentException& e)
+	{
+		expressionRule = 0;
+		LogLog::error(LOG4CXXNG_STR("Invalid expression [") + expression + LOG4CXXNG_STR("]."), e);
+	}
+}
+
+void ExpressionFilter::setOption(const LogString& option,
+	const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("EXPRESSION"), LOG4CXXNG_STR("expression")))
+	{
+		setExpression(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("CONVERTINFIXTOPOSTFIX"), LOG4CXXNG_STR("convertinfixtopostfix")))
+	{
+		setConvertInFixToPostFix(OptionConverter::toBoolean(value, convertInFixToPostFix));
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("ACCEPTONMATCH"), LOG4CXXNG_STR("acceptonmatch")))
+	{
+		setAcceptOnMatch(OptionConverter::toBoolean(value, acceptOnMatch));
+	}
+}
+
+void ExpressionFilter::setExpression(const LogString& exp)
+{
+	this->expression = exp;
+}
+
+LogString ExpressionFilter::getExpression() const
+{
+	return expression;
+}
+
+void ExpressionFilter::setConvertInFixToPostFix(bool newValue)
+{
+	this->convertInFixToPostFix = newValue;
+}
+
+bool ExpressionFilter::getConvertInFixToPostFix() const
+{
+	return convertInFixToPostFix;
+}
+
+void ExpressionFilter::setAcceptOnMatch(bool newValue)
+{
+	this->acceptOnMatch = newValue;
+}
+
+bool ExpressionFilter::getAcceptOnMatch() const
+{
+	return acceptOnMatch;
+}
+
+Filter::FilterDecision ExpressionFilter::decide(
+	const LoggingEventPtr& event) const
+{
+	if (expressionRule != 0 && expressionRule->evaluate(event))
+	{
+		return acceptOnMatch ? Filter::ACCEPT : Filter::DENY;
+	}
+
+	return Filter::NEUTRAL;
+}
@@ -0,0 +1,717 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/rule/expressionrule.h>
+#include <log4cxxNG/helpers/exception.h>
+#include <log4cxxNG/level.h>
+#include <log4cxxNG/spi/loggingevent.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::rule;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(Rule)
+IMPLEMENT_LOG4CXXNG_OBJECT(ExpressionRule)
+
+namespace
+{
+enum Opcode
+{
+	EQUALS,
+	NOT_EQUALS,
+	CONTAINS,
+	LESS,
+	LESS_EQUAL,
+	GREATER,
+	GREATER_EQUAL,
+	EXISTS,
+	NOT,
+	JUMP_IF_FALSE,
+	JUMP_IF_TRUE
+};
+
+enum Field
+{
+	NO_FIELD,
+	LEVEL,
+	LOGGER,
+	MESSAGE,
+	THREAD,
+	MDC_ENTRY,
+	PROPERTY
+};
+
+logchar toLowerASCII(logchar c)
+{
+	return (c >= 0x41 && c <= 0x5A) ? (logchar) (c + 0x20) : c;
+}
+
+LogString toUpperASCII(const LogString& s)
+{
+	LogString upper(s);
+
+	for (LogString::iterator iter = upper.begin(); iter != upper.end(); iter++)
+	{
+		if (*iter >= 0x61 && *iter <= 0x7A)
+		{
+			*iter = (logchar) (*iter - 0x20);
+		}
+	}
+
+	return upper;
+}
+
+/**
+True if <code>s</code> contains <code>lowerNeedle</code>, which is
+already lower case, ignoring ASCII case.
+*/
+bool containsIgnoreCase(const LogString& s, const LogString& lowerNeedle)
+{
+	if (lowerNeedle.size() > s.size())
+	{
+		return false;
+	}
+
+	size_t last = s.size() - lowerNeedle.size();
+
+	for (size_t start = 0; start <= last; start++)
+	{
+		size_t i = 0;
+
+		while (i < lowerNeedle.size() && toLowerASCII(s[start + i]) == lowerNeedle[i])
+		{
+			i++;
+		}
+
+		if (i == lowerNeedle.size())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const LogString* fieldValue(int field, const LogString& key, const LoggingEventPtr& event)
+{
+	switch (field)
+	{
+		case LOGGER:
+			return &event->getLoggerName();
+
+		case MESSAGE:
+			return &event->getMessage();
+
+		case THREAD:
+			return &event->getThreadName();
+
+		case MDC_ENTRY:
+			return event->findMDC(key);
+
+		case PROPERTY:
+		{
+			const LogString* value = event->findProperty(key);
+			return value != 0 ? value : event->findMDC(key);
+		}
+
+		default:
+			return 0;
+	}
+}
+}
+
+namespace log4cxxng
+{
+namespace rule
+{
+/**
+Turns an expression into the instructions of an ExpressionRule,
+by way of a postfix token list and an expression tree.
+*/
+class ExpressionCompiler
+{
+	public:
+		ExpressionCompiler(ExpressionRule& rule1) : rule(rule1)
+		{
+		}
+
+		void compile(const LogString& expression, bool isPostFix)
+		{
+			std::vector<Token> tokens;
+			tokenize(expression, tokens);
+
+			if (tokens.empty())
+			{
+				return;
+			}
+
+			if (!isPostFix)
+			{
+				std::vector<Token> postfix;
+				toPostFix(tokens, postfix);
+				tokens.swap(postfix);
+			}
+
+			emit(buildTree(tokens));
+		}
+
+	private:
+		enum TokenType
+		{
+			OPERAND,
+			OPEN,
+			CLOSE,
+			OR,
+			AND,
+			NEGATE,
+			RELATION,
+			POSTFIX_EXISTS
+		};
+
+		struct Token
+		{
+			TokenType type;
+			LogString text;
+			int opcode;
+		};
+
+		struct Node
+		{
+			TokenType type;
+			const Token* token;
+			int left;
+			int right;
+		};
+
+		ExpressionRule& rule;
+		std::vector<Node> nodes;
+
+		static void error(const LogString& msg, const LogString& expression)
+		{
+			throw IllegalArgumentException(msg + LOG4CXXNG_STR(" in expression [") + expression + LOG4CXXNG_STR("]"));
+		}
+
+		static Token classify(const LogString& text, bool quoted)
+		{
+			Token token;
+			token.type = OPERAND;
+			token.text = text;
+			token.opcode = -1;
+
+			if (quoted)
+			{
+				return token;
+			}
+
+			static const struct
+			{
+				const logchar* text;
+				TokenType type;
+				int opcode;
+			} operators[] =
+			{
+				{ LOG4CXXNG_STR("||"), OR, -1 },
+				{ LOG4CXXNG_STR("&&"), AND, -1 },
+				{ LOG4CXXNG_STR("!"), NEGATE, NOT },
+				{ LOG4CXXNG_STR("=="), RELATION, EQUALS },
+				{ LOG4CXXNG_STR("!="), RELATION, NOT_EQUALS },
+				{ LOG4CXXNG_STR("~="), RELATION, CONTAINS },
+				{ LOG4CXXNG_STR("<"), RELATION, LESS },
+				{ LOG4CXXNG_STR("<="), RELATION, LESS_EQUAL },
+				{ LOG4CXXNG_STR(">"), RELATION, GREATER },
+				{ LOG4CXXNG_STR(">="), RELATION, GREATER_EQUAL },
+				{ LOG4CXXNG_STR("EXISTS"), POSTFIX_EXISTS, EXISTS }
+			};
+			LogString upper(toUpperASCII(text));
+
+			for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++)
+			{
+				if (upper == operators[i].text)
+				{
+					token.type = operators[i].type;
+					token.opcode = operators[i].opcode;
+					break;
+				}
+			}
+
+			return token;
+		}
+
+		static void tokenize(const LogString& expression, std::vector<Token>& tokens)
+		{
+			LogString::const_iterator iter = expression.begin();
+
+			while (iter != expression.end())
+			{
+				logchar c = *iter;
+
+				if (c == 0x20 || c == 0x09 || c == 0x0A || c == 0x0D)
+				{
+					iter++;
+				}
+				else if (c == 0x28 /* '(' */ || c == 0x29 /* ')' */)
+				{
+					Token token;
+					token.type = (c == 0x28) ? OPEN : CLOSE;
+					token.opcode = -1;
+					token.text.assign(1, c);
+					tokens.push_back(token);
+					iter++;
+				}
+				else if (c == 0x27 /* '\'' */)
+				{
+					LogString::const_iterator end = iter + 1;
+
+					while (end != expression.end() && *end != 0x27)
+					{
+						end++;
+					}
+
+					if (end == expression.end())
+					{
+						error(LOG4CXXNG_STR("Unterminated quote"), expression);
+					}
+
+					tokens.push_back(classify(LogString(iter + 1, end), true));
+					iter = end + 1;
+				}
+				else
+				{
+					LogString::const_iterator end = iter;
+
+					while (end != expression.end() && *end != 0x20 && *end != 0x09
+						&& *end != 0x0A && *end != 0x0D && *end != 0x28 && *end != 0x29)
+					{
+						end++;
+					}
+
+					tokens.push_back(classify(LogString(iter, end), false));
+					iter = end;
+				}
+			}
+		}
+
+		static int precedence(TokenType type)
+		{
+			switch (type)
+			{
+				case OR:
+					return 1;
+
+				case AND:
+					return 2;
+
+				case NEGATE:
+					return 3;
+
+				case RELATION:
+					return 4;
+
+				default:
+					return 0;
+			}
+		}
+
+		static void toPostFix(const std::vector<Token>& infix, std::vector<Token>& postfix)
+		{
+			std::vector<const Token*> operators;
+
+			for (std::vector<Token>::const_iterator iter = infix.begin(); iter != infix.end(); iter++)
+			{
+				switch (iter->type)
+				{
+					case OPERAND:
+					case POSTFIX_EXISTS:
+						postfix.push_back(*iter);
+						break;
+
+					case OPEN:
+					case NEGATE:
+						operators.push_back(&*iter);
+						break;
+
+					case CLOSE:
+						while (!operators.empty() && operators.back()->type != OPEN)
+						{
+							postfix.push_back(*operators.back());
+							operators.pop_back();
+						}
+
+						if (operators.empty())
+						{
+							throw IllegalArgumentException(LOG4CXXNG_STR("Unbalanced parentheses in expression"));
+						}
+
+						operators.pop_back();
+						break;
+
+					default:
+						while (!operators.empty() && operators.back()->type != OPEN
+							&& precedence(operators.back()->type) >= precedence(iter->type))
+						{
+							postfix.push_back(*operators.back());
+							operators.pop_back();
+						}
+
+						operators.push_back(&*iter);
+				}
+			}
+
+			while (!operators.empty())
+			{
+				if (operators.back()->type == OPEN)
+				{
+					throw IllegalArgumentException(LOG4CXXNG_STR("Unbalanced parentheses in expression"));
+				}
+
+				postfix.push_back(*operators.back());
+				operators.pop_back();
+			}
+		}
+
+		/**
+		Resolves a field name, storing the MDC or property key.
+		*/
+		int resolveField(const LogString& name, int& key)
+		{
+			static const LogString MDC_PREFIX(LOG4CXXNG_STR("MDC."));
+			static const LogString PROP_PREFIX(LOG4CXXNG_STR("PROP."));
+			LogString upper(toUpperASCII(name));
+			key = -1;
+
+			if (upper == LOG4CXXNG_STR("LEVEL"))
+			{
+				return LEVEL;
+			}
+
+			if (upper == LOG4CXXNG_STR("LOGGER"))
+			{
+				return LOGGER;
+			}
+
+			if (upper == LOG4CXXNG_STR("MSG") || upper == LOG4CXXNG_STR("MESSAGE"))
+			{
+				return MESSAGE;
+			}
+
+			if (upper == LOG4CXXNG_STR("THREAD"))
+			{
+				return THREAD;
+			}
+
+			if (upper.size() > MDC_PREFIX.size() && upper.compare(0, MDC_PREFIX.size(), MDC_PREFIX) == 0)
+			{
+				key = addConstant(name.substr(MDC_PREFIX.size()));
+				return MDC_ENTRY;
+			}
+
+			if (upper.size() > PROP_PREFIX.size() && upper.compare(0, PROP_PREFIX.size(), PROP_PREFIX) == 0)
+			{
+				key = addConstant(name.substr(PROP_PREFIX.size()));
+				return PROPERTY;
+			}
+
+			return NO_FIELD;
+		}
+
+		int addConstant(const LogString& value)
+		{
+			rule.constants.push_back(value);
+			return (int) rule.constants.size() - 1;
+		}
+
+		int addNode(TokenType type, const Token* token, int left, int right)
+		{
+			Node node = { type, token, left, right };
+			nodes.push_back(node);
+			return (int) nodes.size() - 1;
+		}
+
+		int pop(std::vector<int>& stack, bool wantOperand, const Token& op)
+		{
+			if (stack.empty())
+			{
+				throw IllegalArgumentException(LOG4CXXNG_STR("Missing operand for [") + op.text + LOG4CXXNG_STR("]"));
+			}
+
+			int index = stack.back();
+			stack.pop_back();
+
+			if ((nodes[index].type == OPERAND) != wantOperand)
+			{
+				throw IllegalArgumentException((wantOperand ? LOG4CXXNG_STR("Expected a field or value for [")
+						: LOG4CXXNG_STR("Expected a condition for [")) + op.text + LOG4CXXNG_STR("]"));
+			}
+
+			return index;
+		}
+
+		int buildTree(const std::vector<Token>& postfix)
+		{
+			std::vector<int> stack;
+
+			for (std::vector<Token>::const_iterator iter = postfix.begin(); iter != postfix.end(); iter++)
+			{
+				switch (iter->type)
+				{
+					case OPERAND:
+						stack.push_back(addNode(OPERAND, &*iter, -1, -1));
+						break;
+
+					case POSTFIX_EXISTS:
+						stack.push_back(addNode(RELATION, &*iter, pop(stack, true, *iter), -1));
+						break;
+
+					case RELATION:
+					{
+						int right = pop(stack, true, *iter);
+						int left = pop(stack, true, *iter);
+						stack.push_back(addNode(RELATION, &*iter, left, right));
+						break;
+					}
+
+					case NEGATE:
+						stack.push_back(addNode(NEGATE, &*iter, pop(stack, false, *iter), -1));
+						break;
+
+					case OR:
+					case AND:
+					{
+						int right = pop(stack, false, *iter);
+						int left = pop(stack, false, *iter);
+						stack.push_back(addNode(iter->type, &*iter, left, right));
+						break;
+					}
+
+					default:
+						throw IllegalArgumentException(LOG4CXXNG_STR("Unexpected [") + iter->text + LOG4CXXNG_STR("]"));
+				}
+			}
+
+			if (stack.size() != 1 || nodes[stack.back()].type == OPERAND)
+			{
+				throw IllegalArgumentException(LOG4CXXNG_STR("Expression does not reduce to a single condition"));
+			}
+
+			return stack.back();
+		}
+
+		void emitPredicate(const Node& node)
+		{
+			ExpressionRule::Instruction instruction;
+			instruction.opcode = (unsigned char) node.token->opcode;
+			instruction.operand = -1;
+			const Token& fieldToken = *nodes[node.left].token;
+			int field = resolveField(fieldToken.text, instruction.key);
+
+			if (field == NO_FIELD)
+			{
+				throw IllegalArgumentException(LOG4CXXNG_STR("Unknown field [") + fieldToken.text + LOG4CXXNG_STR("]"));
+			}
+
+			instruction.field = (unsigned char) field;
+
+			if (instruction.opcode != EXISTS)
+			{
+				const LogString& value = nodes[node.right].token->text;
+
+				if (field == LEVEL)
+				{
+					LevelPtr level(Level::toLevelLS(value, LevelPtr()));
+
+					if (level == 0 || instruction.opcode == CONTAINS)
+					{
+						throw IllegalArgumentException(LOG4CXXNG_STR("Can not compare LEVEL with [") + value + LOG4CXXNG_STR("]"));
+					}
+
+					instruction.operand = level->toInt();
+				}
+				else if (instruction.opcode == CONTAINS)
+				{
+					LogString lower(value);
+
+					for (LogString::iterator iter = lower.begin(); iter != lower.end(); iter++)
+					{
+						*iter = toLowerASCII(*iter);
+					}
+
+					instruction.operand = addConstant(lower);
+				}
+				else if (instruction.opcode == EQUALS || instruction.opcode == NOT_EQUALS)
+				{
+					instruction.operand = addConstant(value);
+				}
+				else
+				{
+					throw IllegalArgumentException(LOG4CXXNG_STR("Only LEVEL may be used with [") + node.token->text + LOG4CXXNG_STR("]"));
+				}
+			}
+
+			rule.code.push_back(instruction);
+		}
+
+		void emitSimple(int opcode, int operand)
+		{
+			ExpressionRule::Instruction instruction;
+			instruction.opcode = (unsigned char) opcode;
+			instruction.field = NO_FIELD;
+			instruction.operand = operand;
+			instruction.key = -1;
+			rule.code.push_back(instruction);
+		}
+
+		void emit(int index)
+		{
+			const Node node = nodes[index];
+
+			switch (node.type)
+			{
+				case RELATION:
+					emitPredicate(node);
+					break;
+
+				case NEGATE:
+					emit(node.left);
+					emitSimple(NOT, -1);
+					break;
+
+				default:
+				{
+					// Leave the left result in the register when it
+					// decides the outcome, otherwise evaluate the right.
+					emit(node.left);
+					size_t jump = rule.code.size();
+					emitSimple(node.type == AND ? JUMP_IF_FALSE : JUMP_IF_TRUE, -1);
+					emit(node.right);
+					rule.code[jump].operand = (int) rule.code.size();
+				}
+			}
+		}
+};
+}
+}
+
+
+ExpressionRule::ExpressionRule()
+{
+}
+
+RulePtr ExpressionRule::getRule(const LogString& expression, bool isPostFix)
+{
+	ExpressionRulePtr rule(new ExpressionRule());
+	ExpressionCompiler compiler(*rule);
+	compiler.compile(expression, isPostFix);
+	return rule;
+}
+
+bool ExpressionRule::evaluate(const LoggingEventPtr& event) const
+{
+	bool result = true;
+	const size_t end = code.size();
+	size_t pc = 0;
+
+	while (pc < end)
+	{
+		const Instruction& instruction = code[pc++];
+
+		switch (instruction.opcode)
+		{
+			case JUMP_IF_FALSE:
+				if (!result)
+				{
+					pc = instruction.operand;
+				}
+
+				continue;
+
+			case JUMP_IF_TRUE:
+				if (result)
+				{
+					pc = instruction.operand;
+				}
+
+				continue;
+
+			case NOT:
+				result = !result;
+				continue;
+		}
+
+		if (instruction.field == LEVEL)
+		{
+			int level = event->getLevel()->toInt();
+
+			switch (instruction.opcode)
+			{
+				case EQUALS:
+					result = level == instruction.operand;
+					break;
+
+				case NOT_EQUALS:
+					result = level != instruction.operand;
+					break;
+
+				case LESS:
+					result = level < instruction.operand;
+					break;
+
+				case LESS_EQUAL:
+					result = level <= instruction.operand;
+					break;
+
+				case GREATER:
+					result = level > instruction.operand;
+					break;
+
+				case GREATER_EQUAL:
+					result = level >= instruction.operand;
+					break;
+
+				default:
+					result = true;
+			}
+
+			continue;
+		}
+
+		static const LogString noKey;
+		const LogString* value = fieldValue(instruction.field,
+				instruction.key >= 0 ? constants[instruction.key] : noKey, event);
+
+		switch (instruction.opcode)
+		{
+			case EQUALS:
+				result = value != 0 && *value == constants[instruction.operand];
+				break;
+
+			case NOT_EQUALS:
+				result = value == 0 || *value != constants[instruction.operand];
+				break;
+
+			case CONTAINS:
+				result = value != 0 && containsIgnoreCase(*value, constants[instruction.operand]);
+				break;
+
+			default:
+				result = value != 0 && !value->empty();
+		}
+	}
+
+	return result;
+}
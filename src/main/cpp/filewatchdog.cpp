@@ -24,22 +24,49 @@
 #include <log4cxxNG/helpers/transcoder.h>
 #include <log4cxxNG/helpers/exception.h>
 
+#if defined(__linux__)
+	#define LOG4CXXNG_HAS_INOTIFY 1
+	#include <sys/inotify.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+	#include <errno.h>
+#else
+	#define LOG4CXXNG_HAS_INOTIFY 0
+#endif
+
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
 long FileWatchdog::DEFAULT_DELAY = 60000;
+long FileWatchdog::DEFAULT_DEBOUNCE = 200;
 
 #if APR_HAS_THREADS
 
 FileWatchdog::FileWatchdog(const File& file1)
-	: file(file1), delay(DEFAULT_DELAY), lastModif(0),
-	  warnedAlready(false), interrupted(0), thread()
+	: file(file1), delay(DEFAULT_DELAY), debounce(DEFAULT_DEBOUNCE), lastModif(0),
+	  warnedAlready(false), interrupted(0), thread(), notifyFd(-1)
 {
+	wakeFd[0] = -1;
+	wakeFd[1] = -1;
 }
 
 FileWatchdog::~FileWatchdog()
 {
 	apr_atomic_set32(&interrupted, 0xFFFF);
+#if LOG4CXXNG_HAS_INOTIFY
+
+	if (wakeFd[1] >= 0)
+	{
+		char wake = 0;
+
+		if (write(wakeFd[1], &wake, 1) < 0)
+		{
+			LogLog::debug(LOG4CXXNG_STR("Unable to wake file watchdog"));
+		}
+	}
+
+#endif
 
 	try
 	{
@@ -49,6 +76,8 @@ FileWatchdog::~FileWatchdog()
 	catch (Exception&)
 	{
 	}
+
+	closeNotifier();
 }
 
 void FileWatchdog::checkAndConfigure()
@@ -82,6 +111,14 @@ void* APR_THREAD_FUNC FileWatchdog::run(apr_thread_t* /* thread */, void* data)
 {
 	FileWatchdog* pThis = (FileWatchdog*) data;
 
+	//
+	//   falls back to polling if notifications fail
+	//
+	if (pThis->notifyFd >= 0)
+	{
+		pThis->watchNotifications();
+	}
+
 	unsigned int interrupted = apr_atomic_read32(&pThis->interrupted);
 
 	while (!interrupted)
@@ -104,7 +141,172 @@ void FileWatchdog::start()
 {
 	checkAndConfigure();
 
+	if (!openNotifier())
+	{
+		closeNotifier();
+	}
+
 	thread.run(run, this);
 }
 
+bool FileWatchdog::openNotifier()
+{
+#if LOG4CXXNG_HAS_INOTIFY
+	Pool p;
+	LogString parent(file.getParent(p));
+
+	if (parent.empty())
+	{
+		parent = LOG4CXXNG_STR(".");
+	}
+
+	LOG4CXXNG_ENCODE_CHAR(directory, parent);
+	notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (notifyFd < 0)
+	{
+		return false;
+	}
+
+	//
+	//   watch the directory rather than the file so that a
+	//   file renamed over the original is noticed
+	//
+	if (inotify_add_watch(notifyFd, directory.c_str(),
+			IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE) < 0)
+	{
+		LogLog::debug(((LogString) LOG4CXXNG_STR("Unable to watch ["))
+			+ parent + LOG4CXXNG_STR("], polling for changes."));
+		return false;
+	}
+
+	return pipe2(wakeFd, O_NONBLOCK | O_CLOEXEC) == 0;
+#else
+	return false;
+#endif
+}
+
+void FileWatchdog::closeNotifier()
+{
+#if LOG4CXXNG_HAS_INOTIFY
+
+	if (notifyFd >= 0)
+	{
+		close(notifyFd);
+		notifyFd = -1;
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (wakeFd[i] >= 0)
+		{
+			close(wakeFd[i]);
+			wakeFd[i] = -1;
+		}
+	}
+
+#endif
+}
+
+void FileWatchdog::watchNotifications()
+{
+#if LOG4CXXNG_HAS_INOTIFY
+	LOG4CXXNG_ENCODE_CHAR(name, file.getName());
+	struct pollfd fds[2];
+	fds[0].fd = notifyFd;
+	fds[0].events = POLLIN;
+	fds[1].fd = wakeFd[0];
+	fds[1].events = POLLIN;
+	bool pending = false;
+	apr_time_t settled = 0;
+	apr_time_t nextCheck = apr_time_now() + apr_time_from_msec(delay);
+
+	while (!apr_atomic_read32(&interrupted))
+	{
+		//
+		//   wait for the end of the quiet period after a relevant
+		//   change, and never beyond the next periodic check
+		//
+		apr_time_t now = apr_time_now();
+		apr_time_t deadline = pending && settled < nextCheck ? settled : nextCheck;
+		apr_time_t timeout = deadline > now ? apr_time_as_msec(deadline - now + 999) : 0;
+		fds[0].revents = 0;
+		fds[1].revents = 0;
+		int ready = poll(fds, 2, timeout > 0x7FFFFFFF ? 0x7FFFFFFF : (int) timeout);
+
+		if (ready < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			break;
+		}
+
+		if (fds[1].revents != 0)
+		{
+			break;
+		}
+
+		now = apr_time_now();
+
+		if (ready > 0 && readNotifications(name))
+		{
+			//
+			//   restart the quiet period on every relevant change,
+			//      changes to other files in the directory are ignored
+			//
+			pending = true;
+			settled = now + apr_time_from_msec(debounce);
+			continue;
+		}
+
+		if (pending && now >= settled)
+		{
+			//
+			//   a notified change is applied even when the
+			//   replacement carries an older modification time
+			//
+			pending = false;
+			lastModif = 0;
+		}
+		else if (now < nextCheck)
+		{
+			continue;
+		}
+
+		checkAndConfigure();
+		nextCheck = now + apr_time_from_msec(delay);
+	}
+
+#endif
+}
+
+bool FileWatchdog::readNotifications(const std::string& name)
+{
+	bool relevant = false;
+#if LOG4CXXNG_HAS_INOTIFY
+	alignas(struct inotify_event) char buf[4096];
+	ssize_t len;
+
+	while ((len = read(notifyFd, buf, sizeof(buf))) > 0)
+	{
+		for (char* p = buf; p < buf + len;)
+		{
+			const struct inotify_event* event = (const struct inotify_event*) p;
+
+			if (event->len > 0 && name == event->name)
+			{
+				relevant = true;
+			}
+
+			p += sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+#endif
+	return relevant;
+}
+
 #endif
@@ -17,11 +17,17 @@
 
 #include <log4cxxNG/logstring.h>
 #include <log4cxxNG/spi/filter.h>
+#include <atomic>
 
 using namespace log4cxxng;
 using namespace log4cxxng::spi;
 using namespace log4cxxng::helpers;
 
+namespace
+{
+std::atomic<unsigned int> revision(0);
+}
+
 Filter::Filter() : next()
 {
 }
@@ -44,6 +50,17 @@ FilterPtr Filter::getNext() const
 void Filter::setNext(const FilterPtr& newNext)
 {
 	next = newNext;
+	changed();
+}
+
+unsigned int Filter::getRevision()
+{
+	return revision.load(std::memory_order_acquire);
+}
+
+void Filter::changed()
+{
+	revision.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void Filter::activateOptions(Pool&)
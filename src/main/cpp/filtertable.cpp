@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/spi/filtertable.h>
+#include <log4cxxNG/filter/denyallfilter.h>
+#include <log4cxxNG/filter/levelmatchfilter.h>
+#include <log4cxxNG/filter/levelrangefilter.h>
+#include <log4cxxNG/filter/loggermatchfilter.h>
+#include <log4cxxNG/spi/location/locationinfo.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/level.h>
+#include <algorithm>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+namespace
+{
+/**
+Runs the chain on one event per standard level of logger
+<code>name</code> and returns the levels that get through.
+*/
+unsigned char decisions(const FilterPtr& head, const LogString& name)
+{
+	const LevelPtr levels[] =
+	{
+		Level::getAll(), Level::getTrace(), Level::getDebug(), Level::getInfo(),
+		Level::getWarn(), Level::getError(), Level::getFatal(), Level::getOff()
+	};
+	unsigned char mask = 0;
+
+	for (int i = 0; i < 8; i++)
+	{
+		LoggingEventPtr event(new LoggingEvent(name, levels[i], LogString(),
+				LocationInfo::getLocationUnavailable()));
+		bool append = true;
+
+		for (FilterPtr f = head; f != 0; f = f->getNext())
+		{
+			Filter::FilterDecision decision = f->decide(event);
+
+			if (decision != Filter::NEUTRAL)
+			{
+				append = decision == Filter::ACCEPT;
+				break;
+			}
+		}
+
+		if (append)
+		{
+			mask |= (unsigned char) (1 << i);
+		}
+	}
+
+	return mask;
+}
+}
+
+FilterTable::FilterTable()
+	: compiled(false), recognized(false), revision(0), otherNames(0)
+{
+}
+
+void FilterTable::compile(const FilterPtr& head)
+{
+	// Read first, so that a change made while compiling leaves the
+	// table stale rather than wrong.
+	revision = Filter::getRevision();
+	compiled = true;
+	recognized = false;
+	byNameId.clear();
+	otherNames = 0;
+	std::vector<LogString> names;
+
+	for (FilterPtr f = head; f != 0; f = f->getNext())
+	{
+		const Class& clazz = f->getClass();
+
+		if (&clazz == &LoggerMatchFilter::getStaticClass())
+		{
+			LoggerMatchFilterPtr match(f);
+			names.push_back(match->getLoggerToMatch());
+		}
+		else if (&clazz != &LevelMatchFilter::getStaticClass()
+			&& &clazz != &LevelRangeFilter::getStaticClass()
+			&& &clazz != &DenyAllFilter::getStaticClass())
+		{
+			return;
+		}
+	}
+
+	// Any name the chain does not mention stands for all the others.
+	LogString other;
+
+	while (std::find(names.begin(), names.end(), other) != names.end())
+	{
+		other.append(1, LOG4CXXNG_STR('.'));
+	}
+
+	otherNames = decisions(head, other);
+
+	for (std::vector<LogString>::const_iterator iter = names.begin();
+		iter != names.end(); iter++)
+	{
+		unsigned int id = Logger::internName(*iter);
+
+		if (id >= byNameId.size())
+		{
+			byNameId.resize(id + 1, otherNames);
+		}
+
+		byNameId[id] = decisions(head, *iter);
+	}
+
+	recognized = true;
+}
+
+bool FilterTable::isCurrent() const
+{
+	return compiled && revision == Filter::getRevision();
+}
+
+FilterTable::Decision FilterTable::decide(const LoggingEventPtr& event) const
+{
+	if (!recognized || revision != Filter::getRevision())
+	{
+		return CONSULT_CHAIN;
+	}
+
+	const LoggerPtr& logger = event->getLogger();
+	int index = levelIndex(event->getLevel()->toInt());
+
+	if (logger == 0 || index < 0)
+	{
+		return CONSULT_CHAIN;
+	}
+
+	unsigned int id = logger->getNameId();
+	unsigned char mask = id < byNameId.size() ? byNameId[id] : otherNames;
+	return (mask & (1 << index)) ? APPEND : DROP;
+}
+
+int FilterTable::levelIndex(int level)
+{
+	switch (level)
+	{
+		case Level::ALL_INT:
+			return 0;
+
+		case Level::TRACE_INT:
+			return 1;
+
+		case Level::DEBUG_INT:
+			return 2;
+
+		case Level::INFO_INT:
+			return 3;
+
+		case Level::WARN_INT:
+			return 4;
+
+		case Level::ERROR_INT:
+			return 5;
+
+		case Level::FATAL_INT:
+			return 6;
+
+		case Level::OFF_INT:
+			return 7;
+
+		default:
+			return -1;
+	}
+}
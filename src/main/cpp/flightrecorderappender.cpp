@@ -0,0 +1,890 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/flightrecorderappender.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/synchronized.h>
+#include <log4cxxNG/helpers/exception.h>
+#include <apr_time.h>
+#include <mutex>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+	#include <io.h>
+#else
+	#include <unistd.h>
+#endif
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+using namespace log4cxxng::spi;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(FlightRecorderAppender)
+
+namespace
+{
+/**
+ *  Recorders dumped on a fatal signal, a fixed array so that
+ *  the signal handler can walk it without locking.
+ */
+enum { MAX_RECORDERS = 16, MAX_RINGS = 256 };
+std::atomic<FlightRecorderAppender*> recorders[MAX_RECORDERS];
+
+std::atomic<unsigned long long> generations(0);
+
+#if !defined(_WIN32)
+const int fatalSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+enum { FATAL_SIGNAL_COUNT = sizeof(fatalSignals) / sizeof(fatalSignals[0]) };
+struct sigaction previousActions[FATAL_SIGNAL_COUNT];
+#endif
+
+//
+//   raw file access, usable from a signal handler
+//
+int openDump(const char* path)
+{
+#if defined(_WIN32)
+	return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+	return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+bool writeDump(int fd, const char* bytes, size_t length)
+{
+	while (length > 0)
+	{
+#if defined(_WIN32)
+		int count = _write(fd, bytes, (unsigned int) length);
+#else
+		ssize_t count = write(fd, bytes, length);
+
+		if (count < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+#endif
+
+		if (count <= 0)
+		{
+			return false;
+		}
+
+		bytes += count;
+		length -= count;
+	}
+
+	return true;
+}
+
+void closeDump(int fd)
+{
+#if defined(_WIN32)
+	_close(fd);
+#else
+	close(fd);
+#endif
+}
+}
+
+
+FlightRecorderAppender::FlightRecorderAppender()
+	: fileName(),
+	  filePath(),
+	  bufferSize(1024 * 1024),
+	  maxThreads(64),
+	  triggerLevel(Level::getError()),
+	  evaluator(),
+	  triggerInterval(1000),
+	  dumpOnSignal(true),
+	  generation(++generations),
+	  rings(0),
+	  ringCount(0),
+	  sharedRing(0),
+	  lastDump(0),
+	  dumpMutex(pool),
+	  dumpCondition(pool),
+	  dumpRequested(false),
+	  stopping(false)
+{
+}
+
+FlightRecorderAppender::FlightRecorderAppender(const LayoutPtr& layout1,
+	const LogString& fileName1)
+	: fileName(),
+	  filePath(),
+	  bufferSize(1024 * 1024),
+	  maxThreads(64),
+	  triggerLevel(Level::getError()),
+	  evaluator(),
+	  triggerInterval(1000),
+	  dumpOnSignal(true),
+	  generation(++generations),
+	  rings(0),
+	  ringCount(0),
+	  sharedRing(0),
+	  lastDump(0),
+	  dumpMutex(pool),
+	  dumpCondition(pool),
+	  dumpRequested(false),
+	  stopping(false)
+{
+	setLayout(layout1);
+	setFile(fileName1);
+	Pool p;
+	activateOptions(p);
+}
+
+FlightRecorderAppender::~FlightRecorderAppender()
+{
+	finalize();
+	Ring* ring = rings.exchange(0);
+
+	while (ring != 0)
+	{
+		Ring* next = ring->next;
+		delete ring;
+		ring = next;
+	}
+}
+
+void FlightRecorderAppender::activateOptions(Pool& p)
+{
+	int errors = 0;
+
+	if (layout == 0)
+	{
+		errorHandler->error(
+			((LogString) LOG4CXXNG_STR("No layout set for the appender named ["))
+			+ name + LOG4CXXNG_STR("]."));
+		errors++;
+	}
+
+	if (fileName.empty())
+	{
+		errorHandler->error(
+			((LogString) LOG4CXXNG_STR("No file set for the appender named ["))
+			+ name + LOG4CXXNG_STR("]."));
+		errors++;
+	}
+
+	if (dumpOnSignal)
+	{
+		registerRecorder(this);
+	}
+	else
+	{
+		unregisterRecorder(this);
+	}
+
+	if (errors == 0)
+	{
+		startDumper();
+		AppenderSkeleton::activateOptions(p);
+	}
+}
+
+void FlightRecorderAppender::setOption(const LogString& option,
+	const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("FILE"), LOG4CXXNG_STR("file")))
+	{
+		setFile(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("BUFFERSIZE"), LOG4CXXNG_STR("buffersize")))
+	{
+		setBufferSize(OptionConverter::toFileSize(value, 1024 * 1024));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("MAXTHREADS"), LOG4CXXNG_STR("maxthreads")))
+	{
+		setMaxThreads(OptionConverter::toInt(value, 64));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("TRIGGERLEVEL"), LOG4CXXNG_STR("triggerlevel")))
+	{
+		setTriggerLevel(OptionConverter::toLevel(value, Level::getError()));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("EVALUATORCLASS"), LOG4CXXNG_STR("evaluatorclass")))
+	{
+		setEvaluatorClass(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("TRIGGERINTERVAL"), LOG4CXXNG_STR("triggerinterval")))
+	{
+		setTriggerInterval(OptionConverter::toInt(value, 1000));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("DUMPONSIGNAL"), LOG4CXXNG_STR("dumponsignal")))
+	{
+		setDumpOnSignal(OptionConverter::toBoolean(value, true));
+	}
+	else
+	{
+		AppenderSkeleton::setOption(option, value);
+	}
+}
+
+void FlightRecorderAppender::append(const spi::LoggingEventPtr& event, Pool& p)
+{
+	if (layout == 0)
+	{
+		errorHandler->error(
+			((LogString) LOG4CXXNG_STR("No layout set for the appender named ["))
+			+ name + LOG4CXXNG_STR("]."));
+		return;
+	}
+
+	formatted.erase(formatted.begin(), formatted.end());
+	layout->format(formatted, event, p);
+	Ring* ring = getRing(event);
+#if LOG4CXXNG_LOGCHAR_IS_UTF8
+	ring->write(formatted.data(), formatted.length());
+#else
+	encoded.erase(encoded.begin(), encoded.end());
+	Transcoder::encodeUTF8(formatted, encoded);
+	ring->write(encoded.data(), encoded.length());
+#endif
+
+	if (isTriggeringEvent(event))
+	{
+		log4cxxng_time_t now = apr_time_now();
+
+		if (now - lastDump >= (log4cxxng_time_t) triggerInterval * 1000)
+		{
+			lastDump = now;
+			requestDump();
+		}
+	}
+}
+
+void FlightRecorderAppender::close()
+{
+	{
+		LOCK_W sync(mutex);
+
+		if (closed)
+		{
+			return;
+		}
+
+		closed = true;
+	}
+
+	//
+	//   the dumper takes the lock to copy the rings,
+	//      wait for it without holding the lock
+	//
+	unregisterRecorder(this);
+	stopDumper();
+}
+
+void FlightRecorderAppender::requestDump()
+{
+#if APR_HAS_THREADS
+
+	if (dumper.isAlive())
+	{
+		synchronized sync(dumpMutex);
+		dumpRequested = true;
+		dumpCondition.signalAll();
+		return;
+	}
+
+#endif
+
+	if (!dump())
+	{
+		errorHandler->error(
+			((LogString) LOG4CXXNG_STR("Unable to dump flight recorder to ["))
+			+ fileName + LOG4CXXNG_STR("]."));
+	}
+}
+
+void FlightRecorderAppender::startDumper()
+{
+#if APR_HAS_THREADS
+
+	if (!dumper.isAlive())
+	{
+		stopping = false;
+		dumper.run(dumpLoop, this);
+	}
+
+#endif
+}
+
+void FlightRecorderAppender::stopDumper()
+{
+#if APR_HAS_THREADS
+
+	if (dumper.isAlive())
+	{
+		{
+			synchronized sync(dumpMutex);
+			stopping = true;
+			dumpCondition.signalAll();
+		}
+
+		try
+		{
+			dumper.join();
+		}
+		catch (InterruptedException& e)
+		{
+			Thread::currentThreadInterrupt();
+			LogLog::error(LOG4CXXNG_STR("Got an InterruptedException while waiting for the flight recorder to finish,"), e);
+		}
+	}
+
+#endif
+}
+
+#if APR_HAS_THREADS
+void* LOG4CXXNG_THREAD_FUNC FlightRecorderAppender::dumpLoop(apr_thread_t* /* thread */, void* data)
+{
+	FlightRecorderAppender* pThis = (FlightRecorderAppender*) data;
+
+	while (true)
+	{
+		{
+			synchronized sync(pThis->dumpMutex);
+
+			while (!pThis->dumpRequested && !pThis->stopping)
+			{
+				pThis->dumpCondition.await(pThis->dumpMutex);
+			}
+
+			//
+			//   a dump requested before close is still written
+			//
+			if (!pThis->dumpRequested)
+			{
+				break;
+			}
+
+			pThis->dumpRequested = false;
+		}
+
+		if (!pThis->dump())
+		{
+			pThis->errorHandler->error(
+				((LogString) LOG4CXXNG_STR("Unable to dump flight recorder to ["))
+				+ pThis->fileName + LOG4CXXNG_STR("]."));
+		}
+	}
+
+	return 0;
+}
+#endif
+
+FlightRecorderAppender::Ring* FlightRecorderAppender::getRing(const spi::LoggingEventPtr& event)
+{
+	//
+	//   the rings this thread holds, one per recorder, released
+	//      when the thread exits so that another thread may take them
+	//
+	struct Lease
+	{
+		unsigned long long generation;
+		Ring* ring;
+		std::shared_ptr<std::atomic<bool> > owned;
+		bool owner;
+	};
+
+	struct Leases
+	{
+		std::vector<Lease> list;
+
+		~Leases()
+		{
+			for (std::vector<Lease>::iterator iter = list.begin(); iter != list.end(); iter++)
+			{
+				if (iter->owner)
+				{
+					iter->owned->store(false, std::memory_order_release);
+				}
+			}
+		}
+	};
+
+	thread_local static Leases leases;
+
+	for (std::vector<Lease>::iterator iter = leases.list.begin(); iter != leases.list.end(); iter++)
+	{
+		if (iter->generation == generation)
+		{
+			return iter->ring;
+		}
+	}
+
+	//
+	//   forget the rings of recorders that have since been destroyed
+	//
+	for (std::vector<Lease>::iterator iter = leases.list.begin(); iter != leases.list.end();)
+	{
+		if (iter->owned.use_count() == 1)
+		{
+			iter = leases.list.erase(iter);
+		}
+		else
+		{
+			iter++;
+		}
+	}
+
+	Lease lease;
+	lease.generation = generation;
+	lease.ring = claimRing(event->getThreadName());
+	lease.owned = lease.ring->owned;
+	lease.owner = lease.ring != sharedRing;
+	leases.list.push_back(lease);
+	return lease.ring;
+}
+
+FlightRecorderAppender::Ring* FlightRecorderAppender::claimRing(const LogString& threadName)
+{
+	//
+	//   take over the ring of a thread that has exited
+	//
+	for (Ring* ring = rings.load(std::memory_order_relaxed); ring != 0; ring = ring->next)
+	{
+		bool expected = false;
+
+		if (ring != sharedRing
+			&& ring->owned->compare_exchange_strong(expected, true, std::memory_order_acquire))
+		{
+			ring->written.store(0, std::memory_order_release);
+			ring->setThreadName(threadName);
+			return ring;
+		}
+	}
+
+	if (ringCount >= maxThreads - 1 && sharedRing != 0)
+	{
+		return sharedRing;
+	}
+
+	Ring* ring = 0;
+
+	if (ringCount < maxThreads - 1)
+	{
+		ring = new Ring(bufferSize, threadName);
+		ring->owned->store(true, std::memory_order_relaxed);
+	}
+	else
+	{
+		ring = sharedRing = new Ring(bufferSize, LOG4CXXNG_STR("other threads"));
+	}
+
+	//
+	//   publish the new ring once it is fully constructed
+	//
+	ring->next = rings.load(std::memory_order_relaxed);
+	rings.store(ring, std::memory_order_release);
+	ringCount++;
+	return ring;
+}
+
+bool FlightRecorderAppender::isTriggeringEvent(const spi::LoggingEventPtr& event)
+{
+	if (evaluator != 0)
+	{
+		return evaluator->isTriggeringEvent(event);
+	}
+
+	return triggerLevel != 0 && event->getLevel()->isGreaterOrEqual(triggerLevel);
+}
+
+bool FlightRecorderAppender::dump() const
+{
+	if (filePath.empty())
+	{
+		return false;
+	}
+
+	int fd = openDump(filePath.c_str());
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	//
+	//   rings are listed newest first, write them oldest first
+	//
+	const Ring* stack[MAX_RINGS];
+	int depth = 0;
+
+	for (const Ring* ring = rings.load(std::memory_order_acquire);
+		ring != 0 && depth < MAX_RINGS;
+		ring = ring->next)
+	{
+		stack[depth++] = ring;
+	}
+
+	//
+	//   copy each ring while its thread cannot append to it,
+	//      then write the copy without holding up logging
+	//
+	std::string scratch;
+	bool success = true;
+
+	while (success && depth > 0)
+	{
+		const Ring* ring = stack[--depth];
+		scratch.erase(scratch.begin(), scratch.end());
+		{
+			LOCK_W sync(mutex);
+			ring->copyTo(scratch);
+		}
+		success = writeDump(fd, scratch.data(), scratch.length());
+	}
+
+	closeDump(fd);
+	return success;
+}
+
+bool FlightRecorderAppender::dumpUnlocked() const
+{
+	if (filePath.empty())
+	{
+		return false;
+	}
+
+	int fd = openDump(filePath.c_str());
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	const Ring* stack[MAX_RINGS];
+	int depth = 0;
+
+	for (const Ring* ring = rings.load(std::memory_order_acquire);
+		ring != 0 && depth < MAX_RINGS;
+		ring = ring->next)
+	{
+		stack[depth++] = ring;
+	}
+
+	bool success = true;
+
+	while (success && depth > 0)
+	{
+		success = stack[--depth]->dump(fd);
+	}
+
+	closeDump(fd);
+	return success;
+}
+
+FlightRecorderAppender::Ring::Ring(size_t capacity1, const LogString& threadName1)
+	: storage(),
+	  capacity(0),
+	  written(0),
+	  threadNameLength(0),
+	  owned(new std::atomic<bool>(false)),
+	  next(0)
+{
+	storage.reserve(capacity1 > 0 ? capacity1 : 1);
+	capacity = storage.capacity();
+	setThreadName(threadName1);
+}
+
+void FlightRecorderAppender::Ring::setThreadName(const LogString& threadName1)
+{
+	std::string encodedName;
+	Transcoder::encodeUTF8(threadName1, encodedName);
+	size_t length = encodedName.length();
+
+	if (length > sizeof(threadName))
+	{
+		length = sizeof(threadName);
+	}
+
+	threadNameLength.store(0, std::memory_order_release);
+	memcpy(threadName, encodedName.data(), length);
+	threadNameLength.store(length, std::memory_order_release);
+}
+
+void FlightRecorderAppender::Ring::write(const char* bytes, size_t length)
+{
+	unsigned long long position = written.load(std::memory_order_relaxed);
+
+	if (length > capacity)
+	{
+		position += length - capacity;
+		bytes += length - capacity;
+		length = capacity;
+	}
+
+	size_t offset = (size_t) (position % capacity);
+	size_t first = capacity - offset;
+
+	if (first > length)
+	{
+		first = length;
+	}
+
+	memcpy(storage.data() + offset, bytes, first);
+	memcpy(storage.data(), bytes + first, length - first);
+	written.store(position + length, std::memory_order_release);
+}
+
+void FlightRecorderAppender::Ring::locate(unsigned long long end, size_t& offset, size_t& length) const
+{
+	const char* data = storage.data();
+	length = end < capacity ? (size_t) end : capacity;
+	offset = (size_t) ((end - length) % capacity);
+
+	if (end > capacity)
+	{
+		//
+		//   the oldest event was partly overwritten,
+		//      start with the next line
+		//
+		while (length > 0 && data[offset] != '\n')
+		{
+			offset = (offset + 1) % capacity;
+			length--;
+		}
+
+		if (length > 0)
+		{
+			offset = (offset + 1) % capacity;
+			length--;
+		}
+	}
+}
+
+bool FlightRecorderAppender::Ring::dump(int fd) const
+{
+	size_t offset, length;
+	locate(written.load(std::memory_order_acquire), offset, length);
+	size_t first = capacity - offset;
+
+	if (first > length)
+	{
+		first = length;
+	}
+
+	return writeDump(fd, "==> ", 4)
+		&& writeDump(fd, threadName, threadNameLength.load(std::memory_order_acquire))
+		&& writeDump(fd, " <==\n", 5)
+		&& writeDump(fd, storage.data() + offset, first)
+		&& writeDump(fd, storage.data(), length - first);
+}
+
+void FlightRecorderAppender::Ring::copyTo(std::string& dst) const
+{
+	size_t offset, length;
+	locate(written.load(std::memory_order_relaxed), offset, length);
+	size_t first = capacity - offset;
+
+	if (first > length)
+	{
+		first = length;
+	}
+
+	dst.append("==> ", 4);
+	dst.append(threadName, threadNameLength.load(std::memory_order_relaxed));
+	dst.append(" <==\n", 5);
+	dst.append(storage.data() + offset, first);
+	dst.append(storage.data(), length - first);
+}
+
+void FlightRecorderAppender::registerRecorder(FlightRecorderAppender* recorder)
+{
+#if !defined(_WIN32)
+	static std::mutex installMutex;
+	static bool installed = false;
+
+	for (int i = 0; i < MAX_RECORDERS; i++)
+	{
+		if (recorders[i].load() == recorder)
+		{
+			return;
+		}
+	}
+
+	bool registered = false;
+
+	for (int i = 0; i < MAX_RECORDERS && !registered; i++)
+	{
+		FlightRecorderAppender* expected = 0;
+		registered = recorders[i].compare_exchange_strong(expected, recorder);
+	}
+
+	if (!registered)
+	{
+		LogLog::warn(LOG4CXXNG_STR("Too many flight recorders, [")
+			+ recorder->getName() + LOG4CXXNG_STR("] will not be dumped on a fatal signal."));
+		return;
+	}
+
+	std::lock_guard<std::mutex> sync(installMutex);
+
+	if (!installed)
+	{
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = onSignal;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+
+		for (int i = 0; i < FATAL_SIGNAL_COUNT; i++)
+		{
+			sigaction(fatalSignals[i], &action, &previousActions[i]);
+		}
+
+		installed = true;
+	}
+
+#else
+	LogLog::warn(LOG4CXXNG_STR("Flight recorder [") + recorder->getName()
+		+ LOG4CXXNG_STR("] cannot be dumped on a fatal signal on this platform."));
+#endif
+}
+
+void FlightRecorderAppender::unregisterRecorder(FlightRecorderAppender* recorder)
+{
+	for (int i = 0; i < MAX_RECORDERS; i++)
+	{
+		FlightRecorderAppender* expected = recorder;
+		recorders[i].compare_exchange_strong(expected, 0);
+	}
+}
+
+void FlightRecorderAppender::onSignal(int signal)
+{
+#if !defined(_WIN32)
+	int savedErrno = errno;
+
+	for (int i = 0; i < MAX_RECORDERS; i++)
+	{
+		FlightRecorderAppender* recorder = recorders[i].load();
+
+		if (recorder != 0)
+		{
+			recorder->dumpUnlocked();
+		}
+	}
+
+	//
+	//   hand the signal to whoever handled it before
+	//
+	for (int i = 0; i < FATAL_SIGNAL_COUNT; i++)
+	{
+		if (fatalSignals[i] == signal)
+		{
+			sigaction(signal, &previousActions[i], 0);
+		}
+	}
+
+	errno = savedErrno;
+	raise(signal);
+#endif
+}
+
+void FlightRecorderAppender::setFile(const LogString& fileName1)
+{
+	fileName = fileName1;
+	filePath.erase(filePath.begin(), filePath.end());
+	Transcoder::encode(fileName, filePath);
+}
+
+LogString FlightRecorderAppender::getFile() const
+{
+	return fileName;
+}
+
+void FlightRecorderAppender::setBufferSize(size_t bytes)
+{
+	bufferSize = bytes;
+}
+
+size_t FlightRecorderAppender::getBufferSize() const
+{
+	return bufferSize;
+}
+
+void FlightRecorderAppender::setMaxThreads(int count)
+{
+	maxThreads = count < 1 ? 1 : (count > MAX_RINGS ? MAX_RINGS : count);
+}
+
+int FlightRecorderAppender::getMaxThreads() const
+{
+	return maxThreads;
+}
+
+void FlightRecorderAppender::setTriggerLevel(const LevelPtr& level)
+{
+	triggerLevel = level;
+}
+
+LevelPtr FlightRecorderAppender::getTriggerLevel() const
+{
+	return triggerLevel;
+}
+
+void FlightRecorderAppender::setEvaluator(const spi::TriggeringEventEvaluatorPtr& trigger)
+{
+	evaluator = trigger;
+}
+
+spi::TriggeringEventEvaluatorPtr FlightRecorderAppender::getEvaluator() const
+{
+	return evaluator;
+}
+
+void FlightRecorderAppender::setEvaluatorClass(const LogString& className)
+{
+	evaluator = OptionConverter::instantiateByClassName(className,
+			TriggeringEventEvaluator::getStaticClass(), evaluator);
+}
+
+void FlightRecorderAppender::setTriggerInterval(int millis)
+{
+	triggerInterval = millis < 0 ? 0 : millis;
+}
+
+int FlightRecorderAppender::getTriggerInterval() const
+{
+	return triggerInterval;
+}
+
+void FlightRecorderAppender::setDumpOnSignal(bool value)
+{
+	dumpOnSignal = value;
+}
+
+bool FlightRecorderAppender::getDumpOnSignal() const
+{
+	return dumpOnSignal;
+}
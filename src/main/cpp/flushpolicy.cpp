@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/helpers/flushpolicy.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+
+FlushPolicy::FlushPolicy()
+	: flushBytes(0), flushEvents(0), flushInterval(0), flushLevel(),
+	  pendingBytes(0), pendingEvents(0)
+{
+}
+
+bool FlushPolicy::setOption(const LogString& option, const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("FLUSHBYTES"), LOG4CXXNG_STR("flushbytes")))
+	{
+		setFlushBytes((size_t) OptionConverter::toFileSize(value, flushBytes));
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("FLUSHEVENTS"), LOG4CXXNG_STR("flushevents")))
+	{
+		setFlushEvents(OptionConverter::toInt(value, flushEvents));
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("FLUSHINTERVAL"), LOG4CXXNG_STR("flushinterval")))
+	{
+		setFlushInterval(OptionConverter::toInt(value, flushInterval));
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("FLUSHLEVEL"), LOG4CXXNG_STR("flushlevel")))
+	{
+		setFlushLevel(OptionConverter::toLevel(value, flushLevel));
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void FlushPolicy::setFlushBytes(size_t bytes)
+{
+	flushBytes = bytes;
+}
+
+void FlushPolicy::setFlushEvents(unsigned int events)
+{
+	flushEvents = events;
+}
+
+void FlushPolicy::setFlushInterval(unsigned int milliseconds)
+{
+	flushInterval = milliseconds;
+}
+
+void FlushPolicy::setFlushLevel(const LevelPtr& level)
+{
+	flushLevel = level;
+}
+
+bool FlushPolicy::isActive() const
+{
+	return flushBytes > 0 || flushEvents > 0 || flushInterval > 0 || flushLevel != 0;
+}
+
+bool FlushPolicy::written(const LevelPtr& level, size_t bytes)
+{
+	pendingBytes += bytes;
+	pendingEvents++;
+
+	return (flushBytes > 0 && pendingBytes >= flushBytes)
+		|| (flushEvents > 0 && pendingEvents >= flushEvents)
+		|| (flushLevel != 0 && level->isGreaterOrEqual(flushLevel));
+}
+
+void FlushPolicy::flushed()
+{
+	pendingBytes = 0;
+	pendingEvents = 0;
+}
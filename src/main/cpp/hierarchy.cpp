@@ -32,6 +32,9 @@
 #include <log4cxxNG/helpers/synchronized.h>
 #include <log4cxxNG/logstring.h>
 #include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/spi/appenderattachable.h>
+#include <log4cxxNG/appenderskeleton.h>
 #if !defined(LOG4CXXNG)
 	#define LOG4CXXNG 1
 #endif
@@ -39,6 +42,8 @@
 #include <log4cxxNG/defaultconfigurator.h>
 #include <log4cxxNG/spi/rootlogger.h>
 #include <apr_atomic.h>
+#include <apr_file_io.h>
+#include <set>
 #include "assert.h"
 
 
@@ -61,6 +66,7 @@ Hierarchy::Hierarchy() :
 	configured = false;
 	thresholdInt = Level::ALL_INT;
 	threshold = Level::getAll();
+	configurationEpoch = 0;
 }
 
 Hierarchy::~Hierarchy()
@@ -330,6 +336,35 @@ void Hierarchy::shutdown()
 		LoggerPtr& logger = *it;
 		logger->removeAllAppenders();
 	}
+
+	configuredAppenders.clear();
+}
+
+AppenderPtr Hierarchy::getConfiguredAppender(const LogString& name,
+	const LogString& signature) const
+{
+	synchronized sync(mutex);
+	ConfiguredAppenderMap::const_iterator it = configuredAppenders.find(name);
+
+	if (it != configuredAppenders.end() && it->second.first == signature)
+	{
+		return it->second.second;
+	}
+
+	return 0;
+}
+
+unsigned int Hierarchy::publishConfiguration(ConfiguredAppenderMap& appenders)
+{
+	synchronized sync(mutex);
+	configuredAppenders.swap(appenders);
+	return ++configurationEpoch;
+}
+
+unsigned int Hierarchy::getConfigurationEpoch() const
+{
+	synchronized sync(mutex);
+	return configurationEpoch;
 }
 
 
@@ -409,3 +444,96 @@ bool Hierarchy::isConfigured()
 {
 	return configured;
 }
+
+namespace
+{
+void collectMetrics(const AppenderList& appenders,
+	std::set<Appender*>& seen,
+	std::map<LogString, AppenderMetrics::Snapshot>& metrics)
+{
+	for (AppenderList::const_iterator it = appenders.begin(); it != appenders.end(); it++)
+	{
+		if (*it == 0 || !seen.insert(&(**it)).second)
+		{
+			continue;
+		}
+
+		AppenderSkeletonPtr skeleton(*it);
+
+		if (skeleton != 0)
+		{
+			//
+			//   distinct appenders sharing a name are kept apart
+			//      as name#2, name#3 and so on
+			//
+			LogString key(skeleton->getName());
+
+			for (int n = 2; metrics.find(key) != metrics.end(); n++)
+			{
+				Pool p;
+				key.assign(skeleton->getName());
+				key.append(1, (logchar) 0x23 /* '#' */);
+				StringHelper::toString(n, p, key);
+			}
+
+			skeleton->getMetrics().snapshot(metrics[key]);
+		}
+
+		AppenderAttachablePtr attachable(*it);
+
+		if (attachable != 0)
+		{
+			collectMetrics(attachable->getAllAppenders(), seen, metrics);
+		}
+	}
+}
+}
+
+void Hierarchy::getAppenderMetrics(
+	std::map<LogString, AppenderMetrics::Snapshot>& metrics) const
+{
+	std::set<Appender*> seen;
+	collectMetrics(root->getAllAppenders(), seen, metrics);
+	LoggerList loggerList(getCurrentLoggers());
+
+	for (LoggerList::const_iterator it = loggerList.begin(); it != loggerList.end(); it++)
+	{
+		collectMetrics((*it)->getAllAppenders(), seen, metrics);
+	}
+}
+
+bool Hierarchy::writeMetrics(const File& file) const
+{
+	std::map<LogString, AppenderMetrics::Snapshot> metrics;
+	getAppenderMetrics(metrics);
+	LogString text;
+	AppenderMetrics::writePrometheus(metrics, text);
+	std::string contents;
+	Transcoder::encodeUTF8(text, contents);
+
+	Pool p;
+	File tmp;
+	tmp.setPath(file.getPath() + LOG4CXXNG_STR(".tmp"));
+	apr_file_t* fd;
+
+	if (tmp.open(&fd, APR_WRITE | APR_CREATE | APR_TRUNCATE | APR_BINARY,
+			APR_OS_DEFAULT, p) != APR_SUCCESS)
+	{
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not create metrics file ["))
+			+ tmp.getPath() + LOG4CXXNG_STR("]."));
+		return false;
+	}
+
+	apr_status_t stat = apr_file_write_full(fd, contents.data(), contents.size(), NULL);
+	apr_file_close(fd);
+
+	if (stat != APR_SUCCESS || !tmp.renameTo(file, p))
+	{
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not write metrics file ["))
+			+ file.getPath() + LOG4CXXNG_STR("]."));
+		tmp.deleteFile(p);
+		return false;
+	}
+
+	return true;
+}
@@ -88,18 +88,18 @@ void HTMLLayout::format(LogString& output,
 	if (event->getLevel()->equals(Level::getDebug()))
 	{
 		output.append(LOG4CXXNG_STR("<font color=\"#339933\">"));
-		output.append(event->getLevel()->toString());
+		output.append(event->getLevel()->getEscapedName());
 		output.append(LOG4CXXNG_STR("</font>"));
 	}
 	else if (event->getLevel()->isGreaterOrEqual(Level::getWarn()))
 	{
 		output.append(LOG4CXXNG_STR("<font color=\"#993300\"><strong>"));
-		output.append(event->getLevel()->toString());
+		output.append(event->getLevel()->getEscapedName());
 		output.append(LOG4CXXNG_STR("</strong></font>"));
 	}
 	else
 	{
-		output.append(event->getLevel()->toString());
+		output.append(event->getLevel()->getEscapedName());
 	}
 
 	output.append(LOG4CXXNG_STR("</td>"));
@@ -108,7 +108,17 @@ void HTMLLayout::format(LogString& output,
 	output.append(LOG4CXXNG_STR("<td title=\""));
 	output.append(event->getLoggerName());
 	output.append(LOG4CXXNG_STR(" logger\">"));
-	Transform::appendEscapingTags(output, event->getLoggerName());
+	const LoggerPtr& logger = event->getLogger();
+
+	if (logger != 0 && &logger->getName() == &event->getLoggerName())
+	{
+		logger->getEscapedName(output);
+	}
+	else
+	{
+		Transform::appendEscapingTags(output, event->getLoggerName());
+	}
+
 	output.append(LOG4CXXNG_STR("</td>"));
 	output.append(LOG4CXXNG_EOL);
 
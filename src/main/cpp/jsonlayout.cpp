@@ -363,7 +363,8 @@ void JSONLayout::appendSerializedLocationInfo(LogString& buf,
 
 	appendQuotedEscapedString(buf, LOG4CXXNG_STR("class"));
 	buf.append(LOG4CXXNG_STR(": "));
-	LOG4CXXNG_DECODE_CHAR(className, locInfo.getClassName());
+	LogString className;
+	locInfo.getClassName(className);
 	appendQuotedEscapedString(buf, className);
 	buf.append(LOG4CXXNG_STR(","));
 	buf.append(prettyPrint ? LOG4CXXNG_EOL : LOG4CXXNG_STR(" "));
@@ -375,7 +376,8 @@ void JSONLayout::appendSerializedLocationInfo(LogString& buf,
 
 	appendQuotedEscapedString(buf, LOG4CXXNG_STR("method"));
 	buf.append(LOG4CXXNG_STR(": "));
-	LOG4CXXNG_DECODE_CHAR(methodName, locInfo.getMethodName());
+	LogString methodName;
+	locInfo.getMethodName(methodName);
 	appendQuotedEscapedString(buf, methodName);
 	buf.append(prettyPrint ? LOG4CXXNG_EOL : LOG4CXXNG_STR(" "));
 
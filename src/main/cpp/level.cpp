@@ -19,6 +19,7 @@
 #include <log4cxxNG/level.h>
 #include <log4cxxNG/helpers/stringhelper.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/transform.h>
 #if !defined(LOG4CXXNG)
 	#define LOG4CXXNG 1
 #endif
@@ -82,9 +83,10 @@ LevelPtr Level::getAll()
 
 Level::Level(int level1,
 	const LogString& name1, int syslogEquivalent1)
-	: level(level1), name(name1), syslogEquivalent(syslogEquivalent1)
+	: level(level1), name(name1), escapedName(), syslogEquivalent(syslogEquivalent1)
 {
 	APRInitializer::initialize();
+	Transform::appendEscapingTags(escapedName, name);
 }
 
 
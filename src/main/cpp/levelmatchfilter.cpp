@@ -50,11 +50,14 @@ void LevelMatchFilter::setOption(const LogString& option,
 	{
 		acceptOnMatch = OptionConverter::toBoolean(value, acceptOnMatch);
 	}
+
+	changed();
 }
 
 void LevelMatchFilter::setLevelToMatch(const LogString& levelToMatch1)
 {
 	this->levelToMatch = OptionConverter::toLevel(levelToMatch1, this->levelToMatch);
+	changed();
 }
 
 LogString LevelMatchFilter::getLevelToMatch() const
@@ -54,6 +54,8 @@ void LevelRangeFilter::setOption(const LogString& option,
 	{
 		acceptOnMatch = OptionConverter::toBoolean(value, acceptOnMatch);
 	}
+
+	changed();
 }
 
 Filter::FilterDecision LevelRangeFilter::decide(
@@ -18,6 +18,7 @@
 #include <log4cxxNG/spi/location/locationinfo.h>
 #include <log4cxxNG/helpers/objectoutputstream.h>
 #include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/transcoder.h>
 #include "apr_pools.h"
 #include "apr_strings.h"
 
@@ -47,7 +48,19 @@ LocationInfo::LocationInfo( const char* const fileName1,
 	int lineNumber1 )
 	:  lineNumber( lineNumber1 ),
 	   fileName( fileName1 ),
-	   methodName( methodName1 )
+	   methodName( methodName1 ),
+	   names( 0 )
+{
+}
+
+LocationInfo::LocationInfo( const char* const fileName1,
+	const char* const methodName1,
+	int lineNumber1,
+	const LocationNames* names1 )
+	:  lineNumber( lineNumber1 ),
+	   fileName( fileName1 ),
+	   methodName( methodName1 ),
+	   names( names1 )
 {
 }
 
@@ -57,7 +70,8 @@ LocationInfo::LocationInfo( const char* const fileName1,
 LocationInfo::LocationInfo()
 	: lineNumber( -1 ),
 	  fileName(LocationInfo::NA),
-	  methodName(LocationInfo::NA_METHOD)
+	  methodName(LocationInfo::NA_METHOD),
+	  names( 0 )
 {
 }
 
@@ -68,7 +82,8 @@ LocationInfo::LocationInfo()
 LocationInfo::LocationInfo( const LocationInfo& src )
 	:  lineNumber( src.lineNumber ),
 	   fileName( src.fileName ),
-	   methodName( src.methodName )
+	   methodName( src.methodName ),
+	   names( src.names )
 {
 }
 
@@ -81,6 +96,7 @@ LocationInfo& LocationInfo::operator = ( const LocationInfo& src )
 	fileName = src.fileName;
 	methodName = src.methodName;
 	lineNumber = src.lineNumber;
+	names = src.names;
 	return * this;
 }
 
@@ -92,6 +108,7 @@ void LocationInfo::clear()
 	fileName = NA;
 	methodName = NA_METHOD;
 	lineNumber = -1;
+	names = 0;
 }
 
 
@@ -173,6 +190,51 @@ const std::string LocationInfo::getClassName() const
 	return tmp;
 }
 
+void LocationInfo::getClassName(LogString& dest) const
+{
+	if (names != 0)
+	{
+		dest.append(names->getClassName());
+	}
+	else
+	{
+		Transcoder::decode(getClassName(), dest);
+	}
+}
+
+void LocationInfo::getMethodName(LogString& dest) const
+{
+	if (names != 0)
+	{
+		dest.append(names->getMethodName());
+	}
+	else
+	{
+		Transcoder::decode(getMethodName(), dest);
+	}
+}
+
+namespace
+{
+log4cxxng::LogString decodeName(const std::string& src)
+{
+	log4cxxng::LogString dest;
+	Transcoder::decode(src, dest);
+	return dest;
+}
+}
+
+LocationNames::LocationNames(const char* const functionName)
+	: className(decodeName(LocationInfo(LocationInfo::NA, functionName, -1).getClassName())),
+	  methodName(decodeName(LocationInfo(LocationInfo::NA, functionName, -1).getMethodName()))
+{
+}
+
+const LocationNames* LocationNames::create(const char* const functionName)
+{
+	return new LocationNames(functionName);
+}
+
 void LocationInfo::write(ObjectOutputStream& os, Pool& p) const
 {
 	if (lineNumber == -1 && fileName == NA && methodName == NA_METHOD)
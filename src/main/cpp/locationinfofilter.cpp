@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/filter/locationinfofilter.h>
+#include <log4cxxNG/rule/expressionrule.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/exception.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::rule;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(LocationInfoFilter)
+
+
+LocationInfoFilter::LocationInfoFilter()
+	: convertInFixToPostFix(true), expression(), expressionRule(),
+	  className(LOG4CXXNG_STR("org.apache.log4j.Category"))
+{
+}
+
+void LocationInfoFilter::activateOptions(Pool&)
+{
+	try
+	{
+		expressionRule = ExpressionRule::getRule(expression, !convertInFixToPostFix);
+	}
+	catch (IllegalArgumentException& e)
+	{
+		expressionRule = 0;
+		LogLog::error(LOG4CXXNG_STR("Invalid expression [") + expression + LOG4CXXNG_STR("]."), e);
+	}
+}
+
+void LocationInfoFilter::setOption(const LogString& option,
+	const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("EXPRESSION"), LOG4CXXNG_STR("expression")))
+	{
+		setExpression(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("CONVERTINFIXTOPOSTFIX"), LOG4CXXNG_STR("convertinfixtopostfix")))
+	{
+		setConvertInFixToPostFix(OptionConverter::toBoolean(value, convertInFixToPostFix));
+	}
+}
+
+void LocationInfoFilter::setExpression(const LogString& exp)
+{
+	this->expression = exp;
+}
+
+LogString LocationInfoFilter::getExpression() const
+{
+	return expression;
+}
+
+void LocationInfoFilter::setConvertInFixToPostFix(bool newValue)
+{
+	this->convertInFixToPostFix = newValue;
+}
+
+bool LocationInfoFilter::getConvertInFixToPostFix() const
+{
+	return convertInFixToPostFix;
+}
+
+Filter::FilterDecision LocationInfoFilter::decide(
+	const LoggingEventPtr& /* event */) const
+{
+	return Filter::NEUTRAL;
+}
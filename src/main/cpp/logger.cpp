@@ -27,13 +27,18 @@
 #include <log4cxxNG/helpers/stringhelper.h>
 #include <log4cxxNG/helpers/synchronized.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/transform.h>
 #include <log4cxxNG/helpers/appenderattachableimpl.h>
 #include <log4cxxNG/helpers/exception.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
 #if !defined(LOG4CXXNG)
 	#define LOG4CXXNG 1
 #endif
 #include <log4cxxNG/private/log4cxxNG_private.h>
 #include <log4cxxNG/helpers/aprinitializer.h>
+#include <apr_atomic.h>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
@@ -42,15 +47,45 @@ using namespace log4cxxng::spi;
 IMPLEMENT_LOG4CXXNG_OBJECT(Logger)
 
 Logger::Logger(Pool& p, const LogString& name1)
-	: pool(&p), name(), level(), parent(), resourceBundle(),
+	: pool(&p), name(), nameId(internName(name1)), level(), parent(), resourceBundle(),
 	  repository(), aai(), SHARED_MUTEX_INIT(mutex, p)
 {
 	name = name1;
 	additive = true;
+
+	for (int i = 0; i < pattern::NameAbbreviator::MAX_CACHE_SLOTS; i++)
+	{
+		abbreviatedNames[i] = 0;
+	}
+
+	escapedName = 0;
+}
+
+unsigned int Logger::internName(const LogString& name1)
+{
+	static std::mutex mutex;
+	static std::map<LogString, unsigned int> ids;
+	std::lock_guard<std::mutex> sync(mutex);
+	std::map<LogString, unsigned int>::iterator it = ids.find(name1);
+
+	if (it == ids.end())
+	{
+		unsigned int id = (unsigned int) ids.size();
+		ids.insert(std::make_pair(name1, id));
+		return id;
+	}
+
+	return it->second;
 }
 
 Logger::~Logger()
 {
+	for (int i = 0; i < pattern::NameAbbreviator::MAX_CACHE_SLOTS; i++)
+	{
+		delete (LogString*) abbreviatedNames[i];
+	}
+
+	delete (LogString*) escapedName;
 }
 
 void Logger::addRef() const
@@ -113,6 +148,69 @@ void Logger::callAppenders(const spi::LoggingEventPtr& event, Pool& p) const
 	}
 }
 
+void Logger::getAbbreviatedName(const pattern::NameAbbreviator& abbreviator,
+	LogString& dest) const
+{
+	int slot = abbreviator.getCacheSlot();
+
+	if (slot < 0)
+	{
+		LogString::size_type nameStart = dest.length();
+		dest.append(name);
+		abbreviator.abbreviate(nameStart, dest);
+		return;
+	}
+
+	const LogString* abbreviated = (const LogString*) abbreviatedNames[slot];
+
+	if (abbreviated == 0)
+	{
+		//
+		//   concurrent callers may both abbreviate,
+		//      only the first one stores its result
+		//
+		LogString* newName = new LogString(name);
+		abbreviator.abbreviate(0, *newName);
+		abbreviated = (const LogString*) apr_atomic_casptr(
+				(volatile void**) &abbreviatedNames[slot], newName, 0);
+
+		if (abbreviated == 0)
+		{
+			abbreviated = newName;
+		}
+		else
+		{
+			delete newName;
+		}
+	}
+
+	dest.append(*abbreviated);
+}
+
+void Logger::getEscapedName(LogString& dest) const
+{
+	const LogString* escaped = (const LogString*) escapedName;
+
+	if (escaped == 0)
+	{
+		LogString* newName = new LogString();
+		Transform::appendEscapingTags(*newName, name);
+		escaped = (const LogString*) apr_atomic_casptr(
+				(volatile void**) &escapedName, newName, 0);
+
+		if (escaped == 0)
+		{
+			escaped = newName;
+		}
+		else
+		{
+			delete newName;
+		}
+	}
+
+	dest.append(*escaped);
+}
+
 void Logger::closeNestedAppenders()
 {
 	AppenderList appenders = getAllAppenders();
@@ -128,8 +226,8 @@ void Logger::forcedLog(const LevelPtr& level1, const std::string& message,
 	const LocationInfo& location) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_CHAR(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1, location));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
@@ -137,9 +235,9 @@ void Logger::forcedLog(const LevelPtr& level1, const std::string& message,
 void Logger::forcedLog(const LevelPtr& level1, const std::string& message) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_CHAR(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg,
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1,
 			LocationInfo::getLocationUnavailable()));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
@@ -147,7 +245,7 @@ void Logger::forcedLogLS(const LevelPtr& level1, const LogString& message,
 	const LocationInfo& location) const
 {
 	Pool p;
-	LoggingEventPtr event(new LoggingEvent(name, level1, message, location));
+	LoggingEventPtr event(LoggingEvent::create(*this, level1, message, location));
 	callAppenders(event, p);
 }
 
@@ -456,6 +554,50 @@ void Logger::removeAllAppenders()
 	}
 }
 
+AppenderList Logger::replaceAllAppenders(const AppenderList& appenders)
+{
+	// Build the new list before taking the lock so that logging
+	// threads are only held up by the pointer swap.
+	AppenderAttachableImplPtr newAai;
+
+	if (!appenders.empty())
+	{
+		newAai = new AppenderAttachableImpl(*pool);
+
+		for (AppenderList::const_iterator it = appenders.begin(); it != appenders.end(); ++it)
+		{
+			newAai->addAppender(*it);
+		}
+	}
+
+	AppenderList previous;
+	log4cxxng::spi::LoggerRepository* rep = 0;
+	{
+		LOCK_W sync(mutex);
+
+		if (aai != 0)
+		{
+			previous = aai->getAllAppenders();
+		}
+
+		aai = newAai;
+		rep = repository;
+	}
+
+	if (rep != 0)
+	{
+		for (AppenderList::const_iterator it = appenders.begin(); it != appenders.end(); ++it)
+		{
+			if (std::find(previous.begin(), previous.end(), *it) == previous.end())
+			{
+				rep->fireAddAppenderEvent(this, *it);
+			}
+		}
+	}
+
+	return previous;
+}
+
 void Logger::removeAppender(const AppenderPtr& appender)
 {
 	LOCK_W sync(mutex);
@@ -666,17 +808,17 @@ void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message,
 	const LocationInfo& location) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_WCHAR(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1, location));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const std::wstring& message) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_WCHAR(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg,
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1,
 			LocationInfo::getLocationUnavailable()));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
@@ -817,17 +959,17 @@ void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>&
 	const LocationInfo& location) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_UNICHAR(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1, location));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const std::basic_string<UniChar>& message) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_UNICHAR(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg,
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1,
 			LocationInfo::getLocationUnavailable()));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 #endif
@@ -965,17 +1107,17 @@ void Logger::forcedLog(const LevelPtr& level1, const CFStringRef& message,
 	const LocationInfo& location) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_CFSTRING(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg, location));
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1, location));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
 void Logger::forcedLog(const LevelPtr& level1, const CFStringRef& message) const
 {
 	Pool p;
-	LOG4CXXNG_DECODE_CFSTRING(msg, message);
-	LoggingEventPtr event(new LoggingEvent(name, level1, msg,
+	LoggingEventPtr event(LoggingEvent::obtain(*this, level1,
 			LocationInfo::getLocationUnavailable()));
+	Transcoder::decode(message, event->message);
 	callAppenders(event, p);
 }
 
@@ -37,6 +37,7 @@ LoggerMatchFilter::LoggerMatchFilter()
 void LoggerMatchFilter::setLoggerToMatch(const LogString& value)
 {
 	loggerToMatch = value;
+	changed();
 }
 
 LogString LoggerMatchFilter::getLoggerToMatch() const
@@ -58,6 +59,8 @@ void LoggerMatchFilter::setOption(const LogString& option,
 	{
 		acceptOnMatch = OptionConverter::toBoolean(value, acceptOnMatch);
 	}
+
+	changed();
 }
 
 Filter::FilterDecision LoggerMatchFilter::decide(
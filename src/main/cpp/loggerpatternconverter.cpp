@@ -54,6 +54,17 @@ void LoggerPatternConverter::format(
 	LogString& toAppendTo,
 	Pool& /* p */ ) const
 {
+	const LoggerPtr& logger = event->getLogger();
+
+	//
+	//   the logger keeps its abbreviated names
+	//
+	if (logger != 0)
+	{
+		logger->getAbbreviatedName(getNameAbbreviator(), toAppendTo);
+		return;
+	}
+
 	int initialLength = (int)toAppendTo.length();
 	toAppendTo.append(event->getLoggerName());
 	abbreviate(initialLength, toAppendTo);
@@ -30,6 +30,7 @@
 #include <log4cxxNG/helpers/transcoder.h>
 
 #include <apr_time.h>
+#include <apr_atomic.h>
 #include <apr_portable.h>
 #include <apr_strings.h>
 #include <log4cxxNG/helpers/stringhelper.h>
@@ -54,6 +55,8 @@ log4cxxng_time_t LoggingEvent::getStartTime()
 }
 
 LoggingEvent::LoggingEvent() :
+	loggerName(&ownedLoggerName),
+	pooled(false),
 	ndc(0),
 	mdcCopy(0),
 	properties(0),
@@ -67,7 +70,9 @@ LoggingEvent::LoggingEvent() :
 LoggingEvent::LoggingEvent(
 	const LogString& logger1, const LevelPtr& level1,
 	const LogString& message1, const LocationInfo& locationInfo1) :
-	logger(logger1),
+	loggerName(&ownedLoggerName),
+	ownedLoggerName(logger1),
+	pooled(false),
 	level(level1),
 	ndc(0),
 	mdcCopy(0),
@@ -77,8 +82,9 @@ LoggingEvent::LoggingEvent(
 	message(message1),
 	timeStamp(apr_time_now()),
 	locationInfo(locationInfo1),
-	threadName(getCurrentThreadName())
+	threadName()
 {
+	ThreadSpecificData::getThreadName(threadName);
 }
 
 LoggingEvent::~LoggingEvent()
@@ -88,6 +94,73 @@ LoggingEvent::~LoggingEvent()
 	delete properties;
 }
 
+LoggingEventPtr LoggingEvent::create(const Logger& logger1,
+	const LevelPtr& level1, const LogString& message1,
+	const LocationInfo& locationInfo1)
+{
+	LoggingEvent* event = obtain(logger1, level1, locationInfo1);
+	event->message.assign(message1);
+	return event;
+}
+
+LoggingEvent* LoggingEvent::obtain(const Logger& logger1,
+	const LevelPtr& level1, const LocationInfo& locationInfo1)
+{
+	LoggingEvent* event = ThreadSpecificData::takeEvent();
+
+	if (event == 0)
+	{
+		event = new LoggingEvent();
+		event->pooled = true;
+	}
+
+	event->loggerRef = const_cast<Logger*>(&logger1);
+	event->loggerName = &logger1.getName();
+	event->level = level1;
+	event->message.erase();
+	event->timeStamp = apr_time_now();
+	event->locationInfo = locationInfo1;
+	event->threadName.erase();
+	ThreadSpecificData::getThreadName(event->threadName);
+	return event;
+}
+
+void LoggingEvent::releaseRef() const
+{
+	if (apr_atomic_dec32(&ref) == 0)
+	{
+		if (!pooled || !const_cast<LoggingEvent*>(this)->recycle())
+		{
+			delete this;
+		}
+	}
+}
+
+bool LoggingEvent::recycle()
+{
+	delete ndc;
+	ndc = 0;
+	delete mdcCopy;
+	mdcCopy = 0;
+	delete properties;
+	properties = 0;
+	ndcLookupRequired = true;
+	mdcCopyLookupRequired = true;
+	level = 0;
+	loggerName = &ownedLoggerName;
+	loggerRef = 0;
+
+	//
+	//   do not keep the memory of an exceptionally long message
+	//
+	if (message.capacity() > ThreadSpecificData::MAX_MESSAGE_BUFFER_CAPACITY)
+	{
+		LogString().swap(message);
+	}
+
+	return ThreadSpecificData::cacheEvent(this);
+}
+
 bool LoggingEvent::getNDC(LogString& dest) const
 {
 	if (ndcLookupRequired)
@@ -132,6 +205,36 @@ bool LoggingEvent::getMDC(const LogString& key, LogString& dest) const
 
 }
 
+const LogString* LoggingEvent::findMDC(const LogString& key) const
+{
+	if (mdcCopy != 0 && !mdcCopy->empty())
+	{
+		MDC::Map::const_iterator it = mdcCopy->find(key);
+
+		if (it != mdcCopy->end() && !it->second.empty())
+		{
+			return &it->second;
+		}
+	}
+
+	ThreadSpecificData* data = ThreadSpecificData::getCurrentData();
+
+	if (data != 0)
+	{
+		MDC::Map& map = data->getMap();
+		MDC::Map::const_iterator it = map.find(key);
+
+		if (it != map.end())
+		{
+			return &it->second;
+		}
+
+		data->recycle();
+	}
+
+	return 0;
+}
+
 LoggingEvent::KeySet LoggingEvent::getMDCKeySet() const
 {
 	LoggingEvent::KeySet set;
@@ -201,6 +304,23 @@ bool LoggingEvent::getProperty(const LogString& key, LogString& dest) const
 	return false;
 }
 
+const LogString* LoggingEvent::findProperty(const LogString& key) const
+{
+	if (properties == 0)
+	{
+		return 0;
+	}
+
+	std::map<LogString, LogString>::const_iterator it = properties->find(key);
+
+	if (it != properties->end())
+	{
+		return &it->second;
+	}
+
+	return 0;
+}
+
 LoggingEvent::KeySet LoggingEvent::getPropertyKeySet() const
 {
 	LoggingEvent::KeySet set;
@@ -219,28 +339,6 @@ LoggingEvent::KeySet LoggingEvent::getPropertyKeySet() const
 }
 
 
-const LogString LoggingEvent::getCurrentThreadName()
-{
-#if APR_HAS_THREADS
-#if defined(_WIN32)
-	char result[20];
-	DWORD threadId = GetCurrentThreadId();
-	apr_snprintf(result, sizeof(result), LOG4CXXNG_WIN32_THREAD_FMTSPEC, threadId);
-#else
-	// apr_os_thread_t encoded in HEX takes needs as many characters
-	// as two times the size of the type, plus an additional null byte.
-	char result[sizeof(apr_os_thread_t) * 3 + 10];
-	apr_os_thread_t threadId = apr_os_thread_current();
-	apr_snprintf(result, sizeof(result), LOG4CXXNG_APR_THREAD_FMTSPEC, (void*) &threadId);
-#endif
-	LOG4CXXNG_DECODE_CHAR(str, (const char*) result);
-	return str;
-#else
-	return LOG4CXXNG_STR("0x00000000");
-#endif
-}
-
-
 void LoggingEvent::setProperty(const LogString& key, const LogString& value)
 {
 	if (properties == 0)
@@ -323,7 +421,7 @@ void LoggingEvent::write(helpers::ObjectOutputStream& os, Pool& p) const
 	char lookupsRequired[] = { 0, 0 };
 	os.writeBytes(lookupsRequired, sizeof(lookupsRequired), p);
 	os.writeLong(timeStamp / 1000, p);
-	os.writeObject(logger, p);
+	os.writeObject(*loggerName, p);
 	locationInfo.write(os, p);
 
 	if (mdcCopy == 0 || mdcCopy->size() == 0)
@@ -17,6 +17,11 @@
 
 #include <log4cxxNG/helpers/messagebuffer.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/threadspecificdata.h>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#include <locale>
 
 using namespace log4cxxng::helpers;
 
@@ -41,8 +46,80 @@ void ResetStream(std::basic_ostringstream<T>& stream)
 	stream.clear();
 }
 
-CharMessageBuffer::CharMessageBuffer() : stream(0)
+/**
+ *  True if numbers inserted into a new std::ostream would use
+ *  the classic locale, in which case they can be formatted here.
+ */
+static bool IsClassicLocale()
+{
+	return std::locale() == std::locale::classic();
+}
+
+/**
+ *  Formats the decimal digits of an integer backwards from end,
+ *  as std::ostream would with default flags.
+ *  @return the first character.
+ */
+template <typename T>
+char* FormatInteger(char* end, T val)
+{
+	char* begin = end;
+	bool negative = val < 0;
+	//
+	//   negate digit by digit so that the minimum value does not overflow
+	//
+	do
+	{
+		int digit = (int) (val % 10);
+		*--begin = (char) ('0' + (negative ? -digit : digit));
+		val /= 10;
+	}
+	while (val != 0);
+
+	if (negative)
+	{
+		*--begin = '-';
+	}
+
+	return begin;
+}
+
+/**
+ *  Formats a floating point value in the default std::ostream
+ *  notation, six significant digits and a '.' decimal point
+ *  whatever the C locale of the process.
+ *  @return the number of characters.
+ */
+static size_t FormatDouble(char* digits, size_t size, double val)
 {
+	int len = snprintf(digits, size, "%g", val);
+
+	if (len < 0 || (size_t) len >= size)
+	{
+		return 0;
+	}
+
+	const char* point = localeconv()->decimal_point;
+
+	if (point != 0 && strcmp(point, ".") != 0 && *point != 0)
+	{
+		char* found = strstr(digits, point);
+
+		if (found != 0)
+		{
+			size_t pointLen = strlen(point);
+			*found = '.';
+			memmove(found + 1, found + pointLen, len - (found - digits) - pointLen + 1);
+			len -= (int) (pointLen - 1);
+		}
+	}
+
+	return len;
+}
+
+CharMessageBuffer::CharMessageBuffer() : inlineLength(0), stream(0)
+{
+	ThreadSpecificData::takeMessageBuffer(buf);
 
 #if defined(STATIC_STRINGSTREAM)
 
@@ -72,13 +149,33 @@ CharMessageBuffer::~CharMessageBuffer()
 	{
 		delete stream;
 	}
+
+	ThreadSpecificData::cacheMessageBuffer(buf);
+}
+
+void CharMessageBuffer::append(const char* msg, size_t len)
+{
+	if (buf.empty() && inlineLength + len <= INLINE_CAPACITY)
+	{
+		memcpy(inlineBuf + inlineLength, msg, len);
+		inlineLength += len;
+		return;
+	}
+
+	if (inlineLength > 0)
+	{
+		buf.append(inlineBuf, inlineLength);
+		inlineLength = 0;
+	}
+
+	buf.append(msg, len);
 }
 
 CharMessageBuffer& CharMessageBuffer::operator<<(const std::basic_string<char>& msg)
 {
 	if (stream == 0)
 	{
-		buf.append(msg);
+		append(msg.data(), msg.length());
 	}
 	else
 	{
@@ -99,7 +196,7 @@ CharMessageBuffer& CharMessageBuffer::operator<<(const char* msg)
 
 	if (stream == 0)
 	{
-		buf.append(actualMsg);
+		append(actualMsg, strlen(actualMsg));
 	}
 	else
 	{
@@ -117,7 +214,7 @@ CharMessageBuffer& CharMessageBuffer::operator<<(const char msg)
 {
 	if (stream == 0)
 	{
-		buf.append(1, msg);
+		append(&msg, 1);
 	}
 	else
 	{
@@ -134,7 +231,12 @@ CharMessageBuffer::operator std::basic_ostream<char>& ()
 	{
 		stream = new std::basic_ostringstream<char>();
 
-		if (!buf.empty())
+		if (inlineLength > 0)
+		{
+			stream->write(inlineBuf, inlineLength);
+			inlineLength = 0;
+		}
+		else if (!buf.empty())
 		{
 			*stream << buf;
 		}
@@ -154,6 +256,17 @@ const std::basic_string<char>& CharMessageBuffer::str(std::basic_ostream<char>&)
 
 const std::basic_string<char>& CharMessageBuffer::str(CharMessageBuffer&)
 {
+	if (stream != 0)
+	{
+		return str(*stream);
+	}
+
+	if (inlineLength > 0)
+	{
+		buf.assign(inlineBuf, inlineLength);
+		inlineLength = 0;
+	}
+
 	return buf;
 }
 
@@ -162,44 +275,154 @@ bool CharMessageBuffer::hasStream() const
 	return (stream != 0);
 }
 
-std::ostream& CharMessageBuffer::operator<<(ios_base_manip manip)
+CharMessageBuffer& CharMessageBuffer::operator<<(ios_base_manip manip)
 {
 	std::ostream& s = *this;
 	(*manip)(s);
-	return s;
+	return *this;
 }
 
-std::ostream& CharMessageBuffer::operator<<(bool val)
+CharMessageBuffer& CharMessageBuffer::operator<<(std::ostream& (*manip)(std::ostream&))
 {
-	return ((std::ostream&) * this).operator << (val);
+	std::ostream& s = *this;
+	(*manip)(s);
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(short val)
+
+CharMessageBuffer& CharMessageBuffer::operator<<(bool val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	if (stream == 0)
+	{
+		append(val ? "1" : "0", 1);
+	}
+	else
+	{
+		*stream << val;
+	}
+
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(int val)
+CharMessageBuffer& CharMessageBuffer::operator<<(short val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	if (stream == 0 && IsClassicLocale())
+	{
+		char digits[3 * sizeof(val) + 2];
+		char* end = digits + sizeof(digits);
+		char* begin = FormatInteger(end, val);
+		append(begin, end - begin);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(unsigned int val)
+CharMessageBuffer& CharMessageBuffer::operator<<(int val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	if (stream == 0 && IsClassicLocale())
+	{
+		char digits[3 * sizeof(val) + 2];
+		char* end = digits + sizeof(digits);
+		char* begin = FormatInteger(end, val);
+		append(begin, end - begin);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(long val)
+CharMessageBuffer& CharMessageBuffer::operator<<(unsigned int val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	if (stream == 0 && IsClassicLocale())
+	{
+		char digits[3 * sizeof(val) + 2];
+		char* end = digits + sizeof(digits);
+		char* begin = FormatInteger(end, val);
+		append(begin, end - begin);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(unsigned long val)
+CharMessageBuffer& CharMessageBuffer::operator<<(long val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	if (stream == 0 && IsClassicLocale())
+	{
+		char digits[3 * sizeof(val) + 2];
+		char* end = digits + sizeof(digits);
+		char* begin = FormatInteger(end, val);
+		append(begin, end - begin);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(float val)
+CharMessageBuffer& CharMessageBuffer::operator<<(unsigned long val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	if (stream == 0 && IsClassicLocale())
+	{
+		char digits[3 * sizeof(val) + 2];
+		char* end = digits + sizeof(digits);
+		char* begin = FormatInteger(end, val);
+		append(begin, end - begin);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
 }
-std::ostream& CharMessageBuffer::operator<<(double val)
+CharMessageBuffer& CharMessageBuffer::operator<<(float val)
 {
-	return ((std::ostream&) * this).operator << (val);
+	char digits[64];
+	size_t len = 0;
+
+	if (stream == 0 && IsClassicLocale())
+	{
+		len = FormatDouble(digits, sizeof(digits), val);
+	}
+
+	if (len > 0)
+	{
+		append(digits, len);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
+}
+CharMessageBuffer& CharMessageBuffer::operator<<(double val)
+{
+	char digits[64];
+	size_t len = 0;
+
+	if (stream == 0 && IsClassicLocale())
+	{
+		len = FormatDouble(digits, sizeof(digits), val);
+	}
+
+	if (len > 0)
+	{
+		append(digits, len);
+	}
+	else
+	{
+		((std::ostream&) * this) << val;
+	}
+
+	return *this;
 }
 std::ostream& CharMessageBuffer::operator<<(long double val)
 {
@@ -407,11 +630,14 @@ bool MessageBuffer::hasStream() const
 	return retval;
 }
 
-std::ostream& MessageBuffer::operator<<(ios_base_manip manip)
+CharMessageBuffer& MessageBuffer::operator<<(ios_base_manip manip)
 {
-	std::ostream& s = *this;
-	(*manip)(s);
-	return s;
+	return cbuf.operator << (manip);
+}
+
+CharMessageBuffer& MessageBuffer::operator<<(std::ostream& (*manip)(std::ostream&))
+{
+	return cbuf.operator << (manip);
 }
 
 MessageBuffer::operator std::ostream& ()
@@ -481,35 +707,35 @@ const std::wstring& MessageBuffer::str(std::basic_ostream<wchar_t>& os)
 	return wbuf->str(os);
 }
 
-std::ostream& MessageBuffer::operator<<(bool val)
+CharMessageBuffer& MessageBuffer::operator<<(bool val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(short val)
+CharMessageBuffer& MessageBuffer::operator<<(short val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(int val)
+CharMessageBuffer& MessageBuffer::operator<<(int val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(unsigned int val)
+CharMessageBuffer& MessageBuffer::operator<<(unsigned int val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(long val)
+CharMessageBuffer& MessageBuffer::operator<<(long val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(unsigned long val)
+CharMessageBuffer& MessageBuffer::operator<<(unsigned long val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(float val)
+CharMessageBuffer& MessageBuffer::operator<<(float val)
 {
 	return cbuf.operator << (val);
 }
-std::ostream& MessageBuffer::operator<<(double val)
+CharMessageBuffer& MessageBuffer::operator<<(double val)
 {
 	return cbuf.operator << (val);
 }
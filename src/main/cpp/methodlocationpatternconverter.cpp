@@ -50,5 +50,5 @@ void MethodLocationPatternConverter::format(
 	LogString& toAppendTo,
 	Pool& /* p */ ) const
 {
-	append(toAppendTo, event->getLocationInformation().getMethodName());
+	event->getLocationInformation().getMethodName(toAppendTo);
 }
@@ -0,0 +1,290 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/filter/multistringmatchfilter.h>
+#include <log4cxxNG/filter/stringmatchfilter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <algorithm>
+#include <deque>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(MultiStringMatchFilter)
+
+MultiStringMatchFilter::MultiStringMatchFilter() :
+	needles(),
+	wideClass(),
+	classCount(1),
+	transitions(1, 0),
+	firstMatch(1, 0)
+{
+	std::fill(narrowClass, narrowClass + 256, 0u);
+}
+
+void MultiStringMatchFilter::setOption(const LogString& option,
+	const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("STRINGTOACCEPT"), LOG4CXXNG_STR("stringtoaccept")))
+	{
+		addString(value, true);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("STRINGTODENY"), LOG4CXXNG_STR("stringtodeny")))
+	{
+		addString(value, false);
+	}
+}
+
+void MultiStringMatchFilter::addString(const LogString& stringToMatch,
+	bool acceptOnMatch)
+{
+	if (stringToMatch.empty())
+	{
+		return;
+	}
+
+	Needle needle;
+	needle.text = stringToMatch;
+	needle.acceptOnMatch = acceptOnMatch;
+	needles.push_back(needle);
+	build();
+	changed();
+}
+
+unsigned int MultiStringMatchFilter::classOf(logchar c) const
+{
+	unsigned long code = (unsigned long) c;
+
+	if (sizeof(logchar) == 1)
+	{
+		code &= 0xFF;
+	}
+
+	if (code < 256)
+	{
+		return narrowClass[code];
+	}
+
+	std::vector<std::pair<logchar, unsigned int> >::const_iterator iter =
+		std::lower_bound(wideClass.begin(), wideClass.end(),
+			std::make_pair(c, 0u));
+
+	if (iter != wideClass.end() && iter->first == c)
+	{
+		return iter->second;
+	}
+
+	return 0;
+}
+
+void MultiStringMatchFilter::build()
+{
+	//
+	//   Characters that occur in no string share column 0,
+	//      which always leads back to the root.
+	//
+	std::fill(narrowClass, narrowClass + 256, 0u);
+	wideClass.clear();
+	classCount = 1;
+
+	for (std::vector<Needle>::const_iterator needle = needles.begin();
+		needle != needles.end();
+		needle++)
+	{
+		for (LogString::const_iterator iter = needle->text.begin();
+			iter != needle->text.end();
+			iter++)
+		{
+			if (classOf(*iter) != 0)
+			{
+				continue;
+			}
+
+			unsigned long code = (unsigned long) *iter;
+
+			if (sizeof(logchar) == 1)
+			{
+				code &= 0xFF;
+			}
+
+			if (code < 256)
+			{
+				narrowClass[code] = classCount++;
+			}
+			else
+			{
+				std::pair<logchar, unsigned int> entry(*iter, classCount++);
+				wideClass.insert(std::lower_bound(wideClass.begin(),
+						wideClass.end(), entry), entry);
+			}
+		}
+	}
+
+	const unsigned int none = (unsigned int) needles.size();
+	transitions.assign(classCount, 0);
+	firstMatch.assign(1, none);
+
+	//
+	//   Build the trie, 0 marks a missing edge.
+	//
+	for (unsigned int i = 0; i < needles.size(); i++)
+	{
+		unsigned int state = 0;
+
+		for (LogString::const_iterator iter = needles[i].text.begin();
+			iter != needles[i].text.end();
+			iter++)
+		{
+			unsigned int slot = state * classCount + classOf(*iter);
+
+			if (transitions[slot] == 0)
+			{
+				transitions[slot] = (unsigned int) firstMatch.size();
+				transitions.resize(transitions.size() + classCount, 0);
+				firstMatch.push_back(none);
+			}
+
+			state = transitions[slot];
+		}
+
+		firstMatch[state] = std::min(firstMatch[state], i);
+	}
+
+	//
+	//   Breadth first, resolve failure links into the table so that
+	//      every state has a transition for every column.
+	//
+	std::vector<unsigned int> failure(firstMatch.size(), 0);
+	std::deque<unsigned int> queue;
+
+	for (unsigned int c = 0; c < classCount; c++)
+	{
+		if (transitions[c] != 0)
+		{
+			queue.push_back(transitions[c]);
+		}
+	}
+
+	while (!queue.empty())
+	{
+		unsigned int state = queue.front();
+		queue.pop_front();
+		firstMatch[state] = std::min(firstMatch[state],
+				firstMatch[failure[state]]);
+
+		for (unsigned int c = 0; c < classCount; c++)
+		{
+			unsigned int slot = state * classCount + c;
+			unsigned int fallback = transitions[failure[state] * classCount + c];
+
+			if (transitions[slot] != 0)
+			{
+				failure[transitions[slot]] = fallback;
+				queue.push_back(transitions[slot]);
+			}
+			else
+			{
+				transitions[slot] = fallback;
+			}
+		}
+	}
+}
+
+Filter::FilterDecision MultiStringMatchFilter::decide(
+	const log4cxxng::spi::LoggingEventPtr& event) const
+{
+	const LogString& msg = event->getRenderedMessage();
+
+	if (msg.empty() || needles.empty())
+	{
+		return Filter::NEUTRAL;
+	}
+
+	unsigned int match = (unsigned int) needles.size();
+
+	if (needles.size() == 1)
+	{
+		if (msg.find(needles[0].text) != LogString::npos)
+		{
+			match = 0;
+		}
+	}
+	else
+	{
+		unsigned int state = 0;
+
+		for (LogString::const_iterator iter = msg.begin();
+			iter != msg.end() && match != 0;
+			iter++)
+		{
+			state = transitions[state * classCount + classOf(*iter)];
+
+			if (firstMatch[state] < match)
+			{
+				match = firstMatch[state];
+			}
+		}
+	}
+
+	if (match == needles.size())
+	{
+		return Filter::NEUTRAL;
+	}
+
+	return needles[match].acceptOnMatch ? Filter::ACCEPT : Filter::DENY;
+}
+
+void MultiStringMatchFilter::compile(std::vector<FilterPtr>& filters)
+{
+	std::vector<FilterPtr> compiled;
+	std::vector<FilterPtr>::const_iterator iter = filters.begin();
+
+	while (iter != filters.end())
+	{
+		std::vector<FilterPtr>::const_iterator end = iter;
+
+		while (end != filters.end() && *end != 0
+			&& &(*end)->getClass() == &StringMatchFilter::getStaticClass())
+		{
+			end++;
+		}
+
+		if (end - iter < 2)
+		{
+			compiled.push_back(*iter++);
+			continue;
+		}
+
+		MultiStringMatchFilterPtr multi(new MultiStringMatchFilter());
+
+		for (; iter != end; iter++)
+		{
+			StringMatchFilterPtr single(*iter);
+			multi->addString(single->getStringToMatch(), single->getAcceptOnMatch());
+		}
+
+		compiled.push_back(multi);
+	}
+
+	filters.swap(compiled);
+}
@@ -20,6 +20,7 @@
 #include <log4cxxNG/helpers/stringhelper.h>
 #include <vector>
 #include <limits.h>
+#include <apr_atomic.h>
 
 using namespace log4cxxng;
 using namespace log4cxxng::pattern;
@@ -27,7 +28,7 @@ using namespace log4cxxng::helpers;
 
 IMPLEMENT_LOG4CXXNG_OBJECT(NameAbbreviator)
 
-NameAbbreviator::NameAbbreviator()
+NameAbbreviator::NameAbbreviator() : cacheSlot(-1)
 {
 }
 
@@ -291,7 +292,9 @@ NameAbbreviatorPtr NameAbbreviator::getAbbreviator(const LogString& pattern)
 		//
 		if (i == trimmed.length())
 		{
-			return new MaxElementAbbreviator(StringHelper::toInt(trimmed));
+			NameAbbreviatorPtr abbrev(new MaxElementAbbreviator(StringHelper::toInt(trimmed)));
+			abbrev->cacheSlot = getCacheSlot(trimmed);
+			return abbrev;
 		}
 
 		std::vector<PatternAbbreviatorFragment> fragments;
@@ -346,6 +349,7 @@ NameAbbreviatorPtr NameAbbreviator::getAbbreviator(const LogString& pattern)
 		}
 
 		NameAbbreviatorPtr abbrev(new PatternAbbreviator(fragments));
+		abbrev->cacheSlot = getCacheSlot(trimmed);
 		return abbrev;
 	}
 
@@ -355,6 +359,48 @@ NameAbbreviatorPtr NameAbbreviator::getAbbreviator(const LogString& pattern)
 	return getDefaultAbbreviator();
 }
 
+/**
+ * Gets the cache slot of an abbreviation pattern, assigning
+ * slots to the first MAX_CACHE_SLOTS patterns seen.
+ *
+ * @param pattern trimmed abbreviation pattern.
+ * @return slot or -1 if all slots are in use.
+ */
+int NameAbbreviator::getCacheSlot(const LogString& pattern)
+{
+	//
+	//   slots are never released, a pattern claimed concurrently by
+	//      two threads may occupy two slots
+	//
+	static void* volatile patterns[MAX_CACHE_SLOTS];
+
+	for (int i = 0; i < MAX_CACHE_SLOTS; i++)
+	{
+		const LogString* slotPattern = (const LogString*) patterns[i];
+
+		if (slotPattern == 0)
+		{
+			LogString* newPattern = new LogString(pattern);
+			slotPattern = (const LogString*) apr_atomic_casptr(
+					(volatile void**) &patterns[i], newPattern, 0);
+
+			if (slotPattern == 0)
+			{
+				return i;
+			}
+
+			delete newPattern;
+		}
+
+		if (*slotPattern == pattern)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
 /**
  * Gets default abbreviator.
  *
@@ -19,8 +19,10 @@
 #include <log4cxxNG/helpers/optionconverter.h>
 #include <log4cxxNG/helpers/stringhelper.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/synchronized.h>
 #include <log4cxxNG/patternlayout.h>
 #include <apr_strings.h>
+#include <string.h>
 
 #if !defined(LOG4CXXNG)
 	#define LOG4CXXNG 1
@@ -39,6 +41,40 @@ using namespace log4cxxng::helpers;
 using namespace log4cxxng::db;
 using namespace log4cxxng::spi;
 
+/**
+ *  Number of full buffers that may wait for the flusher thread.
+ */
+static const size_t MAX_PENDING_BUFFERS = 4;
+
+/**
+ *  Appends "name=value" to an ODBC connection string, braced
+ *  so that the value may contain ';' or '}'.
+ */
+static void appendAttribute(LogString& connectionString,
+	const LogString& name, const LogString& value)
+{
+	if (!connectionString.empty()
+		&& connectionString[connectionString.size() - 1] != LOG4CXXNG_STR(';'))
+	{
+		connectionString.append(1, LOG4CXXNG_STR(';'));
+	}
+
+	connectionString.append(name);
+	connectionString.append(LOG4CXXNG_STR("={"));
+
+	for (LogString::const_iterator i = value.begin(); i != value.end(); i++)
+	{
+		if (*i == LOG4CXXNG_STR('}'))
+		{
+			connectionString.append(1, LOG4CXXNG_STR('}'));
+		}
+
+		connectionString.append(1, *i);
+	}
+
+	connectionString.append(1, LOG4CXXNG_STR('}'));
+}
+
 SQLException::SQLException(short fHandleType,
 	void* hInput, const char* prolog,
 	log4cxxng::helpers::Pool& p)
@@ -93,7 +129,8 @@ IMPLEMENT_LOG4CXXNG_OBJECT(ODBCAppender)
 
 
 ODBCAppender::ODBCAppender()
-	: connection(0), env(0), bufferSize(1)
+	: connection(0), env(0), bufferSize(1), preparedStatement(0),
+	  flushMutex(pool), flushCondition(pool), flushRequested(false), stopping(false), blocking(true)
 {
 }
 
@@ -122,10 +159,18 @@ void ODBCAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setURL(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("COLUMNMAPPING"), LOG4CXXNG_STR("columnmapping")))
+	{
+		addColumnMapping(value);
+	}
 	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("USER"), LOG4CXXNG_STR("user")))
 	{
 		setUser(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("BLOCKING"), LOG4CXXNG_STR("blocking")))
+	{
+		setBlocking(OptionConverter::toBoolean(value, true));
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -136,6 +181,13 @@ void ODBCAppender::activateOptions(log4cxxng::helpers::Pool&)
 {
 #if !LOG4CXXNG_HAVE_ODBC
 	LogLog::error(LOG4CXXNG_STR("Can not activate ODBCAppender unless compiled with ODBC support."));
+#else
+
+	if (!columns.empty())
+	{
+		startFlusher();
+	}
+
 #endif
 }
 
@@ -143,10 +195,51 @@ void ODBCAppender::activateOptions(log4cxxng::helpers::Pool&)
 void ODBCAppender::append(const spi::LoggingEventPtr& event, log4cxxng::helpers::Pool& p)
 {
 #if LOG4CXXNG_HAVE_ODBC
+#if APR_HAS_THREADS
+
+	if (flusher.isAlive())
+	{
+		// The event is formatted on the flusher thread, so capture
+		// the context of this one now.
+		LogString ndc;
+		event->getNDC(ndc);
+		event->getThreadName();
+		event->getMDCCopy();
+	}
+
+#endif
 	buffer.push_back(event);
 
 	if (buffer.size() >= bufferSize)
 	{
+#if APR_HAS_THREADS
+
+		if (flusher.isAlive())
+		{
+			synchronized sync(flushMutex);
+
+			//  Hold at most MAX_PENDING_BUFFERS full buffers for
+			//  the flusher, so a slow database cannot grow the list.
+			while (blocking && !stopping
+				&& pending.size() >= MAX_PENDING_BUFFERS * bufferSize)
+			{
+				flushCondition.await(flushMutex);
+			}
+
+			if (pending.size() >= MAX_PENDING_BUFFERS * bufferSize)
+			{
+				metrics.add(AppenderMetrics::DISCARDED, buffer.size());
+				buffer.clear();
+				return;
+			}
+
+			pending.splice(pending.end(), buffer);
+			flushRequested = true;
+			flushCondition.signalAll();
+			return;
+		}
+
+#endif
 		flushBuffer(p);
 	}
 
@@ -204,6 +297,163 @@ void ODBCAppender::execute(const LogString& sql, log4cxxng::helpers::Pool& p)
 #endif
 }
 
+void ODBCAppender::executeBatch(const std::list<spi::LoggingEventPtr>& events, log4cxxng::helpers::Pool& p)
+{
+#if LOG4CXXNG_HAVE_ODBC
+	SQLRETURN ret;
+	SQLHDBC con = getConnection(p);
+
+	if (preparedStatement == SQL_NULL_HSTMT)
+	{
+		SQLHSTMT stmt = SQL_NULL_HSTMT;
+		ret = SQLAllocHandle(SQL_HANDLE_STMT, con, &stmt);
+
+		if (ret < 0)
+		{
+			throw SQLException(SQL_HANDLE_DBC, con, "Failed to allocate sql handle.", p);
+		}
+
+		SQLWCHAR* wsql;
+		encode(&wsql, sqlStatement, p);
+		ret = SQLPrepareW(stmt, wsql, SQL_NTS);
+
+		if (ret < 0)
+		{
+			SQLException ex(SQL_HANDLE_STMT, stmt, "Failed to prepare sql statement.", p);
+			SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+			throw ex;
+		}
+
+		preparedStatement = stmt;
+	}
+
+	SQLHSTMT stmt = preparedStatement;
+	const size_t rows = events.size();
+	const size_t columnCount = columns.size();
+
+	if (rows == 0)
+	{
+		return;
+	}
+
+	//  Format every value first so that each column can be laid out
+	//  as one array of fixed width elements.
+	std::vector<SQLWCHAR*> values(rows * columnCount);
+	std::vector<size_t> widths(columnCount, 1);
+	size_t row = 0;
+
+	for (std::list<LoggingEventPtr>::const_iterator i = events.begin();
+		i != events.end(); i++, row++)
+	{
+		for (size_t col = 0; col < columnCount; col++)
+		{
+			LogString value;
+			columns[col]->format(value, *i, p);
+			SQLWCHAR* wvalue;
+			encode(&wvalue, value, p);
+			size_t len = 0;
+
+			while (wvalue[len] != 0)
+			{
+				len++;
+			}
+
+			if (len + 1 > widths[col])
+			{
+				widths[col] = len + 1;
+			}
+
+			values[row * columnCount + col] = wvalue;
+		}
+	}
+
+	std::vector<SQLWCHAR*> arrays(columnCount);
+	SQLLEN* indicators = (SQLLEN*) p.palloc(rows * columnCount * sizeof(SQLLEN));
+
+	for (size_t col = 0; col < columnCount; col++)
+	{
+		arrays[col] = (SQLWCHAR*) p.palloc(rows * widths[col] * sizeof(SQLWCHAR));
+
+		for (row = 0; row < rows; row++)
+		{
+			const SQLWCHAR* src = values[row * columnCount + col];
+			SQLWCHAR* dest = arrays[col] + row * widths[col];
+			size_t len = 0;
+
+			while (src[len] != 0)
+			{
+				len++;
+			}
+
+			memcpy(dest, src, (len + 1) * sizeof(SQLWCHAR));
+			indicators[col * rows + row] = SQL_NTS;
+		}
+	}
+
+	//  Column-wise binding of all rows at once; drivers that refuse
+	//  parameter arrays are given one row per execution instead.
+	//  The prepared statement is reused, so the set size is
+	//  always written: a smaller batch must not read past its arrays.
+	size_t perExecute = rows;
+
+	if (rows == 1
+		|| SQLSetStmtAttr(stmt, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0) < 0
+		|| SQLSetStmtAttr(stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) rows, 0) < 0)
+	{
+		perExecute = 1;
+	}
+
+	if (perExecute == 1)
+	{
+		ret = SQLSetStmtAttr(stmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+
+		if (ret < 0)
+		{
+			SQLException ex(SQL_HANDLE_STMT, stmt, "Failed to set sql parameter set size.", p);
+			SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+			preparedStatement = SQL_NULL_HSTMT;
+			throw ex;
+		}
+	}
+
+	for (row = 0; row < rows; row += perExecute)
+	{
+		for (size_t col = 0; col < columnCount; col++)
+		{
+			ret = SQLBindParameter(stmt, (SQLUSMALLINT) (col + 1), SQL_PARAM_INPUT,
+					SQL_C_WCHAR, SQL_WVARCHAR, widths[col] - 1, 0,
+					arrays[col] + row * widths[col], widths[col] * sizeof(SQLWCHAR),
+					indicators + col * rows + row);
+
+			if (ret < 0)
+			{
+				SQLException ex(SQL_HANDLE_STMT, stmt, "Failed to bind sql parameter.", p);
+				SQLFreeStmt(stmt, SQL_RESET_PARAMS);
+				throw ex;
+			}
+		}
+
+		ret = SQLExecute(stmt);
+
+		if (ret < 0)
+		{
+			//  The statement may have been invalidated, for instance by
+			//  a lost connection, so prepare it again on the next batch.
+			SQLException ex(SQL_HANDLE_STMT, stmt, "Failed to execute prepared sql statement.", p);
+			SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+			preparedStatement = SQL_NULL_HSTMT;
+			throw ex;
+		}
+	}
+
+	// The bound arrays live in p, so do not leave them attached.
+	SQLFreeStmt(stmt, SQL_RESET_PARAMS);
+	closeConnection(con);
+#else
+	throw SQLException("log4cxx build without ODBC support");
+#endif
+}
+
 /* The default behavior holds a single connection open until the appender
 is closed (typically when garbage collected).*/
 void ODBCAppender::closeConnection(ODBCAppender::SQLHDBC /* con */)
@@ -258,10 +508,35 @@ ODBCAppender::SQLHDBC ODBCAppender::getConnection(log4cxxng::helpers::Pool& p)
 		encode(&wUser, databaseUser, p);
 		encode(&wPwd, databasePassword, p);
 
-		ret = SQLConnectW( connection,
-				wURL, SQL_NTS,
-				wUser, SQL_NTS,
-				wPwd, SQL_NTS);
+		//  A URL with attribute pairs, eg: Driver=SQLite3;Database=:memory:
+		//  is a connection string rather than a data source name.
+		if (databaseURL.find(LOG4CXXNG_STR('=')) != LogString::npos)
+		{
+			LogString connectionString(databaseURL);
+
+			if (!databaseUser.empty())
+			{
+				appendAttribute(connectionString, LOG4CXXNG_STR("UID"), databaseUser);
+			}
+
+			if (!databasePassword.empty())
+			{
+				appendAttribute(connectionString, LOG4CXXNG_STR("PWD"), databasePassword);
+			}
+
+			SQLWCHAR* wConnectionString;
+			encode(&wConnectionString, connectionString, p);
+			ret = SQLDriverConnectW( connection, 0,
+					wConnectionString, SQL_NTS,
+					0, 0, 0, SQL_DRIVER_NOPROMPT);
+		}
+		else
+		{
+			ret = SQLConnectW( connection,
+					wURL, SQL_NTS,
+					wUser, SQL_NTS,
+					wPwd, SQL_NTS);
+		}
 
 
 		if (ret < 0)
@@ -286,6 +561,7 @@ void ODBCAppender::close()
 		return;
 	}
 
+	stopFlusher();
 	Pool p;
 
 	try
@@ -300,6 +576,12 @@ void ODBCAppender::close()
 
 #if LOG4CXXNG_HAVE_ODBC
 
+	if (preparedStatement != SQL_NULL_HSTMT)
+	{
+		SQLFreeHandle(SQL_HANDLE_STMT, preparedStatement);
+		preparedStatement = SQL_NULL_HSTMT;
+	}
+
 	if (connection != SQL_NULL_HDBC)
 	{
 		SQLDisconnect(connection);
@@ -317,9 +599,30 @@ void ODBCAppender::close()
 
 void ODBCAppender::flushBuffer(Pool& p)
 {
+	flushEvents(buffer, p);
+}
+
+void ODBCAppender::flushEvents(std::list<spi::LoggingEventPtr>& events, Pool& p)
+{
+	if (!columns.empty())
+	{
+		try
+		{
+			executeBatch(events, p);
+		}
+		catch (SQLException& e)
+		{
+			errorHandler->error(LOG4CXXNG_STR("Failed to execute sql"), e,
+				ErrorCode::FLUSH_FAILURE);
+		}
+
+		events.clear();
+		return;
+	}
+
 	std::list<spi::LoggingEventPtr>::iterator i;
 
-	for (i = buffer.begin(); i != buffer.end(); i++)
+	for (i = events.begin(); i != events.end(); i++)
 	{
 		try
 		{
@@ -335,7 +638,86 @@ void ODBCAppender::flushBuffer(Pool& p)
 	}
 
 	// clear the buffer of reported events
-	buffer.clear();
+	events.clear();
+}
+
+void ODBCAppender::startFlusher()
+{
+#if APR_HAS_THREADS
+
+	if (!flusher.isAlive())
+	{
+		stopping = false;
+		flusher.run(flushLoop, this);
+	}
+
+#endif
+}
+
+void ODBCAppender::stopFlusher()
+{
+#if APR_HAS_THREADS
+
+	if (flusher.isAlive())
+	{
+		{
+			synchronized sync(flushMutex);
+			stopping = true;
+			flushCondition.signalAll();
+		}
+
+		try
+		{
+			flusher.join();
+		}
+		catch (InterruptedException& e)
+		{
+			Thread::currentThreadInterrupt();
+			LogLog::error(LOG4CXXNG_STR("Got an InterruptedException while waiting for the ODBC flusher to finish,"), e);
+		}
+	}
+
+#endif
+}
+
+#if APR_HAS_THREADS
+void* LOG4CXXNG_THREAD_FUNC ODBCAppender::flushLoop(apr_thread_t* /* thread */, void* data)
+{
+	ODBCAppender* pThis = (ODBCAppender*) data;
+	bool active = true;
+
+	while (active)
+	{
+		std::list<LoggingEventPtr> events;
+		{
+			synchronized sync(pThis->flushMutex);
+
+			while (!pThis->flushRequested && !pThis->stopping)
+			{
+				pThis->flushCondition.await(pThis->flushMutex);
+			}
+
+			events.swap(pThis->pending);
+			pThis->flushRequested = false;
+			active = !pThis->stopping;
+			//  wake any logging thread waiting for room in pending
+			pThis->flushCondition.signalAll();
+		}
+
+		if (!events.empty())
+		{
+			Pool p;
+			pThis->flushEvents(events, p);
+		}
+	}
+
+	return 0;
+}
+#endif
+
+void ODBCAppender::addColumnMapping(const LogString& pattern)
+{
+	columns.push_back(new PatternLayout(pattern));
 }
 
 void ODBCAppender::setSql(const LogString& s)
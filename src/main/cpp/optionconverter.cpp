@@ -33,6 +33,7 @@
 #include <log4cxxNG/helpers/loader.h>
 #include <log4cxxNG/helpers/system.h>
 #include <log4cxxNG/propertyconfigurator.h>
+#include <log4cxxNG/snapshotconfigurator.h>
 #include <log4cxxNG/helpers/transcoder.h>
 #include <log4cxxNG/file.h>
 #include <log4cxxNG/xml/domconfigurator.h>
@@ -391,6 +392,12 @@ void OptionConverter::selectAndConfigure(const File& configFileName,
 		clazz = log4cxxng::xml::DOMConfigurator::getStaticClass().toString();
 	}
 
+	if (clazz.empty()
+		&& StringHelper::endsWith(filename, LOG4CXXNG_STR(".snapshot")))
+	{
+		clazz = SnapshotConfigurator::getStaticClass().toString();
+	}
+
 	if (!clazz.empty())
 	{
 		LogLog::debug(LOG4CXXNG_STR("Preferred configurator class: ") + clazz);
@@ -69,14 +69,32 @@ void OutputStreamWriter::write(const LogString& str, Pool& p)
 {
 	if (str.length() > 0)
 	{
+		enum { BUFSIZE = 1024, MAX_STAGING = 8 * 1024 * 1024 };
 #ifdef LOG4CXXNG_MULTI_PROCESS
 		size_t bufSize = str.length() * 2;
-		char* rawbuf = new char[bufSize];
-		ByteBuffer buf(rawbuf, (size_t) bufSize);
+		ByteBuffer buf(staging.reserve(bufSize), bufSize);
 #else
-		enum { BUFSIZE = 1024 };
 		char rawbuf[BUFSIZE];
-		ByteBuffer buf(rawbuf, (size_t) BUFSIZE);
+		char* bytes = rawbuf;
+		size_t bufSize = BUFSIZE;
+
+		//
+		//   encode long strings in one piece so they reach
+		//      the stream in as few writes as possible
+		//
+		if (str.length() > BUFSIZE)
+		{
+			bufSize = str.length() * 2;
+
+			if (bufSize > MAX_STAGING)
+			{
+				bufSize = MAX_STAGING;
+			}
+
+			bytes = staging.reserve(bufSize);
+		}
+
+		ByteBuffer buf(bytes, bufSize);
 #endif
 		enc->reset();
 		LogString::const_iterator iter = str.begin();
@@ -93,8 +111,18 @@ void OutputStreamWriter::write(const LogString& str, Pool& p)
 		enc->flush(buf);
 		buf.flip();
 		out->write(buf, p);
+
 #ifdef LOG4CXXNG_MULTI_PROCESS
-		delete []rawbuf;
+
+		//
+		//   the whole message is staged for a single write, so only
+		//      the memory of an exceptionally long message is given back
+		//
+		if (staging.capacity() > MAX_STAGING)
+		{
+			staging.release();
+		}
+
 #endif
 	}
 }
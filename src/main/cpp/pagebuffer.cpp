@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/helpers/pagebuffer.h>
+#include <log4cxxNG/private/log4cxxNG_private.h>
+#if LOG4CXXNG_HAVE_MADVISE
+	#include <sys/mman.h>
+#endif
+
+using namespace log4cxxng::helpers;
+
+PageBuffer::PageBuffer() : base(0), size(0), mapped(false)
+{
+}
+
+PageBuffer::~PageBuffer()
+{
+	release();
+}
+
+void PageBuffer::release()
+{
+#if LOG4CXXNG_HAVE_MADVISE
+
+	if (mapped)
+	{
+		munmap(base, size);
+	}
+	else
+#endif
+	{
+		delete [] base;
+	}
+
+	base = 0;
+	size = 0;
+	mapped = false;
+}
+
+char* PageBuffer::reserve(size_t capacity)
+{
+	if (capacity <= size)
+	{
+		return base;
+	}
+
+	//
+	//   grow geometrically so a slowly increasing demand
+	//      does not reallocate every time
+	//
+	if (capacity < size * 2)
+	{
+		capacity = size * 2;
+	}
+
+	release();
+#if LOG4CXXNG_HAVE_MADVISE && defined(MADV_HUGEPAGE)
+
+	if (capacity >= HUGE_PAGE_SIZE)
+	{
+		size_t length = (capacity + HUGE_PAGE_SIZE - 1) & ~((size_t) HUGE_PAGE_SIZE - 1);
+
+		//
+		//   map one huge page more than needed and
+		//      trim both ends to align the buffer
+		//
+		void* region = mmap(0, length + HUGE_PAGE_SIZE,
+				PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (region != MAP_FAILED)
+		{
+			char* start = (char*) region;
+			char* aligned = (char*) (((size_t) start + HUGE_PAGE_SIZE - 1)
+					& ~((size_t) HUGE_PAGE_SIZE - 1));
+
+			if (aligned > start)
+			{
+				munmap(start, aligned - start);
+			}
+
+			if (start + HUGE_PAGE_SIZE > aligned)
+			{
+				munmap(aligned + length, start + HUGE_PAGE_SIZE - aligned);
+			}
+
+			//
+			//   advice only, the buffer works with normal pages too
+			//
+			madvise(aligned, length, MADV_HUGEPAGE);
+			base = aligned;
+			size = length;
+			mapped = true;
+			return base;
+		}
+	}
+
+#endif
+	base = new char[capacity];
+	size = capacity;
+	return base;
+}
@@ -31,6 +31,7 @@
 #include <log4cxxNG/layout.h>
 #include <log4cxxNG/config/propertysetter.h>
 #include <log4cxxNG/spi/loggerrepository.h>
+#include <log4cxxNG/spi/reconfiguration.h>
 #include <log4cxxNG/helpers/stringtokenizer.h>
 #include <log4cxxNG/helpers/synchronized.h>
 #include <apr_file_io.h>
@@ -38,6 +39,7 @@
 #include <apr_pools.h>
 #include <log4cxxNG/helpers/transcoder.h>
 #include <log4cxxNG/helpers/fileinputstream.h>
+#include <algorithm>
 
 #define LOG4CXXNG 1
 #include <log4cxxNG/helpers/aprinitializer.h>
@@ -79,8 +81,39 @@ PropertyWatchdog* PropertyConfigurator::pdog = NULL;
 
 IMPLEMENT_LOG4CXXNG_OBJECT(PropertyConfigurator)
 
+namespace
+{
+/**
+Describes everything an appender is built from: its class, layout,
+filters and options, with variables substituted.
+*/
+LogString appenderSignature(Properties& props, const LogString& prefix)
+{
+	std::vector<LogString> names(props.propertyNames());
+	std::sort(names.begin(), names.end());
+	LogString signature;
+
+	for (std::vector<LogString>::const_iterator it = names.begin(); it != names.end(); ++it)
+	{
+		if (*it == prefix
+			|| (it->size() > prefix.size()
+				&& it->compare(0, prefix.size(), prefix) == 0
+				&& (*it)[prefix.size()] == 0x2E /* '.' */))
+		{
+			signature.append(*it);
+			signature.append(1, (logchar) 0x3D /* '=' */);
+			signature.append(OptionConverter::findAndSubst(*it, props));
+			signature.append(1, (logchar) 0x0A /* '\n' */);
+		}
+	}
+
+	return signature;
+}
+}
+
 PropertyConfigurator::PropertyConfigurator()
-	: registry(new std::map<LogString, AppenderPtr>()), loggerFactory(new DefaultLoggerFactory())
+	: registry(new std::map<LogString, AppenderPtr>()), loggerFactory(new DefaultLoggerFactory()),
+	  reconfiguration(0)
 {
 }
 
@@ -196,9 +229,27 @@ void PropertyConfigurator::doConfigure(helpers::Properties& properties,
 		MessageBufferUseStaticStream();
 	}
 
-	configureRootLogger(properties, hierarchy);
-	configureLoggerFactory(properties);
-	parseCatsAndRenderers(properties, hierarchy);
+	// Loggers and appenders are staged off to the side and published in
+	// one step, so that logging threads never see a half built
+	// configuration and unchanged appenders are not reopened.
+	Reconfiguration staged(hierarchy);
+	reconfiguration = &staged;
+
+	try
+	{
+		configureRootLogger(properties, hierarchy);
+		configureLoggerFactory(properties);
+		parseCatsAndRenderers(properties, hierarchy);
+	}
+	catch (...)
+	{
+		reconfiguration = 0;
+		registry->clear();
+		throw;
+	}
+
+	reconfiguration = 0;
+	staged.commit();
 
 	LogLog::debug(LOG4CXXNG_STR("Finished configuring."));
 
@@ -253,8 +304,6 @@ void PropertyConfigurator::configureRootLogger(helpers::Properties& props,
 	else
 	{
 		LoggerPtr root = hierarchy->getRootLogger();
-
-		LOCK_W sync(root->getMutex());
 		static const LogString INTERNAL_ROOT_NAME(LOG4CXXNG_STR("root"));
 		parseLogger(props, root, effectiveFrefix, INTERNAL_ROOT_NAME, value);
 	}
@@ -290,8 +339,6 @@ void PropertyConfigurator::parseCatsAndRenderers(helpers::Properties& props,
 
 			LogString value = OptionConverter::findAndSubst(key, props);
 			LoggerPtr logger = hierarchy->getLogger(loggerName, loggerFactory);
-
-			LOCK_W sync(logger->getMutex());
 			parseLogger(props, logger, key, loggerName, value);
 			parseAdditivityForLogger(props, logger, loggerName);
 		}
@@ -318,7 +365,7 @@ void PropertyConfigurator::parseAdditivityForLogger(helpers::Properties& props,
 			+ loggerName
 			+ ((additivity) ?  LOG4CXXNG_STR("\" to true") :
 				LOG4CXXNG_STR("\" to false")));
-		cat->setAdditivity(additivity);
+		reconfiguration->setAdditivity(cat, additivity);
 	}
 }
 
@@ -366,24 +413,25 @@ void PropertyConfigurator::parseLogger(
 			}
 			else
 			{
-				logger->setLevel(0);
+				reconfiguration->setLevel(logger, 0);
 				LogLog::debug((LogString) LOG4CXXNG_STR("Logger ")
 					+ loggerName + LOG4CXXNG_STR(" set to null"));
 			}
 		}
 		else
 		{
-			logger->setLevel(OptionConverter::toLevel(levelStr, Level::getDebug()));
+			LevelPtr level(OptionConverter::toLevel(levelStr, Level::getDebug()));
+			reconfiguration->setLevel(logger, level);
 
 			LogLog::debug((LogString) LOG4CXXNG_STR("Logger ")
 				+ loggerName + LOG4CXXNG_STR(" set to ")
-				+ logger->getLevel()->toString());
+				+ level->toString());
 		}
 
 	}
 
 	// Begin by removing all existing appenders.
-	logger->removeAllAppenders();
+	reconfiguration->removeAllAppenders(logger);
 
 	AppenderPtr appender;
 	LogString appenderName;
@@ -403,7 +451,7 @@ void PropertyConfigurator::parseLogger(
 
 		if (appender != 0)
 		{
-			logger->addAppender(appender);
+			reconfiguration->addLoggerAppender(logger, appender);
 		}
 	}
 }
@@ -426,6 +474,15 @@ AppenderPtr PropertyConfigurator::parseAppender(
 	// Appender was not previously initialized.
 	LogString prefix = APPENDER_PREFIX + appenderName;
 	LogString layoutPrefix = prefix + LOG4CXXNG_STR(".layout");
+	LogString signature(appenderSignature(props, prefix));
+
+	appender = reconfiguration->reuseAppender(appenderName, signature);
+
+	if (appender != 0)
+	{
+		registryPut(appender);
+		return appender;
+	}
 
 	appender =
 		OptionConverter::instantiateByKey(
@@ -470,6 +527,7 @@ AppenderPtr PropertyConfigurator::parseAppender(
 	}
 
 	registryPut(appender);
+	reconfiguration->addAppender(appender, signature);
 
 	return appender;
 }
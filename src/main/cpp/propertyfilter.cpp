@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/filter/propertyfilter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/stringtokenizer.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(PropertyFilter)
+
+
+PropertyFilter::PropertyFilter() : properties(new PropertyMap())
+{
+}
+
+PropertyFilter::~PropertyFilter()
+{
+	delete properties;
+}
+
+void PropertyFilter::setOption(const LogString& option,
+	const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("PROPERTIES"), LOG4CXXNG_STR("properties")))
+	{
+		setProperties(value);
+	}
+}
+
+void PropertyFilter::setProperties(const LogString& props)
+{
+	properties->clear();
+	StringTokenizer pairs(props, LOG4CXXNG_STR(","));
+
+	while (pairs.hasMoreTokens())
+	{
+		LogString pair(pairs.nextToken());
+		size_t equals = pair.find(LOG4CXXNG_STR('='));
+
+		if (equals != LogString::npos)
+		{
+			(*properties)[StringHelper::trim(pair.substr(0, equals))] =
+				StringHelper::trim(pair.substr(equals + 1));
+		}
+	}
+}
+
+Filter::FilterDecision PropertyFilter::decide(
+	const LoggingEventPtr& event) const
+{
+	for (PropertyMap::const_iterator iter = properties->begin();
+		iter != properties->end(); iter++)
+	{
+		if (event->findProperty(iter->first) == 0)
+		{
+			event->setProperty(iter->first, iter->second);
+		}
+	}
+
+	return Filter::NEUTRAL;
+}
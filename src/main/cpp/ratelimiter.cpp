@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/helpers/ratelimiter.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <apr_time.h>
+#include <apr_atomic.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+
+RateLimiter::RateLimiter(unsigned int rate, unsigned int burst,
+	unsigned int sampling1, log4cxxng_time_t summaryInterval1)
+	: interval(0), tolerance(0), sampling(0), summaryInterval(0),
+	  nextArrival(0), lastSummary(0), overLimit(0), suppressed(0)
+{
+	configure(rate, burst, sampling1, summaryInterval1);
+}
+
+void RateLimiter::configure(unsigned int rate, unsigned int burst,
+	unsigned int sampling1, log4cxxng_time_t summaryInterval1)
+{
+	if (rate == 0)
+	{
+		interval = 0;
+		tolerance = 0;
+	}
+	else
+	{
+		if (burst == 0)
+		{
+			burst = rate;
+		}
+
+		interval = APR_USEC_PER_SEC / rate;
+		tolerance = interval * (burst - 1);
+	}
+
+	sampling = sampling1;
+	summaryInterval = summaryInterval1;
+}
+
+bool RateLimiter::tryAcquire()
+{
+	return tryAcquire(apr_time_now());
+}
+
+bool RateLimiter::tryAcquire(log4cxxng_time_t now)
+{
+	if (interval > 0)
+	{
+		volatile apr_uint64_t* next = (volatile apr_uint64_t*) &nextArrival;
+		log4cxxng_time_t arrival = (log4cxxng_time_t) apr_atomic_read64(next);
+
+		for (;;)
+		{
+			log4cxxng_time_t start = arrival > now ? arrival : now;
+
+			if (start - now > tolerance)
+			{
+				break;
+			}
+
+			log4cxxng_time_t seen = (log4cxxng_time_t) apr_atomic_cas64(next,
+					(apr_uint64_t) (start + interval), (apr_uint64_t) arrival);
+
+			if (seen == arrival)
+			{
+				return true;
+			}
+
+			arrival = seen;
+		}
+	}
+	else if (sampling == 0)
+	{
+		return true;
+	}
+
+	//
+	//   over the limit, let every sampling-th event through
+	//
+	if (sampling > 0 && (apr_atomic_inc32(&overLimit) % sampling) == 0)
+	{
+		return true;
+	}
+
+	apr_atomic_inc32(&suppressed);
+	return false;
+}
+
+unsigned int RateLimiter::takeSuppressedCount()
+{
+	return takeSuppressedCount(apr_time_now());
+}
+
+unsigned int RateLimiter::takeSuppressedCount(log4cxxng_time_t now)
+{
+	if (apr_atomic_read32(&suppressed) == 0)
+	{
+		return 0;
+	}
+
+	volatile apr_uint64_t* summary = (volatile apr_uint64_t*) &lastSummary;
+	log4cxxng_time_t last = (log4cxxng_time_t) apr_atomic_read64(summary);
+
+	if (now - last < summaryInterval
+		|| apr_atomic_cas64(summary, (apr_uint64_t) now, (apr_uint64_t) last) != (apr_uint64_t) last)
+	{
+		return 0;
+	}
+
+	return apr_atomic_xchg32(&suppressed, 0);
+}
+
+unsigned int RateLimiter::drainSuppressedCount()
+{
+	if (apr_atomic_read32(&suppressed) == 0)
+	{
+		return 0;
+	}
+
+	apr_atomic_set64((volatile apr_uint64_t*) &lastSummary, (apr_uint64_t) apr_time_now());
+	return apr_atomic_xchg32(&suppressed, 0);
+}
+
+unsigned int RateLimiter::getSuppressedCount() const
+{
+	return apr_atomic_read32(const_cast<volatile unsigned int*>(&suppressed));
+}
+
+LogString RateLimiter::formatSummary(unsigned int count)
+{
+	Pool p;
+	LogString msg;
+	StringHelper::toString((size_t) count, p, msg);
+	msg.append(LOG4CXXNG_STR(" similar messages suppressed by rate limit"));
+	return msg;
+}
@@ -0,0 +1,392 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/filter/ratelimitfilter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/synchronized.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/exception.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/logmanager.h>
+#include <apr_time.h>
+#include <apr_atomic.h>
+#include <apr_thread_proc.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(RateLimitFilter)
+
+struct RateLimitFilter::Site
+{
+	Site() : key(0), limiter(), busy(0)
+	{
+	}
+
+	volatile apr_uint64_t key;
+	RateLimiter limiter;
+
+	/**
+	 *  Last suppressed event, the model of the summary event,
+	 *  guarded by busy.
+	 */
+	volatile unsigned int busy;
+	LoggingEventPtr last;
+};
+
+struct RateLimitFilter::Table
+{
+	Table(int size1) : size(size1), sites(new Site[size1])
+	{
+	}
+
+	~Table()
+	{
+		delete [] sites;
+	}
+
+	int size;
+	Site* sites;
+};
+
+//
+//   number of table entries probed for a site
+//
+static const int MAX_PROBES = 16;
+
+//
+//   set while the summarizer logs, so that its events pass
+//
+static thread_local bool summarizing = false;
+
+
+RateLimitFilter::RateLimitFilter()
+	: rate(100), burst(0), sampling(0), summaryInterval(10), maxSites(1024), table(0),
+	  summaryMutex(pool), summaryCondition(pool), stopping(false)
+{
+}
+
+RateLimitFilter::~RateLimitFilter()
+{
+	stopSummarizer();
+	delete (Table*) table;
+
+	for (std::vector<Table*>::iterator iter = retired.begin(); iter != retired.end(); iter++)
+	{
+		delete *iter;
+	}
+}
+
+void RateLimitFilter::setOption(const LogString& option,
+	const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("RATE"), LOG4CXXNG_STR("rate")))
+	{
+		rate = OptionConverter::toInt(value, rate);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("BURST"), LOG4CXXNG_STR("burst")))
+	{
+		burst = OptionConverter::toInt(value, burst);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("SAMPLING"), LOG4CXXNG_STR("sampling")))
+	{
+		sampling = OptionConverter::toInt(value, sampling);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("SUMMARYINTERVAL"), LOG4CXXNG_STR("summaryinterval")))
+	{
+		summaryInterval = OptionConverter::toInt(value, summaryInterval);
+	}
+	else if (StringHelper::equalsIgnoreCase(option,
+			LOG4CXXNG_STR("MAXSITES"), LOG4CXXNG_STR("maxsites")))
+	{
+		maxSites = OptionConverter::toInt(value, maxSites);
+	}
+}
+
+void RateLimitFilter::activateOptions(Pool&)
+{
+	Table* newTable = 0;
+
+	if (maxSites > 0)
+	{
+		newTable = new Table(maxSites);
+
+		for (int i = 0; i < maxSites; i++)
+		{
+			newTable->sites[i].limiter.configure(rate, burst, sampling,
+				(log4cxxng_time_t) summaryInterval * APR_USEC_PER_SEC);
+		}
+	}
+
+	//
+	//   decide() may still be probing the previous table,
+	//      whose suppressed events are reported first
+	//
+	stopSummarizer();
+	summarize(true);
+	Table* oldTable = (Table*) apr_atomic_xchgptr((volatile void**) &table, newTable);
+
+	if (oldTable != 0)
+	{
+		retired.push_back(oldTable);
+	}
+
+#if APR_HAS_THREADS
+
+	if (newTable != 0 && summaryInterval > 0)
+	{
+		stopping = false;
+		summarizer.run(summaryLoop, this);
+	}
+
+#endif
+}
+
+void RateLimitFilter::stopSummarizer()
+{
+#if APR_HAS_THREADS
+
+	if (summarizer.isAlive())
+	{
+		{
+			synchronized sync(summaryMutex);
+			stopping = true;
+			summaryCondition.signalAll();
+		}
+
+		try
+		{
+			summarizer.join();
+		}
+		catch (InterruptedException& e)
+		{
+			Thread::currentThreadInterrupt();
+			LogLog::error(LOG4CXXNG_STR("Got an InterruptedException while waiting for the rate limit summaries,"), e);
+		}
+	}
+
+#endif
+}
+
+#if APR_HAS_THREADS
+void* LOG4CXXNG_THREAD_FUNC RateLimitFilter::summaryLoop(apr_thread_t* /* thread */, void* data)
+{
+	RateLimitFilter* pThis = (RateLimitFilter*) data;
+
+	while (true)
+	{
+		{
+			synchronized sync(pThis->summaryMutex);
+
+			if (!pThis->stopping)
+			{
+				pThis->summaryCondition.await(pThis->summaryMutex,
+					(log4cxxng_time_t) pThis->summaryInterval * APR_USEC_PER_SEC);
+			}
+
+			if (pThis->stopping)
+			{
+				break;
+			}
+		}
+
+		pThis->summarize(false);
+	}
+
+	return 0;
+}
+#endif
+
+void RateLimitFilter::flush()
+{
+	summarize(true);
+}
+
+void RateLimitFilter::summarize(bool all)
+{
+	Table* current = (Table*) table;
+
+	if (current == 0)
+	{
+		return;
+	}
+
+	log4cxxng_time_t now = apr_time_now();
+	Pool p;
+
+	for (int i = 0; i < current->size; i++)
+	{
+		Site& site = current->sites[i];
+
+		if (site.limiter.getSuppressedCount() == 0)
+		{
+			continue;
+		}
+
+		unsigned int count = all ? site.limiter.drainSuppressedCount()
+			: site.limiter.takeSuppressedCount(now);
+
+		if (count == 0)
+		{
+			continue;
+		}
+
+		LoggingEventPtr last;
+
+		while (apr_atomic_cas32(&site.busy, 1, 0) != 0)
+		{
+			apr_thread_yield();
+		}
+
+		last = site.last;
+		site.last = 0;
+		apr_atomic_set32(&site.busy, 0);
+
+		if (last == 0)
+		{
+			continue;
+		}
+
+		LoggerPtr logger(last->getLogger());
+
+		if (logger == 0)
+		{
+			logger = LogManager::getLogger(last->getLoggerName());
+		}
+
+		LoggingEventPtr summary(new LoggingEvent(last->getLoggerName(), last->getLevel(),
+				RateLimiter::formatSummary(count), last->getLocationInformation()));
+		LogString value;
+		StringHelper::toString((size_t) count, p, value);
+		summary->setProperty(LOG4CXXNG_STR("log4cxx.suppressed"), value);
+		summarizing = true;
+		logger->callAppenders(summary, p);
+		summarizing = false;
+	}
+}
+
+RateLimitFilter::Site* RateLimitFilter::getSite(Table& table, const LoggingEventPtr& event)
+{
+	//
+	//   FNV-1a over the location and the logger, events created by a
+	//      logger are keyed by the logger itself and others by its name
+	//
+	const LocationInfo& location = event->getLocationInformation();
+	apr_uint64_t key = 14695981039346656037ULL;
+	key = (key ^ (apr_uint64_t) (size_t) location.getFileName()) * 1099511628211ULL;
+	key = (key ^ (apr_uint64_t) location.getLineNumber()) * 1099511628211ULL;
+
+	if (event->getLogger() != 0)
+	{
+		key = (key ^ (apr_uint64_t) (size_t) (const Logger*) event->getLogger()) * 1099511628211ULL;
+	}
+	else
+	{
+		const LogString& name = event->getLoggerName();
+
+		for (LogString::const_iterator iter = name.begin(); iter != name.end(); iter++)
+		{
+			key = (key ^ (apr_uint64_t) (unsigned int) *iter) * 1099511628211ULL;
+		}
+	}
+
+	if (key == 0)
+	{
+		key = 1;
+	}
+
+	size_t index = (size_t) (key % (apr_uint64_t) table.size);
+
+	for (int probe = 0; probe < MAX_PROBES && probe < table.size; probe++)
+	{
+		Site& site = table.sites[index];
+		apr_uint64_t siteKey = apr_atomic_read64(&site.key);
+
+		if (siteKey == 0)
+		{
+			siteKey = apr_atomic_cas64(&site.key, key, 0);
+
+			if (siteKey == 0 || siteKey == key)
+			{
+				return &site;
+			}
+		}
+		else if (siteKey == key)
+		{
+			return &site;
+		}
+
+		index = (index + 1) % table.size;
+	}
+
+	return 0;
+}
+
+Filter::FilterDecision RateLimitFilter::decide(
+	const spi::LoggingEventPtr& event) const
+{
+	Table* current = (Table*) table;
+
+	if (current == 0 || summarizing)
+	{
+		return Filter::NEUTRAL;
+	}
+
+	Site* site = getSite(*current, event);
+
+	if (site == 0)
+	{
+		return Filter::NEUTRAL;
+	}
+
+	if (!site->limiter.tryAcquire(event->getTimeStamp()))
+	{
+		//
+		//   keep the event as the model of the summary,
+		//      unless the summarizer is taking the previous one
+		//
+		if (apr_atomic_cas32(&site->busy, 1, 0) == 0)
+		{
+			site->last = event;
+			apr_atomic_set32(&site->busy, 0);
+		}
+
+		return Filter::DENY;
+	}
+
+	unsigned int count = site->limiter.takeSuppressedCount(event->getTimeStamp());
+
+	if (count > 0)
+	{
+		Pool p;
+		LogString value;
+		StringHelper::toString((size_t) count, p, value);
+		event->setProperty(LOG4CXXNG_STR("log4cxx.suppressed"), value);
+	}
+
+	return Filter::NEUTRAL;
+}
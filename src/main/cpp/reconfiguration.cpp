@@ -0,0 +1,224 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(_MSC_VER)
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/spi/reconfiguration.h>
+#include <log4cxxNG/appender.h>
+#include <log4cxxNG/level.h>
+#include <log4cxxNG/spi/appenderattachable.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <algorithm>
+
+using namespace log4cxxng;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+Reconfiguration::LoggerChange::LoggerChange(const LoggerPtr& logger1)
+	: logger(logger1), hasLevel(false), hasAdditivity(false), additivity(true),
+	  hasAppenders(false)
+{
+}
+
+Reconfiguration::Reconfiguration(const LoggerRepositoryPtr& repository1)
+	: repository(repository1), hierarchy(repository1), committed(false)
+{
+}
+
+Reconfiguration::~Reconfiguration()
+{
+	if (!committed)
+	{
+		// The staged configuration was abandoned, release whatever
+		// it opened and leave the live one alone.
+		for (AppenderList::iterator it = created.begin(); it != created.end(); ++it)
+		{
+			(*it)->close();
+		}
+	}
+}
+
+AppenderPtr Reconfiguration::reuseAppender(const LogString& name,
+	const LogString& signature)
+{
+	if (hierarchy == 0 || signature.empty())
+	{
+		return 0;
+	}
+
+	AppenderPtr appender(hierarchy->getConfiguredAppender(name, signature));
+
+	// Nested appenders are resolved by reference and may have changed
+	// even though the signature of their parent did not.
+	if (appender == 0 || appender->instanceof(AppenderAttachable::getStaticClass()))
+	{
+		return 0;
+	}
+
+	LogLog::debug(LOG4CXXNG_STR("Reusing unchanged appender named [")
+		+ name + LOG4CXXNG_STR("]."));
+	appenders[name] = std::make_pair(signature, appender);
+	return appender;
+}
+
+void Reconfiguration::addAppender(const AppenderPtr& appender,
+	const LogString& signature)
+{
+	created.push_back(appender);
+	appenders[appender->getName()] = std::make_pair(signature, appender);
+}
+
+Reconfiguration::LoggerChange& Reconfiguration::getChange(const LoggerPtr& logger)
+{
+	std::map<LogString, size_t>::const_iterator it = changeIndex.find(logger->getName());
+
+	if (it != changeIndex.end())
+	{
+		return changes[it->second];
+	}
+
+	changeIndex[logger->getName()] = changes.size();
+	changes.push_back(LoggerChange(logger));
+	return changes.back();
+}
+
+void Reconfiguration::setLevel(const LoggerPtr& logger, const LevelPtr& level)
+{
+	LoggerChange& change = getChange(logger);
+	change.hasLevel = true;
+	change.level = level;
+}
+
+void Reconfiguration::setAdditivity(const LoggerPtr& logger, bool additivity)
+{
+	LoggerChange& change = getChange(logger);
+	change.hasAdditivity = true;
+	change.additivity = additivity;
+}
+
+void Reconfiguration::removeAllAppenders(const LoggerPtr& logger)
+{
+	LoggerChange& change = getChange(logger);
+	change.hasAppenders = true;
+	change.appenders.clear();
+}
+
+void Reconfiguration::addLoggerAppender(const LoggerPtr& logger,
+	const AppenderPtr& appender)
+{
+	LoggerChange& change = getChange(logger);
+	change.hasAppenders = true;
+
+	if (std::find(change.appenders.begin(), change.appenders.end(), appender)
+		== change.appenders.end())
+	{
+		change.appenders.push_back(appender);
+	}
+}
+
+bool Reconfiguration::isAttachedAnywhere(const AppenderPtr& appender) const
+{
+	if (repository->getRootLogger()->isAttached(appender))
+	{
+		return true;
+	}
+
+	LoggerList loggers = repository->getCurrentLoggers();
+
+	for (LoggerList::const_iterator it = loggers.begin(); it != loggers.end(); ++it)
+	{
+		if ((*it)->isAttached(appender))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+unsigned int Reconfiguration::commit()
+{
+	committed = true;
+	AppenderList retired;
+
+	for (std::vector<LoggerChange>::iterator it = changes.begin(); it != changes.end(); ++it)
+	{
+		if (it->hasLevel)
+		{
+			it->logger->setLevel(it->level);
+		}
+
+		if (it->hasAdditivity)
+		{
+			it->logger->setAdditivity(it->additivity);
+		}
+
+		if (it->hasAppenders)
+		{
+			AppenderList previous(it->logger->replaceAllAppenders(it->appenders));
+			retired.insert(retired.end(), previous.begin(), previous.end());
+		}
+	}
+
+	AppenderList current;
+
+	for (Hierarchy::ConfiguredAppenderMap::const_iterator it = appenders.begin();
+		it != appenders.end(); ++it)
+	{
+		current.push_back(it->second.second);
+	}
+
+	unsigned int epoch = 0;
+
+	if (hierarchy != 0)
+	{
+		epoch = hierarchy->publishConfiguration(appenders);
+
+		for (Hierarchy::ConfiguredAppenderMap::const_iterator it = appenders.begin();
+			it != appenders.end(); ++it)
+		{
+			retired.push_back(it->second.second);
+		}
+
+		appenders.clear();
+
+		LogString msg(LOG4CXXNG_STR("Published configuration epoch "));
+		Pool p;
+		StringHelper::toString((int) epoch, p, msg);
+		LogLog::debug(msg);
+	}
+
+	AppenderList closed;
+
+	for (AppenderList::iterator it = retired.begin(); it != retired.end(); ++it)
+	{
+		if (std::find(current.begin(), current.end(), *it) == current.end()
+			&& std::find(closed.begin(), closed.end(), *it) == closed.end()
+			&& !isAttachedAnywhere(*it))
+		{
+			(*it)->close();
+			closed.push_back(*it);
+		}
+	}
+
+	return epoch;
+}
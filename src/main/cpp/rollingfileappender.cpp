@@ -450,7 +450,12 @@ void RollingFileAppenderSkeleton::subAppend(const LoggingEventPtr& event, Pool&
 		try
 		{
 			_event = &(const_cast<LoggingEventPtr&>(event));
-			rollover(p);
+			unsigned long long start = AppenderMetrics::now();
+
+			if (rollover(p))
+			{
+				metrics.recordRollover(AppenderMetrics::now() - start);
+			}
 		}
 		catch (std::exception&)
 		{
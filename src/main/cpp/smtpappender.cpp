@@ -388,7 +388,8 @@ bool DefaultEvaluator::isTriggeringEvent(const spi::LoggingEventPtr& event)
 
 SMTPAppender::SMTPAppender()
 	: smtpPort(25), bufferSize(512), locationInfo(false), cb(bufferSize),
-	  evaluator(new DefaultEvaluator())
+	  evaluator(new DefaultEvaluator()), senderMutex(pool), sendCondition(pool),
+	  sendRequested(false), stopping(false)
 {
 }
 
@@ -397,7 +398,8 @@ Use <code>evaluator</code> passed as parameter as the
 TriggeringEventEvaluator for this SMTPAppender.  */
 SMTPAppender::SMTPAppender(spi::TriggeringEventEvaluatorPtr evaluator)
 	: smtpPort(25), bufferSize(512), locationInfo(false), cb(bufferSize),
-	  evaluator(evaluator)
+	  evaluator(evaluator), senderMutex(pool), sendCondition(pool),
+	  sendRequested(false), stopping(false)
 {
 }
 
@@ -419,6 +421,7 @@ LogString SMTPAppender::getFrom() const
 
 void SMTPAppender::setFrom(const LogString& newVal)
 {
+	LOCK_W sync(mutex);
 	from = newVal;
 }
 
@@ -430,6 +433,7 @@ LogString SMTPAppender::getSubject() const
 
 void SMTPAppender::setSubject(const LogString& newVal)
 {
+	LOCK_W sync(mutex);
 	subject = newVal;
 }
 
@@ -440,6 +444,7 @@ LogString SMTPAppender::getSMTPHost() const
 
 void SMTPAppender::setSMTPHost(const LogString& newVal)
 {
+	LOCK_W sync(mutex);
 	smtpHost = newVal;
 }
 
@@ -450,6 +455,7 @@ int SMTPAppender::getSMTPPort() const
 
 void SMTPAppender::setSMTPPort(int newVal)
 {
+	LOCK_W sync(mutex);
 	smtpPort = newVal;
 }
 
@@ -470,6 +476,7 @@ LogString SMTPAppender::getSMTPUsername() const
 
 void SMTPAppender::setSMTPUsername(const LogString& newVal)
 {
+	LOCK_W sync(mutex);
 	smtpUsername = newVal;
 }
 
@@ -480,6 +487,7 @@ LogString SMTPAppender::getSMTPPassword() const
 
 void SMTPAppender::setSMTPPassword(const LogString& newVal)
 {
+	LOCK_W sync(mutex);
 	smtpPassword = newVal;
 }
 
@@ -604,6 +612,7 @@ void SMTPAppender::activateOptions(Pool& p)
 	if (activate)
 	{
 		AppenderSkeleton::activateOptions(p);
+		startSender();
 	}
 }
 
@@ -628,6 +637,17 @@ void SMTPAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 
 	if (evaluator->isTriggeringEvent(event))
 	{
+#if APR_HAS_THREADS
+
+		if (sender.isAlive())
+		{
+			synchronized sync(senderMutex);
+			sendRequested = true;
+			sendCondition.signalAll();
+			return;
+		}
+
+#endif
 		sendBuffer(p);
 	}
 }
@@ -671,9 +691,84 @@ bool SMTPAppender::checkEntryConditions()
 
 void SMTPAppender::close()
 {
+	stopSender();
 	this->closed = true;
 }
 
+void SMTPAppender::startSender()
+{
+#if APR_HAS_THREADS && LOG4CXXNG_HAVE_LIBESMTP
+
+	if (!sender.isAlive())
+	{
+		stopping = false;
+		sender.run(sendLoop, this);
+	}
+
+#endif
+}
+
+void SMTPAppender::stopSender()
+{
+#if APR_HAS_THREADS
+
+	if (sender.isAlive())
+	{
+		{
+			synchronized sync(senderMutex);
+			stopping = true;
+			sendCondition.signalAll();
+		}
+
+		try
+		{
+			sender.join();
+		}
+		catch (InterruptedException& e)
+		{
+			Thread::currentThreadInterrupt();
+			LogLog::error(LOG4CXXNG_STR("Got an InterruptedException while waiting for the SMTP sender to finish,"), e);
+		}
+	}
+
+#endif
+}
+
+#if APR_HAS_THREADS
+void* LOG4CXXNG_THREAD_FUNC SMTPAppender::sendLoop(apr_thread_t* /* thread */, void* data)
+{
+	SMTPAppender* pThis = (SMTPAppender*) data;
+	bool active = true;
+
+	while (active)
+	{
+		bool requested;
+		{
+			synchronized sync(pThis->senderMutex);
+
+			while (!pThis->sendRequested && !pThis->stopping)
+			{
+				pThis->sendCondition.await(pThis->senderMutex);
+			}
+
+			requested = pThis->sendRequested;
+			pThis->sendRequested = false;
+			active = !pThis->stopping;
+		}
+
+		// Triggers that arrive while a message is being sent are
+		// folded into the next one.
+		if (requested)
+		{
+			Pool p;
+			pThis->sendBuffer(p);
+		}
+	}
+
+	return 0;
+}
+#endif
+
 LogString SMTPAppender::getTo() const
 {
 	return to;
@@ -681,6 +776,7 @@ LogString SMTPAppender::getTo() const
 
 void SMTPAppender::setTo(const LogString& addressStr)
 {
+	LOCK_W sync(mutex);
 	to = addressStr;
 }
 
@@ -691,6 +787,7 @@ LogString SMTPAppender::getCc() const
 
 void SMTPAppender::setCc(const LogString& addressStr)
 {
+	LOCK_W sync(mutex);
 	cc = addressStr;
 }
 
@@ -701,6 +798,7 @@ LogString SMTPAppender::getBcc() const
 
 void SMTPAppender::setBcc(const LogString& addressStr)
 {
+	LOCK_W sync(mutex);
 	bcc = addressStr;
 }
 
@@ -711,27 +809,52 @@ void SMTPAppender::sendBuffer(Pool& p)
 {
 #if LOG4CXXNG_HAVE_LIBESMTP
 
-	// Note: this code already owns the monitor for this
-	// appender. This frees us from needing to synchronize on 'cb'.
+	// This runs on the sender thread, so take a consistent copy of
+	// the message settings, which the setters change under the lock.
+	LayoutPtr layout1;
+	LogString to1, cc1, bcc1, from1, subject1;
+	LogString smtpHost1, smtpUsername1, smtpPassword1;
+	int smtpPort1;
+	{
+		LOCK_W sync(mutex);
+		layout1 = layout;
+		to1 = to;
+		cc1 = cc;
+		bcc1 = bcc;
+		from1 = from;
+		subject1 = subject;
+		smtpHost1 = smtpHost;
+		smtpPort1 = smtpPort;
+		smtpUsername1 = smtpUsername;
+		smtpPassword1 = smtpPassword;
+	}
+
+	// The cyclic buffer may be drained here while other threads add
+	// to it; events added meanwhile are sent with this message or the
+	// next one.
 	try
 	{
 		LogString sbuf;
-		layout->appendHeader(sbuf, p);
+		layout1->appendHeader(sbuf, p);
 
 		int len = cb.length();
 
 		for (int i = 0; i < len; i++)
 		{
 			LoggingEventPtr event = cb.get();
-			layout->format(sbuf, event, p);
+
+			if (event != 0)
+			{
+				layout1->format(sbuf, event, p);
+			}
 		}
 
-		layout->appendFooter(sbuf, p);
+		layout1->appendFooter(sbuf, p);
 
-		SMTPSession session(smtpHost, smtpPort, smtpUsername, smtpPassword, p);
+		SMTPSession session(smtpHost1, smtpPort1, smtpUsername1, smtpPassword1, p);
 
-		SMTPMessage message(session, from, to, cc,
-			bcc, subject, sbuf, p);
+		SMTPMessage message(session, from1, to1, cc1,
+			bcc1, subject1, sbuf, p);
 
 		session.send(p);
 
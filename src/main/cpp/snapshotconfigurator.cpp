@@ -0,0 +1,1744 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/snapshotconfigurator.h>
+#include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/level.h>
+#include <log4cxxNG/appender.h>
+#include <log4cxxNG/layout.h>
+#include <log4cxxNG/defaultloggerfactory.h>
+#include <log4cxxNG/spi/loggerfactory.h>
+#include <log4cxxNG/spi/loggerrepository.h>
+#include <log4cxxNG/spi/optionhandler.h>
+#include <log4cxxNG/spi/appenderattachable.h>
+#include <log4cxxNG/spi/reconfiguration.h>
+#include <log4cxxNG/spi/filter.h>
+#include <log4cxxNG/rolling/rollingfileappender.h>
+#include <log4cxxNG/rolling/filterbasedtriggeringpolicy.h>
+#include <log4cxxNG/net/smtpappender.h>
+#include <log4cxxNG/filter/multistringmatchfilter.h>
+#include <log4cxxNG/helpers/properties.h>
+#include <log4cxxNG/helpers/fileinputstream.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/stringtokenizer.h>
+#include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/messagebuffer.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/loader.h>
+#include <log4cxxNG/helpers/class.h>
+#include <log4cxxNG/helpers/exception.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <apr_file_io.h>
+#include <apr_mmap.h>
+#include <apr_xml.h>
+#include <map>
+#include <string.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+IMPLEMENT_LOG4CXXNG_OBJECT(SnapshotConfigurator)
+
+namespace
+{
+/**
+ *  File layout: the magic bytes and a format version, then the source
+ *  configuration file, the system properties the structure depends on,
+ *  the variables option values refer to, the repository settings, the
+ *  logger factory, the appenders and the loggers. Strings are UTF-8
+ *  prefixed by their length, integers are little endian and
+ *  appenders are referred to by their index.
+ */
+const char SNAPSHOT_MAGIC[4] = { 'L', '4', 'X', 'S' };
+const unsigned int SNAPSHOT_VERSION = 2;
+const unsigned int NO_APPENDER = 0xFFFFFFFF;
+const unsigned int MAX_DEPTH = 8;
+
+enum Role { LAYOUT = 1, FILTER = 2, ROLLING_POLICY = 3, TRIGGERING_POLICY = 4 };
+enum Setting { UNSET = 0, INHERITED = 1, DISABLED = 1, SET = 2 };
+
+struct Option
+{
+	LogString name;
+	LogString value;
+	unsigned int substitute;
+};
+
+/**
+ *  An appender, layout, filter, policy or logger factory.
+ */
+struct Component
+{
+	Component() : role(0), clazz(0)
+	{
+	}
+
+	unsigned int role;
+	LogString className;
+	const Class* clazz;
+	std::vector<Option> options;
+	std::vector<Component> children;
+};
+
+struct AppenderEntry
+{
+	LogString name;
+	Component component;
+	std::vector<unsigned int> refs;
+};
+
+struct LoggerEntry
+{
+	LoggerEntry() : root(0), levelKind(UNSET), levelClazz(0), additivity(UNSET)
+	{
+	}
+
+	unsigned int root;
+	LogString name;
+	unsigned int levelKind;
+	LogString level;
+	LogString levelClass;
+	const Class* levelClazz;
+	unsigned int additivity;
+	std::vector<unsigned int> appenders;
+};
+
+typedef std::vector< std::pair<LogString, LogString> > Pairs;
+
+struct Snapshot
+{
+	Snapshot() : staticStream(0), hasFactory(0)
+	{
+	}
+
+	LogString source;
+	Pairs environment;
+	Pairs variables;
+	LogString debug;
+	LogString threshold;
+	unsigned int staticStream;
+	unsigned int hasFactory;
+	Component factory;
+	std::vector<AppenderEntry> appenders;
+	std::vector<LoggerEntry> loggers;
+};
+
+bool isInherited(const LogString& level)
+{
+	return StringHelper::equalsIgnoreCase(level, LOG4CXXNG_STR("INHERITED"), LOG4CXXNG_STR("inherited"))
+		|| StringHelper::equalsIgnoreCase(level, LOG4CXXNG_STR("NULL"), LOG4CXXNG_STR("null"));
+}
+
+void appendInt(std::string& dst, unsigned int value)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		dst.append(1, (char) ((value >> (8 * i)) & 0xFF));
+	}
+}
+
+void appendString(std::string& dst, const LogString& value)
+{
+	std::string utf8;
+	Transcoder::encodeUTF8(value, utf8);
+	appendInt(dst, (unsigned int) utf8.size());
+	dst.append(utf8);
+}
+
+void appendPairs(std::string& dst, const Pairs& pairs)
+{
+	appendInt(dst, (unsigned int) pairs.size());
+
+	for (Pairs::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+	{
+		appendString(dst, it->first);
+		appendString(dst, it->second);
+	}
+}
+
+void appendIndexes(std::string& dst, const std::vector<unsigned int>& indexes)
+{
+	appendInt(dst, (unsigned int) indexes.size());
+
+	for (std::vector<unsigned int>::const_iterator it = indexes.begin(); it != indexes.end(); ++it)
+	{
+		appendInt(dst, *it);
+	}
+}
+
+void appendComponent(std::string& dst, const Component& component)
+{
+	appendInt(dst, component.role);
+	appendString(dst, component.className);
+	appendInt(dst, (unsigned int) component.options.size());
+
+	for (std::vector<Option>::const_iterator it = component.options.begin();
+		it != component.options.end(); ++it)
+	{
+		appendString(dst, it->name);
+		appendString(dst, it->value);
+		appendInt(dst, it->substitute);
+	}
+
+	appendInt(dst, (unsigned int) component.children.size());
+
+	for (std::vector<Component>::const_iterator it = component.children.begin();
+		it != component.children.end(); ++it)
+	{
+		appendComponent(dst, *it);
+	}
+}
+
+std::string encodeSnapshot(const Snapshot& snapshot)
+{
+	std::string dst(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	appendInt(dst, SNAPSHOT_VERSION);
+	appendString(dst, snapshot.source);
+	appendPairs(dst, snapshot.environment);
+	appendPairs(dst, snapshot.variables);
+	appendString(dst, snapshot.debug);
+	appendString(dst, snapshot.threshold);
+	appendInt(dst, snapshot.staticStream);
+	appendInt(dst, snapshot.hasFactory);
+
+	if (snapshot.hasFactory)
+	{
+		appendComponent(dst, snapshot.factory);
+	}
+
+	appendInt(dst, (unsigned int) snapshot.appenders.size());
+
+	for (std::vector<AppenderEntry>::const_iterator it = snapshot.appenders.begin();
+		it != snapshot.appenders.end(); ++it)
+	{
+		appendString(dst, it->name);
+		appendComponent(dst, it->component);
+		appendIndexes(dst, it->refs);
+	}
+
+	appendInt(dst, (unsigned int) snapshot.loggers.size());
+
+	for (std::vector<LoggerEntry>::const_iterator it = snapshot.loggers.begin();
+		it != snapshot.loggers.end(); ++it)
+	{
+		appendInt(dst, it->root);
+		appendString(dst, it->name);
+		appendInt(dst, it->levelKind);
+		appendString(dst, it->level);
+		appendString(dst, it->levelClass);
+		appendInt(dst, it->additivity);
+		appendIndexes(dst, it->appenders);
+	}
+
+	return dst;
+}
+
+/**
+ *  Decodes a snapshot, every read checked against the end of the file.
+ */
+class SnapshotReader
+{
+	public:
+		SnapshotReader(const char* src1, size_t length)
+			: src(src1), end(src1 + length)
+		{
+		}
+
+		bool read(Snapshot& snapshot)
+		{
+			unsigned int version, appenderCount, loggerCount;
+
+			if ((size_t) (end - src) < sizeof(SNAPSHOT_MAGIC)
+				|| memcmp(src, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+			{
+				return false;
+			}
+
+			src += sizeof(SNAPSHOT_MAGIC);
+
+			if (!readInt(version) || version != SNAPSHOT_VERSION
+				|| !readString(snapshot.source)
+				|| !readPairs(snapshot.environment)
+				|| !readPairs(snapshot.variables)
+				|| !readString(snapshot.debug)
+				|| !readString(snapshot.threshold)
+				|| !readInt(snapshot.staticStream)
+				|| !readInt(snapshot.hasFactory)
+				|| (snapshot.hasFactory && !readComponent(snapshot.factory, 0))
+				|| !readInt(appenderCount))
+			{
+				return false;
+			}
+
+			for (unsigned int i = 0; i < appenderCount; i++)
+			{
+				AppenderEntry entry;
+
+				if (!readString(entry.name)
+					|| !readComponent(entry.component, 0)
+					|| !readIndexes(entry.refs, appenderCount))
+				{
+					return false;
+				}
+
+				snapshot.appenders.push_back(entry);
+			}
+
+			if (!readInt(loggerCount))
+			{
+				return false;
+			}
+
+			for (unsigned int i = 0; i < loggerCount; i++)
+			{
+				LoggerEntry entry;
+
+				if (!readInt(entry.root)
+					|| !readString(entry.name)
+					|| !readInt(entry.levelKind)
+					|| !readString(entry.level)
+					|| !readString(entry.levelClass)
+					|| !readInt(entry.additivity)
+					|| !readIndexes(entry.appenders, appenderCount))
+				{
+					return false;
+				}
+
+				snapshot.loggers.push_back(entry);
+			}
+
+			return src == end;
+		}
+
+	private:
+		bool readInt(unsigned int& value)
+		{
+			if (end - src < 4)
+			{
+				return false;
+			}
+
+			const unsigned char* bytes = (const unsigned char*) src;
+			value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int) bytes[3] << 24);
+			src += 4;
+			return true;
+		}
+
+		bool readString(LogString& value)
+		{
+			unsigned int length;
+
+			if (!readInt(length) || (size_t) (end - src) < length)
+			{
+				return false;
+			}
+
+			Transcoder::decodeUTF8(std::string(src, length), value);
+			src += length;
+			return true;
+		}
+
+		bool readPairs(Pairs& pairs)
+		{
+			unsigned int count;
+
+			if (!readInt(count))
+			{
+				return false;
+			}
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				LogString key, value;
+
+				if (!readString(key) || !readString(value))
+				{
+					return false;
+				}
+
+				pairs.push_back(std::make_pair(key, value));
+			}
+
+			return true;
+		}
+
+		bool readIndexes(std::vector<unsigned int>& indexes, unsigned int limit)
+		{
+			unsigned int count, index;
+
+			if (!readInt(count))
+			{
+				return false;
+			}
+
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (!readInt(index) || index >= limit)
+				{
+					return false;
+				}
+
+				indexes.push_back(index);
+			}
+
+			return true;
+		}
+
+		bool readComponent(Component& component, unsigned int depth)
+		{
+			unsigned int optionCount, childCount;
+
+			if (depth > MAX_DEPTH
+				|| !readInt(component.role)
+				|| !readString(component.className)
+				|| !readInt(optionCount))
+			{
+				return false;
+			}
+
+			for (unsigned int i = 0; i < optionCount; i++)
+			{
+				Option option;
+
+				if (!readString(option.name)
+					|| !readString(option.value)
+					|| !readInt(option.substitute))
+				{
+					return false;
+				}
+
+				component.options.push_back(option);
+			}
+
+			if (!readInt(childCount))
+			{
+				return false;
+			}
+
+			for (unsigned int i = 0; i < childCount; i++)
+			{
+				component.children.push_back(Component());
+
+				if (!readComponent(component.children.back(), depth + 1))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		const char* src;
+		const char* end;
+};
+
+/**
+ *  Builds a snapshot from a configuration, resolving what the snapshot
+ *  fixes and keeping option values as written.
+ */
+class SnapshotCompiler
+{
+	public:
+		SnapshotCompiler(Snapshot& snapshot1, Properties& variables1)
+			: snapshot(snapshot1), variables(variables1), valid(true)
+		{
+		}
+
+		/**
+		 *  Substitutes the variables of a structural value, recording the
+		 *  system properties consulted.
+		 */
+		LogString resolve(const LogString& value)
+		{
+			const logchar delimStart[] = { 0x24, 0x7B, 0 };
+			const logchar delimStop = 0x7D; // '}'
+			LogString result;
+			size_t i = 0;
+
+			while (true)
+			{
+				size_t j = value.find(delimStart, i);
+
+				if (j == LogString::npos)
+				{
+					result.append(value, i, LogString::npos);
+					return result;
+				}
+
+				size_t k = value.find(delimStop, j);
+
+				if (k == LogString::npos)
+				{
+					LogLog::error(LOG4CXXNG_STR("Bad option value [") + value
+						+ LOG4CXXNG_STR("], no closing brace."));
+					valid = false;
+					result.append(value, i, LogString::npos);
+					return result;
+				}
+
+				result.append(value, i, j - i);
+				LogString key(value, j + 2, k - j - 2);
+				LogString replacement(OptionConverter::getSystemProperty(key, LogString()));
+				record(snapshot.environment, key, replacement);
+
+				if (replacement.empty())
+				{
+					replacement = variables.getProperty(key);
+				}
+
+				if (!replacement.empty())
+				{
+					result.append(resolve(replacement));
+				}
+
+				i = k + 1;
+			}
+		}
+
+		/**
+		 *  Adds an option kept as written, along with the variables of the
+		 *  configuration it refers to.
+		 */
+		void addOption(Component& component, const LogString& name, const LogString& value)
+		{
+			const logchar delimStart[] = { 0x24, 0x7B, 0 };
+			Option option;
+			option.name = name;
+			option.value = value;
+			option.substitute = value.find(delimStart) != LogString::npos;
+			component.options.push_back(option);
+
+			if (option.substitute)
+			{
+				addVariables(value);
+			}
+		}
+
+		bool resolveClass(const LogString& className, const LogString& context,
+			const Class& expected, Component& component)
+		{
+			try
+			{
+				const Class& clazz = Loader::loadClass(StringHelper::trim(resolve(className)));
+				ObjectPtr instance(clazz.newInstance());
+
+				if (instance == 0 || !instance->instanceof(expected))
+				{
+					LogLog::error(LOG4CXXNG_STR("Class [") + clazz.getName()
+						+ LOG4CXXNG_STR("] for [") + context
+						+ LOG4CXXNG_STR("] is not a ") + expected.getName()
+						+ LOG4CXXNG_STR("."));
+					valid = false;
+					return false;
+				}
+
+				component.className = StringHelper::toLowerCase(clazz.getName());
+				probe = instance;
+				return true;
+			}
+			catch (Exception& e)
+			{
+				LogLog::error(LOG4CXXNG_STR("Could not resolve class for [")
+					+ context + LOG4CXXNG_STR("]."), e);
+				valid = false;
+				return false;
+			}
+		}
+
+		void addEnvironment(const LogString& key)
+		{
+			record(snapshot.environment, key,
+				OptionConverter::getSystemProperty(key, LogString()));
+		}
+
+		Snapshot& snapshot;
+		Properties& variables;
+		bool valid;
+
+		/**
+		 *  Instance created by the last successful resolveClass.
+		 */
+		ObjectPtr probe;
+
+	private:
+		void addVariables(const LogString& value)
+		{
+			const logchar delimStart[] = { 0x24, 0x7B, 0 };
+			size_t j = value.find(delimStart);
+
+			while (j != LogString::npos)
+			{
+				size_t k = value.find((logchar) 0x7D /* '}' */, j);
+
+				if (k == LogString::npos)
+				{
+					return;
+				}
+
+				LogString key(value, j + 2, k - j - 2);
+				LogString replacement(variables.getProperty(key));
+
+				if (!replacement.empty() && record(snapshot.variables, key, replacement))
+				{
+					addVariables(replacement);
+				}
+
+				j = value.find(delimStart, k);
+			}
+		}
+
+		static bool record(Pairs& pairs, const LogString& key, const LogString& value)
+		{
+			for (Pairs::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
+			{
+				if (it->first == key)
+				{
+					return false;
+				}
+			}
+
+			pairs.push_back(std::make_pair(key, value));
+			return true;
+		}
+};
+
+/**
+ *  Compiles a configuration in PropertyConfigurator format.
+ */
+class PropertiesCompiler : public SnapshotCompiler
+{
+	public:
+		PropertiesCompiler(Snapshot& snapshot1, Properties& props1)
+			: SnapshotCompiler(snapshot1, props1), props(props1)
+		{
+		}
+
+		bool compile()
+		{
+			static const LogString ROOT_LOGGER_KEY(LOG4CXXNG_STR("log4j.rootLogger"));
+			static const LogString ROOT_CATEGORY_KEY(LOG4CXXNG_STR("log4j.rootCategory"));
+			static const LogString LOGGER_PREFIX(LOG4CXXNG_STR("log4j.logger."));
+			static const LogString CATEGORY_PREFIX(LOG4CXXNG_STR("log4j.category."));
+			static const LogString ADDITIVITY_PREFIX(LOG4CXXNG_STR("log4j.additivity."));
+			static const LogString FACTORY_KEY(LOG4CXXNG_STR("log4j.loggerFactory"));
+
+			snapshot.debug = props.getProperty(LOG4CXXNG_STR("log4j.debug"));
+			snapshot.threshold = resolve(props.getProperty(LOG4CXXNG_STR("log4j.threshold")));
+			snapshot.staticStream =
+				props.getProperty(LOG4CXXNG_STR("log4j.stringstream")) == LOG4CXXNG_STR("static");
+
+			LogString factoryClassName(props.getProperty(FACTORY_KEY));
+
+			if (!factoryClassName.empty()
+				&& resolveClass(factoryClassName, FACTORY_KEY,
+					LoggerFactory::getStaticClass(), snapshot.factory))
+			{
+				snapshot.hasFactory = 1;
+				addOptions(snapshot.factory, LOG4CXXNG_STR("log4j.factory."));
+			}
+
+			LogString key(ROOT_LOGGER_KEY);
+			LogString value(props.getProperty(key));
+
+			if (value.empty())
+			{
+				key = ROOT_CATEGORY_KEY;
+				value = props.getProperty(key);
+			}
+
+			if (!value.empty())
+			{
+				LoggerEntry root;
+				root.root = 1;
+				compileLogger(root, key, resolve(value));
+				snapshot.loggers.push_back(root);
+			}
+
+			std::vector<LogString> names(props.propertyNames());
+
+			for (std::vector<LogString>::const_iterator it = names.begin(); it != names.end(); ++it)
+			{
+				LoggerEntry logger;
+
+				if (it->find(LOGGER_PREFIX) == 0)
+				{
+					logger.name = it->substr(LOGGER_PREFIX.length());
+				}
+				else if (it->find(CATEGORY_PREFIX) == 0)
+				{
+					logger.name = it->substr(CATEGORY_PREFIX.length());
+				}
+				else
+				{
+					continue;
+				}
+
+				compileLogger(logger, *it, resolve(props.getProperty(*it)));
+				LogString additivity(resolve(props.getProperty(ADDITIVITY_PREFIX + logger.name)));
+
+				if (!additivity.empty())
+				{
+					logger.additivity = OptionConverter::toBoolean(additivity, true) ? SET : DISABLED;
+				}
+
+				snapshot.loggers.push_back(logger);
+			}
+
+			return valid;
+		}
+
+	private:
+		void compileLogger(LoggerEntry& logger, const LogString& key, const LogString& value)
+		{
+			StringTokenizer st(value, LOG4CXXNG_STR(","));
+
+			if (value.find(LOG4CXXNG_STR(",")) != 0 && st.hasMoreTokens())
+			{
+				LogString level(st.nextToken());
+
+				if (isInherited(level))
+				{
+					if (logger.root)
+					{
+						LogLog::warn(LOG4CXXNG_STR("The root logger cannot be set to null."));
+					}
+					else
+					{
+						logger.levelKind = INHERITED;
+					}
+				}
+				else
+				{
+					logger.levelKind = SET;
+					logger.level = level;
+				}
+			}
+
+			while (st.hasMoreTokens())
+			{
+				LogString appenderName(StringHelper::trim(st.nextToken()));
+
+				if (!appenderName.empty())
+				{
+					unsigned int index = compileAppender(appenderName, key);
+
+					if (index != NO_APPENDER)
+					{
+						logger.appenders.push_back(index);
+					}
+				}
+			}
+		}
+
+		unsigned int compileAppender(const LogString& appenderName, const LogString& key)
+		{
+			static const LogString APPENDER_PREFIX(LOG4CXXNG_STR("log4j.appender."));
+			std::map<LogString, unsigned int>::const_iterator known = indexes.find(appenderName);
+
+			if (known != indexes.end())
+			{
+				return known->second;
+			}
+
+			LogString prefix(APPENDER_PREFIX + appenderName);
+			LogString className(props.getProperty(prefix));
+
+			if (className.empty())
+			{
+				LogLog::error(LOG4CXXNG_STR("Appender [") + appenderName
+					+ LOG4CXXNG_STR("] referenced by [") + key
+					+ LOG4CXXNG_STR("] is not defined."));
+				valid = false;
+				return NO_APPENDER;
+			}
+
+			AppenderEntry entry;
+			entry.name = appenderName;
+
+			if (!resolveClass(className, prefix, Appender::getStaticClass(), entry.component))
+			{
+				return NO_APPENDER;
+			}
+
+			AppenderPtr appender(probe);
+			LogString layoutPrefix(prefix + LOG4CXXNG_STR(".layout"));
+			LogString layoutClassName(props.getProperty(layoutPrefix));
+
+			if (appender->requiresLayout() && !layoutClassName.empty())
+			{
+				Component layout;
+				layout.role = LAYOUT;
+
+				if (resolveClass(layoutClassName, layoutPrefix, Layout::getStaticClass(), layout))
+				{
+					addOptions(layout, layoutPrefix + LOG4CXXNG_STR("."));
+					entry.component.children.push_back(layout);
+				}
+			}
+
+			addOptions(entry.component, prefix + LOG4CXXNG_STR("."));
+			unsigned int index = (unsigned int) snapshot.appenders.size();
+			snapshot.appenders.push_back(entry);
+			indexes[appenderName] = index;
+			return index;
+		}
+
+		/**
+		 *  Adds the options PropertySetter would set from the keys directly
+		 *  below prefix.
+		 */
+		void addOptions(Component& component, const LogString& prefix)
+		{
+			std::vector<LogString> names(props.propertyNames());
+
+			for (std::vector<LogString>::const_iterator it = names.begin(); it != names.end(); ++it)
+			{
+				if (it->find(prefix) == 0
+					&& it->find(0x2E /* '.' */, prefix.length() + 1) == LogString::npos)
+				{
+					LogString option(it->substr(prefix.length()));
+
+					if (option != LOG4CXXNG_STR("layout"))
+					{
+						addOption(component, option, props.getProperty(*it));
+					}
+				}
+			}
+		}
+
+		Properties& props;
+		std::map<LogString, unsigned int> indexes;
+};
+
+/**
+ *  Compiles a configuration in DOMConfigurator format.
+ */
+class XMLCompiler : public SnapshotCompiler
+{
+	public:
+		XMLCompiler(Snapshot& snapshot1)
+			: SnapshotCompiler(snapshot1, noVariables), document(0)
+		{
+		}
+
+		bool compile(apr_xml_elem* root)
+		{
+			static const LogString NuLL(LOG4CXXNG_STR("NULL"));
+			std::string rootName(root->name);
+			document = root;
+
+			if (rootName != "log4j:configuration" && rootName != "configuration")
+			{
+				LogLog::error(LOG4CXXNG_STR("DOM element is - not a <configuration> element."));
+				return false;
+			}
+
+			LogString debug(resolve(getAttribute(root, "debug")));
+
+			if (debug.empty() || debug == NuLL)
+			{
+				debug = resolve(getAttribute(root, "configDebug"));
+			}
+
+			if (!debug.empty() && debug != NuLL)
+			{
+				snapshot.debug = debug;
+			}
+
+			LogString threshold(resolve(getAttribute(root, "threshold")));
+
+			if (threshold != NuLL)
+			{
+				snapshot.threshold = threshold;
+			}
+
+			LogString stringstream(resolve(getAttribute(root, "stringstream")));
+			snapshot.staticStream = !stringstream.empty() && stringstream != NuLL;
+
+			for (apr_xml_elem* element = root->first_child; element; element = element->next)
+			{
+				if (std::string(element->name) == "categoryFactory"
+					&& compileComponent(element, 0, LoggerFactory::getStaticClass(), snapshot.factory))
+				{
+					snapshot.hasFactory = 1;
+				}
+			}
+
+			for (apr_xml_elem* element = root->first_child; element; element = element->next)
+			{
+				std::string tagName(element->name);
+
+				if (tagName == "logger" || tagName == "category")
+				{
+					LoggerEntry logger;
+					logger.name = resolve(getAttribute(element, "name"));
+					logger.additivity = OptionConverter::toBoolean(
+							resolve(getAttribute(element, "additivity")), true) ? SET : DISABLED;
+					compileLogger(element, logger);
+					snapshot.loggers.push_back(logger);
+				}
+				else if (tagName == "root")
+				{
+					LoggerEntry logger;
+					logger.root = 1;
+					compileLogger(element, logger);
+					snapshot.loggers.push_back(logger);
+				}
+			}
+
+			return valid;
+		}
+
+	private:
+		static LogString getAttribute(apr_xml_elem* element, const char* name)
+		{
+			LogString value;
+
+			for (apr_xml_attr* attr = element->attr; attr; attr = attr->next)
+			{
+				if (strcmp(attr->name, name) == 0)
+				{
+					value.erase();
+					Transcoder::decodeUTF8(std::string(attr->value), value);
+				}
+			}
+
+			return value;
+		}
+
+		void compileLogger(apr_xml_elem* loggerElement, LoggerEntry& logger)
+		{
+			for (apr_xml_elem* element = loggerElement->first_child; element; element = element->next)
+			{
+				std::string tagName(element->name);
+
+				if (tagName == "appender-ref")
+				{
+					unsigned int index = findAppender(resolve(getAttribute(element, "ref")));
+
+					if (index != NO_APPENDER)
+					{
+						logger.appenders.push_back(index);
+					}
+				}
+				else if (tagName == "level" || tagName == "priority")
+				{
+					LogString level(resolve(getAttribute(element, "value")));
+					LogString className(resolve(getAttribute(element, "class")));
+
+					if (isInherited(level))
+					{
+						if (logger.root)
+						{
+							LogLog::error(LOG4CXXNG_STR("Root level cannot be inherited. Ignoring directive."));
+						}
+						else
+						{
+							logger.levelKind = INHERITED;
+						}
+					}
+					else
+					{
+						logger.levelKind = SET;
+						logger.level = level;
+
+						if (!className.empty())
+						{
+							Component levelClass;
+
+							if (resolveLevelClass(className, levelClass))
+							{
+								logger.levelClass = levelClass.className;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		bool resolveLevelClass(const LogString& className, Component& component)
+		{
+			try
+			{
+				const Class& clazz = Loader::loadClass(className);
+
+				if (dynamic_cast<const Level::LevelClass*>(&clazz) == 0)
+				{
+					LogLog::error(LOG4CXXNG_STR("Class [") + className
+						+ LOG4CXXNG_STR("] is not a level class."));
+					valid = false;
+					return false;
+				}
+
+				component.className = StringHelper::toLowerCase(clazz.getName());
+				return true;
+			}
+			catch (Exception& e)
+			{
+				LogLog::error(LOG4CXXNG_STR("Could not resolve level class [")
+					+ className + LOG4CXXNG_STR("]."), e);
+				valid = false;
+				return false;
+			}
+		}
+
+		static apr_xml_elem* findElement(apr_xml_elem* element, const LogString& appenderName)
+		{
+			for (; element; element = element->next)
+			{
+				if (std::string(element->name) == "appender"
+					&& getAttribute(element, "name") == appenderName)
+				{
+					return element;
+				}
+
+				apr_xml_elem* found = findElement(element->first_child, appenderName);
+
+				if (found != 0)
+				{
+					return found;
+				}
+			}
+
+			return 0;
+		}
+
+		unsigned int findAppender(const LogString& appenderName)
+		{
+			std::map<LogString, unsigned int>::const_iterator known = indexes.find(appenderName);
+
+			if (known != indexes.end())
+			{
+				if (known->second == NO_APPENDER)
+				{
+					LogLog::error(LOG4CXXNG_STR("Appender [") + appenderName
+						+ LOG4CXXNG_STR("] refers to itself."));
+					valid = false;
+				}
+
+				return known->second;
+			}
+
+			apr_xml_elem* element = findElement(document, appenderName);
+
+			if (element == 0)
+			{
+				LogLog::error(LOG4CXXNG_STR("No appender named [") + appenderName
+					+ LOG4CXXNG_STR("] could be found."));
+				valid = false;
+				return NO_APPENDER;
+			}
+
+			AppenderEntry entry;
+			entry.name = resolve(appenderName);
+			indexes[appenderName] = NO_APPENDER;
+
+			if (!compileComponent(element, 0, Appender::getStaticClass(), entry.component))
+			{
+				return NO_APPENDER;
+			}
+
+			bool attachable = probe->instanceof(AppenderAttachable::getStaticClass());
+
+			for (apr_xml_elem* child = element->first_child; child; child = child->next)
+			{
+				std::string tagName(child->name);
+
+				if (tagName == "errorHandler")
+				{
+					LogLog::error(LOG4CXXNG_STR("The error handler of appender [") + appenderName
+						+ LOG4CXXNG_STR("] cannot be stored in a snapshot."));
+					valid = false;
+				}
+				else if (tagName == "appender-ref")
+				{
+					LogString refName(resolve(getAttribute(child, "ref")));
+
+					if (!attachable)
+					{
+						LogLog::error(LOG4CXXNG_STR("Requesting attachment of appender named [") +
+							refName + LOG4CXXNG_STR("] to appender named [") + appenderName +
+							LOG4CXXNG_STR("] which does not implement AppenderAttachable."));
+						valid = false;
+						continue;
+					}
+
+					unsigned int ref = findAppender(refName);
+
+					if (ref != NO_APPENDER)
+					{
+						entry.refs.push_back(ref);
+					}
+				}
+			}
+
+			unsigned int index = (unsigned int) snapshot.appenders.size();
+			snapshot.appenders.push_back(entry);
+			indexes[appenderName] = index;
+			return index;
+		}
+
+		/**
+		 *  Compiles the class, the parameters and the nested layout,
+		 *  filters and policies of an element.
+		 */
+		bool compileComponent(apr_xml_elem* element, unsigned int role,
+			const Class& expected, Component& component)
+		{
+			LogString context(LOG4CXXNG_STR("<"));
+			Transcoder::decode(element->name, context);
+			context.append(1, (logchar) 0x3E /* '>' */);
+			component.role = role;
+
+			if (!resolveClass(getAttribute(element, "class"), context, expected, component))
+			{
+				return false;
+			}
+
+			ObjectPtr instance(probe);
+
+			for (apr_xml_elem* child = element->first_child; child; child = child->next)
+			{
+				std::string tagName(child->name);
+				Component nested;
+
+				if (tagName == "param")
+				{
+					addOption(component, resolve(getAttribute(child, "name")),
+						getAttribute(child, "value"));
+				}
+				else if (tagName == "layout")
+				{
+					if (compileComponent(child, LAYOUT, Layout::getStaticClass(), nested))
+					{
+						component.children.push_back(nested);
+					}
+				}
+				else if (tagName == "filter")
+				{
+					if (compileComponent(child, FILTER, Filter::getStaticClass(), nested))
+					{
+						component.children.push_back(nested);
+					}
+				}
+				else if (tagName == "rollingPolicy")
+				{
+					if (compileComponent(child, ROLLING_POLICY, Object::getStaticClass(), nested))
+					{
+						component.children.push_back(nested);
+					}
+				}
+				else if (tagName == "triggeringPolicy")
+				{
+					if (compileComponent(child, TRIGGERING_POLICY, Object::getStaticClass(), nested))
+					{
+						component.children.push_back(nested);
+					}
+				}
+			}
+
+			probe = instance;
+			return true;
+		}
+
+		Properties noVariables;
+		apr_xml_elem* document;
+		std::map<LogString, unsigned int> indexes;
+};
+
+bool writeSnapshot(const Snapshot& snapshot, const File& snapshotFile)
+{
+	std::string contents(encodeSnapshot(snapshot));
+
+	// Write next to the destination and rename, so that a process
+	// starting concurrently never maps a partial snapshot.
+	Pool p;
+	File tmp;
+	tmp.setPath(snapshotFile.getPath() + LOG4CXXNG_STR(".tmp"));
+	apr_file_t* fd;
+
+	if (tmp.open(&fd, APR_WRITE | APR_CREATE | APR_TRUNCATE | APR_BINARY,
+			APR_OS_DEFAULT, p) != APR_SUCCESS)
+	{
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not create configuration snapshot ["))
+			+ tmp.getPath() + LOG4CXXNG_STR("]."));
+		return false;
+	}
+
+	apr_status_t stat = apr_file_write_full(fd, contents.data(), contents.size(), NULL);
+	apr_file_close(fd);
+
+	if (stat != APR_SUCCESS || !tmp.renameTo(snapshotFile, p))
+	{
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not write configuration snapshot ["))
+			+ snapshotFile.getPath() + LOG4CXXNG_STR("]."));
+		tmp.deleteFile(p);
+		return false;
+	}
+
+	return true;
+}
+
+bool readSnapshot(const File& snapshotFile, Snapshot& snapshot)
+{
+	Pool p;
+	apr_file_t* fd;
+
+	if (snapshotFile.open(&fd, APR_READ | APR_BINARY, APR_OS_DEFAULT, p) != APR_SUCCESS)
+	{
+		return false;
+	}
+
+	apr_finfo_t finfo;
+	bool valid = false;
+
+	if (apr_file_info_get(&finfo, APR_FINFO_SIZE, fd) == APR_SUCCESS && finfo.size > 0)
+	{
+		apr_size_t length = (apr_size_t) finfo.size;
+#if APR_HAS_MMAP
+		apr_mmap_t* mm;
+
+		if (apr_mmap_create(&mm, fd, 0, length, APR_MMAP_READ, p.getAPRPool()) == APR_SUCCESS)
+		{
+			valid = SnapshotReader((const char*) mm->mm, length).read(snapshot);
+			apr_mmap_delete(mm);
+		}
+		else
+#endif
+		{
+			std::string contents(length, 0);
+
+			if (apr_file_read_full(fd, &contents[0], length, NULL) == APR_SUCCESS)
+			{
+				valid = SnapshotReader(contents.data(), length).read(snapshot);
+			}
+		}
+	}
+
+	apr_file_close(fd);
+	return valid;
+}
+
+bool resolveClasses(Component& component)
+{
+	component.clazz = Class::findRegistered(component.className);
+
+	if (component.clazz == 0)
+	{
+		LogLog::error(LOG4CXXNG_STR("Class [") + component.className
+			+ LOG4CXXNG_STR("] of the configuration snapshot is not registered."));
+		return false;
+	}
+
+	for (std::vector<Component>::iterator it = component.children.begin();
+		it != component.children.end(); ++it)
+	{
+		if (!resolveClasses(*it))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ *  Returns true if the snapshot can be applied in this process: the
+ *  system properties its structure depends on are unchanged and all of
+ *  its classes are registered.
+ */
+bool isCurrent(Snapshot& snapshot)
+{
+	for (Pairs::const_iterator it = snapshot.environment.begin(); it != snapshot.environment.end(); ++it)
+	{
+		if (OptionConverter::getSystemProperty(it->first, LogString()) != it->second)
+		{
+			LogLog::debug(LOG4CXXNG_STR("System property [") + it->first
+				+ LOG4CXXNG_STR("] changed since the configuration snapshot was written."));
+			return false;
+		}
+	}
+
+	if (snapshot.hasFactory && !resolveClasses(snapshot.factory))
+	{
+		return false;
+	}
+
+	for (std::vector<AppenderEntry>::iterator it = snapshot.appenders.begin();
+		it != snapshot.appenders.end(); ++it)
+	{
+		if (!resolveClasses(it->component))
+		{
+			return false;
+		}
+	}
+
+	for (std::vector<LoggerEntry>::iterator it = snapshot.loggers.begin();
+		it != snapshot.loggers.end(); ++it)
+	{
+		if (!it->levelClass.empty())
+		{
+			it->levelClazz = Class::findRegistered(it->levelClass);
+
+			if (dynamic_cast<const Level::LevelClass*>(it->levelClazz) == 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ *  Builds the appenders of a snapshot and stages its loggers.
+ */
+class SnapshotLoader
+{
+	public:
+		SnapshotLoader(Snapshot& snapshot1, Reconfiguration& staged1)
+			: snapshot(snapshot1), staged(staged1),
+			  appenders(snapshot1.appenders.size()), states(snapshot1.appenders.size(), 0)
+		{
+			for (Pairs::const_iterator it = snapshot.variables.begin(); it != snapshot.variables.end(); ++it)
+			{
+				variables.setProperty(it->first, it->second);
+			}
+		}
+
+		void load(LoggerRepositoryPtr& repository)
+		{
+			LoggerFactoryPtr loggerFactory(new DefaultLoggerFactory());
+
+			if (snapshot.hasFactory)
+			{
+				ObjectPtr factory(create(snapshot.factory));
+				LoggerFactoryPtr configured(factory);
+
+				if (configured != 0)
+				{
+					loggerFactory = configured;
+				}
+			}
+
+			for (std::vector<LoggerEntry>::const_iterator it = snapshot.loggers.begin();
+				it != snapshot.loggers.end(); ++it)
+			{
+				LoggerPtr logger(it->root ? repository->getRootLogger()
+					: repository->getLogger(it->name, loggerFactory));
+
+				if (it->levelKind == INHERITED)
+				{
+					staged.setLevel(logger, 0);
+				}
+				else if (it->levelKind == SET && it->levelClazz != 0)
+				{
+					staged.setLevel(logger,
+						((const Level::LevelClass*) it->levelClazz)->toLevel(it->level));
+				}
+				else if (it->levelKind == SET)
+				{
+					staged.setLevel(logger, OptionConverter::toLevel(it->level, Level::getDebug()));
+				}
+
+				if (it->additivity != UNSET)
+				{
+					staged.setAdditivity(logger, it->additivity == SET);
+				}
+
+				staged.removeAllAppenders(logger);
+
+				for (std::vector<unsigned int>::const_iterator index = it->appenders.begin();
+					index != it->appenders.end(); ++index)
+				{
+					AppenderPtr appender(getAppender(*index));
+
+					if (appender != 0)
+					{
+						staged.addLoggerAppender(logger, appender);
+					}
+				}
+			}
+		}
+
+	private:
+		enum { NOT_BUILT, BUILDING, BUILT };
+
+		LogString subst(const Option& option)
+		{
+			if (!option.substitute)
+			{
+				return option.value;
+			}
+
+			try
+			{
+				return OptionConverter::substVars(option.value, variables);
+			}
+			catch (IllegalArgumentException& e)
+			{
+				LogLog::error(((LogString) LOG4CXXNG_STR("Bad option value ["))
+					+ option.value + LOG4CXXNG_STR("]."), e);
+				return option.value;
+			}
+		}
+
+		/**
+		 *  Describes what an appender is built from, values substituted,
+		 *  so that an unchanged appender is reused on reconfiguration.
+		 */
+		void appendSignature(const Component& component, LogString& signature)
+		{
+			signature.append(component.className);
+			signature.append(1, (logchar) 0x0A /* '\n' */);
+
+			for (std::vector<Option>::const_iterator it = component.options.begin();
+				it != component.options.end(); ++it)
+			{
+				signature.append(it->name);
+				signature.append(1, (logchar) 0x3D /* '=' */);
+				signature.append(subst(*it));
+				signature.append(1, (logchar) 0x0A /* '\n' */);
+			}
+
+			for (std::vector<Component>::const_iterator it = component.children.begin();
+				it != component.children.end(); ++it)
+			{
+				signature.append(1, (logchar) 0x7B /* '{' */);
+				appendSignature(*it, signature);
+				signature.append(1, (logchar) 0x7D /* '}' */);
+			}
+		}
+
+		/**
+		 *  Instantiates a component and sets its options, without
+		 *  activating it.
+		 */
+		ObjectPtr instantiate(const Component& component)
+		{
+			ObjectPtr instance(component.clazz->newInstance());
+			OptionHandlerPtr handler(instance);
+
+			if (handler != 0)
+			{
+				for (std::vector<Option>::const_iterator it = component.options.begin();
+					it != component.options.end(); ++it)
+				{
+					LogString value(subst(*it));
+
+					if (!value.empty())
+					{
+						handler->setOption(it->name, value);
+					}
+				}
+			}
+
+			return instance;
+		}
+
+		void activate(const ObjectPtr& instance)
+		{
+			OptionHandlerPtr handler(instance);
+
+			if (handler != 0)
+			{
+				handler->activateOptions(pool);
+			}
+		}
+
+		ObjectPtr create(const Component& component)
+		{
+			ObjectPtr instance(instantiate(component));
+			rolling::FilterBasedTriggeringPolicyPtr filterBased(instance);
+
+			for (std::vector<Component>::const_iterator it = component.children.begin();
+				it != component.children.end(); ++it)
+			{
+				if (it->role == FILTER && filterBased != 0)
+				{
+					filterBased->addFilter(create(*it));
+				}
+			}
+
+			activate(instance);
+			return instance;
+		}
+
+		AppenderPtr getAppender(unsigned int index)
+		{
+			if (states[index] == BUILDING)
+			{
+				return 0;
+			}
+
+			if (states[index] == NOT_BUILT)
+			{
+				states[index] = BUILDING;
+				appenders[index] = buildAppender(snapshot.appenders[index]);
+				states[index] = BUILT;
+			}
+
+			return appenders[index];
+		}
+
+		AppenderPtr buildAppender(const AppenderEntry& entry)
+		{
+			LogString signature;
+			appendSignature(entry.component, signature);
+
+			for (std::vector<unsigned int>::const_iterator it = entry.refs.begin();
+				it != entry.refs.end(); ++it)
+			{
+				signature.append(LOG4CXXNG_STR("ref="));
+				signature.append(snapshot.appenders[*it].name);
+				signature.append(1, (logchar) 0x0A /* '\n' */);
+			}
+
+			AppenderPtr previous(staged.reuseAppender(entry.name, signature));
+
+			if (previous != 0)
+			{
+				return previous;
+			}
+
+			try
+			{
+				AppenderPtr appender(instantiate(entry.component));
+				appender->setName(entry.name);
+				std::vector<FilterPtr> filters;
+
+				for (std::vector<Component>::const_iterator it = entry.component.children.begin();
+					it != entry.component.children.end(); ++it)
+				{
+					ObjectPtr child(create(*it));
+
+					if (it->role == LAYOUT)
+					{
+						appender->setLayout(child);
+					}
+					else if (it->role == FILTER)
+					{
+						filters.push_back(child);
+					}
+					else if (it->role == ROLLING_POLICY)
+					{
+						rolling::RollingFileAppenderPtr rolling(appender);
+
+						if (rolling != 0)
+						{
+							rolling->setRollingPolicy(child);
+						}
+					}
+					else if (it->role == TRIGGERING_POLICY)
+					{
+						rolling::RollingFileAppenderPtr rolling(appender);
+						net::SMTPAppenderPtr smtp(appender);
+
+						if (rolling != 0)
+						{
+							rolling->setTriggeringPolicy(child);
+						}
+						else if (smtp != 0)
+						{
+							TriggeringEventEvaluatorPtr evaluator(child);
+							smtp->setEvaluator(evaluator);
+						}
+					}
+				}
+
+				AppenderAttachablePtr attachable(appender);
+
+				for (std::vector<unsigned int>::const_iterator it = entry.refs.begin();
+					it != entry.refs.end() && attachable != 0; ++it)
+				{
+					AppenderPtr nested(getAppender(*it));
+
+					if (nested != 0)
+					{
+						attachable->addAppender(nested);
+					}
+				}
+
+				//
+				//   consecutive string match filters are scanned in one pass
+				//
+				filter::MultiStringMatchFilter::compile(filters);
+
+				for (std::vector<FilterPtr>::iterator it = filters.begin(); it != filters.end(); ++it)
+				{
+					appender->addFilter(*it);
+				}
+
+				activate(appender);
+				staged.addAppender(appender, signature);
+				return appender;
+			}
+			catch (Exception& oops)
+			{
+				LogLog::error(LOG4CXXNG_STR("Could not create appender [") + entry.name
+					+ LOG4CXXNG_STR("] from the configuration snapshot."), oops);
+				return 0;
+			}
+		}
+
+		Snapshot& snapshot;
+		Reconfiguration& staged;
+		Properties variables;
+		Pool pool;
+		std::vector<AppenderPtr> appenders;
+		std::vector<int> states;
+};
+}
+
+SnapshotConfigurator::SnapshotConfigurator()
+{
+}
+
+void SnapshotConfigurator::addRef() const
+{
+	ObjectImpl::addRef();
+}
+
+void SnapshotConfigurator::releaseRef() const
+{
+	ObjectImpl::releaseRef();
+}
+
+void SnapshotConfigurator::configure(const File& snapshotFile)
+{
+	SnapshotConfigurator().doConfigure(snapshotFile, LogManager::getLoggerRepository());
+}
+
+void SnapshotConfigurator::doConfigure(const File& snapshotFile,
+	spi::LoggerRepositoryPtr& repository)
+{
+	repository->setConfigured(true);
+	Snapshot snapshot;
+	bool readable = readSnapshot(snapshotFile, snapshot);
+	Pool p;
+	File source;
+
+	if (readable && !snapshot.source.empty())
+	{
+		source.setPath(snapshot.source);
+	}
+
+	if (!readable || !isCurrent(snapshot)
+		|| (source.exists(p) && source.lastModified(p) > snapshotFile.lastModified(p)))
+	{
+		if (!source.exists(p))
+		{
+			LogLog::error(((LogString) LOG4CXXNG_STR("Could not use configuration snapshot ["))
+				+ snapshotFile.getPath() + LOG4CXXNG_STR("]."));
+			return;
+		}
+
+		LogLog::debug(((LogString) LOG4CXXNG_STR("Configuration snapshot ["))
+			+ snapshotFile.getPath() + LOG4CXXNG_STR("] is stale, using [")
+			+ source.getPath() + LOG4CXXNG_STR("]."));
+		OptionConverter::selectAndConfigure(source, LogString(), repository);
+		return;
+	}
+
+	if (!snapshot.debug.empty())
+	{
+		LogLog::setInternalDebugging(OptionConverter::toBoolean(snapshot.debug, true));
+	}
+
+	if (!snapshot.threshold.empty())
+	{
+		repository->setThreshold(OptionConverter::toLevel(snapshot.threshold, Level::getAll()));
+	}
+
+	if (snapshot.staticStream)
+	{
+		MessageBufferUseStaticStream();
+	}
+
+	// Loggers and appenders are staged off to the side and published in
+	// one step, as the other configurators do.
+	Reconfiguration staged(repository);
+	SnapshotLoader(snapshot, staged).load(repository);
+	staged.commit();
+	LogLog::debug(LOG4CXXNG_STR("Finished configuring from snapshot."));
+}
+
+bool SnapshotConfigurator::write(Properties& properties, const File& snapshotFile)
+{
+	Snapshot snapshot;
+
+	if (!PropertiesCompiler(snapshot, properties).compile())
+	{
+		return false;
+	}
+
+	return writeSnapshot(snapshot, snapshotFile);
+}
+
+bool SnapshotConfigurator::write(const File& configFile, const File& snapshotFile)
+{
+	Snapshot snapshot;
+	Pool p;
+	snapshot.source = configFile.getPath();
+
+	if (!StringHelper::endsWith(configFile.getPath(), LOG4CXXNG_STR(".xml")))
+	{
+		Properties props;
+
+		try
+		{
+			props.load(new FileInputStream(configFile));
+		}
+		catch (const IOException&)
+		{
+			LogLog::error(((LogString) LOG4CXXNG_STR("Could not read configuration file ["))
+				+ configFile.getPath() + LOG4CXXNG_STR("]."));
+			return false;
+		}
+
+		return PropertiesCompiler(snapshot, props).compile()
+			&& writeSnapshot(snapshot, snapshotFile);
+	}
+
+	apr_file_t* fd;
+
+	if (configFile.open(&fd, APR_READ, APR_OS_DEFAULT, p) != APR_SUCCESS)
+	{
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not open file ["))
+			+ configFile.getPath() + LOG4CXXNG_STR("]."));
+		return false;
+	}
+
+	apr_xml_parser* parser = NULL;
+	apr_xml_doc* doc = NULL;
+	apr_status_t rv = apr_xml_parse_file(p.getAPRPool(), &parser, &doc, fd, 2000);
+	apr_file_close(fd);
+
+	if (rv != APR_SUCCESS)
+	{
+		LogLog::error(((LogString) LOG4CXXNG_STR("Error parsing file ["))
+			+ configFile.getPath() + LOG4CXXNG_STR("]."));
+		return false;
+	}
+
+	return XMLCompiler(snapshot).compile(doc->root)
+		&& writeSnapshot(snapshot, snapshotFile);
+}
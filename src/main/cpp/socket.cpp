@@ -158,4 +158,9 @@ int Socket::getPort() const
 	return port;
 }
 
+apr_socket_t* Socket::getAPRSocket() const
+{
+	return socket;
+}
+
 
@@ -0,0 +1,648 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/helpers/socketfanout.h>
+#include <log4cxxNG/helpers/synchronized.h>
+#include <log4cxxNG/helpers/loglog.h>
+#include <log4cxxNG/helpers/stringhelper.h>
+#include <log4cxxNG/helpers/exception.h>
+#include <apr_atomic.h>
+#include <apr_errno.h>
+#include <apr_network_io.h>
+#include <apr_poll.h>
+#include <apr_portable.h>
+#include <apr_signal.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_WIN32)
+	#include <sys/socket.h>
+	#include <errno.h>
+#endif
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+
+namespace
+{
+/**
+ *  Initial client buffer size, in bytes.
+ */
+const size_t DEFAULT_CLIENT_BUFFER_SIZE = 256 * 1024;
+
+/**
+ *  Size hint of the pollset, a hard limit only for the select and
+ *  poll based implementations.
+ */
+const apr_uint32_t POLLSET_SIZE = 1024;
+
+/**
+ *  Maximum time the I/O thread waits without any event, in microseconds.
+ */
+const apr_interval_time_t POLL_TIMEOUT = 1000000;
+
+/**
+ *  Sends without raising SIGPIPE when the client has gone away,
+ *  where the platform allows it per call.
+ */
+apr_status_t sendNoSignal(apr_socket_t* s, const char* data, apr_size_t* len)
+{
+#if defined(MSG_NOSIGNAL)
+	apr_os_sock_t fd;
+	apr_os_sock_get(&fd, s);
+	ssize_t rv;
+
+	do
+	{
+		rv = ::send(fd, data, *len, MSG_NOSIGNAL);
+	}
+	while (rv < 0 && errno == EINTR);
+
+	if (rv < 0)
+	{
+		*len = 0;
+		return APR_FROM_OS_ERROR(errno);
+	}
+
+	*len = (apr_size_t) rv;
+	return APR_SUCCESS;
+#else
+	return apr_socket_send(s, data, len);
+#endif
+}
+}
+
+/**
+ *  Reference counted, immutable block of bytes shared by all clients.
+ *  Only accessed while holding the fan-out mutex.
+ */
+struct SocketFanout::Message
+{
+	unsigned int ref;
+	size_t len;
+	char data[1];
+
+	static Message* create(const char* bytes, size_t len)
+	{
+		Message* msg = (Message*) malloc(sizeof(Message) + len);
+
+		if (msg == 0)
+		{
+			return 0;
+		}
+
+		msg->ref = 1;
+		msg->len = len;
+		memcpy(msg->data, bytes, len);
+		return msg;
+	}
+
+	void addRef()
+	{
+		ref++;
+	}
+
+	void release()
+	{
+		if (--ref == 0)
+		{
+			free(this);
+		}
+	}
+};
+
+/**
+ *  A connected socket and its ring of pending messages.
+ *  Only accessed while holding the fan-out mutex.
+ */
+class SocketFanout::Client
+{
+	public:
+		Client(const SocketPtr& socket1) :
+			socket(socket1), ring(16), head(0), count(0), offset(0),
+			pendingBytes(0), dropped(0), reqevents(0), writable(true),
+			dead(false)
+		{
+			InetAddressPtr remote(socket->getInetAddress());
+
+			if (remote != 0)
+			{
+				address = remote->getHostAddress();
+				address.append(1, (logchar) 0x3A /* ':' */);
+				Pool p;
+				StringHelper::toString(socket->getPort(), p, address);
+			}
+
+			memset(&pfd, 0, sizeof(pfd));
+			pfd.desc_type = APR_POLL_SOCKET;
+			pfd.desc.s = socket->getAPRSocket();
+			pfd.client_data = this;
+		}
+
+		~Client()
+		{
+			while (count > 0)
+			{
+				pop();
+			}
+
+			try
+			{
+				socket->close();
+			}
+			catch (Exception&)
+			{
+			}
+		}
+
+		void push(Message* msg)
+		{
+			if (count == ring.size())
+			{
+				std::vector<Message*> larger(ring.size() * 2);
+
+				for (size_t i = 0; i < count; i++)
+				{
+					larger[i] = ring[(head + i) % ring.size()];
+				}
+
+				ring.swap(larger);
+				head = 0;
+			}
+
+			msg->addRef();
+			ring[(head + count) % ring.size()] = msg;
+			count++;
+			pendingBytes += msg->len;
+		}
+
+		void pop()
+		{
+			Message* msg = ring[head];
+			pendingBytes -= msg->len - offset;
+			msg->release();
+			ring[head] = 0;
+			head = (head + 1) % ring.size();
+			count--;
+			offset = 0;
+		}
+
+		/**
+		 *  Writes as much pending data as the socket accepts without blocking.
+		 */
+		void flush()
+		{
+			while (count > 0)
+			{
+				Message* msg = ring[head];
+				apr_size_t written = msg->len - offset;
+				apr_status_t stat = sendNoSignal(pfd.desc.s, msg->data + offset, &written);
+				offset += written;
+				pendingBytes -= written;
+
+				if (offset == msg->len)
+				{
+					pop();
+				}
+
+				if (APR_STATUS_IS_EAGAIN(stat))
+				{
+					writable = false;
+					break;
+				}
+				else if (stat != APR_SUCCESS)
+				{
+					dead = true;
+					break;
+				}
+			}
+		}
+
+		SocketPtr socket;
+		LogString address;
+		apr_pollfd_t pfd;
+		std::vector<Message*> ring;
+		size_t head;
+		size_t count;
+		size_t offset;
+		size_t pendingBytes;
+		unsigned int dropped;
+		apr_int16_t reqevents;
+		bool writable;
+		bool dead;
+
+	private:
+		Client(const Client&);
+		Client& operator=(const Client&);
+};
+
+SocketFanout::SocketFanout() :
+	pool(), mutex(pool), pollset(0), thread(),
+	clientBufferSize(DEFAULT_CLIENT_BUFFER_SIZE),
+	laggardPolicy(DROP_NEWEST), closing(0), wakeupPending(0), dropped(0)
+{
+}
+
+SocketFanout::~SocketFanout()
+{
+	stop();
+}
+
+void SocketFanout::start()
+{
+	synchronized sync(mutex);
+
+	if (pollset != 0)
+	{
+		return;
+	}
+
+	apr_status_t stat = apr_pollset_create_ex(&pollset, POLLSET_SIZE,
+			pool.getAPRPool(), APR_POLLSET_WAKEABLE | APR_POLLSET_NODEFAULT,
+			APR_POLLSET_EPOLL);
+
+	if (stat != APR_SUCCESS)
+	{
+		stat = apr_pollset_create_ex(&pollset, POLLSET_SIZE,
+				pool.getAPRPool(), APR_POLLSET_WAKEABLE, APR_POLLSET_DEFAULT);
+	}
+
+	if (stat != APR_SUCCESS)
+	{
+		pollset = 0;
+		throw SocketException(stat);
+	}
+
+#if !defined(MSG_NOSIGNAL) && !defined(SO_NOSIGPIPE) && APR_HAVE_SIGACTION
+	//
+	//   no per socket protection, so a closed client must not
+	//   terminate the process: ignore SIGPIPE once, unless the
+	//   application handles it
+	//
+	apr_sigfunc_t* old = apr_signal(SIGPIPE, SIG_IGN);
+
+	if (old != SIG_DFL)
+	{
+		apr_signal(SIGPIPE, old);
+	}
+
+#endif
+	apr_atomic_set32(&closing, 0);
+	thread.run(run, this);
+}
+
+void SocketFanout::stop()
+{
+	{
+		synchronized sync(mutex);
+
+		if (pollset == 0)
+		{
+			return;
+		}
+
+		apr_atomic_set32(&closing, 1);
+		apr_pollset_wakeup(pollset);
+	}
+
+	thread.join();
+
+	synchronized sync(mutex);
+
+	while (!clients.empty())
+	{
+		removeClient(clients.size() - 1);
+	}
+
+	for (ClientList::iterator iter = newClients.begin();
+		iter != newClients.end();
+		iter++)
+	{
+		delete *iter;
+	}
+
+	newClients.clear();
+	apr_pollset_destroy(pollset);
+	pollset = 0;
+}
+
+void SocketFanout::addClient(const SocketPtr& socket, const char* prolog, size_t prologLen)
+{
+	apr_socket_t* s = socket->getAPRSocket();
+
+	if (s == 0)
+	{
+		return;
+	}
+
+	apr_socket_opt_set(s, APR_SO_NONBLOCK, 1);
+	apr_socket_timeout_set(s, 0);
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+	apr_os_sock_t fd;
+	apr_os_sock_get(&fd, s);
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+	Client* client = new Client(socket);
+
+	synchronized sync(mutex);
+
+	if (prolog != 0 && prologLen > 0)
+	{
+		Message* msg = Message::create(prolog, prologLen);
+
+		if (msg != 0)
+		{
+			client->push(msg);
+			msg->release();
+		}
+	}
+
+	newClients.push_back(client);
+	wakeup();
+}
+
+void SocketFanout::send(const char* data, size_t len)
+{
+	if (len == 0)
+	{
+		return;
+	}
+
+	synchronized sync(mutex);
+
+	if (clients.empty() && newClients.empty())
+	{
+		return;
+	}
+
+	Message* msg = Message::create(data, len);
+
+	if (msg == 0)
+	{
+		return;
+	}
+
+	ClientList* lists[] = { &clients, &newClients };
+
+	for (size_t l = 0; l < 2; l++)
+	{
+		for (ClientList::iterator iter = lists[l]->begin();
+			iter != lists[l]->end();
+			iter++)
+		{
+			Client* client = *iter;
+
+			if (client->dead)
+			{
+				continue;
+			}
+
+			//
+			//   a message larger than the buffer is still sent
+			//   to a client that has caught up
+			//
+			if (client->count > 0 && client->pendingBytes + len > clientBufferSize)
+			{
+				if (laggardPolicy == DISCONNECT)
+				{
+					client->dead = true;
+				}
+				else
+				{
+					client->dropped++;
+					apr_atomic_inc32(&dropped);
+				}
+
+				continue;
+			}
+
+			client->push(msg);
+		}
+	}
+
+	msg->release();
+	wakeup();
+}
+
+size_t SocketFanout::getClientCount() const
+{
+	synchronized sync(mutex);
+	return clients.size() + newClients.size();
+}
+
+SocketFanout::ClientStatisticsList SocketFanout::getClientStatistics() const
+{
+	synchronized sync(mutex);
+	ClientStatisticsList stats;
+	const ClientList* lists[] = { &clients, &newClients };
+
+	for (size_t l = 0; l < 2; l++)
+	{
+		for (ClientList::const_iterator iter = lists[l]->begin();
+			iter != lists[l]->end();
+			iter++)
+		{
+			ClientStatistics stat;
+			stat.address = (*iter)->address;
+			stat.pendingBytes = (*iter)->pendingBytes;
+			stat.droppedMessages = (*iter)->dropped;
+			stats.push_back(stat);
+		}
+	}
+
+	return stats;
+}
+
+unsigned int SocketFanout::getDroppedCount() const
+{
+	return apr_atomic_read32(const_cast<volatile unsigned int*>(&dropped));
+}
+
+void SocketFanout::setClientBufferSize(size_t bytes)
+{
+	synchronized sync(mutex);
+	clientBufferSize = bytes;
+}
+
+size_t SocketFanout::getClientBufferSize() const
+{
+	return clientBufferSize;
+}
+
+void SocketFanout::setLaggardPolicy(LaggardPolicy policy)
+{
+	synchronized sync(mutex);
+	laggardPolicy = policy;
+}
+
+SocketFanout::LaggardPolicy SocketFanout::getLaggardPolicy() const
+{
+	return laggardPolicy;
+}
+
+SocketFanout::LaggardPolicy SocketFanout::toLaggardPolicy(const LogString& value,
+	LaggardPolicy defaultValue)
+{
+	if (StringHelper::equalsIgnoreCase(value, LOG4CXXNG_STR("DROP"), LOG4CXXNG_STR("drop")))
+	{
+		return DROP_NEWEST;
+	}
+
+	if (StringHelper::equalsIgnoreCase(value, LOG4CXXNG_STR("DISCONNECT"), LOG4CXXNG_STR("disconnect")))
+	{
+		return DISCONNECT;
+	}
+
+	return defaultValue;
+}
+
+void SocketFanout::wakeup()
+{
+	if (pollset != 0 && apr_atomic_xchg32(&wakeupPending, 1) == 0)
+	{
+		apr_pollset_wakeup(pollset);
+	}
+}
+
+void SocketFanout::registerNewClients()
+{
+	for (ClientList::iterator iter = newClients.begin();
+		iter != newClients.end();
+		iter++)
+	{
+		clients.push_back(*iter);
+	}
+
+	newClients.clear();
+}
+
+void SocketFanout::flushClients()
+{
+	size_t i = 0;
+
+	while (i < clients.size())
+	{
+		Client* client = clients[i];
+
+		if (!client->dead && client->writable)
+		{
+			client->flush();
+		}
+
+		if (client->dead)
+		{
+			removeClient(i);
+			continue;
+		}
+
+		apr_int16_t reqevents = APR_POLLIN;
+
+		if (!client->writable)
+		{
+			reqevents |= APR_POLLOUT;
+		}
+
+		if (reqevents != client->reqevents)
+		{
+			if (client->reqevents != 0)
+			{
+				apr_pollset_remove(pollset, &client->pfd);
+			}
+
+			client->pfd.reqevents = reqevents;
+
+			if (apr_pollset_add(pollset, &client->pfd) == APR_SUCCESS)
+			{
+				client->reqevents = reqevents;
+			}
+			else
+			{
+				client->reqevents = 0;
+			}
+		}
+
+		i++;
+	}
+}
+
+void SocketFanout::removeClient(size_t index)
+{
+	Client* client = clients[index];
+
+	if (client->reqevents != 0)
+	{
+		apr_pollset_remove(pollset, &client->pfd);
+	}
+
+	LogLog::debug(LOG4CXXNG_STR("dropped connection ") + client->address);
+	clients.erase(clients.begin() + index);
+	delete client;
+}
+
+void* LOG4CXXNG_THREAD_FUNC SocketFanout::run(apr_thread_t* /* thread */, void* data)
+{
+	SocketFanout* pThis = (SocketFanout*) data;
+	char discard[512];
+
+	while (apr_atomic_read32(&pThis->closing) == 0)
+	{
+		apr_int32_t num = 0;
+		const apr_pollfd_t* descs = 0;
+		apr_status_t stat = apr_pollset_poll(pThis->pollset, POLL_TIMEOUT, &num, &descs);
+		apr_atomic_set32(&pThis->wakeupPending, 0);
+
+		synchronized sync(pThis->mutex);
+
+		if (stat == APR_SUCCESS)
+		{
+			for (apr_int32_t i = 0; i < num; i++)
+			{
+				Client* client = (Client*) descs[i].client_data;
+
+				if (descs[i].rtnevents & (APR_POLLHUP | APR_POLLERR))
+				{
+					client->dead = true;
+				}
+				else if (descs[i].rtnevents & APR_POLLIN)
+				{
+					//
+					//   clients never send anything meaningful,
+					//   read only to detect a closed connection
+					//
+					apr_size_t len = sizeof(discard);
+
+					if (apr_socket_recv(client->pfd.desc.s, discard, &len) != APR_SUCCESS)
+					{
+						client->dead = true;
+					}
+				}
+
+				if (descs[i].rtnevents & APR_POLLOUT)
+				{
+					client->writable = true;
+				}
+			}
+		}
+
+		pThis->registerNewClients();
+		pThis->flushClients();
+	}
+
+	return NULL;
+}
@@ -29,7 +29,6 @@
 #include <apr_atomic.h>
 #include <apr_thread_proc.h>
 #include <log4cxxNG/helpers/objectoutputstream.h>
-#include <log4cxxNG/helpers/socketoutputstream.h>
 #include <log4cxxNG/helpers/exception.h>
 
 using namespace log4cxxng;
@@ -49,13 +48,21 @@ SocketHubAppender::~SocketHubAppender()
 }
 
 SocketHubAppender::SocketHubAppender()
-	: port(DEFAULT_PORT), streams(), locationInfo(false), thread()
+	: port(DEFAULT_PORT), locationInfo(false), fanout(),
+	  eventBuffer(new ByteArrayOutputStream()), thread()
 {
+	Pool p;
+	eventStream = new ObjectOutputStream(eventBuffer, p);
+	eventBuffer->reset();
 }
 
 SocketHubAppender::SocketHubAppender(int port1)
-	: port(port1), streams(), locationInfo(false), thread()
+	: port(port1), locationInfo(false), fanout(),
+	  eventBuffer(new ByteArrayOutputStream()), thread()
 {
+	Pool p;
+	eventStream = new ObjectOutputStream(eventBuffer, p);
+	eventBuffer->reset();
 	startServer();
 }
 
@@ -75,6 +82,14 @@ void SocketHubAppender::setOption(const LogString& option,
 	{
 		setLocationInfo(OptionConverter::toBoolean(value, true));
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("CLIENTBUFFERSIZE"), LOG4CXXNG_STR("clientbuffersize")))
+	{
+		setClientBufferSize(OptionConverter::toInt(value, getClientBufferSize()));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("LAGGARDPOLICY"), LOG4CXXNG_STR("laggardpolicy")))
+	{
+		setLaggardPolicy(value);
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -101,29 +116,9 @@ void SocketHubAppender::close()
 	//
 	thread.join();
 
-	LOCK_W sync(mutex);
 	// close all of the connections
 	LogLog::debug(LOG4CXXNG_STR("closing client connections"));
-
-	for (std::vector<helpers::ObjectOutputStreamPtr>::iterator iter = streams.begin();
-		iter != streams.end();
-		iter++)
-	{
-		if ( (*iter) != NULL)
-		{
-			try
-			{
-				(*iter)->close(pool);
-			}
-			catch (SocketException& e)
-			{
-				LogLog::error(LOG4CXXNG_STR("could not close socket: "), e);
-			}
-		}
-	}
-
-	streams.erase(streams.begin(), streams.end());
-
+	fanout.stop();
 
 	LogLog::debug(LOG4CXXNG_STR("SocketHubAppender ")
 		+ getName() + LOG4CXXNG_STR(" closed"));
@@ -133,7 +128,7 @@ void SocketHubAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 {
 
 	// if no open connections, exit now
-	if (streams.empty())
+	if (fanout.getClientCount() == 0)
 	{
 		return;
 	}
@@ -144,37 +139,68 @@ void SocketHubAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 	// Get a copy of this thread's MDC.
 	event->getMDCCopy();
 
+	//
+	//   serialize once for all clients, the trailing reset
+	//   makes each event independent of the previous ones
+	//   so a client may join between any two events
+	//
+	eventBuffer->reset();
 
-	// loop through the current set of open connections, appending the event to each
-	std::vector<ObjectOutputStreamPtr>::iterator it = streams.begin();
-	std::vector<ObjectOutputStreamPtr>::iterator itEnd = streams.end();
+	try
+	{
+		event->write(*eventStream, p);
+		eventStream->reset(p);
+	}
+	catch (std::exception& e)
+	{
+		LogLog::error(LOG4CXXNG_STR("could not serialize event"), e);
+		return;
+	}
+
+	fanout.send((const char*) eventBuffer->data(), eventBuffer->size());
+}
 
-	while (it != itEnd)
+void SocketHubAppender::setClientBufferSize(int bytes)
+{
+	if (bytes > 0)
 	{
-		// list size changed unexpectedly? Just exit the append.
-		if (*it == 0)
-		{
-			break;
-		}
+		fanout.setClientBufferSize(bytes);
+	}
+}
 
-		try
-		{
-			event->write(**it, p);
-			(*it)->flush(p);
-			it++;
-		}
-		catch (std::exception& e)
-		{
-			// there was an io exception so just drop the connection
-			it = streams.erase(it);
-			itEnd = streams.end();
-			LogLog::debug(LOG4CXXNG_STR("dropped connection"), e);
-		}
+int SocketHubAppender::getClientBufferSize() const
+{
+	return (int) fanout.getClientBufferSize();
+}
+
+void SocketHubAppender::setLaggardPolicy(const LogString& policy)
+{
+	fanout.setLaggardPolicy(SocketFanout::toLaggardPolicy(policy, fanout.getLaggardPolicy()));
+}
+
+LogString SocketHubAppender::getLaggardPolicy() const
+{
+	if (fanout.getLaggardPolicy() == SocketFanout::DISCONNECT)
+	{
+		return LOG4CXXNG_STR("Disconnect");
 	}
+
+	return LOG4CXXNG_STR("Drop");
+}
+
+SocketFanout::ClientStatisticsList SocketHubAppender::getClientStatistics() const
+{
+	return fanout.getClientStatistics();
+}
+
+unsigned int SocketHubAppender::getDroppedCount() const
+{
+	return fanout.getDroppedCount();
 }
 
 void SocketHubAppender::startServer()
 {
+	fanout.start();
 	thread.run(monitor, this);
 }
 
@@ -232,12 +258,9 @@ void* APR_THREAD_FUNC SocketHubAppender::monitor(apr_thread_t* /* thread */, voi
 					+ remoteAddress->getHostAddress()
 					+ LOG4CXXNG_STR(")"));
 
-				// add it to the oosList.
-				LOCK_W sync(pThis->mutex);
-				OutputStreamPtr os(new SocketOutputStream(socket));
-				Pool p;
-				ObjectOutputStreamPtr oos(new ObjectOutputStream(os, p));
-				pThis->streams.push_back(oos);
+				// hand it to the fan-out, starting with the stream header
+				unsigned char header[] = { 0xAC, 0xED, 0x00, 0x05 };
+				pThis->fanout.addClient(socket, (const char*) header, sizeof(header));
 			}
 			catch (IOException& e)
 			{
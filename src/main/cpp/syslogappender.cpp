@@ -22,6 +22,13 @@
 #include <log4cxxNG/spi/loggingevent.h>
 #include <log4cxxNG/level.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/optionconverter.h>
+#include <apr_time.h>
+#include <apr_strings.h>
+#include <apr_network_io.h>
+#if !defined(_WIN32)
+	#include <unistd.h>
+#endif
 #if !defined(LOG4CXXNG)
 	#define LOG4CXXNG 1
 #endif
@@ -64,7 +71,9 @@ using namespace log4cxxng::net;
 IMPLEMENT_LOG4CXXNG_OBJECT(SyslogAppender)
 
 SyslogAppender::SyslogAppender()
-	: syslogFacility(LOG_USER), facilityPrinting(false), sw(0)
+	: syslogFacility(LOG_USER), facilityPrinting(false), sw(0),
+	  syslogHostPort(-1), localSyslog(LOG4CXXNG_HAVE_SYSLOG != 0),
+	  protocol(SyslogWriter::UDP), batchSize(1), rfc5424(false)
 {
 	this->initSyslogFacilityStr();
 
@@ -72,7 +81,9 @@ SyslogAppender::SyslogAppender()
 
 SyslogAppender::SyslogAppender(const LayoutPtr& layout1,
 	int syslogFacility1)
-	: syslogFacility(syslogFacility1), facilityPrinting(false), sw(0)
+	: syslogFacility(syslogFacility1), facilityPrinting(false), sw(0),
+	  syslogHostPort(-1), localSyslog(LOG4CXXNG_HAVE_SYSLOG != 0),
+	  protocol(SyslogWriter::UDP), batchSize(1), rfc5424(false)
 {
 	this->layout = layout1;
 	this->initSyslogFacilityStr();
@@ -80,7 +91,9 @@ SyslogAppender::SyslogAppender(const LayoutPtr& layout1,
 
 SyslogAppender::SyslogAppender(const LayoutPtr& layout1,
 	const LogString& syslogHost1, int syslogFacility1)
-	: syslogFacility(syslogFacility1), facilityPrinting(false), sw(0)
+	: syslogFacility(syslogFacility1), facilityPrinting(false), sw(0),
+	  syslogHostPort(-1), localSyslog(LOG4CXXNG_HAVE_SYSLOG != 0),
+	  protocol(SyslogWriter::UDP), batchSize(1), rfc5424(false)
 {
 	this->layout = layout1;
 	this->initSyslogFacilityStr();
@@ -122,6 +135,68 @@ void SyslogAppender::initSyslogFacilityStr()
 	{
 		facilityStr += LOG4CXXNG_STR(":");
 	}
+
+	initSyslogHeaders();
+}
+
+void SyslogAppender::initSyslogHeaders()
+{
+	Pool p;
+
+	for (int severity = 0; severity < 8; severity++)
+	{
+		LogString& header = headers[severity];
+		header.assign(1, 0x3C /* '<' */);
+		StringHelper::toString(syslogFacility | severity, p, header);
+		header.append(1, (logchar) 0x3E /* '>' */);
+
+		if (rfc5424)
+		{
+			header.append(LOG4CXXNG_STR("1 "));
+		}
+	}
+
+	if (hostName.empty())
+	{
+		char host[256];
+
+		if (apr_gethostname(host, sizeof(host), p.getAPRPool()) == APR_SUCCESS)
+		{
+			Transcoder::decode(host, hostName);
+		}
+		else
+		{
+			hostName = LOG4CXXNG_STR("-");
+		}
+	}
+
+	headerFields.assign(1, 0x20 /* ' ' */);
+	headerFields.append(hostName);
+	headerFields.append(1, 0x20 /* ' ' */);
+	headerFields.append(appName.empty() ? LogString(LOG4CXXNG_STR("-")) : appName);
+	headerFields.append(1, 0x20 /* ' ' */);
+#if defined(_WIN32)
+	headerFields.append(1, 0x2D /* '-' */);
+#else
+	StringHelper::toString((int) getpid(), p, headerFields);
+#endif
+	// no MSGID, no STRUCTURED-DATA
+	headerFields.append(LOG4CXXNG_STR(" - - "));
+}
+
+void SyslogAppender::appendTimestamp(log4cxxng_time_t time, LogString& dest) const
+{
+	apr_time_exp_t exploded;
+	apr_time_exp_gmt(&exploded, time);
+	char buf[32];
+	apr_snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ",
+		exploded.tm_year + 1900, exploded.tm_mon + 1, exploded.tm_mday,
+		exploded.tm_hour, exploded.tm_min, exploded.tm_sec, exploded.tm_usec);
+
+	for (const char* c = buf; *c != 0; c++)
+	{
+		dest.append(1, (logchar) *c);
+	}
 }
 
 /**
@@ -305,15 +380,14 @@ void SyslogAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 		return;
 	}
 
-	LogString msg;
-	layout->format(msg, event, p);
-
 	// On the local host, we can directly use the system function 'syslog'
 	// if it is available
 #if LOG4CXXNG_HAVE_SYSLOG
 
-	if (sw == 0)
+	if (sw == 0 && localSyslog)
 	{
+		LogString msg;
+		layout->format(msg, event, p);
 		std::string sbuf;
 		Transcoder::encode(msg, sbuf);
 
@@ -334,17 +408,43 @@ void SyslogAppender::append(const spi::LoggingEventPtr& event, Pool& p)
 		return;
 	}
 
-	LogString sbuf(1, 0x3C /* '<' */);
-	StringHelper::toString((syslogFacility | event->getLevel()->getSyslogEquivalent()), p, sbuf);
-	sbuf.append(1, (logchar) 0x3E /* '>' */);
+	//
+	//   the buffers are members, reused from one event to
+	//   the next while the appender lock is held
+	//
+	int severity = event->getLevel()->getSyslogEquivalent();
+
+	if (severity >= 0 && severity < 8)
+	{
+		buffer.assign(headers[severity]);
+	}
+	else
+	{
+		buffer.assign(1, 0x3C /* '<' */);
+		StringHelper::toString((syslogFacility | severity), p, buffer);
+		buffer.append(1, (logchar) 0x3E /* '>' */);
+
+		if (rfc5424)
+		{
+			buffer.append(LOG4CXXNG_STR("1 "));
+		}
+	}
+
+	if (rfc5424)
+	{
+		appendTimestamp(event->getTimeStamp(), buffer);
+		buffer.append(headerFields);
+	}
 
 	if (facilityPrinting)
 	{
-		sbuf.append(facilityStr);
+		buffer.append(facilityStr);
 	}
 
-	sbuf.append(msg);
-	sw->write(sbuf);
+	layout->format(buffer, event, p);
+	encoded.erase();
+	Transcoder::encode(buffer, encoded);
+	sw->write(encoded.data(), encoded.size());
 }
 
 void SyslogAppender::activateOptions(Pool&)
@@ -361,6 +461,26 @@ void SyslogAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setFacility(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("FACILITYPRINTING"), LOG4CXXNG_STR("facilityprinting")))
+	{
+		setFacilityPrinting(OptionConverter::toBoolean(value, false));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("PROTOCOL"), LOG4CXXNG_STR("protocol")))
+	{
+		setProtocol(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("FORMAT"), LOG4CXXNG_STR("format")))
+	{
+		setFormat(value);
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("BATCHSIZE"), LOG4CXXNG_STR("batchsize")))
+	{
+		setBatchSize(OptionConverter::toInt(value, 1));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("APPNAME"), LOG4CXXNG_STR("appname")))
+	{
+		setAppName(value);
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -369,12 +489,6 @@ void SyslogAppender::setOption(const LogString& option, const LogString& value)
 
 void SyslogAppender::setSyslogHost(const LogString& syslogHost1)
 {
-	if (this->sw != 0)
-	{
-		delete this->sw;
-		this->sw = 0;
-	}
-
 	LogString slHost = syslogHost1;
 	int slHostPort = -1;
 
@@ -391,21 +505,112 @@ void SyslogAppender::setSyslogHost(const LogString& syslogHost1)
 	// On the local host, we can directly use the system function 'syslog'
 	// if it is available (cf. append)
 #if LOG4CXXNG_HAVE_SYSLOG
-
-	if (syslogHost1 != LOG4CXXNG_STR("localhost") && syslogHost1 != LOG4CXXNG_STR("127.0.0.1")
-		&& !syslogHost1.empty())
+	localSyslog = (syslogHost1 == LOG4CXXNG_STR("localhost") || syslogHost1 == LOG4CXXNG_STR("127.0.0.1")
+			|| syslogHost1.empty());
 #endif
-		if (slHostPort >= 0)
+
+	this->syslogHost = slHost;
+	this->syslogHostPort = slHostPort;
+	createWriter();
+}
+
+void SyslogAppender::createWriter()
+{
+	if (this->sw != 0)
+	{
+		delete this->sw;
+		this->sw = 0;
+	}
+
+	//
+	//   the local syslog function only replaces UDP,
+	//   and is the only choice when no host has been set
+	//
+	if (localSyslog && (protocol == SyslogWriter::UDP || syslogHost.empty()))
+	{
+		return;
+	}
+
+	this->sw = new SyslogWriter(syslogHost, syslogHostPort, protocol, batchSize);
+}
+
+void SyslogAppender::setProtocol(const LogString& value)
+{
+	SyslogWriter::Protocol newProtocol = protocol;
+
+	if (StringHelper::equalsIgnoreCase(value, LOG4CXXNG_STR("TCP"), LOG4CXXNG_STR("tcp")))
+	{
+		newProtocol = SyslogWriter::TCP;
+	}
+	else if (StringHelper::equalsIgnoreCase(value, LOG4CXXNG_STR("UDP"), LOG4CXXNG_STR("udp")))
+	{
+		newProtocol = SyslogWriter::UDP;
+	}
+	else
+	{
+		LogLog::error(LOG4CXXNG_STR("[") + value +
+			LOG4CXXNG_STR("] is an unknown syslog protocol, expected UDP or TCP."));
+	}
+
+	if (newProtocol != protocol)
+	{
+		protocol = newProtocol;
+
+		if (sw != 0 || localSyslog)
 		{
-			this->sw = new SyslogWriter(slHost, slHostPort);
+			createWriter();
 		}
-		else
+	}
+}
+
+LogString SyslogAppender::getProtocol() const
+{
+	return protocol == SyslogWriter::TCP ? LOG4CXXNG_STR("TCP") : LOG4CXXNG_STR("UDP");
+}
+
+void SyslogAppender::setFormat(const LogString& value)
+{
+	if (StringHelper::equalsIgnoreCase(value, LOG4CXXNG_STR("RFC5424"), LOG4CXXNG_STR("rfc5424")))
+	{
+		rfc5424 = true;
+	}
+	else if (StringHelper::equalsIgnoreCase(value, LOG4CXXNG_STR("BSD"), LOG4CXXNG_STR("bsd")))
+	{
+		rfc5424 = false;
+	}
+	else
+	{
+		LogLog::error(LOG4CXXNG_STR("[") + value +
+			LOG4CXXNG_STR("] is an unknown syslog format, expected BSD or RFC5424."));
+	}
+
+	initSyslogHeaders();
+}
+
+LogString SyslogAppender::getFormat() const
+{
+	return rfc5424 ? LOG4CXXNG_STR("RFC5424") : LOG4CXXNG_STR("BSD");
+}
+
+void SyslogAppender::setBatchSize(int batchSize1)
+{
+	int newBatchSize = batchSize1 > 1 ? batchSize1 : 1;
+
+	if (newBatchSize != batchSize)
+	{
+		batchSize = newBatchSize;
+
+		if (sw != 0)
 		{
-			this->sw = new SyslogWriter(slHost);
+			createWriter();
 		}
+	}
+}
 
-	this->syslogHost = slHost;
-	this->syslogHostPort = slHostPort;
+void SyslogAppender::setAppName(const LogString& appName1)
+{
+	appName = appName1;
+	initSyslogHeaders();
 }
 
 
@@ -22,47 +22,405 @@
 #include <log4cxxNG/helpers/syslogwriter.h>
 #include <log4cxxNG/helpers/loglog.h>
 #include <log4cxxNG/helpers/inetaddress.h>
-#include <log4cxxNG/helpers/datagramsocket.h>
-#include <log4cxxNG/helpers/datagrampacket.h>
 #include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/helpers/synchronized.h>
+#include <log4cxxNG/helpers/exception.h>
+#if !defined(LOG4CXXNG)
+	#define LOG4CXXNG 1
+#endif
+#include <log4cxxNG/private/log4cxxNG_private.h>
+#include <apr_network_io.h>
+#include <apr_portable.h>
+#include <apr_strings.h>
+#include <apr_atomic.h>
+#include <apr_time.h>
+
+#if LOG4CXXNG_HAVE_SENDMMSG
+	#include <sys/socket.h>
+	#include <sys/uio.h>
+	#include <errno.h>
+#endif
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
+namespace
+{
+/**
+ *  Upper bound of the bytes waiting for the sender thread.
+ */
+const size_t MAX_PENDING_BYTES = 4 * 1024 * 1024;
+
+/**
+ *  Minimum delay between two connection attempts, in microseconds.
+ */
+const log4cxxng_time_t RECONNECTION_DELAY = APR_USEC_PER_SEC;
+
+/**
+ *  Timeout of TCP connect and send, in microseconds.
+ */
+const apr_interval_time_t TCP_TIMEOUT = 5 * APR_USEC_PER_SEC;
+}
+
 SyslogWriter::SyslogWriter(const LogString& syslogHost1, int syslogHostPort1)
-	: syslogHost(syslogHost1), syslogHostPort(syslogHostPort1)
+	: syslogHost(syslogHost1), syslogHostPort(syslogHostPort1),
+	  protocol(UDP), batchSize(1), pool(), address(0), socket(0),
+	  lastConnect(0), mutex(pool), pendingCondition(pool), sentCondition(pool),
+	  thread(), sending(false), closing(false), dropped(0)
+{
+	init();
+}
+
+SyslogWriter::SyslogWriter(const LogString& syslogHost1, int syslogHostPort1,
+	Protocol protocol1, int batchSize1)
+	: syslogHost(syslogHost1),
+	  syslogHostPort(syslogHostPort1 < 0 ? SYSLOG_PORT : syslogHostPort1),
+	  protocol(protocol1), batchSize(batchSize1 > 1 ? batchSize1 : 1),
+	  pool(), address(0), socket(0),
+	  lastConnect(0), mutex(pool), pendingCondition(pool), sentCondition(pool),
+	  thread(), sending(false), closing(false), dropped(0)
+{
+	init();
+}
+
+SyslogWriter::~SyslogWriter()
+{
+	{
+		synchronized sync(mutex);
+		closing = true;
+		pendingCondition.signalAll();
+	}
+
+	thread.join();
+	disconnect();
+}
+
+void SyslogWriter::init()
 {
+	InetAddressPtr inetAddress;
+
 	try
 	{
-		this->address = InetAddress::getByName(syslogHost1);
+		inetAddress = InetAddress::getByName(syslogHost);
 	}
 	catch (UnknownHostException& e)
 	{
-		LogLog::error(((LogString) LOG4CXXNG_STR("Could not find ")) + syslogHost1 +
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not find ")) + syslogHost +
 			LOG4CXXNG_STR(". All logging will FAIL."), e);
+		return;
 	}
 
-	try
+	//
+	//   resolved once, not for every message
+	//
+	LOG4CXXNG_ENCODE_CHAR(hostAddr, inetAddress->getHostAddress());
+	apr_status_t stat = apr_sockaddr_info_get(&address, hostAddr.c_str(),
+			APR_INET, syslogHostPort, 0, pool.getAPRPool());
+
+	if (stat != APR_SUCCESS)
 	{
-		this->ds = new DatagramSocket();
+		address = 0;
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not instantiate socket to ")) + syslogHost +
+			LOG4CXXNG_STR(". All logging will FAIL."), SocketException(stat));
+		return;
 	}
-	catch (SocketException& e)
+
+	connect();
+
+	if (batchSize > 1)
 	{
-		LogLog::error(((LogString) LOG4CXXNG_STR("Could not instantiate DatagramSocket to ")) + syslogHost1 +
-			LOG4CXXNG_STR(". All logging will FAIL."), e);
+		thread.run(sender, this);
+	}
+}
+
+bool SyslogWriter::connect()
+{
+	lastConnect = apr_time_now();
+
+	apr_pool_t* socketPool = 0;
+	apr_status_t stat = apr_pool_create(&socketPool, pool.getAPRPool());
+
+	if (stat == APR_SUCCESS)
+	{
+		if (protocol == TCP)
+		{
+			stat = apr_socket_create(&socket, APR_INET, SOCK_STREAM,
+					APR_PROTO_TCP, socketPool);
+
+			if (stat == APR_SUCCESS)
+			{
+				apr_socket_timeout_set(socket, TCP_TIMEOUT);
+			}
+		}
+		else
+		{
+			stat = apr_socket_create(&socket, APR_INET, SOCK_DGRAM,
+					APR_PROTO_UDP, socketPool);
+		}
+	}
+
+	//
+	//   a connected datagram socket needs no destination
+	//   address per message
+	//
+	if (stat == APR_SUCCESS)
+	{
+		stat = apr_socket_connect(socket, address);
+	}
+
+	if (stat != APR_SUCCESS)
+	{
+		if (socketPool != 0)
+		{
+			apr_pool_destroy(socketPool);
+		}
+
+		socket = 0;
+		LogLog::error(((LogString) LOG4CXXNG_STR("Could not connect to syslog host ")) + syslogHost,
+			SocketException(stat));
+		return false;
+	}
+
+	return true;
+}
+
+void SyslogWriter::disconnect()
+{
+	if (socket != 0)
+	{
+		apr_pool_t* socketPool = apr_socket_pool_get(socket);
+		apr_socket_close(socket);
+		apr_pool_destroy(socketPool);
+		socket = 0;
 	}
 }
 
 void SyslogWriter::write(const LogString& source)
 {
-	if (this->ds != 0 && this->address != 0)
+	LOG4CXXNG_ENCODE_CHAR(data, source);
+	write(data.data(), data.length());
+}
+
+void SyslogWriter::write(const char* data, size_t len)
+{
+	if (address == 0)
+	{
+		return;
+	}
+
+	synchronized sync(mutex);
+
+	if (batchSize <= 1)
+	{
+		pending.assign(data, len);
+		pendingEnds.assign(1, len);
+		sendBatch(pending, pendingEnds);
+		return;
+	}
+
+	if (pending.size() + len > MAX_PENDING_BYTES)
+	{
+		apr_atomic_inc32(&dropped);
+		return;
+	}
+
+	pending.append(data, len);
+	pendingEnds.push_back(pending.size());
+	pendingCondition.signalAll();
+}
+
+void SyslogWriter::flush()
+{
+	if (batchSize <= 1)
+	{
+		return;
+	}
+
+	synchronized sync(mutex);
+
+	while ((!pendingEnds.empty() || sending) && thread.isActive())
+	{
+		sentCondition.await(mutex);
+	}
+}
+
+unsigned int SyslogWriter::getDroppedCount() const
+{
+	return apr_atomic_read32(const_cast<volatile unsigned int*>(&dropped));
+}
+
+bool SyslogWriter::sendStream(const char* data, size_t len)
+{
+	while (len > 0)
+	{
+		apr_size_t written = len;
+		apr_status_t stat = apr_socket_send(socket, data, &written);
+		data += written;
+		len -= written;
+
+		if (stat != APR_SUCCESS)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SyslogWriter::sendBatch(const std::string& data, const std::vector<size_t>& ends)
+{
+	if (socket == 0 &&
+		(apr_time_now() - lastConnect < RECONNECTION_DELAY || !connect()))
+	{
+		apr_atomic_add32(&dropped, (apr_uint32_t) ends.size());
+		return;
+	}
+
+	if (protocol == TCP)
+	{
+		//
+		//   octet counting: MSG-LEN SP SYSLOG-MSG
+		//
+		std::string framed;
+		size_t start = 0;
+
+		for (std::vector<size_t>::const_iterator iter = ends.begin();
+			iter != ends.end();
+			iter++)
+		{
+			char len[24];
+			apr_snprintf(len, sizeof(len), "%" APR_SIZE_T_FMT " ", *iter - start);
+			framed.append(len);
+			framed.append(data, start, *iter - start);
+			start = *iter;
+		}
+
+		if (!sendStream(framed.data(), framed.size()))
+		{
+			apr_atomic_add32(&dropped, (apr_uint32_t) ends.size());
+			disconnect();
+		}
+
+		return;
+	}
+
+#if LOG4CXXNG_HAVE_SENDMMSG
+	apr_os_sock_t fd;
+	apr_os_sock_get(&fd, socket);
+	size_t count = ends.size() < batchSize ? ends.size() : batchSize;
+	std::vector<struct mmsghdr> msgs(count);
+	std::vector<struct iovec> iovs(count);
+	size_t next = 0;
+	size_t start = 0;
+
+	while (next < ends.size())
+	{
+		unsigned int n = 0;
+
+		for (; n < count && next + n < ends.size(); n++)
+		{
+			size_t end = ends[next + n];
+			iovs[n].iov_base = const_cast<char*>(data.data() + start);
+			iovs[n].iov_len = end - start;
+			memset(&msgs[n], 0, sizeof(struct mmsghdr));
+			msgs[n].msg_hdr.msg_iov = &iovs[n];
+			msgs[n].msg_hdr.msg_iovlen = 1;
+			start = end;
+		}
+
+		unsigned int sent = 0;
+
+		while (sent < n)
+		{
+			int rv = sendmmsg(fd, &msgs[sent], n - sent, 0);
+
+			if (rv > 0)
+			{
+				sent += rv;
+			}
+			else if (rv < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else
+			{
+				//
+				//   skip the message that failed, typically
+				//   refused by an unreachable host
+				//
+				apr_atomic_inc32(&dropped);
+				sent++;
+			}
+		}
+
+		next += n;
+	}
+
+#else
+	size_t start = 0;
+
+	for (std::vector<size_t>::const_iterator iter = ends.begin();
+		iter != ends.end();
+		iter++)
+	{
+		apr_size_t len = *iter - start;
+
+		if (apr_socket_send(socket, data.data() + start, &len) != APR_SUCCESS)
+		{
+			apr_atomic_inc32(&dropped);
+		}
+
+		start = *iter;
+	}
+
+#endif
+}
+
+void* LOG4CXXNG_THREAD_FUNC SyslogWriter::sender(apr_thread_t* /* thread */, void* data)
+{
+	SyslogWriter* pThis = (SyslogWriter*) data;
+	std::string batch;
+	std::vector<size_t> ends;
+
+	try
 	{
-		LOG4CXXNG_ENCODE_CHAR(data, source);
+		while (true)
+		{
+			{
+				synchronized sync(pThis->mutex);
+				pThis->sending = false;
+				pThis->sentCondition.signalAll();
+
+				while (pThis->pendingEnds.empty() && !pThis->closing)
+				{
+					pThis->pendingCondition.await(pThis->mutex);
+				}
+
+				if (pThis->pendingEnds.empty())
+				{
+					break;
+				}
 
-		DatagramPacketPtr packet(
-			new DatagramPacket((void*) data.data(), data.length(),
-				address, syslogHostPort));
+				//
+				//   swap the buffers, both keep their capacity
+				//   so a steady state needs no allocation
+				//
+				batch.swap(pThis->pending);
+				ends.swap(pThis->pendingEnds);
+				pThis->sending = true;
+			}
 
-		ds->send(packet);
+			pThis->sendBatch(batch, ends);
+			batch.erase();
+			ends.clear();
+		}
 	}
+	catch (InterruptedException&)
+	{
+		synchronized sync(pThis->mutex);
+		pThis->sending = false;
+		pThis->sentCondition.signalAll();
+	}
+
+	return 0;
 }
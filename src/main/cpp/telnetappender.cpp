@@ -41,13 +41,11 @@ const int TelnetAppender::DEFAULT_PORT = 23;
 const int TelnetAppender::MAX_CONNECTIONS = 20;
 
 TelnetAppender::TelnetAppender()
-	: port(DEFAULT_PORT), connections(MAX_CONNECTIONS),
+	: port(DEFAULT_PORT),
 	  encoding(LOG4CXXNG_STR("UTF-8")),
 	  encoder(CharsetEncoder::getUTF8Encoder()),
-	  serverSocket(NULL), sh()
+	  serverSocket(NULL), sh(), fanout()
 {
-	LOCK_W sync(mutex);
-	activeConnections = 0;
 }
 
 TelnetAppender::~TelnetAppender()
@@ -64,6 +62,7 @@ void TelnetAppender::activateOptions(Pool& /* p */)
 		serverSocket->setSoTimeout(1000);
 	}
 
+	fanout.start();
 	sh.run(acceptConnections, this);
 }
 
@@ -78,6 +77,14 @@ void TelnetAppender::setOption(const LogString& option,
 	{
 		setEncoding(value);
 	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("CLIENTBUFFERSIZE"), LOG4CXXNG_STR("clientbuffersize")))
+	{
+		setClientBufferSize(OptionConverter::toInt(value, getClientBufferSize()));
+	}
+	else if (StringHelper::equalsIgnoreCase(option, LOG4CXXNG_STR("LAGGARDPOLICY"), LOG4CXXNG_STR("laggardpolicy")))
+	{
+		setLaggardPolicy(value);
+	}
 	else
 	{
 		AppenderSkeleton::setOption(option, value);
@@ -98,28 +105,55 @@ void TelnetAppender::setEncoding(const LogString& value)
 }
 
 
-void TelnetAppender::close()
+void TelnetAppender::setClientBufferSize(int bytes)
 {
-	LOCK_W sync(mutex);
+	if (bytes > 0)
+	{
+		fanout.setClientBufferSize(bytes);
+	}
+}
+
+int TelnetAppender::getClientBufferSize() const
+{
+	return (int) fanout.getClientBufferSize();
+}
 
-	if (closed)
+void TelnetAppender::setLaggardPolicy(const LogString& policy)
+{
+	fanout.setLaggardPolicy(SocketFanout::toLaggardPolicy(policy, fanout.getLaggardPolicy()));
+}
+
+LogString TelnetAppender::getLaggardPolicy() const
+{
+	if (fanout.getLaggardPolicy() == SocketFanout::DISCONNECT)
 	{
-		return;
+		return LOG4CXXNG_STR("Disconnect");
 	}
 
-	closed = true;
+	return LOG4CXXNG_STR("Drop");
+}
 
-	SocketPtr nullSocket;
+SocketFanout::ClientStatisticsList TelnetAppender::getClientStatistics() const
+{
+	return fanout.getClientStatistics();
+}
 
-	for (ConnectionList::iterator iter = connections.begin();
-		iter != connections.end();
-		iter++)
+unsigned int TelnetAppender::getDroppedCount() const
+{
+	return fanout.getDroppedCount();
+}
+
+void TelnetAppender::close()
+{
 	{
-		if (*iter != 0)
+		LOCK_W sync(mutex);
+
+		if (closed)
 		{
-			(*iter)->close();
-			*iter = nullSocket;
+			return;
 		}
+
+		closed = true;
 	}
 
 	if (serverSocket != NULL)
@@ -141,85 +175,54 @@ void TelnetAppender::close()
 	{
 	}
 
-	activeConnections = 0;
+	fanout.stop();
 }
 
 
-void TelnetAppender::write(ByteBuffer& buf)
+void TelnetAppender::encodeMessage(const LogString& msg, std::string& dest)
 {
-	for (ConnectionList::iterator iter = connections.begin();
-		iter != connections.end();
-		iter++)
-	{
-		if (*iter != 0)
-		{
-			try
-			{
-				ByteBuffer b(buf.current(), buf.remaining());
-				(*iter)->write(b);
-			}
-			catch (Exception&)
-			{
-				// The client has closed the connection, remove it from our list:
-				*iter = 0;
-				activeConnections--;
-			}
-		}
-	}
-}
-
-void TelnetAppender::writeStatus(const SocketPtr& socket, const LogString& msg, Pool& p)
-{
-	size_t bytesSize = msg.size() * 2;
-	char* bytes = p.pstralloc(bytesSize);
-
+	char bytes[1024];
+	ByteBuffer buf(bytes, sizeof(bytes));
 	LogString::const_iterator msgIter(msg.begin());
-	ByteBuffer buf(bytes, bytesSize);
 
 	while (msgIter != msg.end())
 	{
-		encoder->encode(msg, msgIter, buf);
+		log4cxxng_status_t stat = encoder->encode(msg, msgIter, buf);
 		buf.flip();
-		socket->write(buf);
+		dest.append(buf.data(), buf.limit());
 		buf.clear();
+
+		if (CharsetEncoder::isError(stat))
+		{
+			dest.append(1, '?');
+			msgIter++;
+		}
 	}
 }
 
-void TelnetAppender::append(const spi::LoggingEventPtr& event, Pool& p)
+void TelnetAppender::writeStatus(const SocketPtr& socket, const LogString& msg, Pool& /* p */)
 {
-	size_t count = activeConnections;
+	std::string bytes;
+	encodeMessage(msg, bytes);
+	ByteBuffer buf(const_cast<char*>(bytes.data()), bytes.size());
+	socket->write(buf);
+}
 
-	if (count > 0)
+void TelnetAppender::append(const spi::LoggingEventPtr& event, Pool& /* p */)
+{
+	if (fanout.getClientCount() > 0)
 	{
 		LogString msg;
 		this->layout->format(msg, event, pool);
 		msg.append(LOG4CXXNG_STR("\r\n"));
-		size_t bytesSize = msg.size() * 2;
-		char* bytes = p.pstralloc(bytesSize);
-
-		LogString::const_iterator msgIter(msg.begin());
-		ByteBuffer buf(bytes, bytesSize);
-
-		LOCK_W sync(this->mutex);
 
-		while (msgIter != msg.end())
-		{
-			log4cxxng_status_t stat = encoder->encode(msg, msgIter, buf);
-			buf.flip();
-			write(buf);
-			buf.clear();
-
-			if (CharsetEncoder::isError(stat))
-			{
-				LogString unrepresented(1, 0x3F /* '?' */);
-				LogString::const_iterator unrepresentedIter(unrepresented.begin());
-				stat = encoder->encode(unrepresented, unrepresentedIter, buf);
-				buf.flip();
-				write(buf);
-				buf.clear();
-				msgIter++;
-			}
-		}
+		//
+		//   encoded once, the fan-out shares the bytes
+		//   between all connections
+		//
+		encoded.erase();
+		encodeMessage(msg, encoded);
+		fanout.send(encoded.data(), encoded.size());
 	}
 }
 
@@ -244,9 +247,9 @@ void* APR_THREAD_FUNC TelnetAppender::acceptConnections(apr_thread_t* /* thread
 				break;
 			}
 
-			size_t count = pThis->activeConnections;
+			size_t count = pThis->fanout.getClientCount();
 
-			if (count >= pThis->connections.size())
+			if (count >= (size_t) MAX_CONNECTIONS)
 			{
 				Pool p;
 				pThis->writeStatus(newClient, LOG4CXXNG_STR("Too many connections.\r\n"), p);
@@ -254,29 +257,13 @@ void* APR_THREAD_FUNC TelnetAppender::acceptConnections(apr_thread_t* /* thread
 			}
 			else
 			{
-				//
-				//   find unoccupied connection
-				//
-				LOCK_W sync(pThis->mutex);
-
-				for (ConnectionList::iterator iter = pThis->connections.begin();
-					iter != pThis->connections.end();
-					iter++)
-				{
-					if (*iter == NULL)
-					{
-						*iter = newClient;
-						pThis->activeConnections++;
-
-						break;
-					}
-				}
-
 				Pool p;
 				LogString oss(LOG4CXXNG_STR("TelnetAppender v1.0 ("));
 				StringHelper::toString((int) count + 1, p, oss);
 				oss += LOG4CXXNG_STR(" active connections)\r\n\r\n");
-				pThis->writeStatus(newClient, oss, p);
+				std::string greeting;
+				pThis->encodeMessage(oss, greeting);
+				pThis->fanout.addClient(newClient, greeting.data(), greeting.size());
 			}
 		}
 		catch (InterruptedIOException&)
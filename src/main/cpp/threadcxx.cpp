@@ -24,6 +24,10 @@
 #include <log4cxxNG/helpers/threadlocal.h>
 #include <log4cxxNG/helpers/synchronized.h>
 #include <apr_thread_cond.h>
+#include <log4cxxNG/private/log4cxxNG_private.h>
+#if LOG4CXXNG_HAVE_SCHED_SETAFFINITY
+	#include <sched.h>
+#endif
 
 using namespace log4cxxng::helpers;
 using namespace log4cxxng;
@@ -288,6 +292,106 @@ bool Thread::interrupted()
 	return false;
 }
 
+#if LOG4CXXNG_HAVE_SCHED_SETAFFINITY
+namespace
+{
+/**
+ *  Parses a processor number surrounded by optional blanks.
+ */
+bool parseProcessor(LogString::const_iterator& iter,
+	const LogString::const_iterator& end, int& cpu)
+{
+	while (iter != end && *iter == 0x20 /* ' ' */)
+	{
+		iter++;
+	}
+
+	if (iter == end || *iter < 0x30 /* '0' */ || *iter > 0x39 /* '9' */)
+	{
+		return false;
+	}
+
+	cpu = 0;
+
+	while (iter != end && *iter >= 0x30 && *iter <= 0x39)
+	{
+		cpu = cpu * 10 + (*iter++ - 0x30);
+
+		if (cpu >= CPU_SETSIZE)
+		{
+			return false;
+		}
+	}
+
+	while (iter != end && *iter == 0x20 /* ' ' */)
+	{
+		iter++;
+	}
+
+	return true;
+}
+}
+#endif
+
+bool Thread::setCurrentThreadAffinity(const LogString& cpus)
+{
+#if LOG4CXXNG_HAVE_SCHED_SETAFFINITY
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	if (cpus.empty())
+	{
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		{
+			CPU_SET(cpu, &set);
+		}
+	}
+
+	LogString::const_iterator iter = cpus.begin();
+
+	while (iter != cpus.end())
+	{
+		int first;
+
+		if (!parseProcessor(iter, cpus.end(), first))
+		{
+			return false;
+		}
+
+		int last = first;
+
+		if (iter != cpus.end() && *iter == 0x2D /* '-' */)
+		{
+			iter++;
+
+			if (!parseProcessor(iter, cpus.end(), last) || last < first)
+			{
+				return false;
+			}
+		}
+
+		for (int cpu = first; cpu <= last; cpu++)
+		{
+			CPU_SET(cpu, &set);
+		}
+
+		if (iter != cpus.end())
+		{
+			if (*iter != 0x2C /* ',' */)
+			{
+				return false;
+			}
+
+			iter++;
+		}
+	}
+
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+
 bool Thread::isCurrentThread() const
 {
 #if APR_HAS_THREADS
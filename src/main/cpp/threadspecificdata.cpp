@@ -18,23 +18,35 @@
 #include <log4cxxNG/logstring.h>
 #include <log4cxxNG/helpers/threadspecificdata.h>
 #include <log4cxxNG/helpers/exception.h>
+#include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/spi/loggingevent.h>
 #include <apr_thread_proc.h>
+#include <apr_portable.h>
+#include <apr_strings.h>
 #if !defined(LOG4CXXNG)
 	#define LOG4CXXNG 1
 #endif
 #include <log4cxxNG/helpers/aprinitializer.h>
+#include <log4cxxNG/private/log4cxxNG_private.h>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
 
 ThreadSpecificData::ThreadSpecificData()
-	: ndcStack(), mdcMap()
+	: ndcStack(), mdcMap(), threadName(), eventCache(),
+	  messageBuffer(), messageBufferTaken(false)
 {
 }
 
 ThreadSpecificData::~ThreadSpecificData()
 {
+	for (std::vector<spi::LoggingEvent*>::iterator iter = eventCache.begin();
+		iter != eventCache.end();
+		iter++)
+	{
+		delete *iter;
+	}
 }
 
 
@@ -69,7 +81,11 @@ void ThreadSpecificData::recycle()
 {
 #if APR_HAS_THREADS
 
-	if (ndcStack.empty() && mdcMap.empty())
+	//
+	//   the thread name and cached events are kept
+	//   until the thread terminates
+	//
+	if (ndcStack.empty() && mdcMap.empty() && eventCache.empty() && threadName.empty())
 	{
 		void* pData = NULL;
 		apr_status_t stat = apr_threadkey_private_get(&pData, APRInitializer::getTlsKey());
@@ -150,6 +166,116 @@ void ThreadSpecificData::inherit(const NDC::Stack& src)
 
 
 
+void ThreadSpecificData::getThreadName(LogString& dest)
+{
+	ThreadSpecificData* data = getCurrentData();
+
+	if (data == 0)
+	{
+		data = createCurrentData();
+	}
+
+	if (data != 0 && !data->threadName.empty())
+	{
+		dest.append(data->threadName);
+		return;
+	}
+
+	LogString name;
+#if APR_HAS_THREADS
+#if defined(_WIN32)
+	char result[20];
+	DWORD threadId = GetCurrentThreadId();
+	apr_snprintf(result, sizeof(result), LOG4CXXNG_WIN32_THREAD_FMTSPEC, threadId);
+#else
+	// apr_os_thread_t encoded in HEX takes needs as many characters
+	// as two times the size of the type, plus an additional null byte.
+	char result[sizeof(apr_os_thread_t) * 3 + 10];
+	apr_os_thread_t threadId = apr_os_thread_current();
+	apr_snprintf(result, sizeof(result), LOG4CXXNG_APR_THREAD_FMTSPEC, (void*) &threadId);
+#endif
+	Transcoder::decode((const char*) result, name);
+#else
+	name = LOG4CXXNG_STR("0x00000000");
+#endif
+
+	if (data != 0)
+	{
+		data->threadName = name;
+	}
+
+	dest.append(name);
+}
+
+spi::LoggingEvent* ThreadSpecificData::takeEvent()
+{
+	ThreadSpecificData* data = getCurrentData();
+
+	if (data == 0 || data->eventCache.empty())
+	{
+		return 0;
+	}
+
+	spi::LoggingEvent* event = data->eventCache.back();
+	data->eventCache.pop_back();
+	return event;
+}
+
+bool ThreadSpecificData::cacheEvent(spi::LoggingEvent* event)
+{
+	ThreadSpecificData* data = getCurrentData();
+
+	if (data == 0)
+	{
+		data = createCurrentData();
+	}
+
+	if (data == 0 || data->eventCache.size() >= MAX_CACHED_EVENTS)
+	{
+		return false;
+	}
+
+	if (data->eventCache.capacity() < MAX_CACHED_EVENTS)
+	{
+		data->eventCache.reserve(MAX_CACHED_EVENTS);
+	}
+
+	data->eventCache.push_back(event);
+	return true;
+}
+
+void ThreadSpecificData::takeMessageBuffer(std::string& dest)
+{
+	ThreadSpecificData* data = getCurrentData();
+
+	if (data == 0)
+	{
+		data = createCurrentData();
+	}
+
+	if (data != 0 && !data->messageBufferTaken)
+	{
+		data->messageBufferTaken = true;
+		dest.swap(data->messageBuffer);
+	}
+}
+
+void ThreadSpecificData::cacheMessageBuffer(std::string& src)
+{
+	ThreadSpecificData* data = getCurrentData();
+
+	if (data != 0 && data->messageBufferTaken)
+	{
+		data->messageBufferTaken = false;
+
+		if (src.capacity() <= MAX_MESSAGE_BUFFER_CAPACITY)
+		{
+			src.clear();
+			data->messageBuffer.swap(src);
+		}
+	}
+}
+
 ThreadSpecificData* ThreadSpecificData::createCurrentData()
 {
 #if APR_HAS_THREADS
@@ -24,6 +24,7 @@
 #include <log4cxxNG/helpers/charsetdecoder.h>
 #include <log4cxxNG/helpers/charsetencoder.h>
 #include <vector>
+#include <string.h>
 #include <apr.h>
 #include <apr_strings.h>
 #include <log4cxxNG/helpers/exception.h>
@@ -36,9 +37,160 @@
 	#include <CoreFoundation/CFString.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define LOG4CXXNG_ASCII_SSE2 1
+	#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define LOG4CXXNG_ASCII_AVX2 1
+	#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+	#define LOG4CXXNG_ASCII_NEON 1
+	#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
+namespace
+{
+/**
+ *  Counts leading ASCII bytes eight at a time.
+ */
+size_t asciiLengthScalar(const char* src, size_t len)
+{
+	const apr_uint64_t highBits = (~(apr_uint64_t) 0 / 0xFF) * 0x80;
+	size_t i = 0;
+
+	for (; i + 8 <= len; i += 8)
+	{
+		apr_uint64_t word;
+		memcpy(&word, src + i, sizeof(word));
+
+		if ((word & highBits) != 0)
+		{
+			break;
+		}
+	}
+
+	for (; i < len && ((unsigned char) src[i]) < 0x80; i++)
+		;
+
+	return i;
+}
+
+#if LOG4CXXNG_ASCII_SSE2 || LOG4CXXNG_ASCII_AVX2
+/**
+ *  Index of the lowest set bit of a non-zero mask.
+ */
+inline size_t lowestBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+#if LOG4CXXNG_ASCII_SSE2
+size_t asciiLengthSSE2(const char* src, size_t len)
+{
+	size_t i = 0;
+
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*) (src + i));
+		unsigned int mask = (unsigned int) _mm_movemask_epi8(block);
+
+		if (mask != 0)
+		{
+			return i + lowestBit(mask);
+		}
+	}
+
+	return i + asciiLengthScalar(src + i, len - i);
+}
+#endif
+
+#if LOG4CXXNG_ASCII_AVX2
+__attribute__((target("avx2")))
+size_t asciiLengthAVX2(const char* src, size_t len)
+{
+	size_t i = 0;
+
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*) (src + i));
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8(block);
+
+		if (mask != 0)
+		{
+			return i + lowestBit(mask);
+		}
+	}
+
+	return i + asciiLengthScalar(src + i, len - i);
+}
+#endif
+
+#if LOG4CXXNG_ASCII_NEON
+size_t asciiLengthNEON(const char* src, size_t len)
+{
+	size_t i = 0;
+
+	for (; i + 16 <= len; i += 16)
+	{
+		uint8x16_t block = vld1q_u8((const uint8_t*) (src + i));
+
+		if (vmaxvq_u8(block) >= 0x80)
+		{
+			break;
+		}
+	}
+
+	return i + asciiLengthScalar(src + i, len - i);
+}
+#endif
+
+typedef size_t (*AsciiLengthFunction)(const char*, size_t);
+
+/**
+ *  Picks the widest implementation supported by the running processor.
+ */
+AsciiLengthFunction selectAsciiLength()
+{
+#if LOG4CXXNG_ASCII_AVX2
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return asciiLengthAVX2;
+	}
+
+#endif
+#if LOG4CXXNG_ASCII_SSE2
+	return asciiLengthSSE2;
+#elif LOG4CXXNG_ASCII_NEON
+	return asciiLengthNEON;
+#else
+	return asciiLengthScalar;
+#endif
+}
+}
+
+size_t Transcoder::asciiLength(const char* src, size_t len)
+{
+	static const AsciiLengthFunction function = selectAsciiLength();
+	return function(src, len);
+}
+
 
 void Transcoder::decodeUTF8(const std::string& src, LogString& dst)
 {
@@ -46,11 +198,25 @@ void Transcoder::decodeUTF8(const std::string& src, LogString& dst)
 
 	while (iter != src.end())
 	{
+		size_t ascii = asciiLength(src.data() + (iter - src.begin()), src.end() - iter);
+
+		if (ascii > 0)
+		{
+			dst.append(iter, iter + ascii);
+			iter += ascii;
+			continue;
+		}
+
+		std::string::const_iterator start(iter);
 		unsigned int sv = decode(src, iter);
 
 		if (sv != 0xFFFF)
 		{
+#if LOG4CXXNG_LOGCHAR_IS_UTF8
+			dst.append(start, iter);
+#else
 			encode(sv, dst);
+#endif
 		}
 		else
 		{
@@ -320,14 +486,9 @@ void Transcoder::decode(const std::string& src, LogString& dst)
 	dst.reserve(dst.size() + src.size());
 	std::string::const_iterator iter = src.begin();
 #if !LOG4CXXNG_CHARSET_EBCDIC
-
-	for (;
-		iter != src.end() && ((unsigned char) *iter) < 0x80;
-		iter++)
-	{
-		dst.append(1, *iter);
-	}
-
+	size_t ascii = asciiLength(src.data(), src.size());
+	dst.append(iter, iter + ascii);
+	iter += ascii;
 #endif
 
 	if (iter != src.end())
@@ -17,10 +17,159 @@
 
 #include <log4cxxNG/logstring.h>
 #include <log4cxxNG/helpers/transform.h>
+#include <string>
+
+#if LOG4CXXNG_LOGCHAR_IS_UTF8
+	#if defined(__AVX2__)
+		#include <immintrin.h>
+		#define LOG4CXXNG_ESCAPE_AVX2 1
+	#endif
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#include <emmintrin.h>
+		#define LOG4CXXNG_ESCAPE_SSE2 1
+	#endif
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#endif
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
+namespace
+{
+//
+//   bit n is set if character n is one of " & < >
+//
+const unsigned long long TAG_SPECIALS =
+	(1ULL << 0x22) | (1ULL << 0x26) | (1ULL << 0x3C) | (1ULL << 0x3E);
+
+inline bool isTagSpecial(logchar c)
+{
+	unsigned int code = (unsigned int) c;
+
+	if (sizeof(logchar) == 1)
+	{
+		code &= 0xFF;
+	}
+
+	return code < 64 && (TAG_SPECIALS & (1ULL << code)) != 0;
+}
+
+#if defined(LOG4CXXNG_ESCAPE_SSE2) || defined(LOG4CXXNG_ESCAPE_AVX2)
+inline unsigned int lowestSetBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (unsigned int) index;
+#else
+	return (unsigned int) __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/**
+Returns the first of " & < > in [begin, end), end if there is none.
+Clean runs are skipped a vector register at a time where available.
+*/
+const logchar* findTagSpecial(const logchar* begin, const logchar* end)
+{
+	const logchar* current = begin;
+#if defined(LOG4CXXNG_ESCAPE_AVX2)
+	const __m256i quote32 = _mm256_set1_epi8(0x22);
+	const __m256i amp32 = _mm256_set1_epi8(0x26);
+	const __m256i lt32 = _mm256_set1_epi8(0x3C);
+	const __m256i gt32 = _mm256_set1_epi8(0x3E);
+
+	while (end - current >= 32)
+	{
+		__m256i block = _mm256_loadu_si256((const __m256i*) current);
+		__m256i hits = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(block, quote32),
+					_mm256_cmpeq_epi8(block, amp32)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(block, lt32),
+					_mm256_cmpeq_epi8(block, gt32)));
+		unsigned int mask = (unsigned int) _mm256_movemask_epi8(hits);
+
+		if (mask != 0)
+		{
+			return current + lowestSetBit(mask);
+		}
+
+		current += 32;
+	}
+
+#endif
+#if defined(LOG4CXXNG_ESCAPE_SSE2)
+	const __m128i quote16 = _mm_set1_epi8(0x22);
+	const __m128i amp16 = _mm_set1_epi8(0x26);
+	const __m128i lt16 = _mm_set1_epi8(0x3C);
+	const __m128i gt16 = _mm_set1_epi8(0x3E);
+
+	while (end - current >= 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*) current);
+		__m128i hits = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(block, quote16),
+					_mm_cmpeq_epi8(block, amp16)),
+				_mm_or_si128(_mm_cmpeq_epi8(block, lt16),
+					_mm_cmpeq_epi8(block, gt16)));
+		unsigned int mask = (unsigned int) _mm_movemask_epi8(hits);
+
+		if (mask != 0)
+		{
+			return current + lowestSetBit(mask);
+		}
+
+		current += 16;
+	}
+
+#endif
+
+	for (; current < end; current++)
+	{
+		if (isTagSpecial(*current))
+		{
+			return current;
+		}
+	}
+
+	return end;
+}
+
+/**
+Returns the start of the first "]]>" in [begin, end), end if there is none.
+*/
+const logchar* findCDATAEnd(const logchar* begin, const logchar* end)
+{
+	const logchar* current = begin;
+
+	while (end - current >= 3)
+	{
+		//
+		//   char_traits::find is memchr or wmemchr for the
+		//      common character types, which libraries vectorize
+		//
+		const logchar* bracket = std::char_traits<logchar>::find(
+				current, (end - current) - 2, 0x5D /* ] */);
+
+		if (bracket == 0)
+		{
+			break;
+		}
+
+		if (bracket[1] == 0x5D /* ] */ && bracket[2] == 0x3E /* > */)
+		{
+			return bracket;
+		}
+
+		current = bracket + 1;
+	}
+
+	return end;
+}
+}
 
 
 void Transform::appendEscapingTags(
@@ -34,18 +183,18 @@ void Transform::appendEscapingTags(
 		return;
 	}
 
-	logchar specials[] = { 0x22 /* " */, 0x26 /* & */, 0x3C /* < */, 0x3E /* > */, 0x00 };
-	size_t start = 0;
-	size_t special = input.find_first_of(specials, start);
+	const logchar* start = input.data();
+	const logchar* end = start + input.length();
+	const logchar* special = findTagSpecial(start, end);
 
-	while (special != LogString::npos)
+	while (special != end)
 	{
 		if (special > start)
 		{
-			buf.append(input, start, special - start);
+			buf.append(start, special - start);
 		}
 
-		switch (input[special])
+		switch (*special)
 		{
 			case 0x22:
 				buf.append(LOG4CXXNG_STR("&quot;"));
@@ -59,37 +208,24 @@ void Transform::appendEscapingTags(
 				buf.append(LOG4CXXNG_STR("&lt;"));
 				break;
 
-			case 0x3E:
-				buf.append(LOG4CXXNG_STR("&gt;"));
-				break;
-
 			default:
-				buf.append(1, input[special]);
+				buf.append(LOG4CXXNG_STR("&gt;"));
 				break;
 		}
 
 		start = special + 1;
-
-		if (special < input.size())
-		{
-			special = input.find_first_of(specials, start);
-		}
-		else
-		{
-			special = LogString::npos;
-		}
+		special = findTagSpecial(start, end);
 	}
 
-	if (start < input.size())
+	if (start < end)
 	{
-		buf.append(input, start, input.size() - start);
+		buf.append(start, end - start);
 	}
 }
 
 void Transform::appendEscapingCDATA(
 	LogString& buf, const LogString& input)
 {
-	static const LogString CDATA_END(LOG4CXXNG_STR("]]>"));
 	static const LogString CDATA_EMBEDED_END(LOG4CXXNG_STR("]]>]]&gt;<![CDATA["));
 
 	const LogString::size_type CDATA_END_LEN = 3;
@@ -100,32 +236,17 @@ void Transform::appendEscapingCDATA(
 		return;
 	}
 
-	LogString::size_type end = input.find(CDATA_END);
-
-	if (end == LogString::npos)
-	{
-		buf.append(input);
-		return;
-	}
-
-	LogString::size_type start = 0;
+	const logchar* start = input.data();
+	const logchar* end = start + input.length();
+	const logchar* cdataEnd = findCDATAEnd(start, end);
 
-	while (end != LogString::npos)
+	while (cdataEnd != end)
 	{
-		buf.append(input, start, end - start);
+		buf.append(start, cdataEnd - start);
 		buf.append(CDATA_EMBEDED_END);
-		start = end + CDATA_END_LEN;
-
-		if (start < input.length())
-		{
-			end = input.find(CDATA_END, start);
-		}
-		else
-		{
-			return;
-		}
+		start = cdataEnd + CDATA_END_LEN;
+		cdataEnd = findCDATAEnd(start, end);
 	}
 
-	buf.append(input, start, input.length() - start);
+	buf.append(start, end - start);
 }
-
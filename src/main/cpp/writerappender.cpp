@@ -27,7 +27,13 @@ using namespace log4cxxng::spi;
 
 IMPLEMENT_LOG4CXXNG_OBJECT(WriterAppender)
 
+//
+//   capacity above which the format buffer is released after use
+//
+static const size_t MAX_BUFFER_CAPACITY = 64 * 1024;
+
 WriterAppender::WriterAppender()
+	: timerMutex(pool), timerCondition(pool), timerStopping(false)
 {
 	LOCK_W sync(mutex);
 	immediateFlush = true;
@@ -35,7 +41,8 @@ WriterAppender::WriterAppender()
 
 WriterAppender::WriterAppender(const LayoutPtr& layout1,
 	log4cxxng::helpers::WriterPtr& writer1)
-	: AppenderSkeleton(layout1), writer(writer1)
+	: AppenderSkeleton(layout1), writer(writer1),
+	  timerMutex(pool), timerCondition(pool), timerStopping(false)
 {
 	Pool p;
 	LOCK_W sync(mutex);
@@ -44,7 +51,8 @@ WriterAppender::WriterAppender(const LayoutPtr& layout1,
 }
 
 WriterAppender::WriterAppender(const LayoutPtr& layout1)
-	: AppenderSkeleton(layout1)
+	: AppenderSkeleton(layout1),
+	  timerMutex(pool), timerCondition(pool), timerStopping(false)
 {
 	LOCK_W sync(mutex);
 	immediateFlush = true;
@@ -154,15 +162,29 @@ bool WriterAppender::checkEntryConditions() const
    */
 void WriterAppender::close()
 {
-	LOCK_W sync(mutex);
+	//
+	//   the timer takes the appender lock to flush,
+	//      so it is stopped before taking the lock
+	//
+	stopFlushTimer();
 
-	if (closed)
 	{
-		return;
+		LOCK_W sync(mutex);
+
+		if (closed)
+		{
+			return;
+		}
+
+		closed = true;
+		closeWriter();
 	}
 
-	closed = true;
-	closeWriter();
+	//
+	//   an append racing with the first stop may have restarted
+	//      the timer, no append starts it once closed is set
+	//
+	stopFlushTimer();
 }
 
 /**
@@ -243,21 +265,42 @@ void WriterAppender::setEncoding(const LogString& enc)
 
 void WriterAppender::subAppend(const spi::LoggingEventPtr& event, Pool& p)
 {
-	LogString msg;
-	layout->format(msg, event, p);
+	LOCK_W sync(mutex);
+	buffer.erase();
+	layout->format(buffer, event, p);
+
+	if (writer != NULL)
 	{
-		LOCK_W sync(mutex);
+		writer->write(buffer, p);
+		metrics.add(AppenderMetrics::BYTES_WRITTEN, buffer.size());
 
-		if (writer != NULL)
+		if (flushPolicy.isActive())
 		{
-			writer->write(msg, p);
-
-			if (immediateFlush)
+			if (flushPolicy.written(event->getLevel(), buffer.size()))
 			{
 				writer->flush(p);
+				flushPolicy.flushed();
+				metrics.add(AppenderMetrics::FLUSHES);
 			}
+			else if (flushPolicy.getFlushInterval() > 0 && !flushTimer.isAlive())
+			{
+				startFlushTimer();
+			}
+		}
+		else if (immediateFlush)
+		{
+			writer->flush(p);
+			metrics.add(AppenderMetrics::FLUSHES);
 		}
 	}
+
+	//
+	//   do not keep the memory of an exceptionally long message
+	//
+	if (buffer.capacity() > MAX_BUFFER_CAPACITY)
+	{
+		LogString().swap(buffer);
+	}
 }
 
 
@@ -302,7 +345,7 @@ void WriterAppender::setOption(const LogString& option, const LogString& value)
 	{
 		setEncoding(value);
 	}
-	else
+	else if (!flushPolicy.setOption(option, value))
 	{
 		AppenderSkeleton::setOption(option, value);
 	}
@@ -314,3 +357,95 @@ void WriterAppender::setImmediateFlush(bool value)
 	LOCK_W sync(mutex);
 	immediateFlush = value;
 }
+
+void WriterAppender::startFlushTimer()
+{
+#if APR_HAS_THREADS
+	{
+		synchronized sync(timerMutex);
+		timerStopping = false;
+	}
+	flushTimer.run(flushTimerLoop, this);
+#endif
+}
+
+void WriterAppender::stopFlushTimer()
+{
+#if APR_HAS_THREADS
+
+	if (flushTimer.isAlive())
+	{
+		{
+			synchronized sync(timerMutex);
+			timerStopping = true;
+			timerCondition.signalAll();
+		}
+
+		try
+		{
+			flushTimer.join();
+		}
+		catch (InterruptedException& e)
+		{
+			Thread::currentThreadInterrupt();
+			LogLog::error(LOG4CXXNG_STR("Got an InterruptedException while waiting for the flush timer to finish,"), e);
+		}
+	}
+
+#endif
+}
+
+#if APR_HAS_THREADS
+void* LOG4CXXNG_THREAD_FUNC WriterAppender::flushTimerLoop(apr_thread_t* /* thread */, void* data)
+{
+	WriterAppender* pThis = (WriterAppender*) data;
+	Pool p;
+
+	while (true)
+	{
+		{
+			synchronized sync(pThis->timerMutex);
+			log4cxxng_time_t interval =
+				(log4cxxng_time_t) pThis->flushPolicy.getFlushInterval() * 1000;
+
+			if (!pThis->timerStopping && interval > 0)
+			{
+				pThis->timerCondition.await(pThis->timerMutex, interval);
+			}
+
+			if (pThis->timerStopping || interval <= 0)
+			{
+				break;
+			}
+		}
+
+		//
+		//   output written since the previous tick is at most
+		//      one interval old
+		//
+		LOCK_W sync(pThis->mutex);
+
+		if (pThis->closed)
+		{
+			break;
+		}
+
+		if (pThis->writer != 0 && pThis->flushPolicy.hasPending())
+		{
+			try
+			{
+				pThis->writer->flush(p);
+				pThis->flushPolicy.flushed();
+				pThis->metrics.add(AppenderMetrics::FLUSHES);
+			}
+			catch (IOException& e)
+			{
+				LogLog::error(LOG4CXXNG_STR("Could not flush writer for WriterAppender named ")
+					+ pThis->name, e);
+			}
+		}
+	}
+
+	return 0;
+}
+#endif
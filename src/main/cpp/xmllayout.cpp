@@ -34,6 +34,27 @@ using namespace log4cxxng::xml;
 
 IMPLEMENT_LOG4CXXNG_OBJECT(XMLLayout)
 
+namespace
+{
+//
+//   loggers keep their escaped name,
+//      events without a logger are escaped each time
+//
+void appendEscapedLoggerName(LogString& output, const LoggingEventPtr& event)
+{
+	const LoggerPtr& logger = event->getLogger();
+
+	if (logger != 0 && &logger->getName() == &event->getLoggerName())
+	{
+		logger->getEscapedName(output);
+	}
+	else
+	{
+		Transform::appendEscapingTags(output, event->getLoggerName());
+	}
+}
+}
+
 XMLLayout::XMLLayout()
 	: locationInfo(false), properties(false)
 {
@@ -58,11 +79,11 @@ void XMLLayout::format(LogString& output,
 	Pool& p) const
 {
 	output.append(LOG4CXXNG_STR("<log4j:event logger=\""));
-	Transform::appendEscapingTags(output, event->getLoggerName());
+	appendEscapedLoggerName(output, event);
 	output.append(LOG4CXXNG_STR("\" timestamp=\""));
 	StringHelper::toString(event->getTimeStamp() / 1000L, p, output);
 	output.append(LOG4CXXNG_STR("\" level=\""));
-	Transform::appendEscapingTags(output, event->getLevel()->toString());
+	output.append(event->getLevel()->getEscapedName());
 	output.append(LOG4CXXNG_STR("\" thread=\""));
 	Transform::appendEscapingTags(output, event->getThreadName());
 	output.append(LOG4CXXNG_STR("\">"));
@@ -89,10 +110,12 @@ void XMLLayout::format(LogString& output,
 	{
 		output.append(LOG4CXXNG_STR("<log4j:locationInfo class=\""));
 		const LocationInfo& locInfo = event->getLocationInformation();
-		LOG4CXXNG_DECODE_CHAR(className, locInfo.getClassName());
+		LogString className;
+		locInfo.getClassName(className);
 		Transform::appendEscapingTags(output, className);
 		output.append(LOG4CXXNG_STR("\" method=\""));
-		LOG4CXXNG_DECODE_CHAR(method, locInfo.getMethodName());
+		LogString method;
+		locInfo.getMethodName(method);
 		Transform::appendEscapingTags(output, method);
 		output.append(LOG4CXXNG_STR("\" file=\""));
 		LOG4CXXNG_DECODE_CHAR(fileName, locInfo.getFileName());
@@ -116,6 +116,8 @@ void XMLSocketAppender::append(const spi::LoggingEventPtr& event, log4cxxng::hel
 		{
 			writer->write(output, p);
 			writer->flush(p);
+			metrics.add(AppenderMetrics::BYTES_WRITTEN, output.size());
+			metrics.add(AppenderMetrics::FLUSHES);
 		}
 		catch (std::exception& e)
 		{
@@ -28,9 +28,11 @@
 #include <log4cxxNG/layout.h>
 #include <log4cxxNG/spi/errorhandler.h>
 #include <log4cxxNG/spi/filter.h>
+#include <log4cxxNG/spi/filtertable.h>
 #include <log4cxxNG/helpers/objectimpl.h>
 #include <log4cxxNG/helpers/mutex.h>
 #include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/appendermetrics.h>
 #include <log4cxxNG/level.h>
 
 
@@ -70,6 +72,12 @@ class LOG4CXXNG_EXPORT AppenderSkeleton :
 		/** The last filter in the filter chain. */
 		spi::FilterPtr tailFilter;
 
+		/**
+		The filter chain compiled into a lookup table when it only
+		decides on level and logger name. Rebuilt under the write lock.
+		*/
+		spi::FilterTable filterTable;
+
 		/**
 		Is this appender closed?
 		*/
@@ -78,6 +86,12 @@ class LOG4CXXNG_EXPORT AppenderSkeleton :
 		log4cxxng::helpers::Pool pool;
 		mutable SHARED_MUTEX mutex;
 
+		/**
+		Counters updated while appending, subclasses add their own
+		such as bytes written or rollovers.
+		*/
+		helpers::AppenderMetrics metrics;
+
 		/**
 		Subclasses of <code>AppenderSkeleton</code> should implement this
 		method to perform actual logging. See also AppenderSkeleton::doAppend
@@ -87,6 +101,9 @@ class LOG4CXXNG_EXPORT AppenderSkeleton :
 
 		void doAppendImpl(const spi::LoggingEventPtr& event, log4cxxng::helpers::Pool& pool);
 
+	private:
+		void measuredAppend(const spi::LoggingEventPtr& event, log4cxxng::helpers::Pool& pool);
+
 	public:
 		DECLARE_ABSTRACT_LOG4CXXNG_OBJECT(AppenderSkeleton)
 		BEGIN_LOG4CXXNG_CAST_MAP()
@@ -125,6 +142,14 @@ class LOG4CXXNG_EXPORT AppenderSkeleton :
 		*/
 		void clearFilters();
 
+		/**
+		Returns the counters of this appender.
+		*/
+		const helpers::AppenderMetrics& getMetrics() const
+		{
+			return metrics;
+		}
+
 		/**
 		Return the currently set spi::ErrorHandler for this
 		Appender.
@@ -229,6 +254,7 @@ class LOG4CXXNG_EXPORT AppenderSkeleton :
 		void setThreshold(const LevelPtr& threshold);
 
 }; // class AppenderSkeleton
+LOG4CXXNG_PTR_DEF(AppenderSkeleton);
 }  // namespace log4cxxng
 
 #if defined(_MSC_VER)
@@ -182,6 +182,82 @@ class LOG4CXXNG_EXPORT AsyncAppender :
 		bool getBlocking() const;
 
 
+		/**
+		 * Adds a priority lane for events at or above a level.
+		 *
+		 * <p>Each lane has its own capacity. The dispatcher drains
+		 * higher-severity lanes first. Events below every configured
+		 * threshold go to the default lane, whose capacity is the
+		 * <b>BufferSize</b>. When a lane is full, the oldest event of the
+		 * lowest-severity non-empty lane below it is discarded to make
+		 * room. Only if no such event exists does the appender block or
+		 * discard the new event, according to <b>Blocking</b>.
+		 *
+		 * <p>Adding a lane for a threshold that already has one changes
+		 * that lane's capacity.
+		 *
+		 * @param threshold lowest level routed to the lane, may not be null.
+		 * @param capacity maximum number of events queued in the lane.
+		 */
+		void addLane(const LevelPtr& threshold, int capacity);
+
+		/**
+		 * Sets the priority lanes from a comma separated list of
+		 * <code>LEVEL=capacity</code> pairs, for example
+		 * <code>ERROR=32,WARN=64</code>.
+		 * @param lanes lane specification.
+		 */
+		void setLanes(const LogString& lanes);
+
+		/**
+		 * Gets the number of lanes including the default lane.
+		 * @return number of lanes.
+		 */
+		int getLaneCount() const;
+
+		/**
+		 * Sets whether each attached appender is served by its own
+		 * worker thread.
+		 *
+		 * <p>In this mode the dispatcher hands every event to one bounded
+		 * queue per attached appender, of <b>BufferSize</b> capacity, and a
+		 * dedicated thread drains each queue. Events reach every appender
+		 * in order, and a slow appender only delays its own queue. When
+		 * a queue is full the dispatcher waits if <b>Blocking</b> is set.
+		 * Otherwise the event is discarded for that appender only, and a
+		 * summary is appended to it later.
+		 *
+		 * @param value true to dispatch through per appender workers.
+		 */
+		void setDispatchPerAppender(bool value);
+
+		/**
+		 * Gets whether each attached appender is served by its own
+		 * worker thread.
+		 * @return the current value of the <b>DispatchPerAppender</b> option.
+		 */
+		bool getDispatchPerAppender() const;
+
+		/**
+		 * Binds the dispatcher thread, and the per appender workers it
+		 * starts, to a set of processors.
+		 *
+		 * <p>Binding them to the processors of one NUMA node keeps the
+		 * memory they first touch, such as the staging buffers of the
+		 * attached appenders, local to that node. The binding takes
+		 * effect before the next events are dispatched.
+		 *
+		 * @param cpus comma separated processor numbers and ranges,
+		 * for example "0-7,16-23", an empty list allows all processors.
+		 */
+		void setDispatcherAffinity(const LogString& cpus);
+
+		/**
+		 * Gets the processors the dispatcher thread is bound to.
+		 * @return the current value of the <b>DispatcherAffinity</b> option.
+		 */
+		LogString getDispatcherAffinity() const;
+
 		/**
 		 * Set appender properties by name.
 		 * @param option property name.
@@ -205,7 +281,34 @@ class LOG4CXXNG_EXPORT AsyncAppender :
 		boost::lockfree::queue<log4cxxng::spi::LoggingEvent* > buffer;
 		std::atomic<size_t> discardedCount;
 #else
-		LoggingEventList buffer;
+		/**
+		 * Priority lane, a bounded queue of events at or above a level.
+		 */
+		struct Lane
+		{
+			Lane(const LevelPtr& threshold, size_t capacity);
+
+			LevelPtr threshold;
+			size_t capacity;
+			std::deque<spi::LoggingEventPtr> events;
+		};
+		typedef std::vector<Lane> LaneList;
+
+		/**
+		 * Lanes ordered by decreasing threshold, the last lane
+		 * being the default lane of <b>BufferSize</b> capacity.
+		 */
+		LaneList lanes;
+
+		/**
+		 * Number of events queued in all lanes.
+		 */
+		size_t queued;
+
+		/**
+		 * Sum of the lane capacities.
+		 */
+		size_t capacity;
 #endif
 
 		/**
@@ -295,6 +398,64 @@ class LOG4CXXNG_EXPORT AsyncAppender :
 		*/
 		bool blocking;
 
+		/**
+		 * Does dispatcher use a worker per attached appender.
+		*/
+		bool dispatchPerAppender;
+
+		/**
+		 * Processors the dispatcher is bound to.
+		*/
+		LogString dispatcherAffinity;
+
+		/**
+		 * Has the dispatcher yet to apply dispatcherAffinity.
+		*/
+		bool affinityPending;
+
+#if !defined(NON_BLOCKING)
+		/**
+		 * Bounded queue and thread serving one attached appender.
+		 */
+		class Worker;
+		typedef std::vector<Worker*> WorkerList;
+
+		/**
+		 * Workers of the attached appenders, only used by the
+		 * dispatcher thread and by close once the dispatcher ended.
+		 */
+		WorkerList workers;
+
+		/**
+		 * Hands events to the workers of the attached appenders,
+		 * starting and stopping workers as appenders are attached
+		 * and removed.
+		 * @param events events to dispatch.
+		 */
+		void dispatchToWorkers(const LoggingEventList& events);
+
+		/**
+		 * Waits for all workers to append their queued events
+		 * and ends their threads.
+		 */
+		void stopWorkers();
+#endif
+
+#if !defined(NON_BLOCKING)
+		/**
+		 * Discards the oldest event queued below a lane.
+		 * @param laneIndex index of the lane that needs room.
+		 * @return true if an event was discarded.
+		 */
+		bool evictBelow(size_t laneIndex);
+
+		/**
+		 * Records a discarded event in the discard map.
+		 * @param event discarded event.
+		 */
+		void discard(const spi::LoggingEventPtr& event);
+#endif
+
 		/**
 		 *  Dispatch routine.
 		 */
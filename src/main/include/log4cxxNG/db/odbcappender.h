@@ -29,7 +29,12 @@
 #include <log4cxxNG/helpers/exception.h>
 #include <log4cxxNG/appenderskeleton.h>
 #include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/patternlayout.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/condition.h>
 #include <list>
+#include <vector>
 
 namespace log4cxxng
 {
@@ -74,6 +79,25 @@ inside of the statement.  (see the test cases for examples)
 <p>Overriding the {@link #getLogStatement} method allows more
 explicit control of the statement used for logging.
 
+<p>Alternatively, the statement may use <code>?</code> parameter
+markers and one <b>ColumnMapping</b> option per marker, in marker
+order, each holding a <code>PatternLayout</code> conversion pattern:
+
+<pre>
+&lt;param name="sql" value="INSERT INTO logs (logger, level, message) VALUES (?, ?, ?)"/&gt;
+&lt;param name="ColumnMapping" value="%c"/&gt;
+&lt;param name="ColumnMapping" value="%p"/&gt;
+&lt;param name="ColumnMapping" value="%m"/&gt;
+</pre>
+
+The statement is then prepared once and each full buffer is inserted
+in a single <code>SQLExecute</code> using an array of parameter sets,
+so values never need quoting. Drivers without parameter arrays get
+one execution per event. The buffer is written by a background
+thread so that logging threads do not wait for the database. At most
+four full buffers wait for that thread; beyond that the logging thread
+waits, or the buffer is discarded when <b>Blocking</b> is false.
+
 <p>For use as a base class:
 
 <ul>
@@ -116,6 +140,7 @@ class LOG4CXXNG_EXPORT ODBCAppender : public AppenderSkeleton
 		typedef void* SQLHDBC;
 		typedef void* SQLHENV;
 		typedef void* SQLHANDLE;
+		typedef void* SQLHSTMT;
 		typedef short SQLSMALLINT;
 
 		/**
@@ -150,6 +175,27 @@ class LOG4CXXNG_EXPORT ODBCAppender : public AppenderSkeleton
 		*/
 		std::list<spi::LoggingEventPtr> buffer;
 
+		/**
+		* Conversion patterns bound, in order, to the parameter markers
+		* of the statement. When empty, the statement is formatted per event.
+		*/
+		std::vector<PatternLayoutPtr> columns;
+
+		/**
+		* Statement prepared from <code>sqlStatement</code> when columns
+		* are mapped, held until the appender is closed.
+		*/
+		SQLHSTMT preparedStatement;
+
+	private:
+		std::list<spi::LoggingEventPtr> pending;
+		helpers::Mutex flushMutex;
+		helpers::Condition flushCondition;
+		bool flushRequested;
+		bool stopping;
+		bool blocking;
+		helpers::Thread flusher;
+
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(ODBCAppender)
 		BEGIN_LOG4CXXNG_CAST_MAP()
@@ -198,6 +244,13 @@ class LOG4CXXNG_EXPORT ODBCAppender : public AppenderSkeleton
 		virtual void execute(const LogString& sql,
 			log4cxxng::helpers::Pool& p) /*throw(SQLException)*/;
 
+		/**
+		* Inserts <code>events</code> through the prepared statement,
+		* binding one parameter set per event.
+		*/
+		virtual void executeBatch(const std::list<spi::LoggingEventPtr>& events,
+			log4cxxng::helpers::Pool& p) /*throw(SQLException)*/;
+
 		/**
 		* Override this to return the connection to a pool, or to clean up the
 		* resource.
@@ -253,6 +306,12 @@ class LOG4CXXNG_EXPORT ODBCAppender : public AppenderSkeleton
 		}
 
 
+		/**
+		* Maps the next parameter marker of the statement to a
+		* PatternLayout conversion pattern, eg: %m
+		*/
+		void addColumnMapping(const LogString& pattern);
+
 		inline void setUser(const LogString& user)
 		{
 			databaseUser = user;
@@ -297,9 +356,28 @@ class LOG4CXXNG_EXPORT ODBCAppender : public AppenderSkeleton
 		{
 			return bufferSize;
 		}
+
+		/**
+		* Sets whether a logging thread waits when the background writer
+		* is four buffers behind, or discards the full buffer instead.
+		*/
+		inline void setBlocking(bool value)
+		{
+			blocking = value;
+		}
+
+		inline bool getBlocking() const
+		{
+			return blocking;
+		}
 	private:
 		ODBCAppender(const ODBCAppender&);
 		ODBCAppender& operator=(const ODBCAppender&);
+		void flushEvents(std::list<spi::LoggingEventPtr>& events,
+			log4cxxng::helpers::Pool& p);
+		void startFlusher();
+		void stopFlusher();
+		static void* LOG4CXXNG_THREAD_FUNC flushLoop(apr_thread_t* thread, void* data);
 		static void encode(wchar_t** dest, const LogString& src,
 			log4cxxng::helpers::Pool& p);
 		static void encode(unsigned short** dest, const LogString& src,
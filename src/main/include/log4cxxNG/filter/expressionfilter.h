@@ -94,14 +94,20 @@ class LOG4CXXNG_EXPORT ExpressionFilter: public log4cxxng::spi::Filter
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(ExpressionFilter)
 		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(ExpressionFilter)
 		LOG4CXXNG_CAST_ENTRY(log4cxxng::spi::Filter)
 		END_LOG4CXXNG_CAST_MAP()
 
 
 		ExpressionFilter();
 
+		/**
+		Compiles the expression, see rule::ExpressionRule for its syntax.
+		*/
 		void activateOptions(log4cxxng::helpers::Pool& p);
 
+		void setOption(const LogString& option, const LogString& value);
+
 		void setExpression(const LogString& expression);
 
 		LogString getExpression() const;
@@ -119,6 +125,7 @@ class LOG4CXXNG_EXPORT ExpressionFilter: public log4cxxng::spi::Filter
 		 */
 		FilterDecision decide(const spi::LoggingEventPtr& event) const;
 };
+LOG4CXXNG_PTR_DEF(ExpressionFilter);
 }
 }
 
@@ -75,6 +75,7 @@ class LOG4CXXNG_EXPORT LevelMatchFilter : public spi::Filter
 		inline void setAcceptOnMatch(bool acceptOnMatch1)
 		{
 			this->acceptOnMatch = acceptOnMatch1;
+			changed();
 		}
 
 		inline bool getAcceptOnMatch() const
@@ -87,6 +87,7 @@ class LOG4CXXNG_EXPORT LevelRangeFilter : public spi::Filter
 		void setLevelMin(const LevelPtr& levelMin1)
 		{
 			this->levelMin = levelMin1;
+			changed();
 		}
 
 		/**
@@ -103,6 +104,7 @@ class LOG4CXXNG_EXPORT LevelRangeFilter : public spi::Filter
 		void setLevelMax(const LevelPtr& levelMax1)
 		{
 			this->levelMax = levelMax1;
+			changed();
 		}
 
 		/**
@@ -119,6 +121,7 @@ class LOG4CXXNG_EXPORT LevelRangeFilter : public spi::Filter
 		inline void setAcceptOnMatch(bool acceptOnMatch1)
 		{
 			this->acceptOnMatch = acceptOnMatch1;
+			changed();
 		}
 
 		/**
@@ -55,6 +55,7 @@ class LOG4CXXNG_EXPORT LocationInfoFilter: public log4cxxng::spi::Filter
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(LocationInfoFilter)
 		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(LocationInfoFilter)
 		LOG4CXXNG_CAST_ENTRY(log4cxxng::spi::Filter)
 		END_LOG4CXXNG_CAST_MAP()
 
@@ -62,6 +63,8 @@ class LOG4CXXNG_EXPORT LocationInfoFilter: public log4cxxng::spi::Filter
 
 		void activateOptions(log4cxxng::helpers::Pool&);
 
+		void setOption(const LogString& option, const LogString& value);
+
 		void setExpression(const LogString& expression);
 
 		LogString getExpression() const;
@@ -71,17 +74,18 @@ class LOG4CXXNG_EXPORT LocationInfoFilter: public log4cxxng::spi::Filter
 		bool getConvertInFixToPostFix() const;
 
 		/**
-		 * If this event does not already contain location information,
-		 * evaluate the event against the expression.
-		 *
-		 * If the expression evaluates to true, generate a LocationInfo instance
-		 * by creating an exception and set this LocationInfo on the event.
+		 * In log4j, this generates location information for events
+		 * that match the expression. The logging macros of log4cxx
+		 * always capture location information, so there is nothing
+		 * to add and the expression is only compiled so that such
+		 * configurations load.
 		 *
 		 * Returns {@link log4cxxng::spi::Filter#NEUTRAL}
 		 */
 		FilterDecision decide(const spi::LoggingEventPtr& event) const;
 
 };
+LOG4CXXNG_PTR_DEF(LocationInfoFilter);
 }
 }
 #endif
@@ -77,6 +77,7 @@ class LOG4CXXNG_EXPORT LoggerMatchFilter : public spi::Filter
 		inline void setAcceptOnMatch(bool acceptOnMatch1)
 		{
 			this->acceptOnMatch = acceptOnMatch1;
+			changed();
 		}
 
 		inline bool getAcceptOnMatch() const
@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_FILTER_MULTI_STRING_MATCH_FILTER_H
+#define _LOG4CXXNG_FILTER_MULTI_STRING_MATCH_FILTER_H
+
+#include <log4cxxNG/spi/filter.h>
+#include <vector>
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4251 )
+#endif
+
+namespace log4cxxng
+{
+namespace filter
+{
+/**
+Matches the message of a {@link spi::LoggingEvent LoggingEvent} against
+many strings at once.
+
+<p>Each string carries its own action. Strings added with the
+<b>StringToAccept</b> option return
+{@link log4cxxng::spi::Filter#ACCEPT ACCEPT} on a match and strings
+added with <b>StringToDeny</b> return
+{@link log4cxxng::spi::Filter#DENY DENY}. When several strings occur in
+the message the one added first decides, which is what a chain of
+{@link StringMatchFilter StringMatchFilter}s in the same order would
+return. If no string occurs, NEUTRAL is returned.
+
+<p>All strings are compiled into a single Aho-Corasick automaton, so
+the message is scanned once no matter how many strings are configured.
+A filter holding a single string uses a plain substring search.
+
+<p>DOMConfigurator replaces runs of consecutive StringMatchFilters in
+an appender's configuration with one MultiStringMatchFilter, see
+#compile.
+*/
+class LOG4CXXNG_EXPORT MultiStringMatchFilter : public spi::Filter
+{
+	private:
+		struct Needle
+		{
+			LogString text;
+			bool acceptOnMatch;
+		};
+		std::vector<Needle> needles;
+
+		/**
+		Maps a character to its column in #transitions, 0 for
+		characters that do not occur in any string.
+		*/
+		unsigned int narrowClass[256];
+		std::vector<std::pair<logchar, unsigned int> > wideClass;
+		unsigned int classCount;
+
+		/**
+		Complete transition table, classCount entries per state.
+		*/
+		std::vector<unsigned int> transitions;
+
+		/**
+		Index of the first added string that ends in each state,
+		needles.size() if none does.
+		*/
+		std::vector<unsigned int> firstMatch;
+
+		void build();
+		unsigned int classOf(logchar c) const;
+
+	public:
+		typedef spi::Filter BASE_CLASS;
+		DECLARE_LOG4CXXNG_OBJECT(MultiStringMatchFilter)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(MultiStringMatchFilter)
+		LOG4CXXNG_CAST_ENTRY_CHAIN(BASE_CLASS)
+		END_LOG4CXXNG_CAST_MAP()
+
+		MultiStringMatchFilter();
+
+		/**
+		Set options
+		*/
+		virtual void setOption(const LogString& option,
+			const LogString& value);
+
+		/**
+		Adds a string to match. Empty strings are ignored, like an
+		unset StringMatchFilter.
+		*/
+		void addString(const LogString& stringToMatch, bool acceptOnMatch);
+
+		size_t getStringCount() const
+		{
+			return needles.size();
+		}
+
+		/**
+		Returns the action of the first added string that occurs in the
+		message, {@link log4cxxng::spi::Filter#NEUTRAL NEUTRAL} if none does.
+		*/
+		FilterDecision decide(const spi::LoggingEventPtr& event) const;
+
+		/**
+		Replaces each run of two or more consecutive StringMatchFilters in
+		filters with a single MultiStringMatchFilter that decides the same way.
+		*/
+		static void compile(std::vector<spi::FilterPtr>& filters);
+}; // class MultiStringMatchFilter
+LOG4CXXNG_PTR_DEF(MultiStringMatchFilter);
+}  // namespace filter
+} // namespace log4cxxng
+
+#if defined(_MSC_VER)
+	#pragma warning (pop)
+#endif
+
+#endif // _LOG4CXXNG_FILTER_MULTI_STRING_MATCH_FILTER_H
@@ -60,16 +60,19 @@ class LOG4CXXNG_EXPORT PropertyFilter : public log4cxxng::spi::Filter
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(PropertyFilter)
 		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(PropertyFilter)
 		LOG4CXXNG_CAST_ENTRY(log4cxxng::spi::Filter)
 		END_LOG4CXXNG_CAST_MAP()
 
 		PropertyFilter();
 		~PropertyFilter();
 		void setProperties(const LogString& props);
+		void setOption(const LogString& option, const LogString& value);
 
 		FilterDecision decide(const spi::LoggingEventPtr& event) const;
 
 };
+LOG4CXXNG_PTR_DEF(PropertyFilter);
 
 }
 }
@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_FILTER_RATE_LIMIT_FILTER_H
+#define _LOG4CXXNG_FILTER_RATE_LIMIT_FILTER_H
+
+#include <log4cxxNG/spi/filter.h>
+#include <log4cxxNG/helpers/ratelimiter.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/condition.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <vector>
+
+namespace log4cxxng
+{
+namespace filter
+{
+/**
+This filter limits the rate of events from each call site, identified
+by the file and line of the logging request and by the logger.
+
+<p>The filter admits the options <b>Rate</b>, events admitted per
+second and site, <b>Burst</b>, events admitted at once, <b>Sampling</b>,
+which admits 1 in N of the events over the limit, <b>SummaryInterval</b>,
+in seconds, and <b>MaxSites</b>, the number of call sites tracked.
+See helpers::RateLimiter for their meaning.
+
+<p>Events over the limit are denied, other events are passed
+to the following filters with {@link spi::Filter#NEUTRAL NEUTRAL}.
+When events of a site have been suppressed, the next event admitted
+from that site after the summary interval carries the count of
+suppressed events in its <code>log4cxx.suppressed</code> property.
+Sites that stay over their limit or fall silent are reported when
+their summary interval closes: a background thread then logs a summary
+event, with the logger, level and location of the last suppressed
+event and the count in the same property, to the appenders of that
+logger, as LOG4CXXNG_LOG_LIMITED does. #flush reports every site at
+once, as the filter is not told when its appender closes.
+
+<p>Sites are tracked in a fixed table updated without locks. Events
+from sites that do not fit in the table are not limited, and
+sites whose keys collide share one limit. Activating the options of
+a filter in use installs a new table; the previous tables are only
+released with the filter, as other threads may still be probing them.
+
+<p>As the filter only runs once the event is built, call sites which
+are known to be hot are better limited with LOG4CXXNG_LOG_LIMITED,
+which rejects events before their message is formatted.
+*/
+class LOG4CXXNG_EXPORT RateLimitFilter : public spi::Filter
+{
+	private:
+		struct Site;
+		struct Table;
+
+		unsigned int rate;
+		unsigned int burst;
+		unsigned int sampling;
+		int summaryInterval;
+		int maxSites;
+		void* volatile table;
+		std::vector<Table*> retired;
+
+		log4cxxng::helpers::Pool pool;
+		log4cxxng::helpers::Mutex summaryMutex;
+		log4cxxng::helpers::Condition summaryCondition;
+		bool stopping;
+		log4cxxng::helpers::Thread summarizer;
+
+	public:
+		typedef spi::Filter BASE_CLASS;
+		DECLARE_LOG4CXXNG_OBJECT(RateLimitFilter)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(RateLimitFilter)
+		LOG4CXXNG_CAST_ENTRY_CHAIN(BASE_CLASS)
+		END_LOG4CXXNG_CAST_MAP()
+
+		RateLimitFilter();
+		~RateLimitFilter();
+
+		/**
+		Set options
+		*/
+		virtual void setOption(const LogString& option,
+			const LogString& value);
+
+		/**
+		Allocates the table of sites and starts reporting suppressed
+		events when a summary interval closes.
+		*/
+		void activateOptions(log4cxxng::helpers::Pool& p);
+
+		/**
+		Logs a summary event for every site with suppressed events,
+		whether its summary interval has closed or not. Call it before
+		closing the appender to report the last suppressed events.
+		*/
+		void flush();
+
+		/**
+		Set the <code>Rate</code> option.
+		*/
+		inline void setRate(unsigned int rate1)
+		{
+			this->rate = rate1;
+		}
+
+		/**
+		Get the value of the <code>Rate</code> option.
+		*/
+		inline unsigned int getRate() const
+		{
+			return rate;
+		}
+
+		/**
+		Set the <code>Burst</code> option.
+		*/
+		inline void setBurst(unsigned int burst1)
+		{
+			this->burst = burst1;
+		}
+
+		/**
+		Get the value of the <code>Burst</code> option.
+		*/
+		inline unsigned int getBurst() const
+		{
+			return burst;
+		}
+
+		/**
+		Set the <code>Sampling</code> option.
+		*/
+		inline void setSampling(unsigned int sampling1)
+		{
+			this->sampling = sampling1;
+		}
+
+		/**
+		Get the value of the <code>Sampling</code> option.
+		*/
+		inline unsigned int getSampling() const
+		{
+			return sampling;
+		}
+
+		/**
+		Set the <code>SummaryInterval</code> option in seconds.
+		*/
+		inline void setSummaryInterval(int summaryInterval1)
+		{
+			this->summaryInterval = summaryInterval1;
+		}
+
+		/**
+		Get the value of the <code>SummaryInterval</code> option.
+		*/
+		inline int getSummaryInterval() const
+		{
+			return summaryInterval;
+		}
+
+		/**
+		Set the <code>MaxSites</code> option.
+		*/
+		inline void setMaxSites(int maxSites1)
+		{
+			this->maxSites = maxSites1;
+		}
+
+		/**
+		Get the value of the <code>MaxSites</code> option.
+		*/
+		inline int getMaxSites() const
+		{
+			return maxSites;
+		}
+
+		/**
+		Returns {@link spi::Filter#DENY DENY} if the site of the event
+		is over its limit, {@link spi::Filter#NEUTRAL NEUTRAL} otherwise.
+		*/
+		FilterDecision decide(const spi::LoggingEventPtr& event) const;
+
+	private:
+		RateLimitFilter(const RateLimitFilter&);
+		RateLimitFilter& operator=(const RateLimitFilter&);
+		static Site* getSite(Table& table,
+			const spi::LoggingEventPtr& event);
+		void summarize(bool all);
+		void stopSummarizer();
+		static void* LOG4CXXNG_THREAD_FUNC summaryLoop(apr_thread_t* thread, void* data);
+}; // class RateLimitFilter
+LOG4CXXNG_PTR_DEF(RateLimitFilter);
+}  // namespace filter
+} // namespace log4cxxng
+
+#endif // _LOG4CXXNG_FILTER_RATE_LIMIT_FILTER_H
@@ -0,0 +1,220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_FLIGHT_RECORDER_APPENDER_H
+#define _LOG4CXXNG_FLIGHT_RECORDER_APPENDER_H
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/appenderskeleton.h>
+#include <log4cxxNG/helpers/pagebuffer.h>
+#include <log4cxxNG/spi/triggeringeventevaluator.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/condition.h>
+#include <atomic>
+#include <memory>
+
+namespace log4cxxng
+{
+
+/**
+FlightRecorderAppender keeps the most recent output of every thread in
+memory and writes it to a file only when something goes wrong.
+
+<p>Each event is formatted with the appender's layout and copied into a
+ring buffer of <b>BufferSize</b> bytes owned by the logging thread, in
+the spirit of the {@link helpers::CyclicBuffer CyclicBuffer} used by
+{@link net::SMTPAppender SMTPAppender}, but holding bytes rather than
+events so that a thread logging heavily cannot push out the history of
+the others. Up to <b>MaxThreads</b> - 1 live threads get a ring of their
+own, any further threads share the last one. When a thread exits its
+ring is kept, with its content, until a new thread takes it over.
+<b>MaxThreads</b> is 64 by default and at most 256.
+
+<p>The rings are written to <b>File</b>, replacing its content, when
+<ul>
+<li>#dump is called,</li>
+<li>an event is triggering, at most once every <b>TriggerInterval</b>
+milliseconds. Without an evaluator set with <b>EvaluatorClass</b>, the
+events at or above <b>TriggerLevel</b>, ERROR by default, are. These
+dumps are written by a background thread, the logging thread does not
+wait for them,</li>
+<li>the process receives SIGSEGV, SIGBUS, SIGFPE, SIGILL or SIGABRT
+while <b>DumpOnSignal</b> is true, which is the default.</li>
+</ul>
+
+<p>Dumps on request or on a triggering event copy each ring while the
+appender is locked and write the copy after releasing it. A dump on a
+fatal signal cannot take the lock: it reads the rings as they are and
+writes the file with async-signal-safe calls only, so the oldest bytes
+of a ring may be torn if its thread keeps logging meanwhile. The dump
+lists the rings one after the other, each headed by the name of the
+thread that last owned it.
+*/
+class LOG4CXXNG_EXPORT FlightRecorderAppender : public AppenderSkeleton
+{
+	public:
+		DECLARE_LOG4CXXNG_OBJECT(FlightRecorderAppender)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(FlightRecorderAppender)
+		LOG4CXXNG_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXXNG_CAST_MAP()
+
+		FlightRecorderAppender();
+		FlightRecorderAppender(const LayoutPtr& layout, const LogString& fileName);
+		~FlightRecorderAppender();
+
+		void activateOptions(log4cxxng::helpers::Pool& p);
+		void setOption(const LogString& option, const LogString& value);
+
+		void append(const spi::LoggingEventPtr& event, log4cxxng::helpers::Pool& p);
+		void close();
+
+		bool requiresLayout() const
+		{
+			return true;
+		}
+
+		/**
+		 *  Writes the content of all rings to <b>File</b>.
+		 *  May be called from any thread, but not from a signal handler.
+		 *  @return false if the file could not be written.
+		 */
+		bool dump() const;
+
+		void setFile(const LogString& fileName);
+		LogString getFile() const;
+
+		/**
+		 *  Sets the size of the ring of each thread in bytes,
+		 *  for rings created afterwards.
+		 */
+		void setBufferSize(size_t bytes);
+		size_t getBufferSize() const;
+
+		void setMaxThreads(int count);
+		int getMaxThreads() const;
+
+		void setTriggerLevel(const LevelPtr& level);
+		LevelPtr getTriggerLevel() const;
+
+		void setEvaluator(const spi::TriggeringEventEvaluatorPtr& trigger);
+		spi::TriggeringEventEvaluatorPtr getEvaluator() const;
+		void setEvaluatorClass(const LogString& className);
+
+		void setTriggerInterval(int millis);
+		int getTriggerInterval() const;
+
+		void setDumpOnSignal(bool value);
+		bool getDumpOnSignal() const;
+
+	private:
+		FlightRecorderAppender(const FlightRecorderAppender&);
+		FlightRecorderAppender& operator=(const FlightRecorderAppender&);
+
+		/**
+		 *  Ring buffer written by one thread while the appender is
+		 *  locked, copied under the lock by dumps and read without
+		 *  it on a fatal signal.
+		 */
+		struct Ring
+		{
+			Ring(size_t capacity, const LogString& threadName);
+
+			void setThreadName(const LogString& threadName);
+			void write(const char* bytes, size_t length);
+			void locate(unsigned long long end, size_t& offset, size_t& length) const;
+			bool dump(int fd) const;
+			void copyTo(std::string& dst) const;
+
+			helpers::PageBuffer storage;
+			size_t capacity;
+			std::atomic<unsigned long long> written;
+			char threadName[64];
+			std::atomic<size_t> threadNameLength;
+
+			/**
+			 *  Set while a live thread owns the ring, cleared by
+			 *  that thread on exit. Shared with the thread so that
+			 *  it may outlive the appender.
+			 */
+			std::shared_ptr<std::atomic<bool> > owned;
+			Ring* next;
+		};
+
+		/**
+		 *  Writes the rings as they are, from a signal handler.
+		 */
+		bool dumpUnlocked() const;
+
+		Ring* getRing(const spi::LoggingEventPtr& event);
+		Ring* claimRing(const LogString& threadName);
+		bool isTriggeringEvent(const spi::LoggingEventPtr& event);
+		void requestDump();
+		void startDumper();
+		void stopDumper();
+		static void* LOG4CXXNG_THREAD_FUNC dumpLoop(apr_thread_t* thread, void* data);
+
+		static void registerRecorder(FlightRecorderAppender* recorder);
+		static void unregisterRecorder(FlightRecorderAppender* recorder);
+		static void onSignal(int signal);
+
+		LogString fileName;
+		std::string filePath;
+		size_t bufferSize;
+		int maxThreads;
+		LevelPtr triggerLevel;
+		spi::TriggeringEventEvaluatorPtr evaluator;
+		int triggerInterval;
+		bool dumpOnSignal;
+
+		/**
+		 *  Distinguishes this instance in the thread local ring cache.
+		 */
+		const unsigned long long generation;
+
+		/**
+		 *  Rings newest first, published for lock free dumps.
+		 */
+		std::atomic<Ring*> rings;
+		int ringCount;
+		Ring* sharedRing;
+
+		log4cxxng_time_t lastDump;
+		LogString formatted;
+		std::string encoded;
+
+		helpers::Mutex dumpMutex;
+		helpers::Condition dumpCondition;
+		bool dumpRequested;
+		bool stopping;
+		helpers::Thread dumper;
+}; // class FlightRecorderAppender
+
+LOG4CXXNG_PTR_DEF(FlightRecorderAppender);
+
+}  // namespace log4cxxng
+
+#if defined(_MSC_VER)
+	#pragma warning ( pop )
+#endif
+
+#endif // _LOG4CXXNG_FLIGHT_RECORDER_APPENDER_H
@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_HELPERS_APPENDER_METRICS_H
+#define _LOG4CXXNG_HELPERS_APPENDER_METRICS_H
+
+#include <log4cxxNG/logstring.h>
+#include <atomic>
+#include <map>
+#include <vector>
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4251 )
+#endif
+
+namespace log4cxxng
+{
+namespace helpers
+{
+
+/**
+ *  Counters and a write latency histogram kept by every appender.
+ *
+ *  <p>Each counter is split into stripes padded to their own cache
+ *  line, and a thread always updates the same stripe, so recording
+ *  never takes a lock and rarely shares a cache line between cores.
+ *  Reading sums the stripes and may miss updates in flight.
+ *
+ *  <p>Write latencies are kept in log-linear buckets, four for every
+ *  power of two nanoseconds, which bounds the relative error of a
+ *  percentile to 25%.
+ *
+ *  @see AppenderSkeleton::getMetrics, Hierarchy::getAppenderMetrics
+ */
+class LOG4CXXNG_EXPORT AppenderMetrics
+{
+	public:
+		enum Counter
+		{
+			/** Events passed to the appender. */
+			EVENTS_IN,
+			/** Events that passed the threshold and filters and were appended. */
+			EVENTS_OUT,
+			/** Events dropped because a queue was full. */
+			DISCARDED,
+			/**
+			 *  Formatted characters written, which is the number of
+			 *  bytes for UTF-8 output.
+			 */
+			BYTES_WRITTEN,
+			/** Explicit flushes of the output. */
+			FLUSHES,
+			/** Rollovers performed. */
+			ROLLOVERS,
+			/** Total time spent rolling over, in nanoseconds. */
+			ROLLOVER_NANOS,
+			/** Total time spent appending, in nanoseconds. */
+			WRITE_NANOS,
+			COUNTER_COUNT
+		};
+
+		enum
+		{
+			STRIPES = 8,
+			SUB_BUCKETS = 4,
+			BUCKETS = 48 * SUB_BUCKETS
+		};
+
+		/**
+		 *  Values of all counters at one point in time.
+		 */
+		struct LOG4CXXNG_EXPORT Snapshot
+		{
+			Snapshot();
+
+			unsigned long long counters[COUNTER_COUNT];
+			size_t queueHighWater;
+			std::vector<unsigned long long> writeLatency;
+
+			/**
+			 *  Gets the count of recorded write latencies.
+			 */
+			unsigned long long getWriteCount() const;
+
+			/**
+			 *  Gets a write latency percentile in nanoseconds, the upper
+			 *  bound of the bucket that holds it.
+			 *  @param fraction percentile between 0 and 1.
+			 */
+			unsigned long long getWriteLatency(double fraction) const;
+		};
+
+		AppenderMetrics();
+
+		inline void add(Counter counter, unsigned long long amount = 1)
+		{
+			stripes[stripeIndex()].counters[counter].fetch_add(amount,
+				std::memory_order_relaxed);
+		}
+
+		/**
+		 *  Records the depth of a queue after an event was added.
+		 */
+		void recordQueueDepth(size_t depth);
+
+		/**
+		 *  Records the time taken by one append.
+		 */
+		void recordWrite(unsigned long long nanos);
+
+		/**
+		 *  Records one rollover and the time it took.
+		 */
+		void recordRollover(unsigned long long nanos);
+
+		unsigned long long get(Counter counter) const;
+
+		inline size_t getQueueHighWater() const
+		{
+			return queueHighWater.load(std::memory_order_relaxed);
+		}
+
+		void snapshot(Snapshot& result) const;
+
+		/**
+		 *  Monotonic time in nanoseconds, for measuring durations.
+		 */
+		static unsigned long long now();
+
+		/**
+		 *  Gets the histogram bucket of a latency.
+		 */
+		static int getBucket(unsigned long long nanos);
+
+		/**
+		 *  Gets the exclusive upper bound of a bucket in nanoseconds.
+		 */
+		static unsigned long long getBucketLimit(int bucket);
+
+		/**
+		 *  Appends the metrics of several appenders, keyed by appender
+		 *  name, in the Prometheus text exposition format.
+		 */
+		static void writePrometheus(const std::map<LogString, Snapshot>& metrics,
+			LogString& text);
+
+	private:
+		AppenderMetrics(const AppenderMetrics&);
+		AppenderMetrics& operator=(const AppenderMetrics&);
+
+		static unsigned int stripeIndex();
+
+		struct Stripe
+		{
+			std::atomic<unsigned long long> counters[COUNTER_COUNT];
+			std::atomic<unsigned long long> writeLatency[BUCKETS];
+			char padding[64];
+		};
+
+		Stripe stripes[STRIPES];
+		std::atomic<size_t> queueHighWater;
+};
+
+}  // namespace helpers
+} // namespace log4cxxng
+
+#if defined(_MSC_VER)
+	#pragma warning (pop)
+#endif
+
+#endif // _LOG4CXXNG_HELPERS_APPENDER_METRICS_H
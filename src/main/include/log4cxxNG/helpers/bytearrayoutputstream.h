@@ -61,6 +61,23 @@ class LOG4CXXNG_EXPORT ByteArrayOutputStream : public OutputStream
 		virtual void write(ByteBuffer& buf, Pool& p);
 		ByteList toByteArray() const;
 
+		/**
+		 *  Discards the content written so far, keeping the
+		 *  allocated capacity.
+		 */
+		void reset();
+
+		/**
+		 *  Number of bytes written since creation or the last #reset.
+		 */
+		size_t size() const;
+
+		/**
+		 *  Gives access to the content without copying it,
+		 *  valid until the next write or #reset.
+		 */
+		const unsigned char* data() const;
+
 	private:
 		ByteArrayOutputStream(const ByteArrayOutputStream&);
 		ByteArrayOutputStream& operator=(const ByteArrayOutputStream&);
@@ -44,6 +44,11 @@ class LOG4CXXNG_EXPORT Class
 		LogString toString() const;
 		virtual LogString getName() const = 0;
 		static const Class& forName(const LogString& className);
+		/**
+		 *  Returns the class registered under the lower case form of its
+		 *  name, or null, without trying the other spellings of #forName.
+		 */
+		static const Class* findRegistered(const LogString& registeredName);
 		static bool registerClass(const Class& newClass);
 
 	protected:
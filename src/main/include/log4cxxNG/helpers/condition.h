@@ -62,6 +62,16 @@ class LOG4CXXNG_EXPORT Condition
 		 */
 		void await(Mutex& lock);
 
+		/**
+		 *  Await signaling of condition for at most <code>timeout</code>.
+		 *  @param lock lock associated with condition, calling thread must
+		 *  own lock.
+		 *  @param timeout maximum time to wait in microseconds.
+		 *  @return false if the time elapsed without a signal.
+		 *  @throws InterruptedException if thread is interrupted.
+		 */
+		bool await(Mutex& lock, log4cxxng_time_t timeout);
+
 	private:
 		apr_thread_cond_t* condition;
 		Condition(const Condition&);
@@ -19,6 +19,7 @@
 #define _LOG4CXXNG_HELPERS_CYCLICBUFFER_H
 
 #include <log4cxxNG/spi/loggingevent.h>
+#include <atomic>
 
 namespace log4cxxng
 {
@@ -30,14 +31,28 @@ CyclicBuffer is used by other appenders to hold instances of
 or deferred display.
 <p>This buffer gives read access to any element in the buffer not
 just the first or last element.
+<p>#add, #get() and #get(int) may be called from any number of threads
+without locking: the buffer is a bounded ring in which each slot carries
+a sequence number that hands it over between writers and readers. When
+the buffer is full, #add drops the oldest event. #get(int) marks the
+slot it reads, and an event is only removed once no such read is in
+progress. #resize must not run concurrently with other calls.
 */
 class LOG4CXXNG_EXPORT CyclicBuffer
 {
-		log4cxxng::spi::LoggingEventList ea;
-		int first;
-		int last;
-		int numElems;
+		struct Slot
+		{
+			std::atomic<size_t> sequence;
+			std::atomic<int> readers;
+			spi::LoggingEventPtr event;
+		};
+
+		Slot* slots;
 		int maxSize;
+		std::atomic<size_t> head;
+		std::atomic<size_t> tail;
+
+		void init(int size);
 
 	public:
 		/**
@@ -59,7 +74,8 @@ class LOG4CXXNG_EXPORT CyclicBuffer
 		/**
 		Get the <i>i</i>th oldest event currently in the buffer. If
 		<em>i</em> is outside the range 0 to the number of elements
-		currently in the buffer, then <code>null</code> is returned.
+		currently in the buffer, or the event is removed meanwhile,
+		then <code>null</code> is returned.
 		*/
 		spi::LoggingEventPtr get(int i);
 
@@ -79,16 +95,17 @@ class LOG4CXXNG_EXPORT CyclicBuffer
 		guaranteed to be in the range 0 to <code>maxSize</code>
 		(inclusive).
 		*/
-		int length() const
-		{
-			return numElems;
-		}
+		int length() const;
 
 		/**
 		Resize the cyclic buffer to <code>newSize</code>.
 		@throws IllegalArgumentException if <code>newSize</code> is negative.
 		*/
 		void resize(int newSize);
+
+	private:
+		CyclicBuffer(const CyclicBuffer&);
+		CyclicBuffer& operator=(const CyclicBuffer&);
 }; // class CyclicBuffer
 }  //namespace helpers
 } //namespace log4cxxng
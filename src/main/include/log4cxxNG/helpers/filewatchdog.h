@@ -32,6 +32,13 @@ namespace helpers
 /**
 Check every now and then that a certain file has not changed. If it
 has, then call the #doOnChange method.
+
+Where the platform can notify file system changes (inotify on Linux),
+the directory holding the file is watched as well. A change, including
+a new file renamed over the old one, is then applied once no further
+change has been seen for the debounce period, instead of at the next
+check. The periodic check remains as a fallback for file systems
+that do not deliver notifications.
 */
 class LOG4CXXNG_EXPORT FileWatchdog
 {
@@ -42,6 +49,11 @@ class LOG4CXXNG_EXPORT FileWatchdog
 		seconds.  */
 		static long DEFAULT_DELAY /*= 60000*/;
 
+		/**
+		The default quiet period after a notified change before the
+		file is reloaded, set to 200 milliseconds.  */
+		static long DEFAULT_DEBOUNCE /*= 200*/;
+
 	protected:
 		/**
 		The name of the file to observe  for changes.
@@ -52,6 +64,12 @@ class LOG4CXXNG_EXPORT FileWatchdog
 		The delay to observe between every check.
 		By default set DEFAULT_DELAY.*/
 		long delay;
+
+		/**
+		The quiet period, in milliseconds, that must follow a notified
+		change before the file is reloaded.
+		By default set DEFAULT_DEBOUNCE.*/
+		long debounce;
 		log4cxxng_time_t lastModif;
 		bool warnedAlready;
 		volatile unsigned int interrupted;
@@ -70,12 +88,33 @@ class LOG4CXXNG_EXPORT FileWatchdog
 			this->delay = delay1;
 		}
 
+		/**
+		Set the quiet period that must follow a notified change before
+		the file is reloaded.
+		*/
+		void setDebounce(long debounce1)
+		{
+			this->debounce = debounce1;
+		}
+
 		void start();
 
 	private:
 		static void* LOG4CXXNG_THREAD_FUNC run(apr_thread_t* thread, void* data);
+		bool openNotifier();
+		void closeNotifier();
+		void watchNotifications();
+		bool readNotifications(const std::string& name);
 		Pool pool;
 		Thread thread;
+		/**
+		Change notification descriptor, -1 if changes are only polled.
+		*/
+		int notifyFd;
+		/**
+		Pipe used to wake the watching thread on shutdown.
+		*/
+		int wakeFd[2];
 
 		FileWatchdog(const FileWatchdog&);
 		FileWatchdog& operator=(const FileWatchdog&);
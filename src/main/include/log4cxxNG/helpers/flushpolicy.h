@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_HELPERS_FLUSH_POLICY_H
+#define _LOG4CXXNG_HELPERS_FLUSH_POLICY_H
+
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/level.h>
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4251 )
+#endif
+
+namespace log4cxxng
+{
+namespace helpers
+{
+
+/**
+ *  Decides when a WriterAppender flushes its writer.
+ *
+ *  <p>The output is flushed once <b>FlushBytes</b> characters or
+ *  <b>FlushEvents</b> events have been written since the previous
+ *  flush, and right after an event at or above <b>FlushLevel</b>.
+ *  With <b>FlushInterval</b> set, a timer flushes output left
+ *  pending for that many milliseconds, which bounds how much is lost
+ *  if the process dies.  A policy without any of these options is
+ *  inactive and the appender falls back to <b>ImmediateFlush</b>.
+ *
+ *  <p>The policy is only useful with buffered output, such as a
+ *  FileAppender with <b>BufferedIO</b> set.  It is not synchronized,
+ *  the appender calls it with its lock held.
+ */
+class LOG4CXXNG_EXPORT FlushPolicy
+{
+	public:
+		FlushPolicy();
+
+		/**
+		 *  Sets one of the options described above.
+		 *  @return true if the option is one of the policy's.
+		 */
+		bool setOption(const LogString& option, const LogString& value);
+
+		void setFlushBytes(size_t bytes);
+		void setFlushEvents(unsigned int events);
+		void setFlushInterval(unsigned int milliseconds);
+		void setFlushLevel(const LevelPtr& level);
+
+		inline size_t getFlushBytes() const
+		{
+			return flushBytes;
+		}
+
+		inline unsigned int getFlushEvents() const
+		{
+			return flushEvents;
+		}
+
+		inline unsigned int getFlushInterval() const
+		{
+			return flushInterval;
+		}
+
+		inline const LevelPtr& getFlushLevel() const
+		{
+			return flushLevel;
+		}
+
+		/**
+		 *  Returns true if any option has been set.
+		 */
+		bool isActive() const;
+
+		/**
+		 *  Records an event written to the output.
+		 *  @param level level of the event.
+		 *  @param bytes number of characters written.
+		 *  @return true if the output should be flushed now.
+		 */
+		bool written(const LevelPtr& level, size_t bytes);
+
+		/**
+		 *  Returns true if output was written since the previous flush.
+		 */
+		inline bool hasPending() const
+		{
+			return pendingEvents > 0;
+		}
+
+		/**
+		 *  Records that the output has been flushed.
+		 */
+		void flushed();
+
+	private:
+		size_t flushBytes;
+		unsigned int flushEvents;
+		unsigned int flushInterval;
+		LevelPtr flushLevel;
+		size_t pendingBytes;
+		unsigned int pendingEvents;
+};
+
+}  // namespace helpers
+} // namespace log4cxxng
+
+#if defined(_MSC_VER)
+	#pragma warning (pop)
+#endif
+
+#endif // _LOG4CXXNG_HELPERS_FLUSH_POLICY_H
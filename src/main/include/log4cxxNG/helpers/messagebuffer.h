@@ -42,6 +42,11 @@ typedef std::ios_base& (*ios_base_manip)(std::ios_base&);
  *   This class is used by the LOG4CXXNG_INFO and similar
  *   macros to support insertion operators in the message parameter.
  *   The class is not intended for use outside of that context.
+ *
+ *   Strings and built-in numbers are formatted directly into
+ *   storage held inside the buffer, longer messages spill into a
+ *   string reused by the calling thread.  An STL stream is only
+ *   created for manipulators and user-defined insertion operators.
  */
 class LOG4CXXNG_EXPORT CharMessageBuffer
 {
@@ -85,58 +90,64 @@ class LOG4CXXNG_EXPORT CharMessageBuffer
 		/**
 		 *   Insertion operator for STL manipulators such as std::fixed.
 		 *   @param manip manipulator.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(ios_base_manip manip);
+		CharMessageBuffer& operator<<(ios_base_manip manip);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Insertion operator for STL manipulators such as std::endl.
+		 *   @param manip manipulator.
+		 *   @return this buffer.
+		 */
+		CharMessageBuffer& operator<<(std::ostream& (*manip)(std::ostream&));
+		/**
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(bool val);
+		CharMessageBuffer& operator<<(bool val);
 
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(short val);
+		CharMessageBuffer& operator<<(short val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(int val);
+		CharMessageBuffer& operator<<(int val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(unsigned int val);
+		CharMessageBuffer& operator<<(unsigned int val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(long val);
+		CharMessageBuffer& operator<<(long val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(unsigned long val);
+		CharMessageBuffer& operator<<(unsigned long val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(float val);
+		CharMessageBuffer& operator<<(float val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return this buffer.
 		 */
-		std::ostream& operator<<(double val);
+		CharMessageBuffer& operator<<(double val);
 		/**
 		 *   Insertion operator for built-in type.
 		 *   @param val build in type.
@@ -185,6 +196,22 @@ class LOG4CXXNG_EXPORT CharMessageBuffer
 		 */
 		CharMessageBuffer& operator=(const CharMessageBuffer&);
 
+		/**
+		 *   Appends characters to the inline storage or,
+		 *   once that is full, to the encapsulated string.
+		 */
+		void append(const char* msg, size_t len);
+
+		enum { INLINE_CAPACITY = 256 };
+
+		/**
+		 *  Message characters held before spilling into buf.
+		 */
+		char inlineBuf[INLINE_CAPACITY];
+		/**
+		 *  Number of characters in inlineBuf.
+		 */
+		size_t inlineLength;
 		/**
 		   * Encapsulated std::string.
 		   */
@@ -685,59 +712,65 @@ class LOG4CXXNG_EXPORT MessageBuffer
 		/**
 		 *   Insertion operator for STL manipulators such as std::fixed.
 		 *   @param manip manipulator.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(ios_base_manip manip);
+		CharMessageBuffer& operator<<(ios_base_manip manip);
+		/**
+		 *   Insertion operator for STL manipulators such as std::endl.
+		 *   @param manip manipulator.
+		 *   @return encapsulated CharMessageBuffer.
+		 */
+		CharMessageBuffer& operator<<(std::ostream& (*manip)(std::ostream&));
 
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(bool val);
+		CharMessageBuffer& operator<<(bool val);
 
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(short val);
+		CharMessageBuffer& operator<<(short val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(int val);
+		CharMessageBuffer& operator<<(int val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(unsigned int val);
+		CharMessageBuffer& operator<<(unsigned int val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(long val);
+		CharMessageBuffer& operator<<(long val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(unsigned long val);
+		CharMessageBuffer& operator<<(unsigned long val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(float val);
+		CharMessageBuffer& operator<<(float val);
 		/**
-		 *   Insertion operator for built-in type.
+		 *   Appends built-in type to buffer.
 		 *   @param val build in type.
-		 *   @return encapsulated STL stream.
+		 *   @return encapsulated CharMessageBuffer.
 		 */
-		std::ostream& operator<<(double val);
+		CharMessageBuffer& operator<<(double val);
 		/**
 		 *   Insertion operator for built-in type.
 		 *   @param val build in type.
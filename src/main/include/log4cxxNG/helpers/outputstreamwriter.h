@@ -21,6 +21,7 @@
 #include <log4cxxNG/helpers/writer.h>
 #include <log4cxxNG/helpers/outputstream.h>
 #include <log4cxxNG/helpers/charsetencoder.h>
+#include <log4cxxNG/helpers/pagebuffer.h>
 
 namespace log4cxxng
 {
@@ -36,6 +37,11 @@ class LOG4CXXNG_EXPORT OutputStreamWriter : public Writer
 	private:
 		OutputStreamPtr out;
 		CharsetEncoderPtr enc;
+		/**
+		 *  Encoding buffer for strings too long for the stack,
+		 *  such as the content of a BufferedWriter.
+		 */
+		PageBuffer staging;
 
 	public:
 		DECLARE_ABSTRACT_LOG4CXXNG_OBJECT(OutputStreamWriter)
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_HELPERS_PAGE_BUFFER_H
+#define _LOG4CXXNG_HELPERS_PAGE_BUFFER_H
+
+#include <log4cxxNG/log4cxxNG.h>
+#include <stddef.h>
+
+namespace log4cxxng
+{
+namespace helpers
+{
+
+/**
+ *  Byte buffer for staging large output before it is written.
+ *
+ *  <p>Buffers of at least HUGE_PAGE_SIZE bytes are mapped directly
+ *  from the system, aligned on a huge page boundary, and advised to
+ *  use transparent huge pages where the platform supports it, which
+ *  saves TLB misses when copying megabytes of log output.  Smaller
+ *  buffers come from the heap.
+ *
+ *  <p>The pages of a mapped buffer are placed on the NUMA node of the
+ *  thread that first writes them, so a buffer should be filled by the
+ *  thread that uses it, such as the thread of an AsyncAppender's
+ *  dispatcher bound with <b>DispatcherAffinity</b>.
+ *
+ *  <p>A buffer is not synchronized.
+ */
+class LOG4CXXNG_EXPORT PageBuffer
+{
+	public:
+		enum { HUGE_PAGE_SIZE = 2 * 1024 * 1024 };
+
+		PageBuffer();
+		~PageBuffer();
+
+		/**
+		 *  Makes room for at least <code>capacity</code> bytes.  The
+		 *  content is lost when the buffer has to grow.
+		 *  @param capacity minimum size in bytes.
+		 *  @return start of the buffer.
+		 */
+		char* reserve(size_t capacity);
+
+		char* data() const
+		{
+			return base;
+		}
+
+		size_t capacity() const
+		{
+			return size;
+		}
+
+		/**
+		 *  Tests if the buffer was mapped with huge pages advised.
+		 */
+		bool isHugePage() const
+		{
+			return mapped;
+		}
+
+		/**
+		 *  Returns the memory of the buffer to the system.
+		 */
+		void release();
+
+	private:
+		PageBuffer(const PageBuffer&);
+		PageBuffer& operator=(const PageBuffer&);
+
+		char* base;
+		size_t size;
+		bool mapped;
+};
+
+} // namespace helpers
+} // namespace log4cxxng
+
+#endif //_LOG4CXXNG_HELPERS_PAGE_BUFFER_H
@@ -0,0 +1,131 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_HELPERS_RATE_LIMITER_H
+#define _LOG4CXXNG_HELPERS_RATE_LIMITER_H
+
+#include <log4cxxNG/logstring.h>
+
+namespace log4cxxng
+{
+namespace helpers
+{
+
+/**
+ *  Token bucket and deterministic sampler deciding whether an event
+ *  from one source, typically one call site, may be logged.
+ *
+ *  <p>Up to <b>burst</b> events are admitted at once, then
+ *  <b>rate</b> events per second.  Of the events over that limit,
+ *  every <b>sampling</b>th one is still admitted, and the others are
+ *  counted as suppressed.  A rate of zero disables the token bucket,
+ *  so that only 1 in <b>sampling</b> events is admitted.
+ *
+ *  <p>The bucket is kept as the theoretical arrival time of the next
+ *  event (GCRA) and updated with compare-and-swap, so tryAcquire()
+ *  never blocks.  The 64 bit counters need APR 1.7 or later.
+ *
+ *  @see LOG4CXXNG_LOG_LIMITED, filter::RateLimitFilter
+ */
+class LOG4CXXNG_EXPORT RateLimiter
+{
+	public:
+		/**
+		 *  Create a new instance.
+		 *  @param rate events admitted per second, 0 for no limit.
+		 *  @param burst events admitted at once, 0 for <code>rate</code>.
+		 *  @param sampling admit 1 in <code>sampling</code> of the
+		 *  events over the limit, 0 for none.
+		 *  @param summaryInterval minimum interval in microseconds between
+		 *  two reports of suppressed events.
+		 */
+		RateLimiter(unsigned int rate = 0, unsigned int burst = 0,
+			unsigned int sampling = 0,
+			log4cxxng_time_t summaryInterval = DEFAULT_SUMMARY_INTERVAL);
+
+		/**
+		 *  Changes the limits, must not be called while
+		 *  the limiter is used by other threads.
+		 */
+		void configure(unsigned int rate, unsigned int burst,
+			unsigned int sampling, log4cxxng_time_t summaryInterval);
+
+		/**
+		 *  Decides whether an event occurring now may be logged.
+		 *  @return true if the event is admitted.
+		 */
+		bool tryAcquire();
+
+		/**
+		 *  Decides whether an event may be logged.
+		 *  @param now time of the event in microseconds.
+		 *  @return true if the event is admitted.
+		 */
+		bool tryAcquire(log4cxxng_time_t now);
+
+		/**
+		 *  Takes the count of suppressed events if the summary
+		 *  interval has elapsed since the previous summary.
+		 *  @param now current time in microseconds.
+		 *  @return count of events suppressed since the previous
+		 *  summary, 0 if there are none or no summary is due.
+		 */
+		unsigned int takeSuppressedCount(log4cxxng_time_t now);
+
+		/**
+		 *  Takes the count of suppressed events if a summary is due now.
+		 */
+		unsigned int takeSuppressedCount();
+
+		/**
+		 *  Takes the count of suppressed events whether a summary is
+		 *  due or not, as when the summary interval is cut short.
+		 */
+		unsigned int drainSuppressedCount();
+
+		/**
+		 *  Gets the count of suppressed events not yet taken.
+		 */
+		unsigned int getSuppressedCount() const;
+
+		/**
+		 *  Formats the message of a summary event.
+		 *  @param count count of suppressed events.
+		 *  @return message.
+		 */
+		static LogString formatSummary(unsigned int count);
+
+		enum { DEFAULT_SUMMARY_INTERVAL = 10000000 };
+
+	private:
+		RateLimiter(const RateLimiter&);
+		RateLimiter& operator=(const RateLimiter&);
+
+		log4cxxng_time_t interval;
+		log4cxxng_time_t tolerance;
+		unsigned int sampling;
+		log4cxxng_time_t summaryInterval;
+		volatile log4cxxng_time_t nextArrival;
+		volatile log4cxxng_time_t lastSummary;
+		volatile unsigned int overLimit;
+		volatile unsigned int suppressed;
+};
+
+} // namespace helpers
+} // namespace log4cxxng
+
+#endif //_LOG4CXXNG_HELPERS_RATE_LIMITER_H
@@ -65,6 +65,9 @@ class LOG4CXXNG_EXPORT Socket : public helpers::ObjectImpl
 
 		/** Returns the value of this socket's port field. */
 		int getPort() const;
+
+		/** Returns the underlying APR socket, null once closed. */
+		apr_socket_t* getAPRSocket() const;
 	private:
 		Socket(const Socket&);
 		Socket& operator=(const Socket&);
@@ -0,0 +1,169 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_HELPERS_SOCKET_FANOUT_H
+#define _LOG4CXXNG_HELPERS_SOCKET_FANOUT_H
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/helpers/socket.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <vector>
+
+extern "C" {
+	struct apr_pollset_t;
+}
+
+namespace log4cxxng
+{
+namespace helpers
+{
+
+/**
+ *  Delivers the same byte sequence to a set of connected sockets
+ *  without ever blocking the caller.
+ *
+ *  <p>Each message handed to #send is copied once into a reference
+ *  counted block that is shared by every client.  Every client owns a
+ *  bounded ring of pending blocks which a single I/O thread drains with
+ *  non-blocking writes, waiting on an APR pollset (epoll on Linux) for
+ *  sockets that are not writable.
+ *
+ *  <p>A client whose pending bytes would exceed the configured buffer
+ *  size is a laggard.  Depending on the policy, the new message is either
+ *  dropped for that client only, and counted, or the client is
+ *  disconnected.  Other clients and the logging threads are unaffected.
+ */
+class LOG4CXXNG_EXPORT SocketFanout
+{
+	public:
+		enum LaggardPolicy
+		{
+			DROP_NEWEST,
+			DISCONNECT
+		};
+
+		/**
+		 *  Snapshot of the state of one connected client.
+		 */
+		struct ClientStatistics
+		{
+			LogString address;
+			size_t pendingBytes;
+			unsigned int droppedMessages;
+		};
+		LOG4CXXNG_LIST_DEF(ClientStatisticsList, ClientStatistics);
+
+		SocketFanout();
+		~SocketFanout();
+
+		/**
+		 *  Starts the I/O thread, does nothing if already running.
+		 */
+		void start();
+
+		/**
+		 *  Stops the I/O thread, closes every client and discards
+		 *  pending data.
+		 */
+		void stop();
+
+		/**
+		 *  Adds a connected socket.  The socket is switched to non-blocking
+		 *  mode and is owned by the fan-out from now on.
+		 *  @param socket connected socket.
+		 *  @param prolog bytes sent to this client before any message,
+		 *  may be null.
+		 *  @param prologLen length of prolog.
+		 */
+		void addClient(const SocketPtr& socket, const char* prolog, size_t prologLen);
+
+		/**
+		 *  Queues a message for every connected client.
+		 *  @param data bytes to send, copied once.
+		 *  @param len number of bytes.
+		 */
+		void send(const char* data, size_t len);
+
+		/**
+		 *  Number of connected clients, including those not yet
+		 *  registered by the I/O thread.
+		 */
+		size_t getClientCount() const;
+
+		ClientStatisticsList getClientStatistics() const;
+
+		/**
+		 *  Total number of messages dropped for laggards, including
+		 *  clients that have since disconnected.
+		 */
+		unsigned int getDroppedCount() const;
+
+		/**
+		 *  Sets the maximum number of bytes queued per client.
+		 */
+		void setClientBufferSize(size_t bytes);
+		size_t getClientBufferSize() const;
+
+		void setLaggardPolicy(LaggardPolicy policy);
+		LaggardPolicy getLaggardPolicy() const;
+
+		/**
+		 *  Converts the <b>LaggardPolicy</b> option value,
+		 *  "Drop" or "Disconnect", to a policy.
+		 */
+		static LaggardPolicy toLaggardPolicy(const LogString& value, LaggardPolicy defaultValue);
+
+	private:
+		struct Message;
+		class Client;
+		LOG4CXXNG_LIST_DEF(ClientList, Client*);
+
+		static void* LOG4CXXNG_THREAD_FUNC run(apr_thread_t* thread, void* data);
+		void registerNewClients();
+		void flushClients();
+		void removeClient(size_t index);
+		void wakeup();
+
+		Pool pool;
+		Mutex mutex;
+		apr_pollset_t* pollset;
+		Thread thread;
+		ClientList clients;
+		ClientList newClients;
+		size_t clientBufferSize;
+		LaggardPolicy laggardPolicy;
+		volatile unsigned int closing;
+		volatile unsigned int wakeupPending;
+		volatile unsigned int dropped;
+
+		SocketFanout(const SocketFanout&);
+		SocketFanout& operator=(const SocketFanout&);
+};
+
+}  // namespace helpers
+} // namespace log4cxxng
+
+#if defined(_MSC_VER)
+	#pragma warning ( pop )
+#endif
+
+#endif //_LOG4CXXNG_HELPERS_SOCKET_FANOUT_H
@@ -21,33 +21,113 @@
 
 #include <log4cxxNG/helpers/objectptr.h>
 #include <log4cxxNG/helpers/inetaddress.h>
-#include <log4cxxNG/helpers/datagramsocket.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/condition.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <string>
+#include <vector>
 
 #if defined(_MSC_VER)
 	#pragma warning ( push )
 	#pragma warning ( disable: 4251 )
 #endif
 
+extern "C" {
+	struct apr_socket_t;
+	struct apr_sockaddr_t;
+}
+
 namespace log4cxxng
 {
 namespace helpers
 {
 /**
-SyslogWriter is a wrapper around the DatagramSocket class
-it writes text to the specified host on the port 514 (UNIX syslog)
+SyslogWriter sends syslog messages to the specified host, on the port 514
+(UNIX syslog) by default.
+
+<p>Messages are sent over UDP, one datagram per message, or over a
+persistent TCP connection using octet-counted framing
+("MSG-LEN SP SYSLOG-MSG", RFC 5425 and RFC 6587).  The TCP connection
+is re-established on the next write after a failure.
+
+<p>When the batch size is greater than one, #write only queues the
+message and returns.  A background thread sends everything queued so far
+at once, with a single <code>sendmmsg</code> call for UDP where the
+platform provides it, or a single stream write for TCP.  Batches form
+naturally under load while a lone message is sent without delay.
 */
 class LOG4CXXNG_EXPORT SyslogWriter
 {
 	public:
 #define SYSLOG_PORT 514
+		enum Protocol
+		{
+			UDP,
+			TCP
+		};
+
 		SyslogWriter(const LogString& syslogHost, int syslogHostPort = SYSLOG_PORT);
+
+		/**
+		 *  @param syslogHost host name or address.
+		 *  @param syslogHostPort port, SYSLOG_PORT if negative.
+		 *  @param protocol UDP or TCP.
+		 *  @param batchSize maximum number of messages sent at once,
+		 *  1 or less to send each message synchronously.
+		 */
+		SyslogWriter(const LogString& syslogHost, int syslogHostPort,
+			Protocol protocol, int batchSize);
+		~SyslogWriter();
+
 		void write(const LogString& string);
 
+		/**
+		 *  Sends or queues a message already encoded in the wire
+		 *  charset, without any framing.
+		 */
+		void write(const char* data, size_t len);
+
+		/**
+		 *  Waits until every queued message has been sent.
+		 */
+		void flush();
+
+		/**
+		 *  Number of messages discarded because the queue was full or
+		 *  the host could not be reached.
+		 */
+		unsigned int getDroppedCount() const;
+
 	private:
+		void init();
+		bool connect();
+		void disconnect();
+		void sendBatch(const std::string& data, const std::vector<size_t>& ends);
+		bool sendStream(const char* data, size_t len);
+		static void* LOG4CXXNG_THREAD_FUNC sender(apr_thread_t* thread, void* data);
+
 		LogString syslogHost;
 		int syslogHostPort;
-		InetAddressPtr address;
-		DatagramSocketPtr ds;
+		Protocol protocol;
+		size_t batchSize;
+		Pool pool;
+		apr_sockaddr_t* address;
+		apr_socket_t* socket;
+		log4cxxng_time_t lastConnect;
+
+		Mutex mutex;
+		Condition pendingCondition;
+		Condition sentCondition;
+		Thread thread;
+		std::string pending;
+		std::vector<size_t> pendingEnds;
+		bool sending;
+		bool closing;
+		volatile unsigned int dropped;
+
+		SyslogWriter(const SyslogWriter&);
+		SyslogWriter& operator=(const SyslogWriter&);
 };
 }  // namespace helpers
 } // namespace log4cxxng
@@ -19,6 +19,7 @@
 #define _LOG4CXXNG_HELPERS_THREAD_H
 
 #include <log4cxxNG/log4cxxNG.h>
+#include <log4cxxNG/logstring.h>
 #include <log4cxxNG/helpers/pool.h>
 
 #if !defined(LOG4CXXNG_THREAD_FUNC)
@@ -100,6 +101,16 @@ class LOG4CXXNG_EXPORT Thread
 		 */
 		static bool interrupted();
 
+		/**
+		 *  Binds the current thread to a set of processors. Threads
+		 *  it creates afterwards inherit the binding.
+		 *  @param cpus comma separated processor numbers and ranges,
+		 *  for example "0-7,16-23", an empty list allows all processors.
+		 *  @return false if the list is invalid or binding threads
+		 *  is not supported on this platform.
+		 */
+		static bool setCurrentThreadAffinity(const LogString& cpus);
+
 		bool isAlive();
 		bool isCurrentThread() const;
 		void ending();
@@ -20,6 +20,8 @@
 
 #include <log4cxxNG/ndc.h>
 #include <log4cxxNG/mdc.h>
+#include <string>
+#include <vector>
 
 #if defined(_MSC_VER)
 	#pragma warning ( push )
@@ -28,6 +30,11 @@
 
 namespace log4cxxng
 {
+namespace spi
+{
+class LoggingEvent;
+}
+
 namespace helpers
 {
 /**
@@ -57,12 +64,58 @@ class LOG4CXXNG_EXPORT ThreadSpecificData
 		log4cxxng::NDC::Stack& getStack();
 		log4cxxng::MDC::Map& getMap();
 
+		/**
+		 *  Gets the name of the current thread, computed once per thread.
+		 *  @param dest string to which the name is appended.
+		 */
+		static void getThreadName(LogString& dest);
+
+		/**
+		 *  Takes a recycled logging event from the current thread's cache.
+		 *  @return recycled event or null if the cache is empty.
+		 */
+		static spi::LoggingEvent* takeEvent();
+
+		/**
+		 *  Adds a released logging event to the current thread's cache.
+		 *  @param event event, its state must already have been cleared.
+		 *  @return false if the cache is full and the caller must delete the event.
+		 */
+		static bool cacheEvent(spi::LoggingEvent* event);
+
+		/**
+		 *  Maximum number of logging events cached by one thread.
+		 */
+		enum { MAX_CACHED_EVENTS = 32 };
+
+		/**
+		 *  Swaps the current thread's message formatting buffer into dest.
+		 *  A nested caller receives an empty buffer instead.
+		 *  @param dest empty string.
+		 */
+		static void takeMessageBuffer(std::string& dest);
+
+		/**
+		 *  Returns a message formatting buffer to the current thread.
+		 *  @param src buffer, may be exchanged for an empty string.
+		 */
+		static void cacheMessageBuffer(std::string& src);
+
+		/**
+		 *  Capacity above which a message buffer is not kept.
+		 */
+		enum { MAX_MESSAGE_BUFFER_CAPACITY = 4096 };
+
 
 	private:
 		static ThreadSpecificData& getDataNoThreads();
 		static ThreadSpecificData* createCurrentData();
 		log4cxxng::NDC::Stack ndcStack;
 		log4cxxng::MDC::Map mdcMap;
+		LogString threadName;
+		std::vector<spi::LoggingEvent*> eventCache;
+		std::string messageBuffer;
+		bool messageBufferTaken;
 };
 
 }  // namespace helpers
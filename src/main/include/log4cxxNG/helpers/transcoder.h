@@ -68,6 +68,15 @@ class LOG4CXXNG_EXPORT Transcoder
 		 */
 		static void encodeUTF16BE(unsigned int sv, ByteBuffer& dst);
 
+		/**
+		 *   Counts the leading US-ASCII bytes of a buffer, examining 16 or
+		 *   32 bytes at a time when the processor allows it.
+		 *   @param src bytes to examine.
+		 *   @param len number of bytes available at src.
+		 *   @return number of bytes before the first byte above 0x7F.
+		 */
+		static size_t asciiLength(const char* src, size_t len);
+
 
 		/**
 		 *   Decodes next character from a UTF-8 string.
@@ -31,6 +31,8 @@
 #include <log4cxxNG/helpers/objectimpl.h>
 #include <log4cxxNG/spi/hierarchyeventlistener.h>
 #include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/appendermetrics.h>
+#include <log4cxxNG/file.h>
 #include <mutex>
 
 namespace log4cxxng
@@ -78,9 +80,22 @@ class LOG4CXXNG_EXPORT Hierarchy :
 
 		std::once_flag emittedNoAppenderWarning;
 
+	public:
+		/**
+		Appenders published by a configurator, keyed by appender name.
+		Each entry keeps the signature of the options the appender was
+		built from next to the appender itself.
+		*/
+		typedef std::map<LogString, std::pair<LogString, AppenderPtr> > ConfiguredAppenderMap;
+
+	private:
+		ConfiguredAppenderMap configuredAppenders;
+		unsigned int configurationEpoch;
+
 	public:
 		DECLARE_ABSTRACT_LOG4CXXNG_OBJECT(Hierarchy)
 		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(Hierarchy)
 		LOG4CXXNG_CAST_ENTRY(spi::LoggerRepository)
 		END_LOG4CXXNG_CAST_MAP()
 
@@ -228,6 +243,46 @@ class LOG4CXXNG_EXPORT Hierarchy :
 		virtual bool isConfigured();
 		virtual void setConfigured(bool configured);
 
+		/**
+		Returns the appender published by the previous configuration
+		under <code>name</code> if it was built from the same
+		<code>signature</code>, null otherwise.
+		*/
+		AppenderPtr getConfiguredAppender(const LogString& name,
+			const LogString& signature) const;
+
+		/**
+		Replaces the set of configured appenders with
+		<code>appenders</code> and starts a new configuration epoch.
+		On return <code>appenders</code> holds the previous set.
+		@return the new configuration epoch.
+		*/
+		unsigned int publishConfiguration(ConfiguredAppenderMap& appenders);
+
+		/**
+		Returns the number of configurations published so far.
+		*/
+		unsigned int getConfigurationEpoch() const;
+
+		/**
+		Takes the metrics of every appender attached to a logger of
+		this hierarchy, directly or through an AppenderAttachable such
+		as AsyncAppender, keyed by appender name.  When several
+		appenders share a name, the ones found after the first are
+		keyed as name#2, name#3 and so on.
+		*/
+		void getAppenderMetrics(
+			std::map<LogString, helpers::AppenderMetrics::Snapshot>& metrics) const;
+
+		/**
+		Writes the metrics of every appender to <code>file</code> in the
+		Prometheus text exposition format.  The file is written under a
+		temporary name and renamed, so that a collector never reads a
+		partial file.
+		@return true if the file was written.
+		*/
+		bool writeMetrics(const File& file) const;
+
 
 	private:
 
@@ -273,6 +328,8 @@ class LOG4CXXNG_EXPORT Hierarchy :
 		void updateChildren(ProvisionNode& pn, LoggerPtr logger);
 };
 
+LOG4CXXNG_PTR_DEF(Hierarchy);
+
 }  //namespace log4cxxng
 
 
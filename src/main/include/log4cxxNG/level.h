@@ -199,6 +199,15 @@ class LOG4CXXNG_EXPORT Level : public helpers::ObjectImpl
 		*/
 		LogString toString() const;
 
+		/**
+		Returns the level name with XML and HTML special
+		characters escaped, computed once when the level is created.
+		*/
+		inline const LogString& getEscapedName() const
+		{
+			return escapedName;
+		}
+
 		/**
 		Convert an integer passed as argument to a level. If the
 		conversion fails, then this method returns DEBUG.
@@ -281,6 +290,7 @@ class LOG4CXXNG_EXPORT Level : public helpers::ObjectImpl
 	private:
 		int level;
 		LogString name;
+		LogString escapedName;
 		int syslogEquivalent;
 		Level(const Level&);
 		Level& operator=(const Level&);
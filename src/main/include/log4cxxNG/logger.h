@@ -30,6 +30,8 @@
 #include <log4cxxNG/spi/location/locationinfo.h>
 #include <log4cxxNG/helpers/resourcebundle.h>
 #include <log4cxxNG/helpers/messagebuffer.h>
+#include <log4cxxNG/pattern/nameabbreviator.h>
+#include <log4cxxNG/helpers/ratelimiter.h>
 
 
 namespace log4cxxng
@@ -81,6 +83,12 @@ class LOG4CXXNG_EXPORT Logger :
 		*/
 		LogString name;
 
+		/**
+		The process-wide identifier of the name of this logger.
+		@see internName
+		*/
+		const unsigned int nameId;
+
 		/**
 		The assigned level of this logger.  The
 		<code>level</code> variable need not be assigned a value in
@@ -113,6 +121,20 @@ class LOG4CXXNG_EXPORT Logger :
 		        the user manual for more details. */
 		bool additive;
 
+		/**
+		Names of this logger abbreviated by each cached abbreviation
+		pattern, created on first use.
+		@see getAbbreviatedName
+		*/
+		mutable void* volatile abbreviatedNames[pattern::NameAbbreviator::MAX_CACHE_SLOTS];
+
+		/**
+		Name of this logger with XML and HTML special characters
+		escaped, created on first use.
+		@see getEscapedName
+		*/
+		mutable void* volatile escapedName;
+
 	protected:
 		friend class DefaultLoggerFactory;
 
@@ -635,6 +657,37 @@ class LOG4CXXNG_EXPORT Logger :
 		{
 			return name;
 		}
+
+		/**
+		* Get the identifier of the logger name, as returned by internName.
+		*/
+		unsigned int getNameId() const
+		{
+			return nameId;
+		}
+
+		/**
+		* Returns a small identifier for <code>name</code>, the same for
+		* every call with an equal name, so that tables may be indexed by
+		* logger name. Identifiers are handed out from zero upwards in
+		* order of first use.
+		*/
+		static unsigned int internName(const LogString& name);
+		/**
+		* Get the logger name abbreviated by an abbreviator.
+		* The abbreviation is computed once and kept with the logger
+		* when the abbreviator has a cache slot.
+		* @param abbreviator abbreviator.
+		* @param name buffer to which the abbreviated name is appended.
+		*/
+		void getAbbreviatedName(const pattern::NameAbbreviator& abbreviator,
+			LogString& name) const;
+		/**
+		* Get the logger name with XML and HTML special characters escaped.
+		* The escaped name is computed once and kept with the logger.
+		* @param name buffer to which the escaped name is appended.
+		*/
+		void getEscapedName(LogString& name) const;
 		/**
 		* Get logger name in current encoding.
 		* @param name buffer to which name is appended.
@@ -1445,6 +1498,16 @@ class LOG4CXXNG_EXPORT Logger :
 		*/
 		void removeAllAppenders();
 
+		/**
+		Replace the appenders of this logger with <code>appenders</code>
+		in a single step, so that concurrent logging requests see either
+		the previous or the new list but never an empty one.
+		<p>Unlike #removeAllAppenders the previous appenders are not
+		closed; they are returned so the caller can close the ones that
+		are no longer in use.
+		*/
+		AppenderList replaceAllAppenders(const AppenderList& appenders);
+
 		/**
 		Remove the appender passed as parameter form the list of appenders.
 		*/
@@ -1934,6 +1997,89 @@ Logs a localized message with three parameters.
 		if (logger->isEnabledFor(level)) {\
 			logger->l7dlog(level, key, LOG4CXXNG_LOCATION, p1, p2, p3); }} while (0)
 
+/**
+Logs a message to a specified logger with a specified level, admitting
+at most <code>rate</code> messages per second from this call site.
+
+<p>The decision is taken before the message is formatted.  When
+messages were suppressed, a summary message with their count is
+logged before the next admitted one, at most once per
+helpers::RateLimiter::DEFAULT_SUMMARY_INTERVAL.
+
+@param logger the logger to be used.
+@param level the level to log.
+@param message the message string to log.
+@param rate maximum number of messages per second.
+*/
+#define LOG4CXXNG_LOG_LIMITED(logger, level, message, rate) do { \
+		static ::log4cxxng::helpers::RateLimiter rateLimiter_(rate); \
+		if (logger->isEnabledFor(level) && rateLimiter_.tryAcquire()) {\
+			unsigned int suppressed_ = rateLimiter_.takeSuppressedCount(); \
+			if (suppressed_ > 0) {\
+				logger->forcedLogLS(level, ::log4cxxng::helpers::RateLimiter::formatSummary(suppressed_), LOG4CXXNG_LOCATION); }\
+			::log4cxxng::helpers::MessageBuffer oss_; \
+			logger->forcedLog(level, oss_.str(oss_ << message), LOG4CXXNG_LOCATION); }} while (0)
+
+/**
+Logs one in <code>n</code> of the messages of this call site to a
+specified logger with a specified level.
+
+@param logger the logger to be used.
+@param level the level to log.
+@param message the message string to log.
+@param n sampling interval.
+*/
+#define LOG4CXXNG_LOG_SAMPLED(logger, level, message, n) do { \
+		static ::log4cxxng::helpers::RateLimiter rateLimiter_(0, 0, n); \
+		if (logger->isEnabledFor(level) && rateLimiter_.tryAcquire()) {\
+			::log4cxxng::helpers::MessageBuffer oss_; \
+			logger->forcedLog(level, oss_.str(oss_ << message), LOG4CXXNG_LOCATION); }} while (0)
+
+#if !defined(LOG4CXXNG_THRESHOLD) || LOG4CXXNG_THRESHOLD <= 20000
+/**
+Logs a message to a specified logger with the INFO level, admitting
+at most <code>rate</code> messages per second from this call site.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param rate maximum number of messages per second.
+*/
+#define LOG4CXXNG_INFO_LIMITED(logger, message, rate) \
+	LOG4CXXNG_LOG_LIMITED(logger, ::log4cxxng::Level::getInfo(), message, rate)
+#else
+#define LOG4CXXNG_INFO_LIMITED(logger, message, rate)
+#endif
+
+#if !defined(LOG4CXXNG_THRESHOLD) || LOG4CXXNG_THRESHOLD <= 30000
+/**
+Logs a message to a specified logger with the WARN level, admitting
+at most <code>rate</code> messages per second from this call site.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param rate maximum number of messages per second.
+*/
+#define LOG4CXXNG_WARN_LIMITED(logger, message, rate) \
+	LOG4CXXNG_LOG_LIMITED(logger, ::log4cxxng::Level::getWarn(), message, rate)
+#else
+#define LOG4CXXNG_WARN_LIMITED(logger, message, rate)
+#endif
+
+#if !defined(LOG4CXXNG_THRESHOLD) || LOG4CXXNG_THRESHOLD <= 40000
+/**
+Logs a message to a specified logger with the ERROR level, admitting
+at most <code>rate</code> messages per second from this call site.
+
+@param logger the logger to be used.
+@param message the message string to log.
+@param rate maximum number of messages per second.
+*/
+#define LOG4CXXNG_ERROR_LIMITED(logger, message, rate) \
+	LOG4CXXNG_LOG_LIMITED(logger, ::log4cxxng::Level::getError(), message, rate)
+#else
+#define LOG4CXXNG_ERROR_LIMITED(logger, message, rate)
+#endif
+
 /**@}*/
 
 #if defined(_MSC_VER)
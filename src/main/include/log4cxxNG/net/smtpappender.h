@@ -21,6 +21,9 @@
 
 #include <log4cxxNG/appenderskeleton.h>
 #include <log4cxxNG/helpers/cyclicbuffer.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/condition.h>
 #include <log4cxxNG/spi/triggeringeventevaluator.h>
 
 #if defined(_MSC_VER)
@@ -41,6 +44,9 @@ the value of <b>BufferSize</b> option. The
 <code>BufferSize</code> logging events in its cyclic buffer. This
 keeps memory requirements at a reasonable level while still
 delivering useful application context.
+<p>Buffering an event does not take any lock beyond the appender's
+own. When an event triggers an e-mail, the message is formatted and
+sent by a background thread, so the logging thread only signals it.
 */
 class LOG4CXXNG_EXPORT SMTPAppender : public AppenderSkeleton
 {
@@ -57,6 +63,18 @@ class LOG4CXXNG_EXPORT SMTPAppender : public AppenderSkeleton
 		value <code>false</code> is returned. */
 		bool checkEntryConditions();
 
+		/**
+		Starts the background sender if it is not running.
+		*/
+		void startSender();
+
+		/**
+		Stops the background sender after any requested e-mail is sent.
+		*/
+		void stopSender();
+
+		static void* LOG4CXXNG_THREAD_FUNC sendLoop(apr_thread_t* thread, void* data);
+
 		LogString to;
 		LogString cc;
 		LogString bcc;
@@ -71,6 +89,15 @@ class LOG4CXXNG_EXPORT SMTPAppender : public AppenderSkeleton
 		helpers::CyclicBuffer cb;
 		spi::TriggeringEventEvaluatorPtr evaluator;
 
+		/**
+		Guards sendRequested and stopping.
+		*/
+		helpers::Mutex senderMutex;
+		helpers::Condition sendCondition;
+		bool sendRequested;
+		bool stopping;
+		helpers::Thread sender;
+
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(SMTPAppender)
 		BEGIN_LOG4CXXNG_CAST_MAP()
@@ -28,6 +28,8 @@
 #include <vector>
 #include <log4cxxNG/helpers/thread.h>
 #include <log4cxxNG/helpers/objectoutputstream.h>
+#include <log4cxxNG/helpers/bytearrayoutputstream.h>
+#include <log4cxxNG/helpers/socketfanout.h>
 
 
 namespace log4cxxng
@@ -79,21 +81,15 @@ events will eventually arrive at remote client.
 - If no remote clients are attached, the logging requests are
 simply dropped.
 
-- Logging events are automatically <em>buffered</em> by the
-native TCP implementation. This means that if the link to remote
-client is slow but still faster than the rate of (log) event
-production, the application will not be affected by the slow network
-connection. However, if the network connection is slower then the
-rate of event production, then the local application can only
-progress at the network rate. In particular, if the network link to
-the the remote client is down, the application will be blocked.
-@n @n On the other hand, if the network link is up, but the remote
-client is down, the client will not be blocked when making log
-requests but the log events will be lost due to client
-unavailability.
-@n @n The single remote client case extends to multiple clients
-connections. The rate of logging will be determined by the slowest
-link.
+- Logging events are serialized once and handed to a single I/O
+thread which writes them to every client with non-blocking sockets.
+Each client has its own bounded buffer, set by the
+<b>ClientBufferSize</b> option. A client that falls behind by more than
+that many bytes is a laggard: depending on the <b>LaggardPolicy</b>
+option, events are dropped for that client only and counted (the
+default, "Drop"), or the client is disconnected ("Disconnect").
+The logging application and the other clients are never slowed down by
+a slow or stalled client.
 
 - If the application hosting the <code>SocketHubAppender</code>
 exits before the <code>SocketHubAppender</code> is closed either
@@ -115,8 +111,10 @@ class LOG4CXXNG_EXPORT SocketHubAppender : public AppenderSkeleton
 		static int DEFAULT_PORT;
 
 		int port;
-		ObjectOutputStreamList streams;
 		bool locationInfo;
+		helpers::SocketFanout fanout;
+		helpers::ByteArrayOutputStreamPtr eventBuffer;
+		helpers::ObjectOutputStreamPtr eventStream;
 
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(SocketHubAppender)
@@ -188,6 +186,31 @@ class LOG4CXXNG_EXPORT SocketHubAppender : public AppenderSkeleton
 			return locationInfo;
 		}
 
+		/**
+		The <b>ClientBufferSize</b> option sets the maximum number of
+		bytes queued for a single client before it is considered a laggard. */
+		void setClientBufferSize(int bytes);
+
+		int getClientBufferSize() const;
+
+		/**
+		The <b>LaggardPolicy</b> option is either "Drop", events are
+		dropped for a client whose buffer is full, or "Disconnect", such a
+		client is disconnected. */
+		void setLaggardPolicy(const LogString& policy);
+
+		LogString getLaggardPolicy() const;
+
+		/**
+		Returns the address, pending bytes and dropped events of every
+		connected client. */
+		helpers::SocketFanout::ClientStatisticsList getClientStatistics() const;
+
+		/**
+		Returns the number of events dropped for laggards, including
+		clients that have since disconnected. */
+		unsigned int getDroppedCount() const;
+
 		/**
 		Start the ServerMonitor thread. */
 	private:
@@ -30,7 +30,20 @@ namespace log4cxxng
 {
 namespace net
 {
-/** Use SyslogAppender to send log messages to a remote syslog daemon.*/
+/**
+Use SyslogAppender to send log messages to a remote syslog daemon.
+
+<p>The <b>Format</b> option selects the legacy BSD message format
+(RFC 3164, "&lt;PRI&gt;message", the default) or RFC 5424
+("&lt;PRI&gt;1 TIMESTAMP HOSTNAME APP-NAME PROCID - - message").
+The <b>Protocol</b> option selects UDP (the default) or TCP with
+octet-counted framing over a persistent connection.  A <b>BatchSize</b>
+greater than one hands messages to a background sender which sends
+everything pending at once, see helpers::SyslogWriter.
+
+<p>The priority header of each level is computed once, when the facility
+or the format changes, not for every message.
+*/
 class LOG4CXXNG_EXPORT SyslogAppender : public AppenderSkeleton
 {
 	public:
@@ -136,8 +149,60 @@ class LOG4CXXNG_EXPORT SyslogAppender : public AppenderSkeleton
 			return facilityPrinting;
 		}
 
+		/**
+		The <b>Protocol</b> option is either "UDP" or "TCP".
+		*/
+		void setProtocol(const LogString& protocol);
+
+		/**
+		Returns the value of the <b>Protocol</b> option.
+		*/
+		LogString getProtocol() const;
+
+		/**
+		The <b>Format</b> option is either "BSD" or "RFC5424".
+		*/
+		void setFormat(const LogString& format);
+
+		/**
+		Returns the value of the <b>Format</b> option.
+		*/
+		LogString getFormat() const;
+
+		/**
+		The <b>BatchSize</b> option is the maximum number of messages
+		sent at once by the background sender. The default, 1, sends
+		every message synchronously.
+		*/
+		void setBatchSize(int batchSize);
+
+		/**
+		Returns the value of the <b>BatchSize</b> option.
+		*/
+		inline int getBatchSize() const
+		{
+			return batchSize;
+		}
+
+		/**
+		The <b>AppName</b> option is the APP-NAME field of RFC 5424
+		messages, "-" when not set.
+		*/
+		void setAppName(const LogString& appName);
+
+		/**
+		Returns the value of the <b>AppName</b> option.
+		*/
+		inline const LogString& getAppName() const
+		{
+			return appName;
+		}
+
 	protected:
 		void initSyslogFacilityStr();
+		void initSyslogHeaders();
+		void createWriter();
+		void appendTimestamp(log4cxxng_time_t time, LogString& dest) const;
 
 		int syslogFacility; // Have LOG_USER as default
 		LogString facilityStr;
@@ -145,6 +210,18 @@ class LOG4CXXNG_EXPORT SyslogAppender : public AppenderSkeleton
 		helpers::SyslogWriter* sw;
 		LogString syslogHost;
 		int syslogHostPort;
+		bool localSyslog;
+		helpers::SyslogWriter::Protocol protocol;
+		int batchSize;
+		bool rfc5424;
+		LogString appName;
+		LogString hostName;
+		/** "&lt;PRI&gt;" or "&lt;PRI&gt;1 " for each syslog severity. */
+		LogString headers[8];
+		/** " HOSTNAME APP-NAME PROCID - - " of RFC 5424 messages. */
+		LogString headerFields;
+		LogString buffer;
+		std::string encoded;
 	private:
 		SyslogAppender(const SyslogAppender&);
 		SyslogAppender& operator=(const SyslogAppender&);
@@ -31,6 +31,7 @@
 #include <log4cxxNG/helpers/thread.h>
 #include <vector>
 #include <log4cxxNG/helpers/charsetencoder.h>
+#include <log4cxxNG/helpers/socketfanout.h>
 
 namespace log4cxxng
 {
@@ -66,6 +67,19 @@ servlet.
 <td>optional</td>
 <td>This parameter determines the port to use for announcing log events.  The default port is 23 (telnet).</td>
 <td>5875</td>
+<tr>
+<td>ClientBufferSize</td>
+<td>optional</td>
+<td>Maximum number of bytes queued for a single client.  A slow client
+never blocks logging, once its buffer is full it is a laggard.  The default
+is 262144.</td>
+<td>65536</td>
+<tr>
+<td>LaggardPolicy</td>
+<td>optional</td>
+<td>"Drop" drops messages for a laggard and counts them, "Disconnect"
+closes its connection.  The default is "Drop".</td>
+<td>Disconnect</td>
 </table>
 */
 class LOG4CXXNG_EXPORT TelnetAppender : public AppenderSkeleton
@@ -126,6 +140,33 @@ class LOG4CXXNG_EXPORT TelnetAppender : public AppenderSkeleton
 		}
 
 
+		/**
+		Sets the maximum number of bytes queued for a single client.
+		*/
+		void setClientBufferSize(int bytes);
+
+		int getClientBufferSize() const;
+
+		/**
+		Sets what happens to a client whose buffer is full,
+		"Drop" or "Disconnect".
+		*/
+		void setLaggardPolicy(const LogString& policy);
+
+		LogString getLaggardPolicy() const;
+
+		/**
+		Returns the address, pending bytes and dropped messages of every
+		connected client.
+		*/
+		helpers::SocketFanout::ClientStatisticsList getClientStatistics() const;
+
+		/**
+		Returns the number of messages dropped for laggards, including
+		clients that have since disconnected.
+		*/
+		unsigned int getDroppedCount() const;
+
 		/** shuts down the appender. */
 		void close();
 
@@ -141,14 +182,14 @@ class LOG4CXXNG_EXPORT TelnetAppender : public AppenderSkeleton
 		TelnetAppender(const TelnetAppender&);
 		TelnetAppender& operator=(const TelnetAppender&);
 
-		void write(log4cxxng::helpers::ByteBuffer&);
+		void encodeMessage(const LogString& msg, std::string& dest);
 		void writeStatus(const log4cxxng::helpers::SocketPtr& socket, const LogString& msg, log4cxxng::helpers::Pool& p);
-		ConnectionList connections;
 		LogString encoding;
 		log4cxxng::helpers::CharsetEncoderPtr encoder;
 		helpers::ServerSocket* serverSocket;
 		helpers::Thread sh;
-		size_t activeConnections;
+		helpers::SocketFanout fanout;
+		std::string encoded;
 		static void* LOG4CXXNG_THREAD_FUNC acceptConnections(apr_thread_t* thread, void* data);
 }; // class TelnetAppender
 
@@ -78,6 +78,29 @@ class LOG4CXXNG_EXPORT NameAbbreviator : public log4cxxng::helpers::ObjectImpl
 		 */
 		virtual void abbreviate(LogString::size_type nameStart, LogString& buf) const = 0;
 
+		/**
+		 * Maximum number of distinct abbreviation patterns
+		 * whose results are cached by loggers.
+		 */
+		enum { MAX_CACHE_SLOTS = 8 };
+
+		/**
+		 * Gets the slot in which loggers cache names abbreviated
+		 * by this abbreviator, the same for all abbreviators
+		 * created from the same pattern.
+		 *
+		 * @return slot or -1 if abbreviated names are not cached.
+		 */
+		inline int getCacheSlot() const
+		{
+			return cacheSlot;
+		}
+
+	private:
+		static int getCacheSlot(const LogString& pattern);
+
+		int cacheSlot;
+
 };
 }
 }
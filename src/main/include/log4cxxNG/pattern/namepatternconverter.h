@@ -67,6 +67,15 @@ class LOG4CXXNG_EXPORT NamePatternConverter : public LoggingEventPatternConverte
 		 */
 		void abbreviate(int nameStart, LogString& buf) const;
 
+		/**
+		 * Gets the abbreviator of this converter.
+		 * @return abbreviator.
+		 */
+		const NameAbbreviator& getNameAbbreviator() const
+		{
+			return *abbreviator;
+		}
+
 	private:
 		NameAbbreviatorPtr getAbbreviator(const std::vector<LogString>& options);
 };
@@ -49,6 +49,7 @@ class Properties;
 namespace spi
 {
 class LoggerFactory;
+class Reconfiguration;
 }
 
 class PropertyWatchdog;
@@ -106,6 +107,11 @@ class LOG4CXXNG_EXPORT PropertyConfigurator :
 		*/
 		helpers::ObjectPtrT<spi::LoggerFactory> loggerFactory;
 
+		/**
+		Configuration being staged by the current doConfigure call.
+		*/
+		spi::Reconfiguration* reconfiguration;
+
 	public:
 		DECLARE_LOG4CXXNG_OBJECT(PropertyConfigurator)
 		BEGIN_LOG4CXXNG_CAST_MAP()
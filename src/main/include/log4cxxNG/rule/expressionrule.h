@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_RULE_EXPRESSIONRULE_H
+#define _LOG4CXXNG_RULE_EXPRESSIONRULE_H
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/rule/rule.h>
+#include <vector>
+
+namespace log4cxxng
+{
+namespace rule
+{
+/**
+A rule compiled from a boolean expression over the fields of a
+logging event.
+
+<p>Operands are separated by spaces; parentheses need not be. Values
+containing spaces are enclosed in single quotes. Fields are named
+case-insensitively:
+
+<ul>
+<li><b>LEVEL</b> - the level, compared with <code>== != &lt; &lt;= &gt; &gt;=</code>
+against a level name.
+<li><b>LOGGER</b>, <b>MSG</b> (or MESSAGE), <b>THREAD</b> - compared with
+<code>==</code> and <code>!=</code>, or with <code>~=</code> which is true
+if the field contains the value, ignoring ASCII case.
+<li><b>MDC.</b><i>key</i> - an entry of the mapped diagnostic context.
+<li><b>PROP.</b><i>key</i> - an event property, or failing that an MDC entry.
+</ul>
+
+<p>Any field may also be tested with the postfix <code>EXISTS</code>
+operator, true if the field is present and not empty. Predicates are
+combined with <code>!</code>, <code>&amp;&amp;</code> and
+<code>||</code>, in decreasing order of precedence:
+
+<pre>
+( LEVEL &gt;= WARN || LOGGER == org.example.audit ) &amp;&amp; ! MSG ~= 'heartbeat'
+</pre>
+
+<p>The expression is compiled into a flat instruction list that keeps
+a single boolean register and uses jumps for <code>&amp;&amp;</code> and
+<code>||</code>, so that evaluation short-circuits, needs no stack and
+never allocates or copies a string.
+*/
+class LOG4CXXNG_EXPORT ExpressionRule : public Rule
+{
+	public:
+		DECLARE_LOG4CXXNG_OBJECT(ExpressionRule)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(ExpressionRule)
+		LOG4CXXNG_CAST_ENTRY_CHAIN(Rule)
+		END_LOG4CXXNG_CAST_MAP()
+
+		/**
+		A rule that matches every event.
+		*/
+		ExpressionRule();
+
+		/**
+		Compiles <code>expression</code>, written in infix notation
+		unless <code>isPostFix</code> is true.
+		@throws IllegalArgumentException if the expression is malformed.
+		*/
+		static RulePtr getRule(const LogString& expression, bool isPostFix = false);
+
+		bool evaluate(const spi::LoggingEventPtr& event) const;
+
+	private:
+		struct Instruction
+		{
+			unsigned char opcode;
+			unsigned char field;
+			/** Jump target, level value or index of the value in constants. */
+			int operand;
+			/** Index of the MDC or property key in constants. */
+			int key;
+		};
+
+		std::vector<Instruction> code;
+		std::vector<LogString> constants;
+
+		friend class ExpressionCompiler;
+
+		ExpressionRule(const ExpressionRule&);
+		ExpressionRule& operator=(const ExpressionRule&);
+};
+LOG4CXXNG_PTR_DEF(ExpressionRule);
+}
+}
+
+#if defined(_MSC_VER)
+	#pragma warning ( pop )
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_RULE_RULE_H
+#define _LOG4CXXNG_RULE_RULE_H
+
+#include <log4cxxNG/helpers/objectimpl.h>
+#include <log4cxxNG/spi/loggingevent.h>
+
+namespace log4cxxng
+{
+namespace rule
+{
+/**
+A predicate over logging events, used by filters such as
+filter::ExpressionFilter to decide whether an event matches.
+*/
+class LOG4CXXNG_EXPORT Rule : public virtual helpers::ObjectImpl
+{
+	public:
+		DECLARE_ABSTRACT_LOG4CXXNG_OBJECT(Rule)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(Rule)
+		END_LOG4CXXNG_CAST_MAP()
+
+		/**
+		Returns true if <code>event</code> satisfies the rule.
+		*/
+		virtual bool evaluate(const spi::LoggingEventPtr& event) const = 0;
+};
+LOG4CXXNG_PTR_DEF(Rule);
+}
+}
+
+#endif
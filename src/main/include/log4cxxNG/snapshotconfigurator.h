@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_SNAPSHOT_CONFIGURATOR_H
+#define _LOG4CXXNG_SNAPSHOT_CONFIGURATOR_H
+
+#if defined(_MSC_VER)
+	#pragma warning (push)
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+
+#include <log4cxxNG/helpers/objectptr.h>
+#include <log4cxxNG/helpers/objectimpl.h>
+#include <log4cxxNG/logstring.h>
+#include <log4cxxNG/spi/configurator.h>
+#include <log4cxxNG/file.h>
+
+namespace log4cxxng
+{
+namespace helpers
+{
+class Properties;
+}
+
+/**
+Configures log4cxx from a configuration snapshot, a precompiled form
+of a properties or XML configuration.
+
+<p>A snapshot holds the appender graph of a configuration as it was
+checked when the snapshot was written: every class is stored under
+the key it is registered with, every appender named by a logger or by
+another appender is defined, and each appender, layout, filter and
+policy lists its options with their names. Loading maps the file once,
+looks each class up with a single registry probe and builds the
+appenders directly through OptionHandler::setOption, without parsing
+text or XML, without Class::forName and without PropertySetter.
+
+<p>Option values are stored as written and their variables are
+substituted when the snapshot is loaded, so <code>${...}</code>
+references resolve against the environment of the loading process.
+Class names, logger names, levels and appender references are resolved
+when the snapshot is written; the system properties they depended on
+are recorded and a snapshot loaded where any of them differs is stale.
+Error handlers cannot be stored in a snapshot.
+
+<p>Snapshots are produced with #write, typically at build or install
+time. A snapshot written from a configuration file remembers it: when
+the snapshot is stale, older than that file or unreadable by this
+version of the library, the file is loaded instead. A configuration
+file name ending with <code>.snapshot</code> is always read as one.
+Without a configuration file name, DefaultConfigurator uses
+<code>log4cxx.snapshot</code> only when it was modified after the
+default configuration file it would otherwise load.
+*/
+class LOG4CXXNG_EXPORT SnapshotConfigurator :
+	virtual public spi::Configurator,
+	virtual public helpers::ObjectImpl
+{
+	public:
+		DECLARE_LOG4CXXNG_OBJECT(SnapshotConfigurator)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(spi::Configurator)
+		END_LOG4CXXNG_CAST_MAP()
+
+		SnapshotConfigurator();
+		void addRef() const;
+		void releaseRef() const;
+
+		/**
+		Configure <code>repository</code> from the snapshot in
+		<code>snapshotFile</code>.
+		@param snapshotFile snapshot written by #write.
+		@param repository The hierarchy to operation upon.
+		*/
+		void doConfigure(const File& snapshotFile,
+			spi::LoggerRepositoryPtr& repository);
+
+		/**
+		Read configuration from the snapshot in <code>snapshotFile</code>.
+		*/
+		static void configure(const File& snapshotFile);
+
+		/**
+		Check <code>properties</code> and write them to
+		<code>snapshotFile</code>.
+		@param properties configuration in PropertyConfigurator format.
+		@param snapshotFile destination, replaced if it exists.
+		@return true if the configuration was valid and written.
+		*/
+		static bool write(helpers::Properties& properties,
+			const File& snapshotFile);
+
+		/**
+		Check the configuration in <code>configFile</code>, read as XML
+		when its name ends with <code>.xml</code> and as properties
+		otherwise, and write it to <code>snapshotFile</code>.
+		@param configFile configuration file, loaded in place of a
+		stale snapshot.
+		@param snapshotFile destination, replaced if it exists.
+		@return true if the configuration was valid and written.
+		*/
+		static bool write(const File& configFile, const File& snapshotFile);
+
+	private:
+		SnapshotConfigurator(const SnapshotConfigurator&);
+		SnapshotConfigurator& operator=(const SnapshotConfigurator&);
+}; // class SnapshotConfigurator
+
+LOG4CXXNG_PTR_DEF(SnapshotConfigurator);
+}  // namespace log4cxxng
+
+#if defined(_MSC_VER)
+	#pragma warning (pop)
+#endif
+
+
+#endif //_LOG4CXXNG_SNAPSHOT_CONFIGURATOR_H
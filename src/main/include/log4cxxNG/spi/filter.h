@@ -88,6 +88,12 @@ class LOG4CXXNG_EXPORT Filter : public virtual OptionHandler,
 		log4cxxng::spi::FilterPtr getNext() const;
 		void setNext(const log4cxxng::spi::FilterPtr& newNext);
 
+		/**
+		Returns a number that changes whenever a filter chain is relinked
+		or an option of a filter that FilterTable compiles is changed.
+		*/
+		static unsigned int getRevision();
+
 		enum FilterDecision
 		{
 			/**
@@ -126,6 +132,13 @@ class LOG4CXXNG_EXPORT Filter : public virtual OptionHandler,
 		@param event The LoggingEvent to decide upon.
 		@return The decision of the filter.  */
 		virtual FilterDecision decide(const LoggingEventPtr& event) const = 0;
+
+	protected:
+		/**
+		Invalidates compiled filter tables. Filters recognized by
+		FilterTable call this whenever an option changes.
+		*/
+		static void changed();
 };
 }
 }
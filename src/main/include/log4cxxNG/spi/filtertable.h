@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_SPI_FILTER_TABLE_H
+#define _LOG4CXXNG_SPI_FILTER_TABLE_H
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/spi/filter.h>
+#include <vector>
+
+namespace log4cxxng
+{
+namespace spi
+{
+/**
+A filter chain precomputed into a table of decisions indexed by the
+level of an event and the identifier of its logger name.
+
+<p>Chains made only of LevelMatchFilter, LevelRangeFilter,
+LoggerMatchFilter and DenyAllFilter decide on nothing but the level
+and the logger name, so #compile runs the chain once for each standard
+level and each logger name it mentions and keeps one bit per answer.
+An event of another logger then costs one array lookup.
+
+<p>Chains holding any other filter, events of non-standard levels and
+events not obtained through a logger are left to the chain itself.
+A table stops being current when any chain is relinked or any
+recognized filter changes an option, see Filter#getRevision.
+*/
+class LOG4CXXNG_EXPORT FilterTable
+{
+	public:
+		enum Decision
+		{
+			/** The table has no answer, consult the filter chain. */
+			CONSULT_CHAIN,
+			/** The chain would let the event through. */
+			APPEND,
+			/** The chain would drop the event. */
+			DROP
+		};
+
+		FilterTable();
+
+		/**
+		Rebuilds the table from the chain starting at <code>head</code>.
+		*/
+		void compile(const FilterPtr& head);
+
+		/**
+		Returns true if no filter changed since the last #compile.
+		*/
+		bool isCurrent() const;
+
+		/**
+		Looks up the decision of the compiled chain for <code>event</code>.
+		*/
+		Decision decide(const LoggingEventPtr& event) const;
+
+	private:
+		bool compiled;
+		bool recognized;
+		unsigned int revision;
+
+		/**
+		One bit per standard level, set if the event is appended,
+		for each logger name id up to the largest one mentioned.
+		*/
+		std::vector<unsigned char> byNameId;
+
+		/** Bits for every other logger name. */
+		unsigned char otherNames;
+
+		static int levelIndex(int level);
+};
+}
+}
+
+#if defined(_MSC_VER)
+	#pragma warning ( pop )
+#endif
+
+#endif //_LOG4CXXNG_SPI_FILTER_TABLE_H
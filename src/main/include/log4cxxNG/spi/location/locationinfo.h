@@ -19,6 +19,7 @@
 #define _LOG4CXXNG_SPI_LOCATION_LOCATIONINFO_H
 
 #include <log4cxxNG/log4cxxNG.h>
+#include <log4cxxNG/logstring.h>
 #include <string>
 #include <log4cxxNG/helpers/objectoutputstream.h>
 
@@ -26,6 +27,8 @@ namespace log4cxxng
 {
 namespace spi
 {
+class LocationNames;
+
 /**
  * This class represents the location of a logging statement.
  *
@@ -56,6 +59,21 @@ class LOG4CXXNG_EXPORT LocationInfo
 			const char* const functionName,
 			int lineNumber);
 
+		/**
+		 *   Constructor.
+		 *   @param fileName file name of the caller.
+		 *   @param functionName signature of the calling function.
+		 *   @param lineNumber line number of the caller.
+		 *   @param names class and method names already parsed from
+		 *       functionName, may be null.
+		 *   @remarks Used by LOG4CXXNG_LOCATION so that the names of
+		 *       a call site are parsed only once.
+		 */
+		LocationInfo( const char* const fileName,
+			const char* const functionName,
+			int lineNumber,
+			const LocationNames* names);
+
 		/**
 		 *   Default constructor.
 		 */
@@ -82,6 +100,12 @@ class LOG4CXXNG_EXPORT LocationInfo
 		/** Return the class name of the call site. */
 		const std::string getClassName() const;
 
+		/**
+		 *   Appends the class name of the call site.
+		 *   @param dest buffer to which the class name is appended.
+		 */
+		void getClassName(LogString& dest) const;
+
 		/**
 		 *   Return the file name of the caller.
 		 *   @returns file name, may be null.
@@ -97,6 +121,12 @@ class LOG4CXXNG_EXPORT LocationInfo
 		/** Returns the method name of the caller. */
 		const std::string getMethodName() const;
 
+		/**
+		 *   Appends the method name of the caller.
+		 *   @param dest buffer to which the method name is appended.
+		 */
+		void getMethodName(LogString& dest) const;
+
 		void write(log4cxxng::helpers::ObjectOutputStream& os, log4cxxng::helpers::Pool& p) const;
 
 
@@ -110,7 +140,50 @@ class LOG4CXXNG_EXPORT LocationInfo
 		/** Caller's method name. */
 		const char* methodName;
 
+		/** Names parsed from methodName, null if not yet parsed. */
+		const LocationNames* names;
+
+
+};
+
+/**
+ * Class and method names of a call site, parsed once from the signature
+ * of the calling function.  LOG4CXXNG_LOCATION keeps one instance per
+ * call site for the lifetime of the process and every LocationInfo
+ * created there refers to it.
+ */
+class LOG4CXXNG_EXPORT LocationNames
+{
+	public:
+		/**
+		 *   Parses the names from a function signature.
+		 *   @param functionName signature of the function.
+		 */
+		explicit LocationNames(const char* const functionName);
+
+		/**
+		 *   Returns a new instance for a call site.  The instance is
+		 *   never deleted so that it outlives any event referring to it.
+		 *   @param functionName signature of the function.
+		 */
+		static const LocationNames* create(const char* const functionName);
 
+		const LogString& getClassName() const
+		{
+			return className;
+		}
+
+		const LogString& getMethodName() const
+		{
+			return methodName;
+		}
+
+	private:
+		LocationNames(const LocationNames&);
+		LocationNames& operator=(const LocationNames&);
+
+		const LogString className;
+		const LogString methodName;
 };
 }
 }
@@ -132,9 +205,25 @@ class LOG4CXXNG_EXPORT LocationInfo
 #if !defined(__LOG4CXXNG_FUNC__)
 	#define __LOG4CXXNG_FUNC__ ""
 #endif
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1800)
+//
+//   The lambda gives every call site its own static, which holds the
+//   names parsed the first time the site is reached.  The signature is
+//   passed in as an argument since inside the lambda body it would name
+//   the lambda itself.
+//
+#define LOG4CXXNG_LOCATION ::log4cxxng::spi::LocationInfo(__FILE__,         \
+	__LOG4CXXNG_FUNC__, \
+	__LINE__, \
+	[](const char* const functionName_) -> const ::log4cxxng::spi::LocationNames* { \
+		static const ::log4cxxng::spi::LocationNames* const names_ = \
+			::log4cxxng::spi::LocationNames::create(functionName_); \
+		return names_; }(__LOG4CXXNG_FUNC__))
+#else
 #define LOG4CXXNG_LOCATION ::log4cxxng::spi::LocationInfo(__FILE__,         \
 	__LOG4CXXNG_FUNC__, \
 	__LINE__)
 #endif
+#endif
 
 #endif //_LOG4CXXNG_SPI_LOCATION_LOCATIONINFO_H
@@ -85,6 +85,31 @@ class LOG4CXXNG_EXPORT LoggingEvent :
 
 		~LoggingEvent();
 
+		/**
+		Obtain a LoggingEvent for a request made through a logger.
+
+		<p>The event is taken from the calling thread's cache of
+		released events when one is available, so that creating an
+		event allocates no memory in steady state: the event refers to
+		the name of the logger, which it keeps alive, instead of copying
+		it, and the message and thread name buffers retain their capacity
+		from one use to the next.
+		<p>
+		@param logger The logger of this event.
+		@param level The level of this event.
+		@param message  The message of this event.
+		@param location location of logging request.
+		*/
+		static LoggingEventPtr create(const Logger& logger,
+			const LevelPtr& level,   const LogString& message,
+			const log4cxxng::spi::LocationInfo& location);
+
+		/**
+		Returns an event obtained by create() to the thread's cache
+		instead of deleting it when the last reference is released.
+		*/
+		void releaseRef() const;
+
 		/** Return the level of this event. */
 		inline const LevelPtr& getLevel() const
 		{
@@ -94,7 +119,16 @@ class LOG4CXXNG_EXPORT LoggingEvent :
 		/**  Return the name of the logger. */
 		inline const LogString& getLoggerName() const
 		{
-			return logger;
+			return *loggerName;
+		}
+
+		/**
+		Return the logger of this event, null if the event was
+		not obtained through create(), for example when deserialized.
+		*/
+		inline const LoggerPtr& getLogger() const
+		{
+			return loggerRef;
 		}
 
 		/** Return the message for this logging event. */
@@ -168,6 +202,15 @@ class LOG4CXXNG_EXPORT LoggingEvent :
 		*/
 		bool getMDC(const LogString& key, LogString& dest) const;
 
+		/**
+		* Looks up <code>key</code> as getMDC does without copying the
+		* value.
+		* @param key key.
+		* @return the value, or null if the key has no value. It remains
+		* valid until the MDC of the event or of the current thread changes.
+		*/
+		const LogString* findMDC(const LogString& key) const;
+
 		/**
 		* Returns the set of of the key values in the MDC for the event.
 		* The returned set is unmodifiable by the caller.
@@ -190,6 +233,13 @@ class LOG4CXXNG_EXPORT LoggingEvent :
 		* @return true if key had a corresponding value.
 		*/
 		bool getProperty(const LogString& key, LogString& dest) const;
+
+		/**
+		* Looks up a previously set property without copying it.
+		* @param key key.
+		* @return the value, or null if the property is not set.
+		*/
+		const LogString* findProperty(const LogString& key) const;
 		/**
 		* Returns the set of of the key values in the properties
 		* for the event. The returned set is unmodifiable by the caller.
@@ -204,10 +254,27 @@ class LOG4CXXNG_EXPORT LoggingEvent :
 		void setProperty(const LogString& key, const LogString& value);
 
 	private:
+		friend class log4cxxng::Logger;
+
+		/**
+		* The logger of the logging event, only set by create().
+		**/
+		LoggerPtr loggerRef;
+
+		/**
+		* The name of the logger of the logging event, either
+		* the name of loggerRef or ownedLoggerName.
+		**/
+		const LogString* loggerName;
+
 		/**
-		* The logger of the logging event.
+		* Copy of the logger name when the event was not obtained
+		* through create().
 		**/
-		LogString logger;
+		LogString ownedLoggerName;
+
+		/** true if the event is returned to the thread's cache on release. */
+		bool pooled;
 
 		/** level of logging event. */
 		LevelPtr level;
@@ -246,20 +313,33 @@ class LOG4CXXNG_EXPORT LoggingEvent :
 		log4cxxng_time_t timeStamp;
 
 		/** The is the location where this log statement was written. */
-		const log4cxxng::spi::LocationInfo locationInfo;
+		log4cxxng::spi::LocationInfo locationInfo;
 
 
 		/** The identifier of thread in which this logging event
 		was generated.
 		*/
-		const LogString threadName;
+		LogString threadName;
 
 		//
 		//   prevent copy and assignment
 		//
 		LoggingEvent(const LoggingEvent&);
 		LoggingEvent& operator=(const LoggingEvent&);
-		static const LogString getCurrentThreadName();
+
+		/**
+		Takes an event from the thread's cache or allocates a new one
+		and sets everything but the message.
+		*/
+		static LoggingEvent* obtain(const Logger& logger,
+			const LevelPtr& level,
+			const log4cxxng::spi::LocationInfo& location);
+
+		/**
+		Clears the state of a released event and caches it.
+		@return false if the event could not be cached.
+		*/
+		bool recycle();
 
 		static void writeProlog(log4cxxng::helpers::ObjectOutputStream& os, log4cxxng::helpers::Pool& p);
 
@@ -0,0 +1,133 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LOG4CXXNG_SPI_RECONFIGURATION_H
+#define _LOG4CXXNG_SPI_RECONFIGURATION_H
+
+#if defined(_MSC_VER)
+	#pragma warning ( push )
+	#pragma warning ( disable: 4231 4251 4275 4786 )
+#endif
+
+#include <log4cxxNG/hierarchy.h>
+#include <log4cxxNG/logger.h>
+#include <vector>
+#include <map>
+
+namespace log4cxxng
+{
+namespace spi
+{
+/**
+Stages a new configuration for a logger repository and publishes it
+in one step.
+
+<p>Configurators record levels, additivity flags and appender lists
+here instead of applying them to live loggers. Appenders whose class
+and options did not change since the previous configuration are
+reused as they are, so their files and sockets stay open. On
+#commit every staged logger swaps its appender list under its own
+lock, the repository moves to a new configuration epoch and only the
+appenders that are no longer attached anywhere are closed.
+
+<p>If the instance is destroyed without being committed, the live
+configuration is left untouched and the appenders created for the
+staged one are closed.
+*/
+class LOG4CXXNG_EXPORT Reconfiguration
+{
+	public:
+		Reconfiguration(const LoggerRepositoryPtr& repository);
+		~Reconfiguration();
+
+		/**
+		Returns the appender published by the previous configuration
+		under <code>name</code> if it was built from the same
+		<code>signature</code>, null otherwise. An empty signature
+		never matches.
+		*/
+		AppenderPtr reuseAppender(const LogString& name, const LogString& signature);
+
+		/**
+		Records an appender created for the staged configuration.
+		*/
+		void addAppender(const AppenderPtr& appender, const LogString& signature);
+
+		/**
+		Stages the level of <code>logger</code>, null meaning inherited.
+		*/
+		void setLevel(const LoggerPtr& logger, const LevelPtr& level);
+
+		/**
+		Stages the additivity flag of <code>logger</code>.
+		*/
+		void setAdditivity(const LoggerPtr& logger, bool additivity);
+
+		/**
+		Stages an empty appender list for <code>logger</code>.
+		*/
+		void removeAllAppenders(const LoggerPtr& logger);
+
+		/**
+		Appends <code>appender</code> to the staged appender list of
+		<code>logger</code>.
+		*/
+		void addLoggerAppender(const LoggerPtr& logger, const AppenderPtr& appender);
+
+		/**
+		Publishes the staged configuration.
+		@return the new configuration epoch, 0 if the repository
+		does not keep one.
+		*/
+		unsigned int commit();
+
+	private:
+		struct LoggerChange
+		{
+			LoggerChange(const LoggerPtr& logger);
+
+			LoggerPtr logger;
+			bool hasLevel;
+			LevelPtr level;
+			bool hasAdditivity;
+			bool additivity;
+			bool hasAppenders;
+			AppenderList appenders;
+		};
+
+		LoggerChange& getChange(const LoggerPtr& logger);
+		bool isAttachedAnywhere(const AppenderPtr& appender) const;
+
+		LoggerRepositoryPtr repository;
+		HierarchyPtr hierarchy;
+		std::vector<LoggerChange> changes;
+		std::map<LogString, size_t> changeIndex;
+		Hierarchy::ConfiguredAppenderMap appenders;
+		AppenderList created;
+		bool committed;
+
+		Reconfiguration(const Reconfiguration&);
+		Reconfiguration& operator=(const Reconfiguration&);
+};
+}
+}
+
+#if defined(_MSC_VER)
+	#pragma warning ( pop )
+#endif
+
+#endif //_LOG4CXXNG_SPI_RECONFIGURATION_H
@@ -25,6 +25,10 @@
 
 #include <log4cxxNG/appenderskeleton.h>
 #include <log4cxxNG/helpers/outputstreamwriter.h>
+#include <log4cxxNG/helpers/flushpolicy.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <log4cxxNG/helpers/mutex.h>
+#include <log4cxxNG/helpers/condition.h>
 
 namespace log4cxxng
 {
@@ -67,6 +71,26 @@ class LOG4CXXNG_EXPORT WriterAppender : public AppenderSkeleton
 		*/
 		log4cxxng::helpers::WriterPtr writer;
 
+		/**
+		*  Buffer into which events are formatted, reused from one
+		*  event to the next while the appender is locked.
+		*/
+		LogString buffer;
+
+		/**
+		*  Flushes by size, count, level and age when any of its
+		*  options is set, replacing <code>immediateFlush</code>.
+		*/
+		helpers::FlushPolicy flushPolicy;
+
+		/**
+		*  Flushes output left pending for the flush interval.
+		*/
+		helpers::Mutex timerMutex;
+		helpers::Condition timerCondition;
+		bool timerStopping;
+		helpers::Thread flushTimer;
+
 
 	public:
 		DECLARE_ABSTRACT_LOG4CXXNG_OBJECT(WriterAppender)
@@ -115,6 +139,17 @@ class LOG4CXXNG_EXPORT WriterAppender : public AppenderSkeleton
 			return immediateFlush;
 		}
 
+		/**
+		Returns the policy deciding when the writer is flushed.  The
+		<b>FlushBytes</b>, <b>FlushEvents</b>, <b>FlushInterval</b> and
+		<b>FlushLevel</b> options are passed to it, see
+		helpers::FlushPolicy.
+		*/
+		helpers::FlushPolicy& getFlushPolicy()
+		{
+			return flushPolicy;
+		}
+
 		/**
 		This method is called by the AppenderSkeleton#doAppend
 		method.
@@ -210,6 +245,10 @@ class LOG4CXXNG_EXPORT WriterAppender : public AppenderSkeleton
 		virtual void writeHeader(log4cxxng::helpers::Pool& p);
 
 	private:
+		void startFlushTimer();
+		void stopFlushTimer();
+		static void* LOG4CXXNG_THREAD_FUNC flushTimerLoop(apr_thread_t* thread, void* data);
+
 		//
 		//  prevent copy and assignment
 		WriterAppender(const WriterAppender&);
@@ -46,6 +46,10 @@ extern "C" {
 
 namespace log4cxxng
 {
+namespace spi
+{
+class Reconfiguration;
+}
 
 namespace xml
 {
@@ -295,11 +299,26 @@ class LOG4CXXNG_EXPORT DOMConfigurator :
 
 		LogString subst(const LogString& value);
 
+		/**
+		Appends a description of <code>element</code> and its children,
+		with variables substituted, to <code>signature</code>.
+		@return false if the element refers to other appenders.
+		*/
+		bool appendSignature(
+			log4cxxng::helpers::CharsetDecoderPtr& utf8Decoder,
+			apr_xml_elem* element,
+			LogString& signature);
+
 	protected:
 		helpers::Properties props;
 		spi::LoggerRepositoryPtr repository;
 		spi::LoggerFactoryPtr loggerFactory;
 
+		/**
+		Configuration being staged by the current doConfigure call.
+		*/
+		spi::Reconfiguration* reconfiguration;
+
 	private:
 		//   prevent assignment or copy statements
 		DOMConfigurator(const DOMConfigurator&);
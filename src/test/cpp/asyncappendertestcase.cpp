@@ -31,6 +31,7 @@
 #include <log4cxxNG/spi/location/locationinfo.h>
 #include <log4cxxNG/xml/domconfigurator.h>
 #include <log4cxxNG/file.h>
+#include <log4cxxNG/helpers/loglog.h>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
@@ -128,6 +129,10 @@ class AsyncAppenderTestCase : public AppenderSkeletonTestCase
 		//LOGUNIT_TEST(testBadAppender);
 		LOGUNIT_TEST(testLocationInfoTrue);
 		LOGUNIT_TEST(testConfiguration);
+		LOGUNIT_TEST(testLanesOption);
+		LOGUNIT_TEST(testPriorityLanes);
+		LOGUNIT_TEST(testDispatchPerAppender);
+		LOGUNIT_TEST(testDispatchPerAppenderFailure);
 		LOGUNIT_TEST_SUITE_END();
 
 
@@ -307,6 +312,133 @@ class AsyncAppenderTestCase : public AppenderSkeletonTestCase
 			// LOGUNIT_ASSERT_EQUAL(true, vectorAppender->isClosed());
 		}
 
+		void testLanesOption()
+		{
+			AsyncAppenderPtr async = new AsyncAppender();
+			LOGUNIT_ASSERT_EQUAL(1, async->getLaneCount());
+			async->setOption(LOG4CXXNG_STR("Lanes"), LOG4CXXNG_STR("ERROR=4, WARN=8, BOGUS"));
+			LOGUNIT_ASSERT_EQUAL(3, async->getLaneCount());
+			async->addLane(Level::getError(), 16);
+			LOGUNIT_ASSERT_EQUAL(3, async->getLaneCount());
+			async->close();
+		}
+
+		/**
+		 * Tests that errors are dispatched first and displace debug events.
+		 */
+		void testPriorityLanes()
+		{
+			BlockableVectorAppenderPtr blockableAppender = new BlockableVectorAppender();
+			AsyncAppenderPtr async = new AsyncAppender();
+			async->addAppender(blockableAppender);
+			async->setBufferSize(5);
+			async->addLane(Level::getError(), 3);
+			async->setBlocking(false);
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr rootLogger = Logger::getRootLogger();
+			rootLogger->addAppender(async);
+			{
+				synchronized sync(blockableAppender->getBlocker());
+				LOG4CXXNG_DEBUG(rootLogger, "first");
+				Thread::sleep(50);
+
+				for (int i = 0; i < 10; i++)
+				{
+					LOG4CXXNG_DEBUG(rootLogger, "debug");
+				}
+
+				for (int i = 0; i < 5; i++)
+				{
+					LOG4CXXNG_ERROR(rootLogger, "error");
+				}
+			}
+			async->close();
+			const std::vector<spi::LoggingEventPtr>& events = blockableAppender->getVector();
+			LOGUNIT_ASSERT(events.size() > 6);
+			LOGUNIT_ASSERT(events[0]->getMessage() == LOG4CXXNG_STR("first"));
+
+			for (size_t i = 1; i <= 5; i++)
+			{
+				LOGUNIT_ASSERT_EQUAL(Level::getError(), events[i]->getLevel());
+			}
+
+			LOGUNIT_ASSERT_EQUAL(Level::getDebug(), events[6]->getLevel());
+			LoggingEventPtr discardEvent = events[events.size() - 1];
+			LOGUNIT_ASSERT(discardEvent->getMessage().substr(0, 10) == LOG4CXXNG_STR("Discarded "));
+		}
+		/**
+		 * Tests that a blocked appender does not hold back another one.
+		 */
+		void testDispatchPerAppender()
+		{
+			BlockableVectorAppenderPtr blockableAppender = new BlockableVectorAppender();
+			VectorAppenderPtr vectorAppender = new VectorAppender();
+			AsyncAppenderPtr async = new AsyncAppender();
+			async->addAppender(blockableAppender);
+			async->addAppender(vectorAppender);
+			async->setOption(LOG4CXXNG_STR("DispatchPerAppender"), LOG4CXXNG_STR("true"));
+			LOGUNIT_ASSERT_EQUAL(true, async->getDispatchPerAppender());
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr root = Logger::getRootLogger();
+			root->addAppender(async);
+			size_t LEN = 20;
+			{
+				synchronized sync(blockableAppender->getBlocker());
+
+				for (size_t i = 0; i < LEN; i++)
+				{
+					LOG4CXXNG_DEBUG(root, "message" << i);
+				}
+
+				for (int i = 0; i < 100 && vectorAppender->getVector().size() < LEN; i++)
+				{
+					Thread::sleep(10);
+				}
+
+				LOGUNIT_ASSERT_EQUAL(LEN, vectorAppender->getVector().size());
+			}
+			async->close();
+
+			const std::vector<spi::LoggingEventPtr>& v = blockableAppender->getVector();
+			LOGUNIT_ASSERT_EQUAL(LEN, v.size());
+			LOGUNIT_ASSERT(v[0]->getMessage() == LOG4CXXNG_STR("message0"));
+			LOGUNIT_ASSERT(v[LEN - 1]->getMessage() == LOG4CXXNG_STR("message19"));
+			LOGUNIT_ASSERT(vectorAppender->isClosed());
+		}
+
+		/**
+		 * Tests that an appender throwing on every event neither stops
+		 * its worker nor stalls a blocking dispatcher.
+		 */
+		void testDispatchPerAppenderFailure()
+		{
+			AppenderPtr nullPointerAppender = new NullPointerAppender();
+			VectorAppenderPtr vectorAppender = new VectorAppender();
+			AsyncAppenderPtr async = new AsyncAppender();
+			async->addAppender(nullPointerAppender);
+			async->addAppender(vectorAppender);
+			async->setDispatchPerAppender(true);
+			async->setBufferSize(2);
+			Pool p;
+			async->activateOptions(p);
+			LoggerPtr logger = Logger::getLogger("AsyncAppenderTestCase.failure");
+			logger->setAdditivity(false);
+			logger->addAppender(async);
+			size_t LEN = 20;
+			LogLog::setQuietMode(true);
+
+			for (size_t i = 0; i < LEN; i++)
+			{
+				LOG4CXXNG_DEBUG(logger, "message" << i);
+			}
+
+			async->close();
+			LogLog::setQuietMode(false);
+			logger->removeAppender(async);
+			LOGUNIT_ASSERT_EQUAL(LEN, vectorAppender->getVector().size());
+		}
 
 };
 
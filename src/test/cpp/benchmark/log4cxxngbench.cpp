@@ -0,0 +1,1106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/level.h>
+#include <log4cxxNG/appenderskeleton.h>
+#include <log4cxxNG/propertyconfigurator.h>
+#include <log4cxxNG/snapshotconfigurator.h>
+#include <log4cxxNG/xml/domconfigurator.h>
+#include <log4cxxNG/patternlayout.h>
+#include <log4cxxNG/jsonlayout.h>
+#include <log4cxxNG/htmllayout.h>
+#include <log4cxxNG/xml/xmllayout.h>
+#include <log4cxxNG/fileappender.h>
+#include <log4cxxNG/asyncappender.h>
+#include <log4cxxNG/flightrecorderappender.h>
+#include <log4cxxNG/net/smtpappender.h>
+#include <log4cxxNG/rolling/rollingfileappender.h>
+#include <log4cxxNG/rolling/fixedwindowrollingpolicy.h>
+#include <log4cxxNG/rolling/sizebasedtriggeringpolicy.h>
+#include <log4cxxNG/filter/andfilter.h>
+#include <log4cxxNG/filter/expressionfilter.h>
+#include <log4cxxNG/filter/levelrangefilter.h>
+#include <log4cxxNG/filter/loggermatchfilter.h>
+#include <log4cxxNG/filter/stringmatchfilter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/fileinputstream.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/properties.h>
+#include <log4cxxNG/helpers/thread.h>
+#include <log4cxxNG/helpers/transcoder.h>
+#include <log4cxxNG/mdc.h>
+#include <log4cxxNG/ndc.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::helpers;
+using namespace log4cxxng::rolling;
+using namespace log4cxxng::spi;
+
+/**
+ *  log4cxxNG-bench measures the end-to-end logging paths.
+ *
+ *  usage: log4cxxNG-bench [--quick] [scenario-prefix...]
+ *
+ *  Every scenario runs a fixed number of operations after a warm up,
+ *  spread evenly over its threads, and reports operations per second,
+ *  the 50th, 99th and 99.9th percentile latency of one operation and
+ *  the number of heap allocations per operation. Latency is sampled
+ *  over batches of operations where a single one is too short to
+ *  time. Allocations are counted by replacing the global operator new,
+ *  which on platforms without symbol interposition only sees the
+ *  allocations made by this executable. Files are written below
+ *  output/ and configurations read from input/, so run it from
+ *  src/test/resources like the tests.
+ *
+ *  On hosts with more than one NUMA node, async-4t-local and
+ *  async-4t-remote run the producers on node 0 with the dispatcher
+ *  on node 0 and on node 1 respectively, the difference being the
+ *  cost of handing events and writing buffers across nodes.
+ */
+
+namespace
+{
+std::atomic<unsigned long long> allocations(0);
+}
+
+void* operator new(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void* block = malloc(size == 0 ? 1 : size);
+
+	if (block == 0)
+	{
+		throw std::bad_alloc();
+	}
+
+	return block;
+}
+
+void operator delete(void* block) noexcept
+{
+	free(block);
+}
+
+namespace
+{
+/**
+ *  Appender that discards every event, so that a scenario measures
+ *  the cost of reaching the appender.
+ */
+class BenchAppender : public AppenderSkeleton
+{
+	public:
+		DECLARE_LOG4CXXNG_OBJECT(BenchAppender)
+		BEGIN_LOG4CXXNG_CAST_MAP()
+		LOG4CXXNG_CAST_ENTRY(BenchAppender)
+		LOG4CXXNG_CAST_ENTRY_CHAIN(AppenderSkeleton)
+		END_LOG4CXXNG_CAST_MAP()
+
+		void append(const LoggingEventPtr&, Pool&)
+		{
+		}
+
+		void close()
+		{
+			closed = true;
+		}
+
+		bool requiresLayout() const
+		{
+			return false;
+		}
+};
+}
+
+IMPLEMENT_LOG4CXXNG_OBJECT(BenchAppender)
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+class Scenario
+{
+	public:
+		Scenario(const std::string& name1, int threads1, int batch1, long iterations1)
+			: name(name1), threads(threads1), batch(batch1), iterations(iterations1)
+		{
+		}
+
+		virtual ~Scenario()
+		{
+		}
+
+		virtual void setUp()
+		{
+		}
+
+		virtual void operation() = 0;
+
+		/**
+		 *  Called after the workers finished, before the clock stops,
+		 *  to wait for work handed to other threads.
+		 */
+		virtual void drain()
+		{
+		}
+
+		virtual void tearDown()
+		{
+		}
+
+		const std::string name;
+		const int threads;
+		const int batch;
+		const long iterations;
+};
+
+struct Worker
+{
+	Scenario* scenario;
+	long batches;
+	std::vector<double> samples;
+	std::atomic<int>* ready;
+	std::atomic<bool>* go;
+};
+
+void* LOG4CXXNG_THREAD_FUNC work(apr_thread_t*, void* data)
+{
+	Worker* worker = (Worker*) data;
+	Scenario* scenario = worker->scenario;
+	worker->ready->fetch_add(1);
+
+	while (!worker->go->load())
+	{
+	}
+
+	for (long b = 0; b < worker->batches; b++)
+	{
+		Clock::time_point start = Clock::now();
+
+		for (int i = 0; i < scenario->batch; i++)
+		{
+			scenario->operation();
+		}
+
+		std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+		worker->samples.push_back(elapsed.count() / scenario->batch);
+	}
+
+	return 0;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+	if (sorted.empty())
+	{
+		return 0;
+	}
+
+	size_t index = (size_t) (fraction * sorted.size());
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void measure(Scenario& scenario, long divisor)
+{
+	scenario.setUp();
+
+	long iterations = std::max(scenario.iterations / divisor, (long) scenario.batch * scenario.threads);
+
+	for (long i = 0; i < iterations / 10; i++)
+	{
+		scenario.operation();
+	}
+
+	std::vector<Worker> workers(scenario.threads);
+	std::vector<Thread> threads(scenario.threads);
+	std::atomic<int> ready(0);
+	std::atomic<bool> go(false);
+
+	for (int t = 0; t < scenario.threads; t++)
+	{
+		workers[t].scenario = &scenario;
+		workers[t].batches = iterations / scenario.threads / scenario.batch;
+		workers[t].samples.reserve(workers[t].batches);
+		workers[t].ready = &ready;
+		workers[t].go = &go;
+		threads[t].run(work, &workers[t]);
+	}
+
+	while (ready.load() < scenario.threads)
+	{
+	}
+
+	unsigned long long allocationsBefore = allocations.load();
+	Clock::time_point start = Clock::now();
+	go.store(true);
+
+	for (int t = 0; t < scenario.threads; t++)
+	{
+		threads[t].join();
+	}
+
+	scenario.drain();
+	std::chrono::duration<double> elapsed = Clock::now() - start;
+	unsigned long long allocated = allocations.load() - allocationsBefore;
+
+	std::vector<double> samples;
+	long operations = 0;
+
+	for (int t = 0; t < scenario.threads; t++)
+	{
+		samples.insert(samples.end(), workers[t].samples.begin(), workers[t].samples.end());
+		operations += workers[t].batches * scenario.batch;
+	}
+
+	scenario.tearDown();
+	std::sort(samples.begin(), samples.end());
+
+	printf("%-24s %7d %14.0f %10.1f %10.1f %10.1f %10.2f\n",
+		scenario.name.c_str(),
+		scenario.threads,
+		operations / elapsed.count(),
+		percentile(samples, 0.5),
+		percentile(samples, 0.99),
+		percentile(samples, 0.999),
+		(double) allocated / operations);
+	fflush(stdout);
+}
+
+/**
+ *  A debug statement against a logger enabled for WARN.
+ */
+class DisabledScenario : public Scenario
+{
+	public:
+		DisabledScenario()
+			: Scenario("disabled", 1, 1000, 100000000L)
+		{
+		}
+
+		void setUp()
+		{
+			logger = Logger::getLogger(LOG4CXXNG_STR("bench.disabled"));
+			logger->setLevel(Level::getWarn());
+		}
+
+		void operation()
+		{
+			LOG4CXXNG_DEBUG(logger, "disabled statement " << 42);
+		}
+
+	private:
+		LoggerPtr logger;
+};
+
+/**
+ *  Info statements through one appender attached to a
+ *  non-additive logger.
+ */
+class AppenderScenario : public Scenario
+{
+	public:
+		AppenderScenario(const std::string& name1, int threads1, long iterations1)
+			: Scenario(name1, threads1, 1, iterations1)
+		{
+		}
+
+		virtual AppenderPtr createAppender(Pool& p) = 0;
+
+		void setUp()
+		{
+			logger = Logger::getLogger(LOG4CXXNG_STR("bench.appender"));
+			logger->setLevel(Level::getInfo());
+			logger->setAdditivity(false);
+			appender = createAppender(pool);
+			logger->addAppender(appender);
+		}
+
+		void operation()
+		{
+			LOG4CXXNG_INFO(logger, "Hello, benchmark. The quick brown fox jumps over the lazy dog.");
+		}
+
+		void tearDown()
+		{
+			logger->removeAllAppenders();
+			appender->close();
+			appender = 0;
+		}
+
+	protected:
+		static LayoutPtr createLayout()
+		{
+			return new PatternLayout(LOG4CXXNG_STR("%d %-5p [%t] %c - %m%n"));
+		}
+
+		Pool pool;
+		LoggerPtr logger;
+		AppenderPtr appender;
+};
+
+class FileScenario : public AppenderScenario
+{
+	public:
+		FileScenario(int threads1)
+			: AppenderScenario(threads1 == 1 ? "file-sync-1t" : "file-sync-4t", threads1, 400000L)
+		{
+		}
+
+		AppenderPtr createAppender(Pool&)
+		{
+			return new FileAppender(createLayout(), LOG4CXXNG_STR("output/bench-file.log"), false);
+		}
+};
+
+class BufferedFileScenario : public AppenderScenario
+{
+	public:
+		BufferedFileScenario()
+			: AppenderScenario("file-buffered-1t", 1, 400000L)
+		{
+		}
+
+		AppenderPtr createAppender(Pool& p)
+		{
+			FileAppenderPtr file(new FileAppender());
+			file->setLayout(createLayout());
+			file->setFile(LOG4CXXNG_STR("output/bench-buffered.log"));
+			file->setAppend(false);
+			file->setBufferedIO(true);
+			file->setBufferSize(4 * 1024 * 1024);
+			file->activateOptions(p);
+			return file;
+		}
+};
+
+class FlightRecorderScenario : public AppenderScenario
+{
+	public:
+		FlightRecorderScenario(int threads1)
+			: AppenderScenario(threads1 == 1 ? "flightrecorder-1t" : "flightrecorder-4t", threads1, 400000L)
+		{
+		}
+
+		AppenderPtr createAppender(Pool& p)
+		{
+			FlightRecorderAppenderPtr recorder(new FlightRecorderAppender());
+			recorder->setLayout(createLayout());
+			recorder->setFile(LOG4CXXNG_STR("output/bench-flightrecorder.log"));
+			recorder->setDumpOnSignal(false);
+			recorder->activateOptions(p);
+			return recorder;
+		}
+};
+
+/**
+ *  Error statements through an SMTP appender, each of them triggering
+ *  an e-mail: the logging thread should only pay for buffering the
+ *  event and waking the sender. The server refuses the connection, so
+ *  the sender fails quickly and no mail leaves the machine.
+ */
+class SMTPTriggerScenario : public AppenderScenario
+{
+	public:
+		SMTPTriggerScenario()
+			: AppenderScenario("smtp-trigger-1t", 1, 20000L)
+		{
+		}
+
+		AppenderPtr createAppender(Pool& p)
+		{
+			net::SMTPAppenderPtr smtp(new net::SMTPAppender());
+			smtp->setLayout(createLayout());
+			smtp->setSMTPHost(LOG4CXXNG_STR("localhost"));
+			smtp->setSMTPPort(1);
+			smtp->setTo(LOG4CXXNG_STR("you@example.invalid"));
+			smtp->setFrom(LOG4CXXNG_STR("me@example.invalid"));
+			smtp->activateOptions(p);
+			return smtp;
+		}
+
+		void operation()
+		{
+			LOG4CXXNG_ERROR(logger, "Hello, benchmark. The quick brown fox jumps over the lazy dog.");
+		}
+};
+
+/**
+ *  Reads the processors of a NUMA node, empty if there is no such node.
+ */
+LogString getNodeProcessors(int node)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+	std::string cpus;
+	FILE* file = fopen(path, "r");
+
+	if (file != NULL)
+	{
+		char line[1024];
+
+		if (fgets(line, sizeof(line), file) != NULL)
+		{
+			cpus.assign(line, strcspn(line, "\r\n"));
+		}
+
+		fclose(file);
+	}
+
+	LOG4CXXNG_DECODE_CHAR(result, cpus);
+	return result;
+}
+
+class AsyncScenario : public AppenderScenario
+{
+	public:
+		AsyncScenario()
+			: AppenderScenario("async-4t", 4, 400000L)
+		{
+		}
+
+		/**
+		 *  Runs the producers and the dispatcher on the given processors.
+		 */
+		AsyncScenario(const std::string& name1,
+			const LogString& producerCpus1, const LogString& dispatcherCpus1)
+			: AppenderScenario(name1, 4, 400000L),
+			  producerCpus(producerCpus1), dispatcherCpus(dispatcherCpus1)
+		{
+		}
+
+		void setUp()
+		{
+			//
+			//   the workers of measure inherit the binding of this thread
+			//
+			if (!producerCpus.empty())
+			{
+				Thread::setCurrentThreadAffinity(producerCpus);
+			}
+
+			AppenderScenario::setUp();
+		}
+
+		AppenderPtr createAppender(Pool& p)
+		{
+			AsyncAppenderPtr async(new AsyncAppender());
+
+			if (!dispatcherCpus.empty())
+			{
+				async->setDispatcherAffinity(dispatcherCpus);
+			}
+
+			async->addAppender(new FileAppender(createLayout(),
+					LOG4CXXNG_STR("output/bench-async.log"), false));
+			async->activateOptions(p);
+			return async;
+		}
+
+		void drain()
+		{
+			appender->close();
+		}
+
+		void tearDown()
+		{
+			logger->removeAllAppenders();
+			appender = 0;
+
+			if (!producerCpus.empty())
+			{
+				Thread::setCurrentThreadAffinity(LogString());
+			}
+		}
+
+	private:
+		LogString producerCpus;
+		LogString dispatcherCpus;
+};
+
+class RollingScenario : public AppenderScenario
+{
+	public:
+		RollingScenario()
+			: AppenderScenario("rolling-1t", 1, 400000L)
+		{
+		}
+
+		AppenderPtr createAppender(Pool& p)
+		{
+			FixedWindowRollingPolicyPtr rollingPolicy(new FixedWindowRollingPolicy());
+			rollingPolicy->setMinIndex(1);
+			rollingPolicy->setMaxIndex(3);
+			rollingPolicy->setFileNamePattern(LOG4CXXNG_STR("output/bench-rolling.%i"));
+			rollingPolicy->activateOptions(p);
+			SizeBasedTriggeringPolicyPtr triggeringPolicy(new SizeBasedTriggeringPolicy());
+			triggeringPolicy->setMaxFileSize(1024 * 1024);
+
+			RollingFileAppenderPtr rolling(new RollingFileAppender());
+			rolling->setAppend(false);
+			rolling->setLayout(createLayout());
+			rolling->setFile(LOG4CXXNG_STR("output/bench-rolling.log"));
+			rolling->setRollingPolicy(rollingPolicy);
+			rolling->setTriggeringPolicy(triggeringPolicy);
+			rolling->activateOptions(p);
+			return rolling;
+		}
+};
+
+/**
+ *  Formats the same event with one layout, without any appender.
+ */
+class LayoutScenario : public Scenario
+{
+	public:
+		LayoutScenario(const std::string& name1, const LayoutPtr& layout1)
+			: Scenario(name1, 1, 100, 2000000L), layout(layout1)
+		{
+		}
+
+		void setUp()
+		{
+			layout->activateOptions(pool);
+			LoggerPtr logger(Logger::getLogger(LOG4CXXNG_STR("bench.layout")));
+			NDC::push(LOG4CXXNG_STR("request 42"));
+			MDC::put(LOG4CXXNG_STR("user"), LOG4CXXNG_STR("alice"));
+			event = LoggingEvent::create(*logger, Level::getInfo(),
+					LOG4CXXNG_STR("Hello, benchmark. The quick brown fox jumps over the lazy dog."),
+					LOG4CXXNG_LOCATION);
+		}
+
+		void operation()
+		{
+			output.erase();
+			layout->format(output, event, pool);
+		}
+
+		void tearDown()
+		{
+			event = 0;
+			NDC::clear();
+			MDC::clear();
+		}
+
+	private:
+		LayoutPtr layout;
+		LoggingEventPtr event;
+		LogString output;
+		Pool pool;
+};
+
+struct Point
+{
+	int x;
+	int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& point)
+{
+	return os << '(' << point.x << ", " << point.y << ')';
+}
+
+/**
+ *  Info statements built from different kinds of arguments, reaching
+ *  an appender that discards them, so that the difference between the
+ *  scenarios is the cost of building the message.
+ */
+class MessageScenario : public AppenderScenario
+{
+	public:
+		MessageScenario(const std::string& name1)
+			: AppenderScenario(name1, 1, 4000000L), request(0)
+		{
+		}
+
+		AppenderPtr createAppender(Pool&)
+		{
+			return new BenchAppender();
+		}
+
+	protected:
+		int request;
+};
+
+class LiteralMessageScenario : public MessageScenario
+{
+	public:
+		LiteralMessageScenario()
+			: MessageScenario("message-literal")
+		{
+		}
+
+		void operation()
+		{
+			LOG4CXXNG_INFO(logger, "request completed");
+		}
+};
+
+class StringMessageScenario : public MessageScenario
+{
+	public:
+		StringMessageScenario()
+			: MessageScenario("message-string"), user("anonymous")
+		{
+		}
+
+		void operation()
+		{
+			LOG4CXXNG_INFO(logger, "request from " << user << " completed");
+		}
+
+	private:
+		std::string user;
+};
+
+class IntegerMessageScenario : public MessageScenario
+{
+	public:
+		IntegerMessageScenario()
+			: MessageScenario("message-integers")
+		{
+		}
+
+		void operation()
+		{
+			long user = 1234567;
+			LOG4CXXNG_INFO(logger, "request " << ++request << " from user " << user << " completed");
+		}
+};
+
+class DoubleMessageScenario : public MessageScenario
+{
+	public:
+		DoubleMessageScenario()
+			: MessageScenario("message-double")
+		{
+		}
+
+		void operation()
+		{
+			double ms = 12.625;
+			LOG4CXXNG_INFO(logger, "request " << ++request << " took " << ms << "ms");
+		}
+};
+
+class UserTypeMessageScenario : public MessageScenario
+{
+	public:
+		UserTypeMessageScenario()
+			: MessageScenario("message-user-type")
+		{
+		}
+
+		void operation()
+		{
+			Point point = { 3, 4 };
+			LOG4CXXNG_INFO(logger, "request " << ++request << " at " << point);
+		}
+};
+
+/**
+ *  Decodes or encodes 64 KiB of log-like UTF-8 text per operation.
+ */
+class TranscodeScenario : public Scenario
+{
+	public:
+		TranscodeScenario(const std::string& name1, const char* const* lines, bool encode1)
+			: Scenario(name1, 1, 1, 100000L), encode(encode1)
+		{
+			while (corpus.size() < 64 * 1024)
+			{
+				for (const char* const* line = lines; *line != 0; line++)
+				{
+					corpus.append(*line);
+					corpus.append(1, '\n');
+				}
+			}
+		}
+
+		void setUp()
+		{
+			decoded.erase();
+			Transcoder::decodeUTF8(corpus, decoded);
+		}
+
+		void operation()
+		{
+			if (encode)
+			{
+				encoded.erase();
+				Transcoder::encodeUTF8(decoded, encoded);
+			}
+			else
+			{
+				output.erase();
+				Transcoder::decodeUTF8(corpus, output);
+			}
+		}
+
+	private:
+		bool encode;
+		std::string corpus;
+		LogString decoded;
+		std::string encoded;
+		LogString output;
+};
+
+void addTranscodeScenarios(std::vector<Scenario*>& scenarios,
+	const std::string& name, const char* const* lines)
+{
+	scenarios.push_back(new TranscodeScenario("decode-" + name, lines, false));
+	scenarios.push_back(new TranscodeScenario("encode-" + name, lines, true));
+}
+
+/**
+ *  Info statements from four threads through the root logger while,
+ *  with reload set, another thread configures the repository again in
+ *  a tight loop. The reloaded configurations keep the appender of the
+ *  root logger and alternate the level of an unrelated logger.
+ */
+class ReconfigurationScenario : public Scenario
+{
+	public:
+		ReconfigurationScenario(bool reload1)
+			: Scenario(reload1 ? "reconfigure-storm-4t" : "reconfigure-quiet-4t", 4, 1, 400000L),
+			  reload(reload1), stopping(false)
+		{
+		}
+
+		void setUp()
+		{
+			props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("INFO,BENCH"));
+			props.put(LOG4CXXNG_STR("log4j.appender.BENCH"), LOG4CXXNG_STR("BenchAppender"));
+			props.put(LOG4CXXNG_STR("log4j.appender.OTHER"), LOG4CXXNG_STR("BenchAppender"));
+			props.put(LOG4CXXNG_STR("log4j.logger.bench.other"), LOG4CXXNG_STR("ERROR,OTHER"));
+			PropertyConfigurator::configure(props);
+			logger = Logger::getLogger(LOG4CXXNG_STR("bench.reconfigure"));
+			stopping = false;
+
+			if (reload)
+			{
+				reloader.run(reloadAction, this);
+			}
+		}
+
+		void operation()
+		{
+			LOG4CXXNG_INFO(logger, "Hello, benchmark. The quick brown fox jumps over the lazy dog.");
+		}
+
+		void tearDown()
+		{
+			if (reload)
+			{
+				stopping = true;
+				reloader.join();
+			}
+
+			logger = 0;
+			LogManager::resetConfiguration();
+		}
+
+	private:
+		static void* LOG4CXXNG_THREAD_FUNC reloadAction(apr_thread_t*, void* data)
+		{
+			ReconfigurationScenario* scenario = (ReconfigurationScenario*) data;
+
+			for (int reloads = 0; !scenario->stopping.load(); reloads++)
+			{
+				scenario->props.put(LOG4CXXNG_STR("log4j.logger.bench.other"),
+					reloads % 2 == 0 ? LOG4CXXNG_STR("WARN,OTHER") : LOG4CXXNG_STR("ERROR,OTHER"));
+				PropertyConfigurator::configure(scenario->props);
+			}
+
+			return 0;
+		}
+
+		bool reload;
+		std::atomic<bool> stopping;
+		Properties props;
+		LoggerPtr logger;
+		Thread reloader;
+};
+
+/**
+ *  Configures the repository from scratch from the same configuration
+ *  written as XML, as properties or as a snapshot.
+ */
+class StartupScenario : public Scenario
+{
+	public:
+		enum Format { XML, PROPERTIES, SNAPSHOT };
+
+		StartupScenario(const std::string& name1, Format format1)
+			: Scenario(name1, 1, 1, 20000L), format(format1),
+			  snapshot(LOG4CXXNG_STR("output/bench-startup.snapshot"))
+		{
+		}
+
+		void setUp()
+		{
+			if (format == SNAPSHOT)
+			{
+				Properties props;
+				props.load(new FileInputStream(LOG4CXXNG_STR("input/startup.properties")));
+				SnapshotConfigurator::write(props, snapshot);
+			}
+		}
+
+		void operation()
+		{
+			LogManager::resetConfiguration();
+
+			switch (format)
+			{
+				case XML:
+					xml::DOMConfigurator::configure("input/xml/startup.xml");
+					break;
+
+				case PROPERTIES:
+					PropertyConfigurator::configure(File("input/startup.properties"));
+					break;
+
+				case SNAPSHOT:
+					SnapshotConfigurator::configure(snapshot);
+					break;
+			}
+		}
+
+		void tearDown()
+		{
+			LogManager::resetConfiguration();
+		}
+
+	private:
+		Format format;
+		File snapshot;
+};
+
+/**
+ *  Decides twelve events in turn with a filter accepting the events
+ *  of org.example at INFO or above with "order" in the message.
+ */
+class FilterScenario : public Scenario
+{
+	public:
+		FilterScenario(const std::string& name1, const FilterPtr& filter1)
+			: Scenario(name1, 1, 100, 20000000L), filter(filter1), next(0)
+		{
+		}
+
+		void setUp()
+		{
+			filter->activateOptions(pool);
+			const LevelPtr levels[] = { Level::getDebug(), Level::getInfo(), Level::getWarn() };
+			const logchar* loggers[] = { LOG4CXXNG_STR("org.example"), LOG4CXXNG_STR("org.other") };
+			const logchar* messages[] = { LOG4CXXNG_STR("order 42 shipped"), LOG4CXXNG_STR("heartbeat") };
+
+			for (int i = 0; i < 12; i++)
+			{
+				events.push_back(new LoggingEvent(loggers[i % 2], levels[i % 3],
+						messages[(i / 6) % 2], LOG4CXXNG_LOCATION));
+			}
+		}
+
+		void operation()
+		{
+			filter->decide(events[next++ % events.size()]);
+		}
+
+		void tearDown()
+		{
+			events.clear();
+		}
+
+	private:
+		FilterPtr filter;
+		std::vector<LoggingEventPtr> events;
+		size_t next;
+		Pool pool;
+};
+
+FilterPtr createAndFilter()
+{
+	LevelRangeFilterPtr level(new LevelRangeFilter());
+	level->setLevelMin(Level::getInfo());
+	level->setAcceptOnMatch(true);
+	LoggerMatchFilterPtr logger(new LoggerMatchFilter());
+	logger->setLoggerToMatch(LOG4CXXNG_STR("org.example"));
+	StringMatchFilterPtr message(new StringMatchFilter());
+	message->setStringToMatch(LOG4CXXNG_STR("order"));
+	AndFilterPtr filter(new AndFilter());
+	filter->addFilter(level);
+	filter->addFilter(logger);
+	filter->addFilter(message);
+	return filter;
+}
+
+FilterPtr createExpressionFilter()
+{
+	ExpressionFilterPtr filter(new ExpressionFilter());
+	filter->setExpression(LOG4CXXNG_STR("LEVEL >= INFO && LOGGER == org.example && MSG ~= order"));
+	return filter;
+}
+
+void addPatternScenario(std::vector<Scenario*>& scenarios, const std::string& conversion)
+{
+	LogString pattern;
+
+	for (std::string::const_iterator iter = conversion.begin(); iter != conversion.end(); iter++)
+	{
+		pattern.append(1, (logchar) *iter);
+	}
+
+	scenarios.push_back(new LayoutScenario("layout " + conversion,
+			new PatternLayout(pattern)));
+}
+}
+
+int main(int argc, const char* const argv[])
+{
+	long divisor = 1;
+	std::vector<std::string> selected;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--quick") == 0)
+		{
+			divisor = 100;
+		}
+		else if (argv[i][0] == '-')
+		{
+			fprintf(stderr, "usage: %s [--quick] [scenario-prefix...]\n", argv[0]);
+			return 1;
+		}
+		else
+		{
+			selected.push_back(argv[i]);
+		}
+	}
+
+	std::vector<Scenario*> scenarios;
+	scenarios.push_back(new DisabledScenario());
+	scenarios.push_back(new FileScenario(1));
+	scenarios.push_back(new FileScenario(4));
+	scenarios.push_back(new BufferedFileScenario());
+	scenarios.push_back(new FlightRecorderScenario(1));
+	scenarios.push_back(new FlightRecorderScenario(4));
+	scenarios.push_back(new SMTPTriggerScenario());
+	scenarios.push_back(new AsyncScenario());
+
+	LogString node0(getNodeProcessors(0));
+	LogString node1(getNodeProcessors(1));
+
+	if (!node0.empty() && !node1.empty())
+	{
+		scenarios.push_back(new AsyncScenario("async-4t-local", node0, node0));
+		scenarios.push_back(new AsyncScenario("async-4t-remote", node0, node1));
+	}
+
+	scenarios.push_back(new RollingScenario());
+
+	const char* conversions[] =
+	{
+		"%m", "%c", "%c{1}", "%C", "%d", "%d{ABSOLUTE}", "%F", "%l", "%L",
+		"%M", "%n", "%p", "%-5p", "%r", "%t", "%x", "%X{user}",
+		"%d %-5p [%t] %c - %m%n"
+	};
+
+	for (size_t i = 0; i < sizeof(conversions) / sizeof(conversions[0]); i++)
+	{
+		addPatternScenario(scenarios, conversions[i]);
+	}
+
+	scenarios.push_back(new LayoutScenario("layout json", new JSONLayout()));
+	scenarios.push_back(new LayoutScenario("layout xml", new xml::XMLLayout()));
+	scenarios.push_back(new LayoutScenario("layout html", new HTMLLayout()));
+
+	scenarios.push_back(new LiteralMessageScenario());
+	scenarios.push_back(new StringMessageScenario());
+	scenarios.push_back(new IntegerMessageScenario());
+	scenarios.push_back(new DoubleMessageScenario());
+	scenarios.push_back(new UserTypeMessageScenario());
+
+	const char* const ascii[] =
+	{
+		"2020-03-14 09:26:53,589 INFO  [http-nio-8080-exec-7] o.a.l.web.RequestLogger - GET /api/v1/orders/48213 200 12ms",
+		"2020-03-14 09:26:53,602 DEBUG [pool-3-thread-1] o.a.l.cache.Eviction - evicted 128 entries, 4096 remaining",
+		"2020-03-14 09:26:53,617 WARN  [main] o.a.l.config.Loader - property 'timeout' is deprecated, use 'readTimeout'",
+		0
+	};
+	const char* const latin[] =
+	{
+		"2020-03-14 09:26:53,589 INFO  [main] o.a.l.Facturation - facture n\xC2\xB0" "4821 \xC3\xA9mise pour Fran\xC3\xA7ois M\xC3\xBCller",
+		"2020-03-14 09:26:53,602 INFO  [main] o.a.l.Versand - Lieferung an Stra\xC3\x9F" "e 12, M\xC3\xBCnchen best\xC3\xA4tigt",
+		0
+	};
+	const char* const mixed[] =
+	{
+		"2020-03-14 09:26:53,589 INFO  [main] o.a.l.User - \xE7\x94\xA8\xE6\x88\xB7\xE7\x99\xBB\xE5\xBD\x95\xE6\x88\x90\xE5\x8A\x9F user=\xE5\xBC\xA0\xE4\xBC\x9F",
+		"2020-03-14 09:26:53,602 ERROR [main] o.a.l.Db - \xD0\x9E\xD1\x88\xD0\xB8\xD0\xB1\xD0\xBA\xD0\xB0 \xD1\x81\xD0\xBE\xD0\xB5\xD0\xB4\xD0\xB8\xD0\xBD\xD0\xB5\xD0\xBD\xD0\xB8\xD1\x8F \xF0\x9F\x94\xA5",
+		0
+	};
+	addTranscodeScenarios(scenarios, "ascii", ascii);
+	addTranscodeScenarios(scenarios, "latin", latin);
+	addTranscodeScenarios(scenarios, "mixed", mixed);
+
+	scenarios.push_back(new ReconfigurationScenario(false));
+	scenarios.push_back(new ReconfigurationScenario(true));
+	scenarios.push_back(new StartupScenario("startup-xml", StartupScenario::XML));
+	scenarios.push_back(new StartupScenario("startup-properties", StartupScenario::PROPERTIES));
+	scenarios.push_back(new StartupScenario("startup-snapshot", StartupScenario::SNAPSHOT));
+	scenarios.push_back(new FilterScenario("filter-and", createAndFilter()));
+	scenarios.push_back(new FilterScenario("filter-expression", createExpressionFilter()));
+
+	printf("%-24s %7s %14s %10s %10s %10s %10s\n",
+		"scenario", "threads", "ops/s", "p50 ns", "p99 ns", "p99.9 ns", "allocs/op");
+
+	for (std::vector<Scenario*>::iterator iter = scenarios.begin(); iter != scenarios.end(); iter++)
+	{
+		bool run = selected.empty();
+
+		for (std::vector<std::string>::const_iterator prefix = selected.begin();
+			!run && prefix != selected.end();
+			prefix++)
+		{
+			run = (*iter)->name.compare(0, prefix->length(), *prefix) == 0;
+		}
+
+		if (run)
+		{
+			measure(**iter, divisor);
+		}
+
+		delete *iter;
+	}
+
+	LogManager::shutdown();
+	return 0;
+}
@@ -24,8 +24,57 @@
 
 #ifdef LOG4CXXNG_HAVE_ODBC
 
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/logmanager.h>
+#if defined(WIN32) || defined(_WIN32)
+	#include <windows.h>
+#endif
+#include <sqlext.h>
+
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
+using namespace log4cxxng::db;
+
+/**
+ *  Counts the batches written and, after each one, the rows in the
+ *  table, which only exists as long as the appender's connection.
+ */
+class BatchCountingODBCAppender : public ODBCAppender
+{
+	public:
+		int batches;
+		long rows;
+
+		BatchCountingODBCAppender() : batches(0), rows(0)
+		{
+		}
+
+		void createTable(Pool& p)
+		{
+			execute(LOG4CXXNG_STR("CREATE TABLE log (logger VARCHAR(255), level VARCHAR(10), message VARCHAR(255))"), p);
+		}
+
+		void executeBatch(const std::list<spi::LoggingEventPtr>& events, Pool& p)
+		{
+			ODBCAppender::executeBatch(events, p);
+			batches++;
+			SQLHSTMT stmt = SQL_NULL_HSTMT;
+
+			if (SQLAllocHandle(SQL_HANDLE_STMT, getConnection(p), &stmt) >= 0)
+			{
+				SQLINTEGER count = 0;
+
+				if (SQLExecDirect(stmt, (SQLCHAR*) "SELECT COUNT(*) FROM log", SQL_NTS) >= 0
+					&& SQLFetch(stmt) >= 0
+					&& SQLGetData(stmt, 1, SQL_C_SLONG, &count, 0, 0) >= 0)
+				{
+					rows = count;
+				}
+
+				SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+			}
+		}
+};
 
 /**
    Unit tests of log4cxxng::SocketAppender
@@ -38,6 +87,7 @@ class ODBCAppenderTestCase : public AppenderSkeletonTestCase
 		//
 		LOGUNIT_TEST(testDefaultThreshold);
 		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testPreparedBatch);
 
 		LOGUNIT_TEST_SUITE_END();
 
@@ -48,6 +98,51 @@ class ODBCAppenderTestCase : public AppenderSkeletonTestCase
 		{
 			return new log4cxxng::db::ODBCAppender();
 		}
+
+		/**
+		 *  Writes through an in-memory SQLite database using the SQLite
+		 *  ODBC driver; skipped when that driver is not installed.
+		 */
+		void testPreparedBatch()
+		{
+			BatchCountingODBCAppender* appender = new BatchCountingODBCAppender();
+			AppenderPtr holder(appender);
+			appender->setURL(LOG4CXXNG_STR("Driver=SQLite3;Database=:memory:"));
+			appender->setSql(LOG4CXXNG_STR("INSERT INTO log (logger, level, message) VALUES (?, ?, ?)"));
+			appender->setOption(LOG4CXXNG_STR("ColumnMapping"), LOG4CXXNG_STR("%c"));
+			appender->setOption(LOG4CXXNG_STR("ColumnMapping"), LOG4CXXNG_STR("%p"));
+			appender->setOption(LOG4CXXNG_STR("ColumnMapping"), LOG4CXXNG_STR("%m"));
+			appender->setBufferSize(10);
+			Pool p;
+
+			try
+			{
+				appender->createTable(p);
+			}
+			catch (SQLException&)
+			{
+				return;
+			}
+
+			appender->activateOptions(p);
+			LoggerPtr logger(Logger::getLogger("ODBCAppenderTestCase"));
+			logger->setAdditivity(false);
+			logger->addAppender(holder);
+
+			for (int i = 0; i < 24; i++)
+			{
+				LOG4CXXNG_INFO(logger, "Message " << i);
+			}
+
+			// would be a syntax error if spliced into the statement text
+			LOG4CXXNG_WARN(logger, "It's 'quoted'");
+			appender->close();
+			logger->removeAllAppenders();
+
+			// two full buffers, possibly coalesced by the flusher, and the rest on close
+			LOGUNIT_ASSERT(appender->batches >= 2);
+			LOGUNIT_ASSERT_EQUAL(25L, appender->rows);
+		}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(ODBCAppenderTestCase);
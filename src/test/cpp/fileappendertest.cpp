@@ -17,6 +17,8 @@
 #include <log4cxxNG/helpers/pool.h>
 #include <log4cxxNG/fileappender.h>
 #include <log4cxxNG/patternlayout.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/thread.h>
 #include "logunit.h"
 
 using namespace log4cxxng;
@@ -33,6 +35,9 @@ LOGUNIT_CLASS(FileAppenderTest)
 	LOGUNIT_TEST(testDirectoryCreation);
 	LOGUNIT_TEST(testgetSetThreshold);
 	LOGUNIT_TEST(testIsAsSevereAsThreshold);
+	LOGUNIT_TEST(testFlushEvents);
+	LOGUNIT_TEST(testFlushLevel);
+	LOGUNIT_TEST(testFlushInterval);
 	LOGUNIT_TEST_SUITE_END();
 public:
 	/**
@@ -81,6 +86,86 @@ public:
 		LevelPtr debug = Level::getDebug();
 		LOGUNIT_ASSERT(appender->isAsSevereAsThreshold(debug));
 	}
+
+	/**
+	 * Creates a buffered appender with one flush policy option set.
+	 */
+	static FileAppenderPtr createBuffered(const LogString& fileName,
+		const LogString& option, const LogString& value, Pool& p)
+	{
+		FileAppenderPtr appender(new FileAppender());
+		appender->setFile(fileName);
+		appender->setAppend(false);
+		appender->setBufferedIO(true);
+		appender->setLayout(new PatternLayout(LOG4CXXNG_STR("%m%n")));
+		appender->setOption(option, value);
+		appender->activateOptions(p);
+		return appender;
+	}
+
+	static void append(const FileAppenderPtr& appender, const LevelPtr& level, Pool& p)
+	{
+		spi::LoggingEventPtr event(new spi::LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.FileAppenderTest"),
+				level, LOG4CXXNG_STR("Hello"), LOG4CXXNG_LOCATION));
+		appender->doAppend(event, p);
+	}
+
+	/**
+	 * Tests that FlushEvents flushes every n events.
+	 */
+	void testFlushEvents()
+	{
+		Pool p;
+		File file(LOG4CXXNG_STR("output/flushEvents.log"));
+		FileAppenderPtr appender(createBuffered(file.getPath(),
+				LOG4CXXNG_STR("FlushEvents"), LOG4CXXNG_STR("2"), p));
+		LOGUNIT_ASSERT_EQUAL(2U, appender->getFlushPolicy().getFlushEvents());
+
+		append(appender, Level::getInfo(), p);
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, file.length(p));
+		append(appender, Level::getInfo(), p);
+		LOGUNIT_ASSERT(file.length(p) > 0);
+		appender->close();
+	}
+
+	/**
+	 * Tests that FlushLevel flushes after a severe event.
+	 */
+	void testFlushLevel()
+	{
+		Pool p;
+		File file(LOG4CXXNG_STR("output/flushLevel.log"));
+		FileAppenderPtr appender(createBuffered(file.getPath(),
+				LOG4CXXNG_STR("FlushLevel"), LOG4CXXNG_STR("ERROR"), p));
+
+		append(appender, Level::getWarn(), p);
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, file.length(p));
+		append(appender, Level::getError(), p);
+		LOGUNIT_ASSERT(file.length(p) > 0);
+		appender->close();
+	}
+
+	/**
+	 * Tests that FlushInterval flushes pending output from a timer.
+	 */
+	void testFlushInterval()
+	{
+		Pool p;
+		File file(LOG4CXXNG_STR("output/flushInterval.log"));
+		FileAppenderPtr appender(createBuffered(file.getPath(),
+				LOG4CXXNG_STR("FlushInterval"), LOG4CXXNG_STR("20"), p));
+
+		append(appender, Level::getInfo(), p);
+
+		for (int i = 0; i < 100 && file.length(p) == 0; i++)
+		{
+			Thread::sleep(20);
+		}
+
+		LOGUNIT_ASSERT(file.length(p) > 0);
+		appender->close();
+	}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(FileAppenderTest);
@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/filter/expressionfilter.h>
+#include <log4cxxNG/filter/propertyfilter.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/mdc.h>
+#include <log4cxxNG/spi/filter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include "../logunit.h"
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+
+/**
+ * Unit tests for ExpressionFilter and PropertyFilter.
+ */
+LOGUNIT_CLASS(ExpressionFilterTest)
+{
+	LOGUNIT_TEST_SUITE(ExpressionFilterTest);
+	LOGUNIT_TEST(testLevelAndMessage);
+	LOGUNIT_TEST(testNegation);
+	LOGUNIT_TEST(testLevelInequality);
+	LOGUNIT_TEST(testLoggerAlternatives);
+	LOGUNIT_TEST(testMDCAndProperty);
+	LOGUNIT_TEST(testPostFix);
+	LOGUNIT_TEST(testDenyOnMatch);
+	LOGUNIT_TEST(testInvalidExpression);
+	LOGUNIT_TEST(testPropertyFilter);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown()
+	{
+		MDC::clear();
+	}
+
+	static LoggingEventPtr createEvent(const LogString& logger,
+		const LevelPtr& level, const LogString& msg)
+	{
+		return new LoggingEvent(logger, level, msg, LOG4CXXNG_LOCATION);
+	}
+
+	static ExpressionFilterPtr createFilter(const LogString& expression)
+	{
+		ExpressionFilterPtr filter(new ExpressionFilter());
+		filter->setExpression(expression);
+		Pool p;
+		filter->activateOptions(p);
+		return filter;
+	}
+
+	void testLevelAndMessage()
+	{
+		ExpressionFilterPtr filter(createFilter(LOG4CXXNG_STR("LEVEL == DEBUG && MSG ~= 'a test'")));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getDebug(), LOG4CXXNG_STR("This is A Test"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("This is a test"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getDebug(), LOG4CXXNG_STR("Hello"))));
+	}
+
+	void testNegation()
+	{
+		ExpressionFilterPtr filter(createFilter(LOG4CXXNG_STR("!(LEVEL == DEBUG && MSG ~= test)")));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getDebug(), LOG4CXXNG_STR("test"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("test"))));
+	}
+
+	void testLevelInequality()
+	{
+		ExpressionFilterPtr filter(createFilter(LOG4CXXNG_STR("LEVEL >= WARN")));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getError(), LOG4CXXNG_STR("m"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getWarn(), LOG4CXXNG_STR("m"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("m"))));
+	}
+
+	void testLoggerAlternatives()
+	{
+		ExpressionFilterPtr filter(createFilter(
+				LOG4CXXNG_STR("LEVEL > INFO && LOGGER == org.example || LOGGER == org.audit")));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.audit"), Level::getDebug(), LOG4CXXNG_STR("m"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getWarn(), LOG4CXXNG_STR("m"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("m"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.other"), Level::getWarn(), LOG4CXXNG_STR("m"))));
+	}
+
+	void testMDCAndProperty()
+	{
+		ExpressionFilterPtr filter(createFilter(
+				LOG4CXXNG_STR("MDC.user == alice && PROP.request EXISTS")));
+		LoggingEventPtr event(createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("m")));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		MDC::putLS(LOG4CXXNG_STR("user"), LOG4CXXNG_STR("alice"));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		event->setProperty(LOG4CXXNG_STR("request"), LOG4CXXNG_STR("42"));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(event));
+	}
+
+	void testPostFix()
+	{
+		ExpressionFilterPtr filter(new ExpressionFilter());
+		filter->setOption(LOG4CXXNG_STR("Expression"), LOG4CXXNG_STR("LEVEL WARN >= MSG boom ~= &&"));
+		filter->setOption(LOG4CXXNG_STR("ConvertInFixToPostFix"), LOG4CXXNG_STR("false"));
+		Pool p;
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getError(), LOG4CXXNG_STR("Boom!"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getDebug(), LOG4CXXNG_STR("Boom!"))));
+	}
+
+	void testDenyOnMatch()
+	{
+		ExpressionFilterPtr filter(new ExpressionFilter());
+		filter->setOption(LOG4CXXNG_STR("Expression"), LOG4CXXNG_STR("THREAD != ''"));
+		filter->setOption(LOG4CXXNG_STR("AcceptOnMatch"), LOG4CXXNG_STR("false"));
+		Pool p;
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(
+				createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("m"))));
+	}
+
+	void testInvalidExpression()
+	{
+		const logchar* invalid[] =
+		{
+			LOG4CXXNG_STR("LEVEL =="),
+			LOG4CXXNG_STR("( LEVEL == INFO"),
+			LOG4CXXNG_STR("LEVEL == NOSUCHLEVEL"),
+			LOG4CXXNG_STR("COLOUR == red"),
+			LOG4CXXNG_STR("MSG >= a"),
+			LOG4CXXNG_STR("MSG == 'unterminated")
+		};
+
+		for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+		{
+			ExpressionFilterPtr filter(createFilter(invalid[i]));
+			LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(
+					createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("a"))));
+		}
+	}
+
+	void testPropertyFilter()
+	{
+		PropertyFilterPtr filter(new PropertyFilter());
+		filter->setOption(LOG4CXXNG_STR("properties"), LOG4CXXNG_STR("host=db1, region = east"));
+		LoggingEventPtr event(createEvent(LOG4CXXNG_STR("org.example"), Level::getInfo(), LOG4CXXNG_STR("m")));
+		event->setProperty(LOG4CXXNG_STR("host"), LOG4CXXNG_STR("web7"));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LogString value;
+		LOGUNIT_ASSERT(event->getProperty(LOG4CXXNG_STR("host"), value));
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("web7"), value);
+		value.erase();
+		LOGUNIT_ASSERT(event->getProperty(LOG4CXXNG_STR("region"), value));
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("east"), value);
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(ExpressionFilterTest);
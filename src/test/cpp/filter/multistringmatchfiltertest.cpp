@@ -0,0 +1,244 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/filter/multistringmatchfilter.h>
+#include <log4cxxNG/filter/stringmatchfilter.h>
+#include <log4cxxNG/filter/denyallfilter.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/spi/filter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include "../logunit.h"
+#include <stdlib.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+
+/**
+ * Unit tests for MultiStringMatchFilter.
+ */
+LOGUNIT_CLASS(MultiStringMatchFilterTest)
+{
+	LOGUNIT_TEST_SUITE(MultiStringMatchFilterTest);
+	LOGUNIT_TEST(testNoStrings);
+	LOGUNIT_TEST(testSingleString);
+	LOGUNIT_TEST(testFirstAddedWins);
+	LOGUNIT_TEST(testOverlappingStrings);
+	LOGUNIT_TEST(testOptions);
+	LOGUNIT_TEST(testCompile);
+	LOGUNIT_TEST(testMatchesChain);
+	LOGUNIT_TEST_SUITE_END();
+
+	static LoggingEventPtr createEvent(const LogString& msg)
+	{
+		return LoggingEventPtr(new LoggingEvent(
+					LOG4CXXNG_STR("org.apache.log4j.filter.MultiStringMatchFilterTest"),
+					Level::getInfo(),
+					msg,
+					LOG4CXXNG_LOCATION));
+	}
+
+	static Filter::FilterDecision decideChain(const std::vector<FilterPtr>& chain,
+		const LoggingEventPtr& event)
+	{
+		for (std::vector<FilterPtr>::const_iterator iter = chain.begin();
+			iter != chain.end();
+			iter++)
+		{
+			Filter::FilterDecision decision = (*iter)->decide(event);
+
+			if (decision != Filter::NEUTRAL)
+			{
+				return decision;
+			}
+		}
+
+		return Filter::NEUTRAL;
+	}
+
+public:
+
+	/**
+	 * Check that decide() returns NEUTRAL when no string is set.
+	 */
+	void testNoStrings()
+	{
+		MultiStringMatchFilter filter;
+		filter.addString(LogString(), true);
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, filter.getStringCount());
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL,
+			filter.decide(createEvent(LOG4CXXNG_STR("Hello, World"))));
+	}
+
+	/**
+	 * Check the single string case that uses a plain search.
+	 */
+	void testSingleString()
+	{
+		MultiStringMatchFilter filter;
+		filter.addString(LOG4CXXNG_STR("World"), false);
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY,
+			filter.decide(createEvent(LOG4CXXNG_STR("Hello, World"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL,
+			filter.decide(createEvent(LOG4CXXNG_STR("Hello, world"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL,
+			filter.decide(createEvent(LogString())));
+	}
+
+	/**
+	 * Check that the string added first decides, wherever it occurs.
+	 */
+	void testFirstAddedWins()
+	{
+		MultiStringMatchFilter filter;
+		filter.addString(LOG4CXXNG_STR("World"), false);
+		filter.addString(LOG4CXXNG_STR("Hello"), true);
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY,
+			filter.decide(createEvent(LOG4CXXNG_STR("Hello, World"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT,
+			filter.decide(createEvent(LOG4CXXNG_STR("Hello, world"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL,
+			filter.decide(createEvent(LOG4CXXNG_STR("Goodbye"))));
+	}
+
+	/**
+	 * Check strings that are suffixes and prefixes of each other.
+	 */
+	void testOverlappingStrings()
+	{
+		MultiStringMatchFilter filter;
+		filter.addString(LOG4CXXNG_STR("he"), true);
+		filter.addString(LOG4CXXNG_STR("she"), false);
+		filter.addString(LOG4CXXNG_STR("hers"), false);
+		filter.addString(LOG4CXXNG_STR("ushers"), false);
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT,
+			filter.decide(createEvent(LOG4CXXNG_STR("ushers"))));
+
+		MultiStringMatchFilter reversed;
+		reversed.addString(LOG4CXXNG_STR("hers"), false);
+		reversed.addString(LOG4CXXNG_STR("aab"), true);
+		reversed.addString(LOG4CXXNG_STR("he"), true);
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY,
+			reversed.decide(createEvent(LOG4CXXNG_STR("ushers"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT,
+			reversed.decide(createEvent(LOG4CXXNG_STR("aaab"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT,
+			reversed.decide(createEvent(LOG4CXXNG_STR("hehe"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL,
+			reversed.decide(createEvent(LOG4CXXNG_STR("her"))));
+	}
+
+	/**
+	 * Check the StringToAccept and StringToDeny options.
+	 */
+	void testOptions()
+	{
+		MultiStringMatchFilter filter;
+		filter.setOption(LOG4CXXNG_STR("StringToDeny"), LOG4CXXNG_STR("heartbeat"));
+		filter.setOption(LOG4CXXNG_STR("stringtoaccept"), LOG4CXXNG_STR("ALERT"));
+		Pool p;
+		filter.activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, filter.getStringCount());
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY,
+			filter.decide(createEvent(LOG4CXXNG_STR("ALERT heartbeat"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT,
+			filter.decide(createEvent(LOG4CXXNG_STR("ALERT disk full"))));
+	}
+
+	/**
+	 * Check that compile() merges only runs of StringMatchFilters.
+	 */
+	void testCompile()
+	{
+		std::vector<FilterPtr> filters;
+		StringMatchFilterPtr first(new StringMatchFilter());
+		first->setStringToMatch(LOG4CXXNG_STR("foo"));
+		first->setAcceptOnMatch(false);
+		filters.push_back(first);
+		filters.push_back(new DenyAllFilter());
+		StringMatchFilterPtr second(new StringMatchFilter());
+		second->setStringToMatch(LOG4CXXNG_STR("bar"));
+		filters.push_back(second);
+		StringMatchFilterPtr third(new StringMatchFilter());
+		third->setStringToMatch(LOG4CXXNG_STR("baz"));
+		third->setAcceptOnMatch(false);
+		filters.push_back(third);
+
+		MultiStringMatchFilter::compile(filters);
+		LOGUNIT_ASSERT_EQUAL((size_t) 3, filters.size());
+		LOGUNIT_ASSERT(StringMatchFilterPtr(filters[0]) == first);
+		MultiStringMatchFilterPtr multi(filters[2]);
+		LOGUNIT_ASSERT(multi != 0);
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, multi->getStringCount());
+		LOGUNIT_ASSERT_EQUAL(Filter::ACCEPT,
+			multi->decide(createEvent(LOG4CXXNG_STR("baz bar"))));
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY,
+			multi->decide(createEvent(LOG4CXXNG_STR("baz ba"))));
+	}
+
+	/**
+	 * Check against the equivalent StringMatchFilter chain on
+	 *    random strings over a small alphabet.
+	 */
+	void testMatchesChain()
+	{
+		srand(42);
+		const logchar alphabet[] = { 0x61, 0x62, 0x63, 0x64 };
+
+		for (int round = 0; round < 50; round++)
+		{
+			std::vector<FilterPtr> chain;
+			MultiStringMatchFilter multi;
+
+			for (int i = 0; i < 8; i++)
+			{
+				LogString needle;
+				int length = 1 + rand() % 4;
+
+				for (int j = 0; j < length; j++)
+				{
+					needle.append(1, alphabet[rand() % 4]);
+				}
+
+				bool accept = (rand() % 2) == 0;
+				StringMatchFilterPtr single(new StringMatchFilter());
+				single->setStringToMatch(needle);
+				single->setAcceptOnMatch(accept);
+				chain.push_back(single);
+				multi.addString(needle, accept);
+			}
+
+			for (int k = 0; k < 40; k++)
+			{
+				LogString msg;
+				int length = rand() % 16;
+
+				for (int j = 0; j < length; j++)
+				{
+					msg.append(1, alphabet[rand() % 4]);
+				}
+
+				LoggingEventPtr event(createEvent(msg));
+				LOGUNIT_ASSERT_EQUAL(decideChain(chain, event), multi.decide(event));
+			}
+		}
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(MultiStringMatchFilterTest);
@@ -0,0 +1,231 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxxNG/filter/ratelimitfilter.h>
+#include <log4cxxNG/helpers/ratelimiter.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/spi/filter.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include "../vectorappender.h"
+#include "../logunit.h"
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::spi;
+using namespace log4cxxng::helpers;
+
+
+/**
+ * Unit tests for RateLimitFilter and RateLimiter.
+ */
+LOGUNIT_CLASS(RateLimitFilterTest)
+{
+	LOGUNIT_TEST_SUITE(RateLimitFilterTest);
+	LOGUNIT_TEST(testBurst);
+	LOGUNIT_TEST(testSites);
+	LOGUNIT_TEST(testSampling);
+	LOGUNIT_TEST(testSummary);
+	LOGUNIT_TEST(testFlush);
+	LOGUNIT_TEST(testMacro);
+	LOGUNIT_TEST(testReactivate);
+	LOGUNIT_TEST(testForName);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	/**
+	 * Check that events over the burst of a site are denied.
+	 */
+	void testBurst()
+	{
+		LoggingEventPtr event(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest"),
+				Level::getWarn(),
+				LOG4CXXNG_STR("Hello, World"),
+				LOG4CXXNG_LOCATION));
+		RateLimitFilterPtr filter(new RateLimitFilter());
+		filter->setRate(1);
+		filter->setBurst(3);
+		Pool p;
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event));
+	}
+
+	/**
+	 * Check that activating the options again installs a fresh table
+	 * sized by the new MaxSites.
+	 */
+	void testReactivate()
+	{
+		LoggingEventPtr event(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest"),
+				Level::getWarn(),
+				LOG4CXXNG_STR("Hello, World"),
+				LOG4CXXNG_LOCATION));
+		RateLimitFilterPtr filter(new RateLimitFilter());
+		filter->setRate(1);
+		filter->setBurst(1);
+		Pool p;
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event));
+		filter->setMaxSites(1);
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event));
+		filter->setMaxSites(0);
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+	}
+
+	/**
+	 * Check that the filter can be named in configuration files.
+	 */
+	void testForName()
+	{
+		const Class& clazz = Class::forName(LOG4CXXNG_STR("org.apache.log4j.filter.RateLimitFilter"));
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("RateLimitFilter"), clazz.getName());
+	}
+
+	/**
+	 * Check that call sites and loggers are limited independently.
+	 */
+	void testSites()
+	{
+		LoggingEventPtr event1(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest"),
+				Level::getWarn(),
+				LOG4CXXNG_STR("Hello, World"),
+				LOG4CXXNG_LOCATION));
+		LoggingEventPtr event2(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest"),
+				Level::getWarn(),
+				LOG4CXXNG_STR("Hello, World"),
+				LOG4CXXNG_LOCATION));
+		LoggingEventPtr event3(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.Filter::OtherTest"),
+				Level::getWarn(),
+				LOG4CXXNG_STR("Hello, World"),
+				event1->getLocationInformation()));
+		RateLimitFilterPtr filter(new RateLimitFilter());
+		filter->setOption(LOG4CXXNG_STR("Rate"), LOG4CXXNG_STR("1"));
+		filter->setOption(LOG4CXXNG_STR("Burst"), LOG4CXXNG_STR("1"));
+		Pool p;
+		filter->activateOptions(p);
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event1));
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event1));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event2));
+		LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event3));
+		LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event3));
+	}
+
+	/**
+	 * Check that 1 in N events is admitted without a rate.
+	 */
+	void testSampling()
+	{
+		LoggingEventPtr event(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest"),
+				Level::getWarn(),
+				LOG4CXXNG_STR("Hello, World"),
+				LOG4CXXNG_LOCATION));
+		RateLimitFilterPtr filter(new RateLimitFilter());
+		filter->setRate(0);
+		filter->setSampling(3);
+		Pool p;
+		filter->activateOptions(p);
+
+		for (int i = 0; i < 3; i++)
+		{
+			LOGUNIT_ASSERT_EQUAL(Filter::NEUTRAL, filter->decide(event));
+			LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event));
+			LOGUNIT_ASSERT_EQUAL(Filter::DENY, filter->decide(event));
+		}
+	}
+
+	/**
+	 * Check that suppressed events are reported once per summary interval.
+	 */
+	void testSummary()
+	{
+		RateLimiter limiter(1, 1, 0, 1000000);
+		log4cxxng_time_t start = 10000000;
+		LOGUNIT_ASSERT_EQUAL(true, limiter.tryAcquire(start));
+		LOGUNIT_ASSERT_EQUAL(false, limiter.tryAcquire(start + 1));
+		LOGUNIT_ASSERT_EQUAL(false, limiter.tryAcquire(start + 2));
+		LOGUNIT_ASSERT_EQUAL(2, (int) limiter.takeSuppressedCount(start + 3));
+		LOGUNIT_ASSERT_EQUAL(false, limiter.tryAcquire(start + 10));
+		LOGUNIT_ASSERT_EQUAL(0, (int) limiter.takeSuppressedCount(start + 11));
+		LOGUNIT_ASSERT_EQUAL(true, limiter.tryAcquire(start + 2000000));
+		LOGUNIT_ASSERT_EQUAL(1, (int) limiter.takeSuppressedCount(start + 2000000));
+	}
+
+	/**
+	 * Check that flushing logs a summary of the suppressed events.
+	 */
+	void testFlush()
+	{
+		LoggerPtr logger(Logger::getLogger(LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest.flush")));
+		VectorAppenderPtr appender(new VectorAppender());
+		RateLimitFilterPtr filter(new RateLimitFilter());
+		filter->setRate(1);
+		filter->setBurst(1);
+		filter->setSummaryInterval(3600);
+		Pool p;
+		filter->activateOptions(p);
+		appender->addFilter(filter);
+		logger->addAppender(appender);
+		logger->setAdditivity(false);
+
+		for (int i = 0; i < 5; i++)
+		{
+			LOG4CXXNG_WARN(logger, "message " << i);
+		}
+
+		filter->flush();
+		logger->removeAppender(appender);
+		const std::vector<LoggingEventPtr>& events(appender->getVector());
+		LOGUNIT_ASSERT_EQUAL((size_t) 2, events.size());
+		LogString count;
+		LOGUNIT_ASSERT(events[1]->getProperty(LOG4CXXNG_STR("log4cxx.suppressed"), count));
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("4"), count);
+		LOGUNIT_ASSERT_EQUAL((int) Level::WARN_INT, events[1]->getLevel()->toInt());
+	}
+
+	/**
+	 * Check that the macro rejects messages over the rate of its call site.
+	 */
+	void testMacro()
+	{
+		LoggerPtr logger(Logger::getLogger(LOG4CXXNG_STR("org.apache.log4j.Filter::RateLimitFilterTest")));
+		VectorAppenderPtr appender(new VectorAppender());
+		logger->addAppender(appender);
+		logger->setAdditivity(false);
+
+		for (int i = 0; i < 100; i++)
+		{
+			LOG4CXXNG_WARN_LIMITED(logger, "message " << i, 5);
+		}
+
+		logger->removeAppender(appender);
+		LOGUNIT_ASSERT_EQUAL((size_t) 5, appender->getVector().size());
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(RateLimitFilterTest);
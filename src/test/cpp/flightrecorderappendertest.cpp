@@ -0,0 +1,250 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/flightrecorderappender.h>
+#include <log4cxxNG/patternlayout.h>
+#include <log4cxxNG/file.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/helpers/thread.h>
+#include "logunit.h"
+#include <apr_atomic.h>
+#include <fstream>
+#include <sstream>
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+using namespace log4cxxng::spi;
+
+/**
+ *
+ * FlightRecorderAppender tests.
+ */
+LOGUNIT_CLASS(FlightRecorderAppenderTest)
+{
+	LOGUNIT_TEST_SUITE(FlightRecorderAppenderTest);
+	LOGUNIT_TEST(testDump);
+	LOGUNIT_TEST(testWrap);
+	LOGUNIT_TEST(testTrigger);
+#if APR_HAS_THREADS
+	LOGUNIT_TEST(testRingReuse);
+	LOGUNIT_TEST(testDumpWhileLogging);
+#endif
+	LOGUNIT_TEST_SUITE_END();
+
+	Pool p;
+
+	FlightRecorderAppenderPtr createAppender(const LogString& fileName, const LogString& triggerLevel)
+	{
+		File(fileName).deleteFile(p);
+		FlightRecorderAppenderPtr appender(new FlightRecorderAppender());
+		appender->setLayout(new PatternLayout(LOG4CXXNG_STR("%m%n")));
+		appender->setFile(fileName);
+		appender->setOption(LOG4CXXNG_STR("DumpOnSignal"), LOG4CXXNG_STR("false"));
+		appender->setOption(LOG4CXXNG_STR("TriggerLevel"), triggerLevel);
+		appender->activateOptions(p);
+		return appender;
+	}
+
+	void append(const FlightRecorderAppenderPtr & appender,
+		const LevelPtr & level, const LogString & message)
+	{
+		LoggingEventPtr event(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.FlightRecorderAppenderTest"),
+				level, message, LOG4CXXNG_LOCATION));
+		appender->doAppend(event, p);
+	}
+
+	static std::string read(const char* fileName)
+	{
+		std::ifstream in(fileName, std::ios::binary);
+		std::ostringstream content;
+		content << in.rdbuf();
+		return content.str();
+	}
+
+public:
+	/**
+	 * Tests that nothing is written until the recorder is dumped.
+	 */
+	void testDump()
+	{
+		FlightRecorderAppenderPtr appender(createAppender(
+				LOG4CXXNG_STR("output/flightrecorder.log"), LOG4CXXNG_STR("OFF")));
+		append(appender, Level::getDebug(), LOG4CXXNG_STR("one"));
+		append(appender, Level::getError(), LOG4CXXNG_STR("two"));
+		LOGUNIT_ASSERT_EQUAL(false, File(LOG4CXXNG_STR("output/flightrecorder.log")).exists(p));
+
+		LOGUNIT_ASSERT_EQUAL(true, appender->dump());
+		std::string content(read("output/flightrecorder.log"));
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, content.find("==> "));
+		LOGUNIT_ASSERT(content.find(" <==\none\ntwo\n") != std::string::npos);
+		appender->close();
+	}
+
+	/**
+	 * Tests that a full ring keeps whole recent events only.
+	 */
+	void testWrap()
+	{
+		FlightRecorderAppenderPtr appender(createAppender(
+				LOG4CXXNG_STR("output/flightrecorderwrap.log"), LOG4CXXNG_STR("OFF")));
+		appender->setBufferSize(64);
+		LogString message(LOG4CXXNG_STR("message 0"));
+
+		for (int i = 0; i < 10; i++)
+		{
+			message[8] = (logchar) (0x30 + i);
+			append(appender, Level::getDebug(), message);
+		}
+
+		LOGUNIT_ASSERT_EQUAL(true, appender->dump());
+		std::string content(read("output/flightrecorderwrap.log"));
+		size_t start = content.find(" <==\n");
+		LOGUNIT_ASSERT(start != std::string::npos);
+		std::string events(content.substr(start + 5));
+		LOGUNIT_ASSERT(events.length() <= 64);
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, events.find("message "));
+		LOGUNIT_ASSERT_EQUAL(events.length() - 10, events.find("message 9\n"));
+		LOGUNIT_ASSERT(events.find("message 0") == std::string::npos);
+		appender->close();
+	}
+
+	/**
+	 * Tests that an error dumps the recorder.
+	 */
+	void testTrigger()
+	{
+		FlightRecorderAppenderPtr appender(createAppender(
+				LOG4CXXNG_STR("output/flightrecordertrigger.log"), LOG4CXXNG_STR("ERROR")));
+		append(appender, Level::getInfo(), LOG4CXXNG_STR("before"));
+		LOGUNIT_ASSERT_EQUAL(false, File(LOG4CXXNG_STR("output/flightrecordertrigger.log")).exists(p));
+		append(appender, Level::getError(), LOG4CXXNG_STR("failure"));
+
+		// the dump is written in the background, close waits for it
+		appender->close();
+		std::string content(read("output/flightrecordertrigger.log"));
+		LOGUNIT_ASSERT(content.find("before\nfailure\n") != std::string::npos);
+	}
+
+#if APR_HAS_THREADS
+	/**
+	 * Tests that the ring of an exited thread is taken over by the next one.
+	 */
+	void testRingReuse()
+	{
+		FlightRecorderAppenderPtr appender(createAppender(
+				LOG4CXXNG_STR("output/flightrecorderreuse.log"), LOG4CXXNG_STR("OFF")));
+		Thread first;
+		first.run(appendFirst, appender);
+		first.join();
+		Thread second;
+		second.run(appendSecond, appender);
+		second.join();
+
+		LOGUNIT_ASSERT_EQUAL(true, appender->dump());
+		std::string content(read("output/flightrecorderreuse.log"));
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, content.find("==> "));
+		LOGUNIT_ASSERT_EQUAL(std::string::npos, content.find("==> ", 1));
+		LOGUNIT_ASSERT(content.find(" <==\nsecond\n") != std::string::npos);
+		LOGUNIT_ASSERT_EQUAL(std::string::npos, content.find("first"));
+		appender->close();
+	}
+
+	/**
+	 * Tests that a dump holds whole events while the ring keeps wrapping.
+	 */
+	void testDumpWhileLogging()
+	{
+		FlightRecorderAppenderPtr appender(createAppender(
+				LOG4CXXNG_STR("output/flightrecorderbusy.log"), LOG4CXXNG_STR("OFF")));
+		appender->setBufferSize(64);
+		Logging logging;
+		logging.appender = appender;
+		apr_atomic_set32(&logging.stop, 0);
+		Thread thread;
+		thread.run(appendUntilStopped, &logging);
+
+		for (int i = 0; i < 200; i++)
+		{
+			LOGUNIT_ASSERT_EQUAL(true, appender->dump());
+			std::string content(read("output/flightrecorderbusy.log"));
+			size_t start = content.find(" <==\n");
+			LOGUNIT_ASSERT(start != std::string::npos);
+
+			for (size_t line = start + 5; line < content.length(); line += 10)
+			{
+				LOGUNIT_ASSERT_EQUAL(std::string("message "), content.substr(line, 8));
+				LOGUNIT_ASSERT_EQUAL('\n', content[line + 9]);
+			}
+		}
+
+		apr_atomic_set32(&logging.stop, 1);
+		thread.join();
+		appender->close();
+	}
+
+private:
+	struct Logging
+	{
+		FlightRecorderAppender* appender;
+		volatile apr_uint32_t stop;
+	};
+
+	static void* LOG4CXXNG_THREAD_FUNC appendUntilStopped(apr_thread_t* /* thread */, void* data)
+	{
+		Logging* logging = (Logging*) data;
+		LogString message(LOG4CXXNG_STR("message 0"));
+		Pool pool;
+
+		for (int i = 0; apr_atomic_read32(&logging->stop) == 0; i++)
+		{
+			message[8] = (logchar) (0x30 + i % 10);
+			LoggingEventPtr event(new LoggingEvent(
+					LOG4CXXNG_STR("org.apache.log4j.FlightRecorderAppenderTest"),
+					Level::getInfo(), message, LOG4CXXNG_LOCATION));
+			logging->appender->doAppend(event, pool);
+		}
+
+		return 0;
+	}
+
+	static void appendFrom(void* data, const LogString& message)
+	{
+		FlightRecorderAppender* appender = (FlightRecorderAppender*) data;
+		LoggingEventPtr event(new LoggingEvent(
+				LOG4CXXNG_STR("org.apache.log4j.FlightRecorderAppenderTest"),
+				Level::getInfo(), message, LOG4CXXNG_LOCATION));
+		Pool pool;
+		appender->doAppend(event, pool);
+	}
+
+	static void* LOG4CXXNG_THREAD_FUNC appendFirst(apr_thread_t* /* thread */, void* data)
+	{
+		appendFrom(data, LOG4CXXNG_STR("first"));
+		return 0;
+	}
+
+	static void* LOG4CXXNG_THREAD_FUNC appendSecond(apr_thread_t* /* thread */, void* data)
+	{
+		appendFrom(data, LOG4CXXNG_STR("second"));
+		return 0;
+	}
+#endif
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(FlightRecorderAppenderTest);
@@ -40,6 +40,9 @@ LOGUNIT_CLASS(CharsetEncoderTestCase)
 	LOGUNIT_TEST(encode4);
 #if APR_HAS_THREADS
 	LOGUNIT_TEST(thread1);
+#if APR_HAS_XLATE
+	LOGUNIT_TEST(thread2);
+#endif
 #endif
 	LOGUNIT_TEST_SUITE_END();
 
@@ -313,10 +316,27 @@ public:
 	}
 
 	void thread1()
+	{
+		CharsetEncoderPtr enc(CharsetEncoder::getEncoder(LOG4CXXNG_STR("ISO-8859-1")));
+		runThreads(enc);
+	}
+
+#if APR_HAS_XLATE
+	/**
+	 *  ISO-8859-15 is encoded by apr_xlate, which must not share
+	 *  a conversion handle between threads.
+	 */
+	void thread2()
+	{
+		CharsetEncoderPtr enc(CharsetEncoder::getEncoder(LOG4CXXNG_STR("ISO-8859-15")));
+		runThreads(enc);
+	}
+#endif
+
+	void runThreads(CharsetEncoderPtr& enc)
 	{
 		enum { THREAD_COUNT = 10, THREAD_REPS = 10000 };
 		Thread threads[THREAD_COUNT];
-		CharsetEncoderPtr enc(CharsetEncoder::getEncoder(LOG4CXXNG_STR("ISO-8859-1")));
 		ThreadPackage* package = new ThreadPackage(enc, THREAD_REPS);
 		{
 			for (int i = 0; i < THREAD_COUNT; i++)
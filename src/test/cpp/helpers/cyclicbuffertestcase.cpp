@@ -22,7 +22,9 @@
 #include <log4cxxNG/logger.h>
 #include <log4cxxNG/spi/loggingevent.h>
 #include <log4cxxNG/spi/location/locationinfo.h>
+#include <log4cxxNG/helpers/thread.h>
 #include "../testchar.h"
+#include <set>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
@@ -36,6 +38,7 @@ LOGUNIT_CLASS(CyclicBufferTestCase)
 	LOGUNIT_TEST(test0);
 	LOGUNIT_TEST(test1);
 	LOGUNIT_TEST(testResize);
+	LOGUNIT_TEST(testConcurrentAddAndGet);
 	LOGUNIT_TEST_SUITE_END();
 
 	LoggerPtr logger;
@@ -167,6 +170,79 @@ public:
 			LOGUNIT_ASSERT_EQUAL(e[offset + j], cb.get(j));
 		}
 	}
+
+	struct Producer
+	{
+		CyclicBuffer* cb;
+		const LoggingEventPtr* events;
+		int count;
+	};
+
+	static void* LOG4CXXNG_THREAD_FUNC produce(apr_thread_t*, void* data)
+	{
+		Producer* producer = (Producer*) data;
+
+		for (int i = 0; i < producer->count; i++)
+		{
+			producer->cb->add(producer->events[i]);
+		}
+
+		return 0;
+	}
+
+	/**
+	 *  Several threads add to a small buffer while this thread drains it.
+	 *  No event may be seen twice and the buffer never grows past its size.
+	 */
+	void testConcurrentAddAndGet()
+	{
+		enum { PRODUCERS = 4, PER_PRODUCER = MAX / PRODUCERS };
+		CyclicBuffer cb(16);
+		Producer producers[PRODUCERS];
+		Thread threads[PRODUCERS];
+
+		for (int i = 0; i < PRODUCERS; i++)
+		{
+			producers[i].cb = &cb;
+			producers[i].events = &e[i * PER_PRODUCER];
+			producers[i].count = PER_PRODUCER;
+			threads[i].run(produce, &producers[i]);
+		}
+
+		std::set<LoggingEvent*> seen;
+		bool running = true;
+
+		while (running)
+		{
+			running = false;
+
+			for (int i = 0; i < PRODUCERS; i++)
+			{
+				running = running || threads[i].isAlive();
+			}
+
+			LOGUNIT_ASSERT(cb.length() <= cb.getMaxSize());
+
+			for (LoggingEventPtr event = cb.get(); event != 0; event = cb.get())
+			{
+				LOGUNIT_ASSERT(seen.insert(event).second);
+			}
+		}
+
+		for (int i = 0; i < PRODUCERS; i++)
+		{
+			threads[i].join();
+		}
+
+		for (LoggingEventPtr event = cb.get(); event != 0; event = cb.get())
+		{
+			LOGUNIT_ASSERT(seen.insert(event).second);
+		}
+
+		LOGUNIT_ASSERT(seen.size() <= (size_t) (PRODUCERS * PER_PRODUCER));
+		LOGUNIT_ASSERT(seen.size() >= (size_t) cb.getMaxSize());
+		LOGUNIT_ASSERT_EQUAL(0, cb.length());
+	}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(CyclicBufferTestCase);
@@ -18,6 +18,10 @@
 #include <log4cxxNG/helpers/filewatchdog.h>
 #include "../logunit.h"
 #include "apr_time.h"
+#include <apr_atomic.h>
+#include <apr_file_io.h>
+#include <stdio.h>
+#include <fstream>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
@@ -31,19 +35,31 @@ LOGUNIT_CLASS(FileWatchdogTest)
 {
 	LOGUNIT_TEST_SUITE(FileWatchdogTest);
 	LOGUNIT_TEST(testShutdownDelay);
+#if defined(__linux__)
+	LOGUNIT_TEST(testRenameNotified);
+#endif
 	LOGUNIT_TEST_SUITE_END();
 
 private:
 	class MockWatchdog : public FileWatchdog
 	{
 		public:
-			MockWatchdog(const File& file) : FileWatchdog(file)
+			MockWatchdog(const File& file) : FileWatchdog(file), changes(0)
 			{
 			}
 
 			void doOnChange()
 			{
+				apr_atomic_inc32(&changes);
 			}
+
+			unsigned int getChanges()
+			{
+				return apr_atomic_read32(&changes);
+			}
+
+		private:
+			volatile apr_uint32_t changes;
 	};
 
 public:
@@ -65,6 +81,40 @@ public:
 		LOGUNIT_ASSERT(delta < 30000000);
 	}
 
+#if defined(__linux__)
+	/**
+	 *  Tests that a file renamed over the watched file is picked up
+	 *  without waiting for the delay, even with an older modification time.
+	 */
+	void testRenameNotified()
+	{
+		Pool p;
+		{
+			std::ofstream config("output/filewatchdog.properties");
+			config << "log4j.rootLogger=INFO" << std::endl;
+		}
+		MockWatchdog dog(File(LOG4CXXNG_STR("output/filewatchdog.properties")));
+		dog.setDebounce(50);
+		dog.start();
+		LOGUNIT_ASSERT_EQUAL(1U, dog.getChanges());
+
+		{
+			std::ofstream config("output/filewatchdog.tmp");
+			config << "log4j.rootLogger=DEBUG" << std::endl;
+		}
+		apr_file_mtime_set("output/filewatchdog.tmp",
+			apr_time_now() - APR_USEC_PER_SEC * 3600, p.getAPRPool());
+		LOGUNIT_ASSERT_EQUAL(0, rename("output/filewatchdog.tmp", "output/filewatchdog.properties"));
+
+		for (int i = 0; i < 100 && dog.getChanges() < 2; i++)
+		{
+			apr_sleep(20000);
+		}
+
+		LOGUNIT_ASSERT_EQUAL(2U, dog.getChanges());
+	}
+#endif
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(FileWatchdogTest);
@@ -17,6 +17,8 @@
 
 #include <log4cxxNG/helpers/messagebuffer.h>
 #include <iomanip>
+#include <climits>
+#include <sstream>
 #include "../insertwide.h"
 #include "../logunit.h"
 #include <log4cxxNG/logstring.h>
@@ -28,6 +30,20 @@
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
+namespace
+{
+struct Point
+{
+	int x;
+	int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& point)
+{
+	return os << '(' << point.x << ", " << point.y << ')';
+}
+}
+
 /**
  *  Test MessageBuffer.
  */
@@ -40,6 +56,11 @@ LOGUNIT_CLASS(MessageBufferTest)
 	LOGUNIT_TEST(testInsertString);
 	LOGUNIT_TEST(testInsertNull);
 	LOGUNIT_TEST(testInsertInt);
+	LOGUNIT_TEST(testInsertEndl);
+	LOGUNIT_TEST(testInsertNumbers);
+	LOGUNIT_TEST(testInsertFloatingPoint);
+	LOGUNIT_TEST(testInsertUserType);
+	LOGUNIT_TEST(testInsertLongMessage);
 	LOGUNIT_TEST(testInsertManipulator);
 #if LOG4CXXNG_WCHAR_T_API
 	LOGUNIT_TEST(testInsertConstWStr);
@@ -117,6 +138,60 @@ public:
 		LOGUNIT_ASSERT_EQUAL(true, buf.hasStream());
 	}
 
+	void testInsertEndl()
+	{
+		MessageBuffer buf;
+		std::ostringstream expected;
+		expected << "n=" << 5 << std::endl << "done";
+		int n = 5;
+		CharMessageBuffer& retval = buf << "n=" << n << std::endl << "done";
+		LOGUNIT_ASSERT_EQUAL(expected.str(), buf.str(retval));
+		LOGUNIT_ASSERT_EQUAL(true, buf.hasStream());
+	}
+
+	void testInsertNumbers()
+	{
+		MessageBuffer buf;
+		std::ostringstream expected;
+		expected << (short) -12 << ' ' << 0 << ' ' << LONG_MIN << ' '
+			<< ULONG_MAX << ' ' << UINT_MAX << ' ' << true;
+		CharMessageBuffer& retval = buf << (short) -12 << ' ' << 0 << ' ' << LONG_MIN << ' '
+			<< ULONG_MAX << ' ' << UINT_MAX << ' ' << true;
+		LOGUNIT_ASSERT_EQUAL(expected.str(), buf.str(retval));
+		LOGUNIT_ASSERT_EQUAL(false, buf.hasStream());
+	}
+
+	void testInsertFloatingPoint()
+	{
+		MessageBuffer buf;
+		std::ostringstream expected;
+		expected << 3.1415926 << ' ' << 0.5f << ' ' << -1e-5 << ' ' << 1234567.0 << ' ' << 0.0;
+		CharMessageBuffer& retval = buf << 3.1415926 << ' ' << 0.5f << ' ' << -1e-5 << ' ' << 1234567.0 << ' ' << 0.0;
+		LOGUNIT_ASSERT_EQUAL(expected.str(), buf.str(retval));
+		LOGUNIT_ASSERT_EQUAL(false, buf.hasStream());
+	}
+
+	void testInsertUserType()
+	{
+		MessageBuffer buf;
+		std::string greeting("id=5 at (1, 2) took 7ms");
+		Point point = { 1, 2 };
+		std::ostream& retval = buf << "id=" << 5 << " at " << point << " took " << 7 << "ms";
+		LOGUNIT_ASSERT_EQUAL(greeting, buf.str(retval));
+		LOGUNIT_ASSERT_EQUAL(true, buf.hasStream());
+	}
+
+	void testInsertLongMessage()
+	{
+		MessageBuffer buf;
+		std::string text(300, 'x');
+		std::ostringstream expected;
+		expected << "id=" << 5 << ' ' << text << ' ' << 7;
+		CharMessageBuffer& retval = buf << "id=" << 5 << ' ' << text << ' ' << 7;
+		LOGUNIT_ASSERT_EQUAL(expected.str(), buf.str(retval));
+		LOGUNIT_ASSERT_EQUAL(false, buf.hasStream());
+	}
+
 	void testInsertManipulator()
 	{
 		MessageBuffer buf;
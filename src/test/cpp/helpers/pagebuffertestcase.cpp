@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/helpers/pagebuffer.h>
+#include "../logunit.h"
+#include <string.h>
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+
+
+/**
+   Unit test for PageBuffer.
+
+   */
+LOGUNIT_CLASS(PageBufferTestCase)
+{
+	LOGUNIT_TEST_SUITE(PageBufferTestCase);
+	LOGUNIT_TEST(testSmall);
+	LOGUNIT_TEST(testLarge);
+	LOGUNIT_TEST(testRelease);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	/**
+	 * Small buffers come from the heap and are reused.
+	 */
+	void testSmall()
+	{
+		PageBuffer buffer;
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, buffer.capacity());
+		char* data = buffer.reserve(100);
+		LOGUNIT_ASSERT(data != 0);
+		LOGUNIT_ASSERT_EQUAL((size_t) 100, buffer.capacity());
+		LOGUNIT_ASSERT_EQUAL(false, buffer.isHugePage());
+		memset(data, 'x', 100);
+		LOGUNIT_ASSERT(data == buffer.reserve(50));
+		buffer.reserve(120);
+		LOGUNIT_ASSERT_EQUAL((size_t) 200, buffer.capacity());
+	}
+
+	/**
+	 * Large buffers are aligned on huge pages when mapped.
+	 */
+	void testLarge()
+	{
+		PageBuffer buffer;
+		size_t capacity = 3 * PageBuffer::HUGE_PAGE_SIZE / 2;
+		char* data = buffer.reserve(capacity);
+		LOGUNIT_ASSERT(buffer.capacity() >= capacity);
+		memset(data, 'x', buffer.capacity());
+
+		if (buffer.isHugePage())
+		{
+			LOGUNIT_ASSERT_EQUAL((size_t) 0, (size_t) data % PageBuffer::HUGE_PAGE_SIZE);
+			LOGUNIT_ASSERT_EQUAL((size_t) 0, buffer.capacity() % PageBuffer::HUGE_PAGE_SIZE);
+		}
+	}
+
+	/**
+	 * A released buffer is empty and can be reserved again.
+	 */
+	void testRelease()
+	{
+		PageBuffer buffer;
+		buffer.reserve(PageBuffer::HUGE_PAGE_SIZE);
+		buffer.release();
+		LOGUNIT_ASSERT_EQUAL((size_t) 0, buffer.capacity());
+		LOGUNIT_ASSERT(buffer.data() == 0);
+		LOGUNIT_ASSERT_EQUAL(false, buffer.isHugePage());
+		char* data = buffer.reserve(100);
+		LOGUNIT_ASSERT(data != 0);
+		LOGUNIT_ASSERT_EQUAL((size_t) 100, buffer.capacity());
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(PageBufferTestCase);
@@ -32,6 +32,7 @@ LOGUNIT_CLASS(ThreadTestCase)
 {
 	LOGUNIT_TEST_SUITE(ThreadTestCase);
 	LOGUNIT_TEST(testInterrupt);
+	LOGUNIT_TEST(testAffinity);
 	LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -52,6 +53,25 @@ public:
 		LOGUNIT_ASSERT(elapsed < 1000000);
 	}
 
+	/**
+	 * Binds the current thread to the first processor and back.
+	 */
+	void testAffinity()
+	{
+		LOGUNIT_ASSERT_EQUAL(false, Thread::setCurrentThreadAffinity(LOG4CXXNG_STR("0-")));
+		LOGUNIT_ASSERT_EQUAL(false, Thread::setCurrentThreadAffinity(LOG4CXXNG_STR("3-1")));
+		LOGUNIT_ASSERT_EQUAL(false, Thread::setCurrentThreadAffinity(LOG4CXXNG_STR("0;1")));
+
+		//
+		//   binding is not supported everywhere
+		//
+		if (Thread::setCurrentThreadAffinity(LOG4CXXNG_STR("")))
+		{
+			LOGUNIT_ASSERT_EQUAL(true, Thread::setCurrentThreadAffinity(LOG4CXXNG_STR(" 0 , 0-0")));
+			LOGUNIT_ASSERT_EQUAL(true, Thread::setCurrentThreadAffinity(LOG4CXXNG_STR("")));
+		}
+	}
+
 private:
 	static void* LOG4CXXNG_THREAD_FUNC sleep(apr_thread_t* thread, void* data)
 	{
@@ -16,6 +16,7 @@
  */
 
 #include <log4cxxNG/helpers/transcoder.h>
+#include <string.h>
 #include "../insertwide.h"
 #include "../logunit.h"
 
@@ -53,6 +54,8 @@ LOGUNIT_CLASS(TranscoderTestCase)
 	LOGUNIT_TEST(testDecodeUTF8_2);
 	LOGUNIT_TEST(testDecodeUTF8_3);
 	LOGUNIT_TEST(testDecodeUTF8_4);
+	LOGUNIT_TEST(testDecodeUTF8_5);
+	LOGUNIT_TEST(testAsciiLength);
 #if LOG4CXXNG_UNICHAR_API
 	LOGUNIT_TEST(udecode2);
 	LOGUNIT_TEST(udecode4);
@@ -268,6 +271,58 @@ public:
 		LOGUNIT_ASSERT_EQUAL(true, iter == out.end());
 	}
 
+	/**
+	 *  Places a two byte character at every offset of strings long
+	 *  enough to cross the 16 and 32 byte blocks of the ASCII scan.
+	 */
+	void testDecodeUTF8_5()
+	{
+		for (size_t len = 0; len < 70; len++)
+		{
+			for (size_t pos = 0; pos < len; pos++)
+			{
+				std::string src(len, 'x');
+				src.insert(pos, "\xC2\xA9");
+				LogString out;
+				Transcoder::decodeUTF8(src, out);
+				LOGUNIT_ASSERT_EQUAL(len + 1, countCodePoints(out));
+				LogString::const_iterator iter = out.begin() + pos;
+				LOGUNIT_ASSERT_EQUAL((unsigned int) 0xA9, Transcoder::decode(out, iter));
+			}
+		}
+	}
+
+	static size_t countCodePoints(const LogString& str)
+	{
+		size_t count = 0;
+
+		for (LogString::const_iterator iter = str.begin(); iter != str.end(); count++)
+		{
+			Transcoder::decode(str, iter);
+		}
+
+		return count;
+	}
+
+	void testAsciiLength()
+	{
+		char buf[100];
+
+		for (size_t len = 0; len < sizeof(buf); len++)
+		{
+			memset(buf, 'a', sizeof(buf));
+			LOGUNIT_ASSERT_EQUAL(len, Transcoder::asciiLength(buf, len));
+
+			for (size_t pos = 0; pos < len; pos++)
+			{
+				memset(buf, 'a', sizeof(buf));
+				buf[pos] = (char) 0x80;
+				LOGUNIT_ASSERT_EQUAL(pos, Transcoder::asciiLength(buf, len));
+				LOGUNIT_ASSERT_EQUAL((size_t) 0, Transcoder::asciiLength(buf + pos, len - pos));
+			}
+		}
+	}
+
 
 #if LOG4CXXNG_UNICHAR_API
 	void udecode2()
@@ -18,10 +18,16 @@
 
 #include <log4cxxNG/logger.h>
 #include <log4cxxNG/hierarchy.h>
+#include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/file.h>
 #include "logunit.h"
 #include "insertwide.h"
+#include "vectorappender.h"
+#include <fstream>
+#include <sstream>
 
 using namespace log4cxxng;
+using namespace log4cxxng::helpers;
 
 /**
  * Tests hierarchy.
@@ -31,6 +37,7 @@ LOGUNIT_CLASS(HierarchyTest)
 {
 	LOGUNIT_TEST_SUITE(HierarchyTest);
 	LOGUNIT_TEST(testGetParent);
+	LOGUNIT_TEST(testAppenderMetrics);
 	LOGUNIT_TEST_SUITE_END();
 public:
 
@@ -53,6 +60,59 @@ public:
 			logger2->getParent()->getName());
 	}
 
+	/**
+	 * Tests that appender metrics can be taken and written.
+	 */
+	void testAppenderMetrics()
+	{
+		LoggerPtr logger(Logger::getLogger("HierarchyTest_testAppenderMetrics"));
+		VectorAppenderPtr appender(new VectorAppender());
+		appender->setName(LOG4CXXNG_STR("metricsVector"));
+		appender->setThreshold(Level::getInfo());
+		logger->addAppender(appender);
+		VectorAppenderPtr sameName(new VectorAppender());
+		sameName->setName(LOG4CXXNG_STR("metricsVector"));
+		logger->addAppender(sameName);
+		LOG4CXXNG_DEBUG(logger, "below threshold");
+		LOG4CXXNG_INFO(logger, "first");
+		LOG4CXXNG_WARN(logger, "second");
+
+		HierarchyPtr hierarchy(LogManager::getLoggerRepository());
+		std::map<LogString, AppenderMetrics::Snapshot> metrics;
+		hierarchy->getAppenderMetrics(metrics);
+		std::map<LogString, AppenderMetrics::Snapshot>::const_iterator found =
+			metrics.find(LOG4CXXNG_STR("metricsVector"));
+		LOGUNIT_ASSERT(found != metrics.end());
+		LOGUNIT_ASSERT_EQUAL(3ULL, found->second.counters[AppenderMetrics::EVENTS_IN]);
+		LOGUNIT_ASSERT_EQUAL(2ULL, found->second.counters[AppenderMetrics::EVENTS_OUT]);
+		LOGUNIT_ASSERT_EQUAL(2ULL, found->second.getWriteCount());
+		found = metrics.find(LOG4CXXNG_STR("metricsVector#2"));
+		LOGUNIT_ASSERT(found != metrics.end());
+		LOGUNIT_ASSERT_EQUAL(3ULL, found->second.counters[AppenderMetrics::EVENTS_OUT]);
+
+		Pool p;
+		File(LOG4CXXNG_STR("output")).mkdirs(p);
+		LOGUNIT_ASSERT(hierarchy->writeMetrics(File(LOG4CXXNG_STR("output/metrics.prom"))));
+		logger->removeAppender(appender);
+		logger->removeAppender(sameName);
+
+		std::ifstream in("output/metrics.prom");
+		std::stringstream contents;
+		contents << in.rdbuf();
+		LOGUNIT_ASSERT(contents.str().find(
+				"log4cxx_appender_events_in_total{appender=\"metricsVector\"} 3\n")
+			!= std::string::npos);
+		LOGUNIT_ASSERT(contents.str().find(
+				"log4cxx_appender_write_latency_seconds_count{appender=\"metricsVector\"} 2\n")
+			!= std::string::npos);
+		LOGUNIT_ASSERT(contents.str().find(
+				"log4cxx_appender_write_latency_seconds_bucket{appender=\"metricsVector\",le=\"0.000000256\"} ")
+			!= std::string::npos);
+		LOGUNIT_ASSERT(contents.str().find(
+				"log4cxx_appender_events_out_total{appender=\"metricsVector#2\"} 3\n")
+			!= std::string::npos);
+	}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(HierarchyTest);
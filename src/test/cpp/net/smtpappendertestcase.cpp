@@ -25,6 +25,8 @@
 #include <log4cxxNG/xml/domconfigurator.h>
 #include <log4cxxNG/logmanager.h>
 #include <log4cxxNG/ttcclayout.h>
+#include <log4cxxNG/helpers/exception.h>
+#include <apr_portable.h>
 
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
@@ -65,6 +67,35 @@ class MockTriggeringEventEvaluator :
 
 IMPLEMENT_LOG4CXXNG_OBJECT(MockTriggeringEventEvaluator)
 
+namespace
+{
+/**
+ *  Layout that records the thread formatting a message and then fails
+ *  it, so that no SMTP session is ever opened.
+ */
+class RecordingLayout : public TTCCLayout
+{
+	public:
+		RecordingLayout() : headers(0)
+		{
+		}
+
+		void appendHeader(LogString&, Pool&)
+		{
+			formatter = apr_os_thread_current();
+			headers++;
+		}
+
+		void appendFooter(LogString&, Pool&)
+		{
+			throw IllegalStateException();
+		}
+
+		apr_os_thread_t formatter;
+		int headers;
+};
+}
+
 
 /**
    Unit tests of log4cxxng::SocketAppender
@@ -79,6 +110,9 @@ class SMTPAppenderTestCase : public AppenderSkeletonTestCase
 		LOGUNIT_TEST(testSetOptionThreshold);
 		LOGUNIT_TEST(testTrigger);
 		LOGUNIT_TEST(testInvalid);
+#if APR_HAS_THREADS
+		LOGUNIT_TEST(testTriggerNotInline);
+#endif
 		LOGUNIT_TEST_SUITE_END();
 
 
@@ -124,6 +158,34 @@ class SMTPAppenderTestCase : public AppenderSkeletonTestCase
 			LOG4CXXNG_ERROR(root, "Sending Message")
 		}
 
+#if APR_HAS_THREADS
+		/**
+		 * A triggering event is only buffered on the logging thread,
+		 * the message is formatted and sent by the sender thread.
+		 */
+		void testTriggerNotInline()
+		{
+			SMTPAppenderPtr appender(new SMTPAppender());
+			appender->setSMTPHost(LOG4CXXNG_STR("localhost"));
+			appender->setTo(LOG4CXXNG_STR("you@example.invalid"));
+			appender->setFrom(LOG4CXXNG_STR("me@example.invalid"));
+			RecordingLayout* layout = new RecordingLayout();
+			appender->setLayout(layout);
+			Pool p;
+			appender->activateOptions(p);
+			LoggerPtr logger(Logger::getLogger("SMTPAppenderTestCase.trigger"));
+			logger->setAdditivity(false);
+			logger->addAppender(appender);
+
+			LOG4CXXNG_ERROR(logger, "Triggering event");
+			// close() waits for the requested message
+			appender->close();
+			logger->removeAllAppenders();
+			LOGUNIT_ASSERT_EQUAL(1, layout->headers);
+			LOGUNIT_ASSERT(!apr_os_thread_equal(layout->formatter, apr_os_thread_current()));
+		}
+#endif
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(SMTPAppenderTestCase);
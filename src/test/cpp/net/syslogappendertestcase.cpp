@@ -17,11 +17,35 @@
 
 #include <log4cxxNG/helpers/datagramsocket.h>
 #include <log4cxxNG/net/syslogappender.h>
+#include <log4cxxNG/patternlayout.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/helpers/pool.h>
 #include "../appenderskeletontestcase.h"
 
+#if !defined(LOG4CXXNG)
+	#define LOG4CXXNG 1
+#endif
+#include <log4cxxNG/private/log4cxxNG_private.h>
+
 using namespace log4cxxng;
 using namespace log4cxxng::helpers;
 
+namespace
+{
+/**
+ *  Exposes whether events go to the local syslog function.
+ */
+class LocalSyslogAppender : public log4cxxng::net::SyslogAppender
+{
+	public:
+		bool usesLocalSyslog() const
+		{
+			return sw == 0 && localSyslog;
+		}
+};
+}
+
 /**
    Unit tests of log4cxxng::SyslogAppender
  */
@@ -33,6 +57,11 @@ class SyslogAppenderTestCase : public AppenderSkeletonTestCase
 		//
 		LOGUNIT_TEST(testDefaultThreshold);
 		LOGUNIT_TEST(testSetOptionThreshold);
+		LOGUNIT_TEST(testSetOptionTransport);
+		LOGUNIT_TEST(testSetOptionInvalidTransport);
+#if LOG4CXXNG_HAVE_SYSLOG
+		LOGUNIT_TEST(testNoHostUsesLocalSyslog);
+#endif
 
 		LOGUNIT_TEST_SUITE_END();
 
@@ -43,6 +72,57 @@ class SyslogAppenderTestCase : public AppenderSkeletonTestCase
 		{
 			return new log4cxxng::net::SyslogAppender();
 		}
+
+		void testSetOptionTransport()
+		{
+			log4cxxng::net::SyslogAppenderPtr appender(new log4cxxng::net::SyslogAppender());
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("UDP"), appender->getProtocol());
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("BSD"), appender->getFormat());
+			LOGUNIT_ASSERT_EQUAL(1, appender->getBatchSize());
+
+			appender->setOption(LOG4CXXNG_STR("Protocol"), LOG4CXXNG_STR("tcp"));
+			appender->setOption(LOG4CXXNG_STR("Format"), LOG4CXXNG_STR("rfc5424"));
+			appender->setOption(LOG4CXXNG_STR("BatchSize"), LOG4CXXNG_STR("64"));
+			appender->setOption(LOG4CXXNG_STR("AppName"), LOG4CXXNG_STR("unittest"));
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("TCP"), appender->getProtocol());
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("RFC5424"), appender->getFormat());
+			LOGUNIT_ASSERT_EQUAL(64, appender->getBatchSize());
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("unittest"), appender->getAppName());
+		}
+
+		void testSetOptionInvalidTransport()
+		{
+			log4cxxng::net::SyslogAppenderPtr appender(new log4cxxng::net::SyslogAppender());
+			appender->setOption(LOG4CXXNG_STR("Protocol"), LOG4CXXNG_STR("sctp"));
+			appender->setOption(LOG4CXXNG_STR("Format"), LOG4CXXNG_STR("json"));
+			appender->setOption(LOG4CXXNG_STR("BatchSize"), LOG4CXXNG_STR("-5"));
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("UDP"), appender->getProtocol());
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("BSD"), appender->getFormat());
+			LOGUNIT_ASSERT_EQUAL(1, appender->getBatchSize());
+		}
+
+		/**
+		 *  An appender without a SyslogHost writes through syslog(3),
+		 *  whatever the protocol.
+		 */
+		void testNoHostUsesLocalSyslog()
+		{
+			LocalSyslogAppender* local = new LocalSyslogAppender();
+			log4cxxng::net::SyslogAppenderPtr appender(local);
+			appender->setLayout(LayoutPtr(new PatternLayout(LOG4CXXNG_STR("%m"))));
+			Pool p;
+			appender->activateOptions(p);
+			LOGUNIT_ASSERT_EQUAL(true, local->usesLocalSyslog());
+
+			appender->setOption(LOG4CXXNG_STR("Protocol"), LOG4CXXNG_STR("tcp"));
+			LOGUNIT_ASSERT_EQUAL(true, local->usesLocalSyslog());
+
+			spi::LoggingEventPtr event(new spi::LoggingEvent(
+					LOG4CXXNG_STR("org.apache.log4j.net.SyslogAppenderTestCase"),
+					Level::getDebug(), LOG4CXXNG_STR("no host"), LOG4CXXNG_LOCATION));
+			appender->doAppend(event, p);
+			appender->close();
+		}
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(SyslogAppenderTestCase);
@@ -17,6 +17,8 @@
 
 #include <log4cxxNG/net/telnetappender.h>
 #include <log4cxxNG/ttcclayout.h>
+#include <log4cxxNG/helpers/socket.h>
+#include <log4cxxNG/helpers/inetaddress.h>
 #include "../appenderskeletontestcase.h"
 #include <apr_thread_proc.h>
 #include <apr_time.h>
@@ -40,6 +42,8 @@ class TelnetAppenderTestCase : public AppenderSkeletonTestCase
 		LOGUNIT_TEST(testActivateClose);
 		LOGUNIT_TEST(testActivateSleepClose);
 		LOGUNIT_TEST(testActivateWriteClose);
+		LOGUNIT_TEST(testSetOptionFanout);
+		LOGUNIT_TEST(testStalledClientDoesNotBlock);
 
 		LOGUNIT_TEST_SUITE_END();
 
@@ -91,6 +95,59 @@ class TelnetAppenderTestCase : public AppenderSkeletonTestCase
 			appender->close();
 		}
 
+		void testSetOptionFanout()
+		{
+			TelnetAppenderPtr appender(new TelnetAppender());
+			appender->setOption(LOG4CXXNG_STR("ClientBufferSize"), LOG4CXXNG_STR("4096"));
+			appender->setOption(LOG4CXXNG_STR("LaggardPolicy"), LOG4CXXNG_STR("Disconnect"));
+			LOGUNIT_ASSERT_EQUAL(4096, appender->getClientBufferSize());
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("Disconnect"), appender->getLaggardPolicy());
+			appender->setOption(LOG4CXXNG_STR("LaggardPolicy"), LOG4CXXNG_STR("drop"));
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("Drop"), appender->getLaggardPolicy());
+		}
+
+		/**
+		 *  A client that never reads must not block logging,
+		 *  messages beyond its buffer are dropped and counted.
+		 */
+		void testStalledClientDoesNotBlock()
+		{
+			TelnetAppenderPtr appender(new TelnetAppender());
+			appender->setLayout(new TTCCLayout());
+			appender->setPort(TEST_PORT);
+			appender->setClientBufferSize(4096);
+			Pool p;
+			appender->activateOptions(p);
+
+			InetAddressPtr addr(InetAddress::getByName(LOG4CXXNG_STR("127.0.0.1")));
+			SocketPtr client(new Socket(addr, TEST_PORT));
+
+			for (int i = 0; i < 50 && appender->getClientStatistics().empty(); i++)
+			{
+				Thread::sleep(100);
+			}
+
+			LOGUNIT_ASSERT_EQUAL((size_t) 1, appender->getClientStatistics().size());
+
+			LoggerPtr logger(Logger::getLogger("org.apache.log4j.net.TelnetAppenderTestCase"));
+			logger->setAdditivity(false);
+			logger->addAppender(appender);
+			std::string payload(1024, 'x');
+
+			for (int i = 0; i < 20000; i++)
+			{
+				LOG4CXXNG_INFO(logger, payload);
+			}
+
+			LOGUNIT_ASSERT(appender->getDroppedCount() > 0);
+			LOGUNIT_ASSERT_EQUAL(appender->getDroppedCount(),
+				appender->getClientStatistics()[0].droppedMessages);
+
+			logger->removeAppender(appender);
+			appender->close();
+			client->close();
+		}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(TelnetAppenderTestCase);
@@ -71,6 +71,7 @@ LOGUNIT_CLASS(PatternParserTestCase)
 	LOGUNIT_TEST(testBasic1);
 	LOGUNIT_TEST(testBasic2);
 	LOGUNIT_TEST(testMultiOption);
+	LOGUNIT_TEST(testCachedAbbreviation);
 	LOGUNIT_TEST_SUITE_END();
 
 	LoggingEventPtr event;
@@ -243,6 +244,27 @@ public:
 			expected);
 	}
 
+	/**
+	 * Abbreviated names of events created by a logger are cached
+	 * by the logger and must match the uncached result.
+	 */
+	void testCachedAbbreviation()
+	{
+		LoggerPtr logger(Logger::getLogger(LOG4CXXNG_STR("org.apache.log4j.pattern.PatternParserTestCase")));
+		LogString pattern(LOG4CXXNG_STR("%c{1} %c{2} %c{1.} %c"));
+		LogString expected(LOG4CXXNG_STR("PatternParserTestCase pattern.PatternParserTestCase ")
+			LOG4CXXNG_STR("o.a.l.p.PatternParserTestCase org.apache.log4j.pattern.PatternParserTestCase"));
+
+		event = new LoggingEvent(logger->getName(), Level::getInfo(),
+			LOG4CXXNG_STR("msg 1"), LOG4CXXNG_LOCATION);
+		assertFormattedEquals(pattern, getFormatSpecifiers(), expected);
+
+		event = LoggingEvent::create(*logger, Level::getInfo(),
+				LOG4CXXNG_STR("msg 1"), LOG4CXXNG_LOCATION);
+		assertFormattedEquals(pattern, getFormatSpecifiers(), expected);
+		assertFormattedEquals(pattern, getFormatSpecifiers(), expected);
+	}
+
 };
 
 //
@@ -18,6 +18,8 @@
 #include <log4cxxNG/helpers/properties.h>
 #include <log4cxxNG/propertyconfigurator.h>
 #include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/hierarchy.h>
+#include <log4cxxNG/helpers/thread.h>
 #include "vectorappender.h"
 #include "logunit.h"
 
@@ -31,8 +33,15 @@ LOGUNIT_CLASS(PropertyConfiguratorTest)
 	LOGUNIT_TEST(testInherited);
 	LOGUNIT_TEST(testNull);
 	LOGUNIT_TEST(testAppenderThreshold);
+	LOGUNIT_TEST(testReloadReusesUnchangedAppender);
+	LOGUNIT_TEST(testReloadReplacesChangedAppender);
+#if APR_HAS_THREADS
+	LOGUNIT_TEST(testReloadWhileLogging);
+#endif
 	LOGUNIT_TEST_SUITE_END();
 
+	enum { EVENT_COUNT = 20000 };
+
 public:
 	void testInherited()
 	{
@@ -85,6 +94,92 @@ public:
 		LogManager::resetConfiguration();
 	}
 
+	void testReloadReusesUnchangedAppender()
+	{
+		HierarchyPtr hierarchy(LogManager::getLoggerRepository());
+		LOGUNIT_ASSERT(hierarchy != 0);
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("WARN,VECTOR1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR1"), LOG4CXXNG_STR("org.apache.log4j.VectorAppender"));
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR1.threshold"), LOG4CXXNG_STR("WARN"));
+		PropertyConfigurator::configure(props);
+		unsigned int epoch = hierarchy->getConfigurationEpoch();
+		LoggerPtr root(Logger::getRootLogger());
+		VectorAppenderPtr first(root->getAppender(LOG4CXXNG_STR("VECTOR1")));
+
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("INFO,VECTOR1"));
+		PropertyConfigurator::configure(props);
+		VectorAppenderPtr second(root->getAppender(LOG4CXXNG_STR("VECTOR1")));
+		LOGUNIT_ASSERT(first == second);
+		LOGUNIT_ASSERT(!first->isClosed());
+		LOGUNIT_ASSERT_EQUAL((int) Level::INFO_INT, root->getLevel()->toInt());
+		LOGUNIT_ASSERT_EQUAL(epoch + 1, hierarchy->getConfigurationEpoch());
+		LogManager::resetConfiguration();
+		LOGUNIT_ASSERT(first->isClosed());
+	}
+
+	void testReloadReplacesChangedAppender()
+	{
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("ALL,VECTOR1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR1"), LOG4CXXNG_STR("org.apache.log4j.VectorAppender"));
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR1.threshold"), LOG4CXXNG_STR("WARN"));
+		PropertyConfigurator::configure(props);
+		LoggerPtr root(Logger::getRootLogger());
+		VectorAppenderPtr first(root->getAppender(LOG4CXXNG_STR("VECTOR1")));
+
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR1.threshold"), LOG4CXXNG_STR("ERROR"));
+		PropertyConfigurator::configure(props);
+		VectorAppenderPtr second(root->getAppender(LOG4CXXNG_STR("VECTOR1")));
+		LOGUNIT_ASSERT(first != second);
+		LOGUNIT_ASSERT(first->isClosed());
+		LOGUNIT_ASSERT(!second->isClosed());
+		LOGUNIT_ASSERT_EQUAL((int) Level::ERROR_INT, second->getThreshold()->toInt());
+		LogManager::resetConfiguration();
+	}
+
+#if APR_HAS_THREADS
+	/**
+	 * Tests that no event is lost while the configuration is reloaded
+	 * under a logging thread.
+	 */
+	void testReloadWhileLogging()
+	{
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("INFO,VECTOR1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR1"), LOG4CXXNG_STR("org.apache.log4j.VectorAppender"));
+		props.put(LOG4CXXNG_STR("log4j.appender.VECTOR2"), LOG4CXXNG_STR("org.apache.log4j.VectorAppender"));
+		PropertyConfigurator::configure(props);
+		VectorAppenderPtr appender(Logger::getRootLogger()->getAppender(LOG4CXXNG_STR("VECTOR1")));
+		Thread logging;
+		logging.run(logEvents, 0);
+
+		for (int i = 0; i < 50; i++)
+		{
+			props.put(LOG4CXXNG_STR("log4j.logger.org.apache.log4j.Other"),
+				i % 2 == 0 ? LOG4CXXNG_STR("WARN,VECTOR2") : LOG4CXXNG_STR("ERROR,VECTOR2"));
+			PropertyConfigurator::configure(props);
+		}
+
+		logging.join();
+		LOGUNIT_ASSERT(appender == Logger::getRootLogger()->getAppender(LOG4CXXNG_STR("VECTOR1")));
+		LOGUNIT_ASSERT_EQUAL((size_t) EVENT_COUNT, appender->getVector().size());
+		LogManager::resetConfiguration();
+	}
+
+private:
+	static void* LOG4CXXNG_THREAD_FUNC logEvents(apr_thread_t* /* thread */, void* /* data */)
+	{
+		LoggerPtr logger(Logger::getLogger("org.apache.log4j.PropertyConfiguratorTest"));
+
+		for (int i = 0; i < EVENT_COUNT; i++)
+		{
+			LOG4CXXNG_INFO(logger, "request " << i << " completed");
+		}
+
+		return 0;
+	}
+#endif
 };
 
 
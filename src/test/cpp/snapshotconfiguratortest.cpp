@@ -0,0 +1,175 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxxNG/snapshotconfigurator.h>
+#include <log4cxxNG/helpers/properties.h>
+#include <log4cxxNG/helpers/fileinputstream.h>
+#include <log4cxxNG/helpers/pool.h>
+#include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/fileappender.h>
+#include <apr_env.h>
+#include <fstream>
+#include "logunit.h"
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+
+
+LOGUNIT_CLASS(SnapshotConfiguratorTest)
+{
+	LOGUNIT_TEST_SUITE(SnapshotConfiguratorTest);
+	LOGUNIT_TEST(testVariables);
+	LOGUNIT_TEST(testEnvironment);
+	LOGUNIT_TEST(testConfigure);
+	LOGUNIT_TEST(testConfigureXML);
+	LOGUNIT_TEST(testStale);
+	LOGUNIT_TEST(testUndefinedAppender);
+	LOGUNIT_TEST(testUnknownClass);
+	LOGUNIT_TEST(testNotASnapshot);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown()
+	{
+		Pool p;
+		apr_env_delete("SNAPSHOT_TEST_DIR", p.getAPRPool());
+		LogManager::resetConfiguration();
+	}
+
+	void testVariables()
+	{
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("DEBUG, A1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1"), LOG4CXXNG_STR("org.apache.log4j.FileAppender"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1.File"), LOG4CXXNG_STR("output/${snapshot.dir}/snapshot.A1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1.layout"), LOG4CXXNG_STR("org.apache.log4j.SimpleLayout"));
+		props.put(LOG4CXXNG_STR("snapshot.dir"), LOG4CXXNG_STR("${snapshot.base}"));
+		props.put(LOG4CXXNG_STR("snapshot.base"), LOG4CXXNG_STR("snapshot"));
+		File snapshot("output/variables.snapshot");
+		LOGUNIT_ASSERT(SnapshotConfigurator::write(props, snapshot));
+
+		SnapshotConfigurator::configure(snapshot);
+		FileAppenderPtr a1(Logger::getRootLogger()->getAppender(LOG4CXXNG_STR("A1")));
+		LOGUNIT_ASSERT(a1 != 0);
+		LOGUNIT_ASSERT(a1->getLayout() != 0);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("output/snapshot/snapshot.A1"), a1->getFile());
+	}
+
+	void testEnvironment()
+	{
+		Pool p;
+		apr_env_set("SNAPSHOT_TEST_DIR", "written", p.getAPRPool());
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("DEBUG, A1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1"), LOG4CXXNG_STR("org.apache.log4j.FileAppender"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1.File"), LOG4CXXNG_STR("output/${SNAPSHOT_TEST_DIR}/env.A1"));
+		File snapshot("output/environment.snapshot");
+		LOGUNIT_ASSERT(SnapshotConfigurator::write(props, snapshot));
+
+		apr_env_set("SNAPSHOT_TEST_DIR", "loaded", p.getAPRPool());
+		SnapshotConfigurator::configure(snapshot);
+		FileAppenderPtr a1(Logger::getRootLogger()->getAppender(LOG4CXXNG_STR("A1")));
+		LOGUNIT_ASSERT(a1 != 0);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("output/loaded/env.A1"), a1->getFile());
+	}
+
+	void testConfigure()
+	{
+		Properties props;
+		props.load(new FileInputStream(LOG4CXXNG_STR("input/startup.properties")));
+		File snapshot("output/startup.snapshot");
+		LOGUNIT_ASSERT(SnapshotConfigurator::write(props, snapshot));
+
+		SnapshotConfigurator::configure(snapshot);
+		assertStartup();
+	}
+
+	void testConfigureXML()
+	{
+		File snapshot("output/startup-xml.snapshot");
+		LOGUNIT_ASSERT(SnapshotConfigurator::write(File("input/xml/startup.xml"), snapshot));
+
+		SnapshotConfigurator::configure(snapshot);
+		assertStartup();
+	}
+
+	/**
+	 *  A snapshot whose structure depends on a system property that
+	 *  changed loads the configuration file it was written from.
+	 */
+	void testStale()
+	{
+		Pool p;
+		apr_env_set("SNAPSHOT_TEST_DIR", "A1", p.getAPRPool());
+		{
+			std::ofstream config("output/stale.properties");
+			config << "log4j.rootLogger=INFO, ${SNAPSHOT_TEST_DIR}" << std::endl;
+			config << "log4j.appender.A1=org.apache.log4j.FileAppender" << std::endl;
+			config << "log4j.appender.A1.File=output/stale.A1" << std::endl;
+			config << "log4j.appender.A2=org.apache.log4j.FileAppender" << std::endl;
+			config << "log4j.appender.A2.File=output/stale.A2" << std::endl;
+		}
+		File snapshot("output/stale.snapshot");
+		LOGUNIT_ASSERT(SnapshotConfigurator::write(File("output/stale.properties"), snapshot));
+
+		apr_env_set("SNAPSHOT_TEST_DIR", "A2", p.getAPRPool());
+		SnapshotConfigurator::configure(snapshot);
+		LoggerPtr root(Logger::getRootLogger());
+		LOGUNIT_ASSERT(root->getAppender(LOG4CXXNG_STR("A1")) == 0);
+		LOGUNIT_ASSERT(root->getAppender(LOG4CXXNG_STR("A2")) != 0);
+	}
+
+	void testUndefinedAppender()
+	{
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("DEBUG, A1, MISSING"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1"), LOG4CXXNG_STR("org.apache.log4j.FileAppender"));
+		File snapshot("output/undefined.snapshot");
+		LOGUNIT_ASSERT(!SnapshotConfigurator::write(props, snapshot));
+	}
+
+	void testUnknownClass()
+	{
+		Properties props;
+		props.put(LOG4CXXNG_STR("log4j.rootLogger"), LOG4CXXNG_STR("DEBUG, A1"));
+		props.put(LOG4CXXNG_STR("log4j.appender.A1"), LOG4CXXNG_STR("org.apache.log4j.NoSuchAppender"));
+		File snapshot("output/unknown.snapshot");
+		LOGUNIT_ASSERT(!SnapshotConfigurator::write(props, snapshot));
+	}
+
+	void testNotASnapshot()
+	{
+		SnapshotConfigurator::configure(File("input/startup.properties"));
+		LOGUNIT_ASSERT(Logger::getRootLogger()->getAllAppenders().empty());
+	}
+
+private:
+	void assertStartup()
+	{
+		LoggerPtr root(Logger::getRootLogger());
+		LOGUNIT_ASSERT_EQUAL((int) Level::INFO_INT, root->getLevel()->toInt());
+		FileAppenderPtr a2(root->getAppender(LOG4CXXNG_STR("A2")));
+		LOGUNIT_ASSERT(a2 != 0);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("output/startup.A2"), a2->getFile());
+		LoggerPtr startup(Logger::getLogger("org.apache.log4j.startup"));
+		LOGUNIT_ASSERT(!startup->getAdditivity());
+		LOGUNIT_ASSERT(startup->getAppender(LOG4CXXNG_STR("A1")) != 0);
+	}
+};
+
+
+LOGUNIT_TEST_SUITE_REGISTRATION(SnapshotConfiguratorTest);
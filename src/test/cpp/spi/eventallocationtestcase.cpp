@@ -0,0 +1,223 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/fileappender.h>
+#include <log4cxxNG/patternlayout.h>
+#include <log4cxxNG/level.h>
+#include <log4cxxNG/helpers/threadspecificdata.h>
+#include "../logunit.h"
+#include <stdlib.h>
+#include <new>
+
+using namespace log4cxxng;
+using namespace log4cxxng::helpers;
+using namespace log4cxxng::spi;
+
+//
+//   Counts the allocations made while countAllocations is set.
+//   With glibc malloc itself is interposed so that allocations made
+//   by APR are counted too, elsewhere only operator new is replaced.
+//
+static volatile bool countAllocations = false;
+static volatile unsigned int allocations = 0;
+
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+extern "C" void* malloc(size_t size)
+{
+	if (countAllocations)
+	{
+		allocations++;
+	}
+
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+	if (countAllocations)
+	{
+		allocations++;
+	}
+
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+	if (countAllocations)
+	{
+		allocations++;
+	}
+
+	return __libc_realloc(ptr, size);
+}
+#else
+void* operator new(size_t size)
+{
+	if (countAllocations)
+	{
+		allocations++;
+	}
+
+	void* ptr = malloc(size);
+
+	if (ptr == 0)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void operator delete(void* ptr) throw()
+{
+	free(ptr);
+}
+#endif
+
+
+/**
+   Unit tests of the allocation of LoggingEvent.
+ */
+LOGUNIT_CLASS(EventAllocationTestCase)
+{
+	LOGUNIT_TEST_SUITE(EventAllocationTestCase);
+	LOGUNIT_TEST(testEventIsRecycled);
+	LOGUNIT_TEST(testLongMessageIsReleased);
+	LOGUNIT_TEST(testSteadyStateAllocations);
+	LOGUNIT_TEST(testSteadyStateMacroAllocations);
+	LOGUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown()
+	{
+		LogManager::shutdown();
+	}
+
+	/**
+	 * Tests that a released event is reused by the same thread
+	 * and refers to the name of its logger.
+	 */
+	void testEventIsRecycled()
+	{
+		LoggerPtr logger(Logger::getLogger("org.apache.log4j.EventAllocationTestCase"));
+		LoggingEvent* first = 0;
+		{
+			LoggingEventPtr event(LoggingEvent::create(*logger, Level::getInfo(),
+					LOG4CXXNG_STR("first"), LocationInfo::getLocationUnavailable()));
+			first = event;
+		}
+
+		LoggingEventPtr event(LoggingEvent::create(*logger, Level::getWarn(),
+				LOG4CXXNG_STR("second"), LocationInfo::getLocationUnavailable()));
+		LOGUNIT_ASSERT(first == (LoggingEvent*) event);
+		LOGUNIT_ASSERT(&logger->getName() == &event->getLoggerName());
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("second"), event->getMessage());
+		LOGUNIT_ASSERT_EQUAL((int) Level::WARN_INT, event->getLevel()->toInt());
+		LogString ndc;
+		LOGUNIT_ASSERT_EQUAL(false, event->getNDC(ndc));
+	}
+
+	/**
+	 * Tests that a recycled event does not keep the
+	 * capacity of an exceptionally long message.
+	 */
+	void testLongMessageIsReleased()
+	{
+		LoggerPtr logger(Logger::getLogger("org.apache.log4j.EventAllocationTestCase"));
+		LoggingEvent* first = 0;
+		{
+			LogString msg(100000, LOG4CXXNG_STR('x'));
+			LoggingEventPtr event(LoggingEvent::create(*logger, Level::getInfo(),
+					msg, LocationInfo::getLocationUnavailable()));
+			first = event;
+		}
+
+		LoggingEventPtr event(LoggingEvent::create(*logger, Level::getInfo(),
+				LOG4CXXNG_STR("short"), LocationInfo::getLocationUnavailable()));
+		LOGUNIT_ASSERT(first == (LoggingEvent*) event);
+		LOGUNIT_ASSERT(event->getMessage().capacity() <= ThreadSpecificData::MAX_MESSAGE_BUFFER_CAPACITY);
+	}
+
+	/**
+	 * Logs through a PatternLayout and a FileAppender and checks that,
+	 * once warmed up, no memory is allocated.  The pattern leaves the date
+	 * out as formatting a new second may allocate.
+	 */
+	void testSteadyStateAllocations()
+	{
+		LayoutPtr layout(new PatternLayout(LOG4CXXNG_STR("%-5p %c{2} [%t] - %m%n")));
+		FileAppenderPtr appender(new FileAppender(layout,
+				LOG4CXXNG_STR("output/eventallocation.log"), false));
+		LoggerPtr logger(Logger::getLogger("org.apache.log4j.EventAllocationTestCase"));
+		logger->setAdditivity(false);
+		logger->setLevel(Level::getInfo());
+		logger->addAppender(appender);
+
+		std::string msg("a message long enough to need a heap allocation when copied");
+
+		for (int i = 0; i < 100; i++)
+		{
+			logger->info(msg);
+		}
+
+		allocations = 0;
+		countAllocations = true;
+
+		for (int i = 0; i < 10000; i++)
+		{
+			logger->info(msg);
+		}
+
+		countAllocations = false;
+		LOGUNIT_ASSERT_EQUAL(0, (int) allocations);
+	}
+
+	/**
+	 * Checks that inserting strings and numbers with LOG4CXXNG_INFO
+	 * does not allocate once warmed up.
+	 */
+	void testSteadyStateMacroAllocations()
+	{
+		LayoutPtr layout(new PatternLayout(LOG4CXXNG_STR("%-5p %c{2} [%t] - %m%n")));
+		FileAppenderPtr appender(new FileAppender(layout,
+				LOG4CXXNG_STR("output/eventallocation.log"), false));
+		LoggerPtr logger(Logger::getLogger("org.apache.log4j.EventAllocationTestCase"));
+		logger->setAdditivity(false);
+		logger->setLevel(Level::getInfo());
+		logger->addAppender(appender);
+		allocations = 0;
+
+		for (int i = 0; i < 200; i++)
+		{
+			countAllocations = i >= 100;
+			LOG4CXXNG_INFO(logger, "request " << i << " from user " << -42L
+				<< " took " << 0.25 << "ms, cached=" << true);
+		}
+
+		countAllocations = false;
+		LOGUNIT_ASSERT_EQUAL(0, (int) allocations);
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(EventAllocationTestCase);
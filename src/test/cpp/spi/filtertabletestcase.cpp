@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <log4cxxNG/spi/filtertable.h>
+#include <log4cxxNG/filter/denyallfilter.h>
+#include <log4cxxNG/filter/levelrangefilter.h>
+#include <log4cxxNG/filter/loggermatchfilter.h>
+#include <log4cxxNG/filter/stringmatchfilter.h>
+#include <log4cxxNG/logger.h>
+#include <log4cxxNG/logmanager.h>
+#include <log4cxxNG/spi/loggingevent.h>
+#include <log4cxxNG/spi/location/locationinfo.h>
+#include "../logunit.h"
+
+using namespace log4cxxng;
+using namespace log4cxxng::filter;
+using namespace log4cxxng::helpers;
+using namespace log4cxxng::spi;
+
+/**
+   Unit tests for FilterTable
+ */
+LOGUNIT_CLASS(FilterTableTestCase)
+{
+	LOGUNIT_TEST_SUITE(FilterTableTestCase);
+	LOGUNIT_TEST(testEmptyChain);
+	LOGUNIT_TEST(testRangeLoggerDeny);
+	LOGUNIT_TEST(testUnknownFilter);
+	LOGUNIT_TEST(testEventWithoutLogger);
+	LOGUNIT_TEST(testChangedFilter);
+	LOGUNIT_TEST_SUITE_END();
+
+	FilterPtr chain;
+
+public:
+	void tearDown()
+	{
+		chain = 0;
+		LogManager::shutdown();
+	}
+
+	/**
+	 *  LevelRangeFilter(INFO..ERROR, accept) -> LoggerMatchFilter(org.example, accept) -> DenyAllFilter.
+	 */
+	LevelRangeFilterPtr buildChain()
+	{
+		LevelRangeFilterPtr range(new LevelRangeFilter());
+		range->setLevelMin(Level::getInfo());
+		range->setLevelMax(Level::getError());
+		range->setAcceptOnMatch(false);
+		LoggerMatchFilterPtr match(new LoggerMatchFilter());
+		match->setLoggerToMatch(LOG4CXXNG_STR("org.example"));
+		FilterPtr deny(new DenyAllFilter());
+		range->setNext(match);
+		match->setNext(deny);
+		chain = range;
+		return range;
+	}
+
+	static LoggingEventPtr event(const LoggerPtr& logger, const LevelPtr& level)
+	{
+		return LoggingEvent::create(*logger, level, LOG4CXXNG_STR("msg"),
+				LocationInfo::getLocationUnavailable());
+	}
+
+	void testEmptyChain()
+	{
+		FilterTable table;
+		table.compile(chain);
+		LOGUNIT_ASSERT(table.isCurrent());
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::APPEND,
+			(int) table.decide(event(Logger::getLogger("a"), Level::getDebug())));
+	}
+
+	void testRangeLoggerDeny()
+	{
+		buildChain();
+		FilterTable table;
+		table.compile(chain);
+		LoggerPtr matched(Logger::getLogger("org.example"));
+		LoggerPtr other(Logger::getLogger("org.other"));
+
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::APPEND,
+			(int) table.decide(event(matched, Level::getInfo())));
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::APPEND,
+			(int) table.decide(event(matched, Level::getError())));
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::DROP,
+			(int) table.decide(event(matched, Level::getDebug())));
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::DROP,
+			(int) table.decide(event(matched, Level::getFatal())));
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::DROP,
+			(int) table.decide(event(other, Level::getWarn())));
+	}
+
+	void testUnknownFilter()
+	{
+		buildChain();
+		StringMatchFilterPtr string(new StringMatchFilter());
+		string->setNext(chain);
+		chain = string;
+		FilterTable table;
+		table.compile(chain);
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::CONSULT_CHAIN,
+			(int) table.decide(event(Logger::getLogger("org.example"), Level::getInfo())));
+	}
+
+	void testEventWithoutLogger()
+	{
+		buildChain();
+		FilterTable table;
+		table.compile(chain);
+		LoggingEventPtr detached(new LoggingEvent(LOG4CXXNG_STR("org.example"),
+				Level::getInfo(), LOG4CXXNG_STR("msg"), LocationInfo::getLocationUnavailable()));
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::CONSULT_CHAIN, (int) table.decide(detached));
+	}
+
+	void testChangedFilter()
+	{
+		LevelRangeFilterPtr range(buildChain());
+		FilterTable table;
+		table.compile(chain);
+		range->setLevelMin(Level::getDebug());
+		LOGUNIT_ASSERT(!table.isCurrent());
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::CONSULT_CHAIN,
+			(int) table.decide(event(Logger::getLogger("org.example"), Level::getDebug())));
+		table.compile(chain);
+		LOGUNIT_ASSERT_EQUAL((int) FilterTable::APPEND,
+			(int) table.decide(event(Logger::getLogger("org.example"), Level::getDebug())));
+	}
+};
+
+LOGUNIT_TEST_SUITE_REGISTRATION(FilterTableTestCase);
@@ -19,6 +19,7 @@
 #include <log4cxxNG/logmanager.h>
 #include <log4cxxNG/ndc.h>
 #include <log4cxxNG/mdc.h>
+#include <log4cxxNG/helpers/transcoder.h>
 #include "../logunit.h"
 
 using namespace log4cxxng;
@@ -38,6 +39,7 @@ LOGUNIT_CLASS(LoggingEventTest)
 	LOGUNIT_TEST(testSerializationWithLocation);
 	LOGUNIT_TEST(testSerializationNDC);
 	LOGUNIT_TEST(testSerializationMDC);
+	LOGUNIT_TEST(testLocationNames);
 	LOGUNIT_TEST_SUITE_END();
 
 public:
@@ -121,6 +123,40 @@ public:
 				"witness/serialization/mdc.bin", event, 237));
 	}
 
+	static LocationInfo locate()
+	{
+		return LOG4CXXNG_LOCATION;
+	}
+
+	/**
+	 * Names parsed once per call site must match those parsed
+	 * from the signature on every call.
+	 */
+	void testLocationNames()
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			LocationInfo location(locate());
+			LogString className;
+			location.getClassName(className);
+			LogString methodName;
+			location.getMethodName(methodName);
+
+			LOG4CXXNG_DECODE_CHAR(expectedClass, location.getClassName());
+			LOG4CXXNG_DECODE_CHAR(expectedMethod, location.getMethodName());
+			LOGUNIT_ASSERT_EQUAL(expectedClass, className);
+			LOGUNIT_ASSERT_EQUAL(expectedMethod, methodName);
+#if defined(__GNUC__) || defined(_MSC_VER)
+			LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("locate"), methodName);
+#endif
+		}
+
+		LocationInfo location(LocationInfo::getLocationUnavailable());
+		LogString methodName;
+		location.getMethodName(methodName);
+		LOGUNIT_ASSERT_EQUAL((LogString) LOG4CXXNG_STR("?"), methodName);
+	}
+
 };
 
 LOGUNIT_TEST_SUITE_REGISTRATION(LoggingEventTest);
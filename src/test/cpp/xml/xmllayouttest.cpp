@@ -67,6 +67,7 @@ LOGUNIT_CLASS(XMLLayoutTest)
 	LOGUNIT_TEST(testActivateOptions);
 	LOGUNIT_TEST(testProblemCharacters);
 	LOGUNIT_TEST(testNDCWithCDATA);
+	LOGUNIT_TEST(testLongProblemCharacters);
 	LOGUNIT_TEST_SUITE_END();
 
 
@@ -453,6 +454,34 @@ public:
 		LOGUNIT_ASSERT_EQUAL(1, ndcCount);
 	}
 
+	/**
+	 * Tests problem characters on either side of the 16 and 32
+	 * character blocks scanned at once, in the cached escaped
+	 * name of a logger.
+	 */
+	void testLongProblemCharacters()
+	{
+		std::string problemName = "com.example.long.logger.name.for.blocks<>&\"'.end";
+		LoggerPtr logger = Logger::getLogger(problemName);
+		std::string message = "0123456789abcde<0123456789abcdef>0123456789abcdef0123456789abcde&";
+		LOG4CXXNG_DECODE_CHAR(messageLS, message);
+		XMLLayout layout;
+		Pool p;
+
+		for (int i = 0; i < 2; i++)
+		{
+			LoggingEventPtr event(LoggingEvent::create(*logger,
+					Level::getInfo(), messageLS, LOG4CXXNG_LOCATION));
+			LogString result;
+			layout.format(result, event, p);
+
+			apr_xml_elem* parsedResult = parse(result, p);
+			checkEventElement(parsedResult, event);
+			LOGUNIT_ASSERT(parsedResult->first_child != NULL);
+			checkMessageElement(parsedResult->first_child, message);
+		}
+	}
+
 };
 
 